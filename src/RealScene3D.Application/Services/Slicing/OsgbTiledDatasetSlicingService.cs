@@ -64,8 +64,9 @@ public class OsgbTiledDatasetSlicingService
             _logger.LogWarning("未找到 metadata.xml，将使用默认坐标系");
         }
 
-        // 3. 调用 C++ 处理
+        // 3. 调用 C++ 处理（原生后台线程执行，取消时各转换线程完成当前节点即停止）
         using var reader = new OSGB23dTiles.Helper();
+        var progress = new Progress<ConversionProgress>(ReportProgress);
         bool success;
 
         if (config.StorageLocation == StorageLocationType.MinIO)
@@ -80,21 +81,21 @@ public class OsgbTiledDatasetSlicingService
                 throw new InvalidOperationException("MinIO 配置不完整，请提供 Endpoint、AccessKey 和 SecretKey");
             }
 
-            success = await Task.Run(() =>
-                reader.ConvertToB3DMBatchToMinIO(
-                    datasetRootPath,
-                    outputDir,
-                    config.MinioEndpoint,
-                    config.MinioAccessKey,
-                    config.MinioSecretKey,
-                    config.MinioUseSSL,
-                    centerX: config.CenterX ?? 0.0,
-                    centerY: config.CenterY ?? 0.0,
-                    maxLevel: -1, // -1 表示不限制层级，处理所有 LOD
-                    enableTextureCompression: config.EnableTextureCompression,
-                    enableMeshOptimization: config.EnableMeshOptimization,
-                    enableDracoCompression: config.EnableDracoCompression
-                ), cancellationToken);
+            success = await reader.ConvertToB3DMBatchToMinIOAsync(
+                datasetRootPath,
+                outputDir,
+                config.MinioEndpoint,
+                config.MinioAccessKey,
+                config.MinioSecretKey,
+                config.MinioUseSSL,
+                centerX: config.CenterX ?? 0.0,
+                centerY: config.CenterY ?? 0.0,
+                maxLevel: -1, // -1 表示不限制层级，处理所有 LOD
+                enableTextureCompression: config.EnableTextureCompression,
+                enableMeshOptimization: config.EnableMeshOptimization,
+                enableDracoCompression: config.EnableDracoCompression,
+                progress: progress,
+                cancellationToken: cancellationToken);
         }
         else
         {
@@ -104,17 +105,17 @@ public class OsgbTiledDatasetSlicingService
             // 确保输出目录存在
             Directory.CreateDirectory(outputDir);
 
-            success = await Task.Run(() =>
-                reader.ConvertToB3DMBatch(
-                    datasetRootPath,
-                    outputDir,
-                    centerX: config.CenterX ?? 0.0,
-                    centerY: config.CenterY ?? 0.0,
-                    maxLevel: -1, // -1 表示不限制层级，处理所有 LOD
-                    enableTextureCompression: config.EnableTextureCompression,
-                    enableMeshOptimization: config.EnableMeshOptimization,
-                    enableDracoCompression: config.EnableDracoCompression
-                ), cancellationToken);
+            success = await reader.ConvertToB3DMBatchAsync(
+                datasetRootPath,
+                outputDir,
+                centerX: config.CenterX ?? 0.0,
+                centerY: config.CenterY ?? 0.0,
+                maxLevel: -1, // -1 表示不限制层级，处理所有 LOD
+                enableTextureCompression: config.EnableTextureCompression,
+                enableMeshOptimization: config.EnableMeshOptimization,
+                enableDracoCompression: config.EnableDracoCompression,
+                progress: progress,
+                cancellationToken: cancellationToken);
         }
 
         if (!success)
@@ -137,6 +138,21 @@ public class OsgbTiledDatasetSlicingService
         return true;
     }
 
+    /// <summary>
+    /// 输出切片进度
+    /// </summary>
+    private void ReportProgress(ConversionProgress progress)
+    {
+        _logger.LogInformation(
+            "切片进度: {Done}/{Total} 个瓦片 (失败 {Failed}), 已写入 {Bytes:F1} MB, 已用 {Elapsed:F0} 秒, 预计剩余 {Eta}",
+            progress.nTilesDone,
+            progress.nTilesTotal,
+            progress.nTilesFailed,
+            progress.nBytesWritten / (1024.0 * 1024.0),
+            progress.dElapsedSeconds,
+            progress.dEtaSeconds >= 0 ? $"{progress.dEtaSeconds:F0} 秒" : "未知");
+    }
+
     /// <summary>
     /// 读取metadata.xml文件，提取坐标系信息
     /// </summary>
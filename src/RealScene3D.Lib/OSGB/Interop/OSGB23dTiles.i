@@ -9,6 +9,14 @@
 #define ENABLE_MINIO
 #include "Native/OSGB23dTiles.h"
 #include "Native/Tileset.h"
+#include "Native/TileArchiveReader.h"
+#include "Native/LazyTileConverter.h"
+#include "Native/GlbCache.h"
+#include "Native/ConversionJob.h"
+#include "Native/TilesetMerger.h"
+#include "Native/ConversionMetrics.h"
+#include "Native/TraceRecorder.h"
+#include "Native/AsyncLog.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -28,24 +36,38 @@
  * std::vector<uint8_t> 映射 - 用于 ToGLBBuf 返回值
  * ============================================================================ */
 
+// 原生数据地址映射为 C# IntPtr
+%apply void *VOID_INT_PTR { const void * }
+%apply void *VOID_INT_PTR { void *pDest }
+
+// 暴露 vector 的数据地址，C# 侧一次 Marshal.Copy 复制整个数组
+%extend std::vector<unsigned char> {
+    const void* DataPtr() const {
+        return $self->empty() ? nullptr : $self->data();
+    }
+}
+
 // 定义 std::vector<uint8_t> 模板，元素类型为 unsigned char (byte)
 namespace std {
     %template(VectorUInt8) vector<unsigned char>;
+    %template(VectorString) vector<std::string>;
+    %template(VectorDouble) vector<double>;
 }
 
-// 将 std::vector<uint8_t> 转换为 C# byte[]
+// 将 std::vector<uint8_t> 转换为 C# byte[]（一次内存复制，不逐元素访问）
 %typemap(cstype) std::vector<uint8_t> "byte[]"
 %typemap(csout, excode=SWIGEXCODE) std::vector<uint8_t> {
     global::System.IntPtr cPtr = $imcall;$excode
-    VectorUInt8 tempVector = new VectorUInt8(cPtr, true);
+    using (VectorUInt8 tempVector = new VectorUInt8(cPtr, true))
+    {
+        byte[] result = new byte[tempVector.Count];
+        if (result.Length > 0)
+        {
+            global::System.Runtime.InteropServices.Marshal.Copy(tempVector.DataPtr(), result, 0, result.Length);
+        }
 
-    byte[] result = new byte[tempVector.Count];
-    for (int i = 0; i < tempVector.Count; i++) {
-        result[i] = tempVector[i];
+        return result;
     }
-
-    tempVector.Dispose();
-    return result;
 }
 
 /* ============================================================================
@@ -79,12 +101,86 @@ namespace std {
 %ignore OSGB23dTiles::DoTileJob;
 %ignore OSGB23dTiles::EncodeTileJSON;
 %ignore OSGB23dTiles::GetAllTree;
+%ignore OSGB23dTiles::WriteTileNode;
+%ignore OSGB23dTiles::FinishTileTree;
+%ignore OSGB23dTiles::ToB3DMProgressive;
+%ignore OSGB23dTiles::EstimateTileBox;
+%ignore OSGB23dTiles::SetLazyConversion;
+%ignore OSGB23dTiles::MakeSettingsKey;
+%ignore OSGB23dTiles::LoadDatasetMetadata;
+%ignore OSGB23dTiles::ToB3DMNode;
+%ignore OSGB23dTiles::ToB3DMLazy;
+%ignore OSGB23dTiles::RegisterLazyNodes;
+%ignore LazyNodeCallback;
 %ignore OSGB23dTiles::WriteOsgIndecis;
 %ignore OSGB23dTiles::WriteVec3Array;
 %ignore OSGB23dTiles::WriteVec2Array;
 %ignore OSGB23dTiles::WriteElementArrayPrimitive;
 %ignore OSGB23dTiles::WriteOsgGeometry;
 
+// 归档读取器的零拷贝视图只在C++侧使用，C#通过 GetTileData 获取 IntPtr
+%ignore TileArchiveSpan;
+
+// 输出目标：C# 侧只需创建 LocalFileSink / MemorySink / NullSink 并传给 ToB3DMBatch
+%ignore IOutputSink::Write;
+%ignore IOutputSink::MakeDirs;
+%ignore IOutputSink::WriteEncoded;
+%ignore MemorySink::Get;
+%ignore ArchiveSink;
+%ignore MinioSink;
+%ignore AsyncFileWriter;
+%ignore TileArchiveReader::Find;
+%ignore TileArchiveReader::ReadEntry;
+
+// 增量清单只在C++侧使用，C# 通过 IncrementalSettings / Helper.SetIncremental 配置
+%ignore IncrementalManifest;
+%ignore BatchJournal;
+%ignore JournalRecord;
+
+// 按需转换：C# 通过 ConvertTileBuf 获取 B3DM
+%ignore LazyTileConverter::ConvertTile;
+
+// GLB 缓存：C# 通过 Helper.SetGlbCache / GetGlbCacheStats 使用
+%ignore GlbCache::GetOrCreate;
+%ignore GlbCache::Producer;
+
+// 原生缓冲区：C++侧填充，C# 通过 GetData / CopyTo 访问；ToGLBHandle 返回的句柄由C#释放
+%ignore NativeBuffer::NativeBuffer(std::string&&);
+%ignore NativeBuffer::NativeBuffer(std::shared_ptr<const std::string>);
+%ignore OSGB23dTiles::ToGLBCached;
+%newobject OSGB23dTiles::ToGLBHandle;
+
+// 异步任务：C# 继承 ProgressListener 接收进度，通过 ConversionJob 启动与取消
+%feature("director") ProgressListener;
+%ignore JobControl;
+%ignore OSGB23dTiles::SetJobControl;
+
+// 调度器：C# 通过 Helper.SetScheduling / ConfigureScheduler / GetSchedulerStats 使用
+%ignore JobScheduler::Slot;
+%ignore JobScheduler::Acquire;
+%ignore JobGroup;
+
+// 转换子集：C# 通过 SubsetSettings / Helper.SetSubset 配置，过滤器只在C++侧使用
+%ignore SubsetFilter;
+
+// 转换统计：C# 只读取报告，计时与累加只在C++侧使用
+%ignore ConversionMetrics::Begin;
+%ignore ConversionMetrics::End;
+%ignore ConversionMetrics::AddStage;
+%ignore ConversionMetrics::AddBytes;
+%ignore ConversionMetrics::AddNode;
+%ignore ConversionMetrics::AddTile;
+%ignore MetricsTimer;
+
+// 时间线跟踪：C# 通过 TraceSettings / Helper.SetTrace 按任务开关，记录器只在C++侧使用
+%ignore TraceRecorder;
+%ignore TraceScope;
+%ignore TraceSession;
+
+// 异步日志：C# 通过 Helper.SetAsyncLogging 配置，限流只在C++侧使用
+%ignore AsyncLog::ProgressIntervalMs;
+%ignore LogThrottle;
+
 /* ============================================================================
  * 自定义 C# 辅助类 - 提供更友好的 API
  * 必须在 %include 头文件之前定义才能生效
@@ -138,20 +234,35 @@ using System.Runtime.InteropServices;
             bool enableMeshOptimization = false,
             bool enableDracoCompression = false)
         {
-            byte[] glbBytes = reader.ToGLBBuf(
+            using (NativeBuffer? glb = ConvertToGlbHandle(
                 osgbPath,
-                -1,  // node_type: -1 表示自动判断
                 bBainary,
                 enableTextureCompression,
                 enableMeshOptimization,
-                enableDracoCompression);
-
-            if (glbBytes == null || glbBytes.Length == 0)
+                enableDracoCompression))
             {
-                return null;
+                return glb?.ToArray();
             }
+        }
 
-            return glbBytes;
+        /// <summary>
+        /// 将 OSGB 文件转换为 GLB，结果留在原生内存中
+        /// </summary>
+        /// <returns>缓冲区句柄（通过 AsSpan / AsStream 直接访问，用完后 Dispose），失败返回 null</returns>
+        public NativeBuffer? ConvertToGlbHandle(
+            string osgbPath,
+            bool bBainary = true,
+            bool enableTextureCompression = false,
+            bool enableMeshOptimization = false,
+            bool enableDracoCompression = false)
+        {
+            return reader.ToGLBHandle(
+                osgbPath,
+                -1,  // node_type: -1 表示自动判断
+                bBainary,
+                enableTextureCompression,
+                enableMeshOptimization,
+                enableDracoCompression);
         }
 
         /// <summary>
@@ -195,9 +306,201 @@ using System.Runtime.InteropServices;
             return (true, string.IsNullOrEmpty(tilesetJson) ? null : tilesetJson, bbox);
         }
 
+        /// <summary>
+        /// 设置批量转换的增量模式：输入与参数未变化的瓦片跳过转换
+        /// </summary>
+        /// <param name="manifestPath">增量清单路径，null 表示保存在本地输出目录（输出到MinIO时必须指定）</param>
+        public void SetIncremental(bool enable, bool contentHash = false, string? manifestPath = null)
+        {
+            IncrementalSettings settings = new IncrementalSettings();
+            settings.bEnable = enable;
+            settings.bContentHash = contentHash;
+            settings.strManifestPath = manifestPath ?? "";
+            reader.SetIncrementalSettings(settings);
+        }
+
+        /// <summary>
+        /// 设置批量转换的断点续传：进程中断后重新运行只转换未完成的瓦片
+        /// </summary>
+        /// <param name="journalPath">进度日志路径，null 表示保存在本地输出目录（输出到MinIO时必须指定）</param>
+        public void SetResume(bool enable, string? journalPath = null, int checkpointSeconds = 30)
+        {
+            ResumeSettings settings = new ResumeSettings();
+            settings.bEnable = enable;
+            settings.strJournalPath = journalPath ?? "";
+            settings.nCheckpointSeconds = checkpointSeconds;
+            reader.SetResumeSettings(settings);
+        }
+
+        /// <summary>
+        /// 设置批量转换写入本地输出目录时的异步写入
+        /// </summary>
+        /// <param name="syncOnFlush">任务结束前是否对全部输出文件执行 fsync（返回成功时瓦片已落盘）</param>
+        /// <param name="threads">I/O线程数（NFS等高延迟存储上可适当调大）</param>
+        public void SetLocalWrite(bool syncOnFlush, int threads = 4)
+        {
+            AsyncWriteSettings settings = new AsyncWriteSettings();
+            settings.bSyncOnFlush = syncOnFlush;
+            settings.nThreads = threads;
+            reader.SetLocalWriteSettings(settings);
+        }
+
+        /// <summary>
+        /// 设置批量转换的渐进式发布：先发布 tileset 骨架，再按LOD层级由粗到细转换
+        /// </summary>
+        public void SetProgressivePublish(bool enable)
+        {
+            reader.SetProgressivePublish(enable);
+        }
+
+        /// <summary>
+        /// 设置批量转换的子集：只读取并转换与区域相交、层级在范围内的节点
+        /// </summary>
+        /// <param name="region">区域多边形顶点（数据集坐标系，依次为 x0, y0, x1, y1, ...），null 表示不限制区域</param>
+        /// <param name="minLevel">最低层级（含），-1 表示不限制</param>
+        /// <param name="maxLevel">最高层级（含），-1 表示不限制</param>
+        public void SetSubset(double[]? region = null, int minLevel = -1, int maxLevel = -1)
+        {
+            SubsetSettings settings = new SubsetSettings();
+            settings.vecRegion = new VectorDouble(region ?? new double[0]);
+            settings.nMinLevel = minLevel;
+            settings.nMaxLevel = maxLevel;
+            reader.SetSubsetSettings(settings);
+        }
+
+        /// <summary>
+        /// 设置批量转换的子集：矩形区域（数据集坐标系）与层级范围
+        /// </summary>
+        public void SetSubsetBox(double minX, double minY, double maxX, double maxY, int minLevel = -1, int maxLevel = -1)
+        {
+            SetSubset(new double[] { minX, minY, maxX, minY, maxX, maxY, minX, maxY }, minLevel, maxLevel);
+        }
+
+        /// <summary>
+        /// 设置转换统计（各阶段耗时、字节数、三角形与顶点数、最慢的瓦片）
+        /// </summary>
+        /// <param name="writeReport">批量转换结束时是否把报告写到输出目录</param>
+        /// <param name="slowestTiles">报告中保留的最慢瓦片数</param>
+        public void SetMetrics(bool enable = true, bool writeReport = false, int slowestTiles = 10)
+        {
+            MetricsSettings settings = new MetricsSettings();
+            settings.bEnable = enable;
+            settings.bWriteReport = writeReport;
+            settings.nSlowestTiles = slowestTiles;
+            reader.SetMetricsSettings(settings);
+        }
+
+        /// <summary>
+        /// 最近一次同步转换的统计报告（JSON）
+        /// </summary>
+        public string GetMetricsReport()
+        {
+            return reader.GetMetricsReport();
+        }
+
+        /// <summary>
+        /// 最近一次异步任务的统计报告（JSON），任务未启动时为 null
+        /// </summary>
+        public string? LastJobMetricsReport { get; private set; }
+
+        /// <summary>
+        /// 设置批量转换的时间线跟踪（成功结束时在输出目录写出 Chrome trace JSON）
+        /// </summary>
+        /// <param name="eventsPerThread">每个线程保留的事件数，超出后覆盖最早的事件</param>
+        public void SetTrace(bool enable, uint eventsPerThread = 65536)
+        {
+            TraceSettings settings = new TraceSettings();
+            settings.bEnable = enable;
+            settings.nEventsPerThread = eventsPerThread;
+            reader.SetTraceSettings(settings);
+        }
+
+        /// <summary>
+        /// 设置进程共享的异步日志（默认不启用，应在开始转换前调用）
+        /// </summary>
+        /// <param name="queueSize">日志队列容量（条），写满时写日志的线程等待；只在首次启用时生效</param>
+        /// <param name="progressIntervalMs">批量转换进度日志的最小间隔（毫秒），0 表示每个瓦片都输出</param>
+        public static bool SetAsyncLogging(bool enable, uint queueSize = 8192, int progressIntervalMs = 1000)
+        {
+            AsyncLogSettings settings = new AsyncLogSettings();
+            settings.bEnable = enable;
+            settings.nQueueSize = queueSize;
+            settings.nProgressIntervalMs = progressIntervalMs;
+            return AsyncLog.Configure(settings);
+        }
+
+        /// <summary>
+        /// 设置进程共享的 GLB 缓存（ConvertToGlb / ConvertToGlbBuffer 使用）
+        /// </summary>
+        /// <param name="maxBytes">缓存的 GLB 字节上限</param>
+        public static void SetGlbCache(bool enable, uint maxBytes = 256u * 1024 * 1024)
+        {
+            GlbCacheSettings settings = new GlbCacheSettings();
+            settings.bEnable = enable;
+            settings.nMaxBytes = maxBytes;
+            GlbCache.Global().Configure(settings);
+        }
+
+        /// <summary>
+        /// 设置批量转换的调度方式：瓦片之间让出给交互请求（模型预览、按需瓦片）
+        /// </summary>
+        /// <param name="priority">批量转换的优先级</param>
+        /// <param name="maxConcurrency">每次批量转换同时占用的槽位上限，0 表示不限制</param>
+        public void SetScheduling(JobPriority priority, int maxConcurrency = 0)
+        {
+            reader.SetScheduling(priority, maxConcurrency);
+        }
+
+        /// <summary>
+        /// 配置进程共享的转换调度器
+        /// </summary>
+        /// <param name="maxSlots">同时执行转换的槽位数，0 表示使用硬件线程数</param>
+        /// <param name="reservedInteractive">为交互请求保留的槽位数</param>
+        public static void ConfigureScheduler(int maxSlots = 0, int reservedInteractive = 1)
+        {
+            SchedulerSettings settings = new SchedulerSettings();
+            settings.nMaxSlots = maxSlots;
+            settings.nReservedInteractive = reservedInteractive;
+            JobScheduler.Global().Configure(settings);
+        }
+
+        /// <summary>
+        /// 获取调度统计（含交互请求的等待时间）
+        /// </summary>
+        public static SchedulerStats GetSchedulerStats()
+        {
+            return JobScheduler.Global().GetStats();
+        }
+
+        /// <summary>
+        /// 合并多个已转换的数据集：生成引用各数据集根 tileset.json 的新根，不重新转换瓦片
+        /// </summary>
+        /// <param name="tilesetPaths">各数据集的根 tileset.json 路径或所在目录</param>
+        /// <param name="outputPath">输出 tileset.json 路径或目录</param>
+        public static bool MergeTilesets(System.Collections.Generic.IEnumerable<string> tilesetPaths, string outputPath)
+        {
+            using (VectorString paths = new VectorString())
+            {
+                foreach (string path in tilesetPaths)
+                {
+                    paths.Add(path);
+                }
+                return TilesetMerger.Merge(paths, outputPath);
+            }
+        }
+
+        /// <summary>
+        /// 获取 GLB 缓存统计
+        /// </summary>
+        public static GlbCacheStats GetGlbCacheStats()
+        {
+            return GlbCache.Global().GetStats();
+        }
+
         /// <summary>
         /// 批量转换整个倾斜摄影数据集
         /// </summary>
+        /// <param name="sink">输出目标（如 MemorySink / NullSink），null 表示写入 outputDir</param>
         public bool ConvertToB3DMBatch(
             string dataDir,
             string outputDir,
@@ -206,7 +509,8 @@ using System.Runtime.InteropServices;
             int maxLevel = 0,
             bool enableTextureCompression = false,
             bool enableMeshOptimization = false,
-            bool enableDracoCompression = false)
+            bool enableDracoCompression = false,
+            IOutputSink? sink = null)
         {
             return reader.ToB3DMBatch(
                 dataDir,
@@ -216,6 +520,31 @@ using System.Runtime.InteropServices;
                 maxLevel,
                 enableTextureCompression,
                 enableMeshOptimization,
+                enableDracoCompression,
+                sink);
+        }
+
+        /// <summary>
+        /// 批量转换倾斜摄影数据集并写入单个3TZ归档文件
+        /// </summary>
+        public bool ConvertToB3DMBatchToArchive(
+            string dataDir,
+            string archivePath,
+            double centerX = 0.0,
+            double centerY = 0.0,
+            int maxLevel = 0,
+            bool enableTextureCompression = false,
+            bool enableMeshOptimization = false,
+            bool enableDracoCompression = false)
+        {
+            return reader.ToB3DMBatchToArchive(
+                dataDir,
+                archivePath,
+                centerX,
+                centerY,
+                maxLevel,
+                enableTextureCompression,
+                enableMeshOptimization,
                 enableDracoCompression);
         }
 
@@ -234,7 +563,9 @@ using System.Runtime.InteropServices;
             int maxLevel = 0,
             bool enableTextureCompression = false,
             bool enableMeshOptimization = false,
-            bool enableDracoCompression = false)
+            bool enableDracoCompression = false,
+            bool skipUnchanged = false,
+            bool precompress = false)
         {
             return reader.ToB3DMBatchToMinIO(
                 dataDir,
@@ -248,7 +579,191 @@ using System.Runtime.InteropServices;
                 maxLevel,
                 enableTextureCompression,
                 enableMeshOptimization,
-                enableDracoCompression);
+                enableDracoCompression,
+                skipUnchanged,
+                precompress);
+        }
+
+        /// <summary>
+        /// 异步批量转换：在原生后台线程执行，不占用 .NET 线程
+        /// </summary>
+        /// <param name="progress">进度（约每 500 毫秒一次）</param>
+        /// <param name="cancellationToken">取消后各转换线程完成当前节点即停止，已完成的瓦片保留在进度日志中</param>
+        /// <exception cref="OperationCanceledException">任务被取消</exception>
+        public System.Threading.Tasks.Task<bool> ConvertToB3DMBatchAsync(
+            string dataDir,
+            string outputDir,
+            double centerX = 0.0,
+            double centerY = 0.0,
+            int maxLevel = 0,
+            bool enableTextureCompression = false,
+            bool enableMeshOptimization = false,
+            bool enableDracoCompression = false,
+            IProgress<ConversionProgress>? progress = null,
+            System.Threading.CancellationToken cancellationToken = default)
+        {
+            return RunJobAsync(job => job.StartB3DMBatch(
+                dataDir,
+                outputDir,
+                centerX,
+                centerY,
+                maxLevel,
+                enableTextureCompression,
+                enableMeshOptimization,
+                enableDracoCompression), progress, cancellationToken);
+        }
+
+        /// <summary>
+        /// 异步批量转换并写入MinIO
+        /// </summary>
+        /// <exception cref="OperationCanceledException">任务被取消</exception>
+        public System.Threading.Tasks.Task<bool> ConvertToB3DMBatchToMinIOAsync(
+            string dataDir,
+            string minioPath,
+            string minioEndpoint,
+            string accessKey,
+            string secretKey,
+            bool useSSL,
+            double centerX = 0.0,
+            double centerY = 0.0,
+            int maxLevel = 0,
+            bool enableTextureCompression = false,
+            bool enableMeshOptimization = false,
+            bool enableDracoCompression = false,
+            bool skipUnchanged = false,
+            bool precompress = false,
+            IProgress<ConversionProgress>? progress = null,
+            System.Threading.CancellationToken cancellationToken = default)
+        {
+            return RunJobAsync(job => job.StartB3DMBatchToMinIO(
+                dataDir,
+                minioPath,
+                minioEndpoint,
+                accessKey,
+                secretKey,
+                useSSL,
+                centerX,
+                centerY,
+                maxLevel,
+                enableTextureCompression,
+                enableMeshOptimization,
+                enableDracoCompression,
+                skipUnchanged,
+                precompress), progress, cancellationToken);
+        }
+
+        /// <summary>
+        /// 异步将 OSGB 文件转换为 GLB 文件（转换开始后不可中断）
+        /// </summary>
+        /// <exception cref="OperationCanceledException">任务被取消</exception>
+        public System.Threading.Tasks.Task<bool> ConvertToGlbAsync(
+            string osgbPath,
+            string glbPath,
+            bool enableTextureCompression = false,
+            bool enableMeshOptimization = false,
+            bool enableDracoCompression = false,
+            System.Threading.CancellationToken cancellationToken = default)
+        {
+            return RunJobAsync(job => job.StartGLB(
+                osgbPath,
+                glbPath,
+                true,
+                enableTextureCompression,
+                enableMeshOptimization,
+                enableDracoCompression), null, cancellationToken);
+        }
+
+        /// <summary>
+        /// 启动异步任务（沿用本对象的增量、续传与渐进式发布配置）并等待结束
+        /// </summary>
+        private async System.Threading.Tasks.Task<bool> RunJobAsync(
+            Func<ConversionJob, bool> start,
+            IProgress<ConversionProgress>? progress,
+            System.Threading.CancellationToken cancellationToken)
+        {
+            cancellationToken.ThrowIfCancellationRequested();
+
+            // listener 须在任务结束前保持存活（原生线程通过 director 回调）；
+            // 离开 using 时释放任务，等待原生线程退出（OnFinished 之后立即结束）
+            JobListener listener = new JobListener(progress);
+            using (ConversionJob job = new ConversionJob(listener, 500))
+            {
+                OSGB23dTiles converter = job.GetConverter();
+                converter.SetIncrementalSettings(reader.GetIncrementalSettings());
+                converter.SetResumeSettings(reader.GetResumeSettings());
+                converter.SetLocalWriteSettings(reader.GetLocalWriteSettings());
+                converter.SetProgressivePublish(reader.IsProgressivePublish());
+                converter.SetSubsetSettings(reader.GetSubsetSettings());
+                converter.SetScheduling(reader.GetSchedulingPriority(), reader.GetMaxConcurrency());
+                converter.SetMetricsSettings(reader.GetMetricsSettings());
+                converter.SetTraceSettings(reader.GetTraceSettings());
+
+                if (!start(job))
+                {
+                    return false;
+                }
+
+                bool success;
+                using (cancellationToken.Register(() => job.Cancel()))
+                {
+                    success = await listener.Completion.Task.ConfigureAwait(false);
+                }
+
+                LastJobMetricsReport = converter.GetMetricsReport();
+
+                if (listener.Cancelled)
+                {
+                    cancellationToken.ThrowIfCancellationRequested();
+                }
+
+                return success;
+            }
+        }
+
+        /// <summary>
+        /// 把原生进度回调转给 IProgress，并在任务结束时完成 Completion
+        /// </summary>
+        private sealed class JobListener : ProgressListener
+        {
+            private readonly IProgress<ConversionProgress>? progress;
+
+            public System.Threading.Tasks.TaskCompletionSource<bool> Completion { get; } =
+                new System.Threading.Tasks.TaskCompletionSource<bool>(
+                    System.Threading.Tasks.TaskCreationOptions.RunContinuationsAsynchronously);
+
+            public bool Cancelled { get; private set; }
+
+            public JobListener(IProgress<ConversionProgress>? progress)
+            {
+                this.progress = progress;
+            }
+
+            public override void OnProgress(ConversionProgress current)
+            {
+                // 回调参数只在回调期间有效，IProgress 可能稍后在其他线程读取，先复制
+                progress?.Report(Copy(current));
+            }
+
+            public override void OnFinished(bool bSuccess, ConversionProgress current)
+            {
+                Cancelled = current.bCancelled;
+                Completion.TrySetResult(bSuccess);
+            }
+
+            private static ConversionProgress Copy(ConversionProgress source)
+            {
+                ConversionProgress copy = new ConversionProgress();
+                copy.nTilesDone = source.nTilesDone;
+                copy.nTilesFailed = source.nTilesFailed;
+                copy.nTilesTotal = source.nTilesTotal;
+                copy.nLevelsDone = source.nLevelsDone;
+                copy.nLevelsTotal = source.nLevelsTotal;
+                copy.nBytesWritten = source.nBytesWritten;
+                copy.dElapsedSeconds = source.dElapsedSeconds;
+                copy.dEtaSeconds = source.dEtaSeconds;
+                copy.bCancelled = source.bCancelled;
+                return copy;
+            }
         }
 
         public void Dispose()
@@ -266,6 +781,74 @@ using System.Runtime.InteropServices;
     }
 %}
 
+%typemap(cscode) NativeBuffer %{
+    /// <summary>
+    /// 以 Span 直接访问原生数据（句柄 Dispose 前有效）
+    /// </summary>
+    public unsafe ReadOnlySpan<byte> AsSpan()
+    {
+        return new ReadOnlySpan<byte>((void*)GetData(), checked((int)GetSize()));
+    }
+
+    /// <summary>
+    /// 以只读流直接访问原生数据（句柄 Dispose 前有效）
+    /// </summary>
+    public unsafe System.IO.UnmanagedMemoryStream AsStream()
+    {
+        return new System.IO.UnmanagedMemoryStream((byte*)GetData(), GetSize());
+    }
+
+    /// <summary>
+    /// 复制到调用方提供的数组（先通过 GetSize 查询所需大小）
+    /// </summary>
+    /// <returns>数组长度不足返回 false</returns>
+    public bool CopyTo(byte[] destination)
+    {
+        GCHandle pin = GCHandle.Alloc(destination, GCHandleType.Pinned);
+        try
+        {
+            return CopyTo(pin.AddrOfPinnedObject(), destination.LongLength);
+        }
+        finally
+        {
+            pin.Free();
+        }
+    }
+
+    /// <summary>
+    /// 复制为托管数组（一次 Marshal.Copy）
+    /// </summary>
+    public byte[] ToArray()
+    {
+        byte[] result = new byte[GetSize()];
+        if (result.Length > 0)
+        {
+            Marshal.Copy(GetData(), result, 0, result.Length);
+        }
+        return result;
+    }
+%}
+
+%typemap(cscode) TileArchiveReader %{
+    /// <summary>
+    /// 读取归档条目（一次 Marshal.Copy，避免 VectorUInt8 逐元素复制）
+    /// </summary>
+    /// <returns>条目数据，不存在或为压缩条目时返回 null</returns>
+    public byte[] ReadTileBytes(string path)
+    {
+        long size = GetTileSize(path);
+        IntPtr data = GetTileData(path);
+        if (size < 0 || data == IntPtr.Zero)
+        {
+            return null;
+        }
+
+        byte[] result = new byte[size];
+        Marshal.Copy(data, result, 0, (int)size);
+        return result;
+    }
+%}
+
 /* ============================================================================
  * 包含C++头文件
  * ============================================================================ */
@@ -276,9 +859,53 @@ using System.Runtime.InteropServices;
 // 包含 Tileset.h（获取 TileBox 等定义）
 %include "Native/Tileset.h"
 
+// 包含数据集合并工具
+%include "Native/TilesetMerger.h"
+
+// 包含输出目标定义（须在 OSGB23dTiles.h 之前，ToB3DMBatch 参数才能映射为 C# 类）
+%include "Native/AsyncFileWriter.h"
+%include "Native/OutputSink.h"
+
+// 包含增量与断点续传配置定义
+%include "Native/IncrementalManifest.h"
+%include "Native/BatchJournal.h"
+
+// 包含原生缓冲区句柄定义（须在 OSGB23dTiles.h 之前）
+%include "Native/NativeBuffer.h"
+
+// 包含 GLB 缓存定义
+%include "Native/GlbCache.h"
+
+// 包含任务进度与监听器定义
+%include "Native/JobControl.h"
+
+// 包含调度器定义
+%include "Native/JobScheduler.h"
+
+// 包含转换子集定义
+%include "Native/SubsetFilter.h"
+
+// 包含转换统计定义
+%include "Native/ConversionMetrics.h"
+
+// 包含时间线跟踪定义
+%include "Native/TraceRecorder.h"
+
+// 包含异步日志定义
+%include "Native/AsyncLog.h"
+
 // 包含 OSGB23dTiles.h（获取所有结构体和类定义）
 %include "Native/OSGB23dTiles.h"
 
+// 包含 LazyTileConverter.h（按需转换）
+%include "Native/LazyTileConverter.h"
+
+// 包含 ConversionJob.h（异步转换任务）
+%include "Native/ConversionJob.h"
+
+// 包含 TileArchiveReader.h（3TZ归档读取）
+%include "Native/TileArchiveReader.h"
+
 /* ============================================================================
  * 异常处理
  * ============================================================================ */
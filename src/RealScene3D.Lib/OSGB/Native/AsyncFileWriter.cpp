@@ -0,0 +1,330 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "AsyncFileWriter.h"
+#include "OSGBTools.h"
+
+using namespace OSGBLog;
+
+AsyncFileWriter::AsyncFileWriter(const AsyncWriteSettings& writeSettings)
+	: settings(writeSettings)
+{
+	size_t nThreads = static_cast<size_t>(std::max(1, settings.nThreads));
+	for (size_t i = 0; i < nThreads; ++i)
+	{
+		workers.emplace_back(&AsyncFileWriter::WorkerLoop, this);
+	}
+
+	LOG_I("本地异步写入器已启动: threads={}, max_in_flight={}MB, sync_on_flush={}, sync_on_barrier={}",
+		nThreads, settings.nMaxInFlightBytes / (1024 * 1024), settings.bSyncOnFlush, settings.bSyncOnBarrier);
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+	Flush();
+
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		stopping = true;
+	}
+	task_cv.notify_all();
+
+	for (auto& worker : workers)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+}
+
+bool AsyncFileWriter::Submit(const std::string& strFileName, std::string&& data)
+{
+	WriteTask task;
+	task.file_name = strFileName;
+	task.data = std::move(data);
+
+	const size_t nSize = task.data.size();
+	{
+		std::unique_lock<std::mutex> lock(queue_mutex);
+
+		// 在途字节超限时阻塞；队列为空时总是放行，保证超大文件也能提交
+		space_cv.wait(lock, [&]()
+		{
+			return stopping || in_flight_bytes == 0 ||
+				in_flight_bytes + nSize <= settings.nMaxInFlightBytes;
+		});
+
+		if (stopping)
+		{
+			return false;
+		}
+
+		in_flight_bytes += nSize;
+		in_flight_tasks++;
+		task.seq = next_seq++;
+		in_flight_seqs.insert(task.seq);
+		queue.emplace_back(std::move(task));
+	}
+	task_cv.notify_one();
+
+	return true;
+}
+
+bool AsyncFileWriter::Submit(const std::string& strFileName, const char* pData, size_t nSize)
+{
+	return Submit(strFileName, std::string(pData, nSize));
+}
+
+void AsyncFileWriter::RequestDirectory(const std::string& strPath)
+{
+	std::lock_guard<std::mutex> lock(dir_mutex);
+	if (created_dirs.count(strPath) == 0)
+	{
+		pending_dirs.insert(strPath);
+	}
+}
+
+bool AsyncFileWriter::Flush()
+{
+	{
+		std::unique_lock<std::mutex> lock(queue_mutex);
+		space_cv.wait(lock, [&]() { return in_flight_tasks == 0; });
+
+		// 失败已计入 failed_since_flush，由本次 Flush 报告
+		failed_seqs.clear();
+	}
+
+	// 没有文件写入的目录（如空瓦片）仍按调用方要求创建
+	std::vector<std::string> dirs;
+	{
+		std::lock_guard<std::mutex> lock(dir_mutex);
+		dirs.assign(pending_dirs.begin(), pending_dirs.end());
+	}
+	for (const auto& dir : dirs)
+	{
+		if (!EnsureDirectory(dir))
+		{
+			failed_since_flush++;
+		}
+	}
+
+	std::vector<std::pair<uint64_t, std::string>> files;
+	{
+		std::lock_guard<std::mutex> lock(written_mutex);
+		files.swap(written_files);
+	}
+
+	if (settings.bSyncOnFlush)
+	{
+		for (const auto& file : files)
+		{
+			if (!SyncFile(file.second))
+			{
+				LOG_W("fsync失败: {}", file.second);
+				failed_since_flush++;
+			}
+		}
+	}
+
+	size_t nFailed = failed_since_flush.exchange(0);
+	if (nFailed > 0)
+	{
+		LOG_E("本地写入完成，但有 {} 个文件或目录写入失败", nFailed);
+		return false;
+	}
+
+	return true;
+}
+
+bool AsyncFileWriter::Barrier()
+{
+	// 只等待序号在屏障之前的任务，其他线程之后提交的任务不影响本次等待
+	size_t nFailed = 0;
+	uint64_t nTicket = 0;
+	{
+		std::unique_lock<std::mutex> lock(queue_mutex);
+		nTicket = next_seq;
+		space_cv.wait(lock, [&]() { return in_flight_seqs.empty() || *in_flight_seqs.begin() >= nTicket; });
+
+		auto it = std::remove_if(failed_seqs.begin(), failed_seqs.end(),
+			[&](uint64_t nSeq) { return nSeq < nTicket; });
+		nFailed = static_cast<size_t>(failed_seqs.end() - it);
+		failed_seqs.erase(it, failed_seqs.end());
+	}
+
+	if (settings.bSyncOnBarrier)
+	{
+		std::vector<std::pair<uint64_t, std::string>> files;
+		{
+			std::lock_guard<std::mutex> lock(written_mutex);
+			auto it = std::partition(written_files.begin(), written_files.end(),
+				[&](const std::pair<uint64_t, std::string>& file) { return file.first >= nTicket; });
+			files.assign(std::make_move_iterator(it), std::make_move_iterator(written_files.end()));
+			written_files.erase(it, written_files.end());
+		}
+
+		for (const auto& file : files)
+		{
+			if (!SyncFile(file.second))
+			{
+				LOG_W("fsync失败: {}", file.second);
+				failed_since_flush++;
+				nFailed++;
+			}
+		}
+	}
+
+	if (nFailed > 0)
+	{
+		LOG_W("检查点之前提交的写入中有 {} 个文件失败", nFailed);
+		return false;
+	}
+
+	return true;
+}
+
+void AsyncFileWriter::WorkerLoop()
+{
+	while (true)
+	{
+		WriteTask task;
+		{
+			std::unique_lock<std::mutex> lock(queue_mutex);
+			task_cv.wait(lock, [&]() { return stopping || !queue.empty(); });
+
+			if (queue.empty())
+			{
+				// stopping 且队列已清空
+				return;
+			}
+
+			task = std::move(queue.front());
+			queue.pop_front();
+		}
+
+		const size_t nSize = task.data.size();
+		const bool bWritten = WriteTaskToDisk(task);
+		if (bWritten)
+		{
+			written_count++;
+			written_bytes += nSize;
+
+			if (settings.bSyncOnFlush || settings.bSyncOnBarrier)
+			{
+				std::lock_guard<std::mutex> lock(written_mutex);
+				written_files.emplace_back(task.seq, std::move(task.file_name));
+			}
+		}
+		else
+		{
+			LOG_E("写入文件失败: {}", task.file_name);
+			failed_count++;
+			failed_since_flush++;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(queue_mutex);
+			in_flight_bytes -= nSize;
+			in_flight_tasks--;
+			in_flight_seqs.erase(task.seq);
+			if (!bWritten)
+			{
+				failed_seqs.push_back(task.seq);
+			}
+		}
+		space_cv.notify_all();
+	}
+}
+
+bool AsyncFileWriter::EnsureDirectory(const std::string& strPath)
+{
+	if (strPath.empty())
+	{
+		return true;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(dir_mutex);
+		if (created_dirs.count(strPath) > 0)
+		{
+			return true;
+		}
+	}
+
+	// create_directories 对已存在目录是幂等的，多个线程同时创建同一目录也安全
+	std::error_code ec;
+	std::filesystem::create_directories(strPath, ec);
+	if (ec && !std::filesystem::is_directory(strPath))
+	{
+		LOG_E("创建目录失败: {} ({})", strPath, ec.message());
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(dir_mutex);
+	created_dirs.insert(strPath);
+	pending_dirs.erase(strPath);
+
+	return true;
+}
+
+bool AsyncFileWriter::WriteTaskToDisk(const WriteTask& task)
+{
+	try
+	{
+		std::string strParent = std::filesystem::path(task.file_name).parent_path().string();
+		if (!EnsureDirectory(strParent))
+		{
+			return false;
+		}
+
+		std::ofstream ofs(task.file_name, std::ios::binary);
+		if (!ofs.is_open())
+		{
+			return false;
+		}
+
+		ofs.write(task.data.data(), static_cast<std::streamsize>(task.data.size()));
+		ofs.close();
+
+		return !ofs.fail();
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+bool AsyncFileWriter::SyncFile(const std::string& strFileName)
+{
+#ifdef _WIN32
+	int fd = _open(strFileName.c_str(), _O_RDWR | _O_BINARY);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	bool bOk = _commit(fd) == 0;
+	_close(fd);
+#else
+	int fd = ::open(strFileName.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	bool bOk = ::fsync(fd) == 0;
+	::close(fd);
+#endif
+
+	return bOk;
+}
@@ -0,0 +1,167 @@
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief 本地异步写入配置
+ */
+struct AsyncWriteSettings
+{
+	// I/O线程数（NFS等高延迟存储上可适当调大）
+	int nThreads = 4;
+
+	// 在途字节上限（排队 + 正在写入），超过后 Submit 阻塞
+	size_t nMaxInFlightBytes = 256ull * 1024 * 1024;
+
+	// Flush 时是否对本次写入的全部文件执行一次 fsync 屏障
+	bool bSyncOnFlush = false;
+
+	// Barrier 时是否对屏障前写入的文件执行 fsync（断点续传的进度日志依赖此项保证已记录的瓦片落盘）
+	bool bSyncOnBarrier = false;
+};
+
+/**
+ * @brief 本地文件异步写入器（write-behind）
+ *
+ * 转换线程通过 Submit 移交缓冲区后立即返回，由I/O线程池负责创建目录和写文件。
+ * 目录只在首次写入时创建一次（已创建目录缓存），MkDirs 请求也只登记不落盘，
+ * 在第一个文件写入或 Flush 时统一创建。
+ *
+ * @example
+ * AsyncFileWriter writer;
+ * writer.Submit("out/Data/Tile_0/Tile_0.b3dm", std::move(b3dm_buf));
+ * bool ok = writer.Flush();  // 等待全部写入完成
+ */
+class AsyncFileWriter
+{
+public:
+	explicit AsyncFileWriter(const AsyncWriteSettings& settings = AsyncWriteSettings());
+
+	// 析构时等待队列清空并停止I/O线程
+	~AsyncFileWriter();
+
+	AsyncFileWriter(const AsyncFileWriter&) = delete;
+	AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+	/**
+	 * @brief 提交写入任务，缓冲区所有权移交给写入器
+	 * @param strFileName 文件路径，父目录不存在时自动创建
+	 * @param data 文件内容
+	 * @return 任务是否入队（写入结果通过 Flush 汇总）
+	 * @note 在途字节超过上限时阻塞，直到有任务完成
+	 */
+	bool Submit(const std::string& strFileName, std::string&& data);
+
+	/**
+	 * @brief 提交写入任务（复制缓冲区）
+	 */
+	bool Submit(const std::string& strFileName, const char* pData, size_t nSize);
+
+	/**
+	 * @brief 登记需要创建的目录（延迟到首次写入或 Flush 时创建）
+	 */
+	void RequestDirectory(const std::string& strPath);
+
+	/**
+	 * @brief 等待所有已提交任务完成，创建剩余的目录，按需执行 fsync 屏障
+	 * @return 自上次 Flush 以来没有失败返回 true
+	 */
+	bool Flush();
+
+	/**
+	 * @brief 检查点屏障：只等待调用前已提交的任务完成（不等待其他线程之后提交的任务），按需 fsync 这些文件
+	 * @return 屏障前提交的任务（自上次 Barrier 以来）没有失败返回 true
+	 */
+	bool Barrier();
+
+	// 已写入的文件数
+	size_t GetWrittenCount() const { return written_count.load(); }
+
+	// 已写入的字节数
+	size_t GetWrittenBytes() const { return written_bytes.load(); }
+
+	// 写入失败的文件数
+	size_t GetFailedCount() const { return failed_count.load(); }
+
+	/**
+	 * @brief 对文件执行 fsync（Windows 为 _commit）
+	 */
+	static bool SyncFile(const std::string& strFileName);
+
+private:
+	/**
+	 * @brief 写入任务
+	 */
+	struct WriteTask
+	{
+		// 文件路径
+		std::string file_name;
+
+		// 文件内容
+		std::string data;
+
+		// 提交序号（Barrier 据此判断任务是否在屏障之前）
+		uint64_t seq = 0;
+	};
+
+	// I/O线程主循环
+	void WorkerLoop();
+
+	// 确保目录存在（已创建目录只创建一次）
+	bool EnsureDirectory(const std::string& strPath);
+
+	// 写入单个文件
+	bool WriteTaskToDisk(const WriteTask& task);
+
+	AsyncWriteSettings settings;
+
+	std::vector<std::thread> workers;
+
+	std::deque<WriteTask> queue;
+	std::mutex queue_mutex;
+
+	// 有新任务或停止信号
+	std::condition_variable task_cv;
+
+	// 在途字节下降或任务全部完成
+	std::condition_variable space_cv;
+
+	// 排队与写入中的字节数、任务数
+	size_t in_flight_bytes = 0;
+	size_t in_flight_tasks = 0;
+	bool stopping = false;
+
+	// 下一个提交序号、排队与写入中任务的序号、尚未被 Barrier 报告的失败任务序号
+	uint64_t next_seq = 1;
+	std::set<uint64_t> in_flight_seqs;
+	std::vector<uint64_t> failed_seqs;
+
+	// 已创建的目录与登记待创建的目录
+	std::unordered_set<std::string> created_dirs;
+	std::unordered_set<std::string> pending_dirs;
+	std::mutex dir_mutex;
+
+	// 尚未 fsync 的已写入文件及其提交序号（仅 bSyncOnFlush 或 bSyncOnBarrier 时记录）
+	std::vector<std::pair<uint64_t, std::string>> written_files;
+	std::mutex written_mutex;
+
+	// 统计
+	std::atomic<size_t> written_count{ 0 };
+	std::atomic<size_t> written_bytes{ 0 };
+	std::atomic<size_t> failed_count{ 0 };
+
+	// 自上次 Flush 以来的失败数
+	std::atomic<size_t> failed_since_flush{ 0 };
+};
+
+#endif // ASYNC_FILE_WRITER_H
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+#include <spdlog/async.h>
+#include <spdlog/async_logger.h>
+
+#include "AsyncLog.h"
+#include "OSGBTools.h"
+
+using namespace OSGBLog;
+
+// ============================================================================
+// 内部辅助函数（仅在本文件内使用）
+// ============================================================================
+
+namespace
+{
+	std::mutex config_mutex;
+	AsyncLogSettings current_settings;
+
+	// 启用前的同步日志器与创建的异步日志器，保留到进程结束
+	std::shared_ptr<spdlog::logger> sync_logger;
+	std::shared_ptr<spdlog::logger> async_logger;
+
+	std::atomic<int> progress_interval_ms{ AsyncLogSettings().nProgressIntervalMs };
+
+	/**
+	 * @brief 创建与同步日志器输出目标、级别相同的异步日志器（调用者持有 config_mutex）
+	 */
+	bool CreateAsyncLogger(size_t nQueueSize)
+	{
+		try
+		{
+			sync_logger = spdlog::default_logger();
+			spdlog::init_thread_pool(std::max<size_t>(nQueueSize, 1), 1);
+
+			auto& sinks = sync_logger->sinks();
+			async_logger = std::make_shared<spdlog::async_logger>(sync_logger->name(), sinks.begin(), sinks.end(),
+				spdlog::thread_pool(), spdlog::async_overflow_policy::block);
+			async_logger->set_level(sync_logger->level());
+			async_logger->flush_on(spdlog::level::err);
+
+			return true;
+		}
+		catch (const spdlog::spdlog_ex& e)
+		{
+			LOG_W("创建异步日志器失败，继续使用同步日志：{}", e.what());
+			async_logger.reset();
+
+			return false;
+		}
+	}
+
+} // anonymous namespace
+
+bool AsyncLog::Configure(const AsyncLogSettings& settings)
+{
+	std::lock_guard<std::mutex> lock(config_mutex);
+
+	current_settings = settings;
+	progress_interval_ms = std::max(settings.nProgressIntervalMs, 0);
+
+	if (!settings.bEnable)
+	{
+		if (async_logger && spdlog::default_logger() == async_logger)
+		{
+			async_logger->flush();
+			spdlog::set_default_logger(sync_logger);
+		}
+
+		return true;
+	}
+
+	if (!async_logger && !CreateAsyncLogger(settings.nQueueSize))
+	{
+		current_settings.bEnable = false;
+
+		return false;
+	}
+
+	if (spdlog::default_logger() != async_logger)
+	{
+		async_logger->set_level(spdlog::default_logger()->level());
+		spdlog::set_default_logger(async_logger);
+	}
+
+	return true;
+}
+
+AsyncLogSettings AsyncLog::GetSettings()
+{
+	std::lock_guard<std::mutex> lock(config_mutex);
+	return current_settings;
+}
+
+void AsyncLog::Flush()
+{
+	spdlog::default_logger()->flush();
+}
+
+int AsyncLog::ProgressIntervalMs()
+{
+	return progress_interval_ms.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,114 @@
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 异步日志配置
+ */
+struct AsyncLogSettings
+{
+	// 是否启用（启用后日志在后台线程格式化并写出，调用线程只把消息放入队列）
+	bool bEnable = false;
+
+	// 队列容量（条），写满时写日志的线程等待队列腾出空间（不丢弃消息）；只在首次启用时生效
+	size_t nQueueSize = 8192;
+
+	// 批量转换进度日志的最小间隔（毫秒），0 表示每个瓦片都输出
+	int nProgressIntervalMs = 1000;
+};
+
+/**
+ * @brief 进程共享的异步日志
+ *
+ * 默认不启用：进程的默认日志器属于宿主程序，只有显式调用 Configure 启用后，
+ * 默认日志器才替换为 spdlog 异步日志器（沿用原日志器的输出目标与级别），
+ * 转换线程写日志时不再等待控制台或文件输出，多个线程之间也不再因输出而串行。
+ * 错误级别的日志立即刷新。
+ *
+ * @note 切换前后的日志器都会保留到进程结束，切换时仍在使用旧日志器的线程不受影响
+ */
+class AsyncLog
+{
+public:
+	/**
+	 * @brief 启用或关闭异步日志，关闭时先写出队列中的消息再恢复同步日志器
+	 * @return 创建异步日志器失败返回 false（仍使用同步日志器）
+	 */
+	static bool Configure(const AsyncLogSettings& settings);
+
+	/**
+	 * @brief 获取当前配置
+	 */
+	static AsyncLogSettings GetSettings();
+
+	/**
+	 * @brief 写出队列中的消息
+	 */
+	static void Flush();
+
+	/**
+	 * @brief 批量转换进度日志的最小间隔（毫秒）
+	 */
+	static int ProgressIntervalMs();
+};
+
+/**
+ * @brief 日志限流：间隔内只放行一条，多线程同时到达时只有一个线程放行
+ *
+ * @example
+ * LogThrottle progress_log(AsyncLog::ProgressIntervalMs());
+ * if (progress_log.Allow())
+ * {
+ *     LOG_I("处理瓦片 {}/{}", i + 1, count);
+ * }
+ */
+class LogThrottle
+{
+public:
+	explicit LogThrottle(int nIntervalMs)
+		: interval_ns(static_cast<int64_t>(nIntervalMs > 0 ? nIntervalMs : 0) * 1000000)
+	{
+	}
+
+	LogThrottle(const LogThrottle&) = delete;
+	LogThrottle& operator=(const LogThrottle&) = delete;
+
+	/**
+	 * @brief 距上次放行超过间隔时返回 true（首次调用总是放行）
+	 */
+	bool Allow()
+	{
+		int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+		int64_t last = last_ns.load(std::memory_order_relaxed);
+		if (last != 0 && now - last < interval_ns)
+		{
+			suppressed.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		if (!last_ns.compare_exchange_strong(last, now, std::memory_order_relaxed))
+		{
+			suppressed.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief 被限流丢弃的消息数
+	 */
+	uint64_t GetSuppressed() const { return suppressed.load(std::memory_order_relaxed); }
+
+private:
+	int64_t interval_ns;
+	std::atomic<int64_t> last_ns{ 0 };
+	std::atomic<uint64_t> suppressed{ 0 };
+};
+
+#endif // ASYNC_LOG_H
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+
+#include <json.hpp>
+
+#include "BatchJournal.h"
+#include "AsyncFileWriter.h"
+#include "OSGBTools.h"
+#include "OutputSink.h"
+
+using namespace OSGBLog;
+
+// ============================================================================
+// 内部辅助函数（仅在本文件内使用）
+// ============================================================================
+
+namespace
+{
+	const int kJournalVersion = 2;
+
+	// 记录序列化为一行 JSON（名称与路径以 UTF-8 保存）
+	std::string ToLine(const JournalRecord& record)
+	{
+		nlohmann::json line = {
+			{"tile", OSGBTools::Utf8String(record.tile_name)},
+			{"bbox", record.bbox},
+			{"geometric_error", record.geometric_error},
+			{"tileset", OSGBTools::Utf8String(record.tileset_path)},
+			{"fingerprint", record.fingerprint}
+		};
+
+		return line.dump() + "\n";
+	}
+
+} // anonymous namespace
+
+BatchJournal::~BatchJournal()
+{
+	if (journal_file.is_open())
+	{
+		journal_file.close();
+	}
+}
+
+bool BatchJournal::Open(const std::string& strPath, const std::string& strSettingsKey, int nCheckpointSeconds)
+{
+	using nlohmann::json;
+
+	journal_path = strPath;
+	checkpoint_interval = std::chrono::seconds(std::max(0, nCheckpointSeconds));
+	last_checkpoint = std::chrono::steady_clock::now();
+	completed.clear();
+
+	// 1. 载入上次的日志：首行参数一致才使用，解析失败的行（被截断的末行）丢弃
+	std::string strContent;
+	if (OSGBTools::ReadFile(strPath, strContent))
+	{
+		std::istringstream lines(strContent);
+		std::string line;
+		bool bHeaderOk = false;
+		while (std::getline(lines, line))
+		{
+			try
+			{
+				json item = json::parse(line);
+				if (!bHeaderOk)
+				{
+					bHeaderOk = item.value("journal", 0) == kJournalVersion &&
+						item.value("settings", "") == strSettingsKey;
+					if (!bHeaderOk)
+					{
+						LOG_I("转换参数已变化，忽略进度日志: {}", strPath);
+						break;
+					}
+					continue;
+				}
+
+				JournalRecord record;
+				record.tile_name = OSGBTools::OSGString(item.at("tile").get<std::string>());
+				record.geometric_error = item.value("geometric_error", 0.0);
+				record.tileset_path = OSGBTools::OSGString(item.value("tileset", ""));
+				record.fingerprint = item.value("fingerprint", "");
+				const auto& bbox = item.at("bbox");
+				for (size_t i = 0; i < record.bbox.size() && i < bbox.size(); ++i)
+				{
+					record.bbox[i] = bbox[i].get<double>();
+				}
+				completed[record.tile_name] = std::move(record);
+			}
+			catch (const std::exception&)
+			{
+				if (!bHeaderOk)
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	// 2. 重写日志（去掉截断行），之后只追加；首次运行时输出目录可能尚未创建（异步输出延迟创建目录）
+	OSGBTools::MkDirs(OSGBTools::GetParent(strPath));
+
+	std::string strHeader = json({ {"journal", kJournalVersion}, {"settings", strSettingsKey} }).dump() + "\n";
+	for (const auto& item : completed)
+	{
+		strHeader += ToLine(item.second);
+	}
+
+	// 先写入临时文件并落盘再替换，重写过程中中断不会丢失已有的进度
+	const std::string strTempPath = strPath + ".tmp";
+	if (!OSGBTools::WriteFile(strTempPath, strHeader.data(), static_cast<unsigned long>(strHeader.size())) ||
+		!AsyncFileWriter::SyncFile(strTempPath))
+	{
+		LOG_W("进度日志无法写入: {}", strTempPath);
+		std::error_code ec;
+		std::filesystem::remove(strTempPath, ec);
+		return false;
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(strTempPath, strPath, ec);
+	if (ec)
+	{
+		LOG_W("进度日志无法替换: {} ({})", strPath, ec.message());
+		std::filesystem::remove(strTempPath, ec);
+		return false;
+	}
+
+	journal_file.open(strPath, std::ios::binary | std::ios::app);
+	if (!journal_file.is_open())
+	{
+		LOG_W("进度日志无法打开: {}", strPath);
+		return false;
+	}
+
+	if (!completed.empty())
+	{
+		LOG_I("从进度日志续传: {} ({} 个瓦片已完成)", strPath, completed.size());
+	}
+
+	return true;
+}
+
+bool BatchJournal::Find(const std::string& strTileName, const std::string& strFingerprint, JournalRecord& record) const
+{
+	// 同名瓦片的输入已变化（如 Tile_+000_+000 被替换）时不能复用上次的结果
+	auto it = completed.find(strTileName);
+	if (it == completed.end() || it->second.fingerprint != strFingerprint)
+	{
+		return false;
+	}
+
+	record = it->second;
+
+	return true;
+}
+
+void BatchJournal::Complete(const JournalRecord& record)
+{
+	std::lock_guard<std::mutex> lock(pending_mutex);
+	pending.emplace_back(record);
+}
+
+bool BatchJournal::Checkpoint(IOutputSink& sink, bool bForce)
+{
+	std::unique_lock<std::mutex> checkpoint_lock(checkpoint_mutex, std::defer_lock);
+	if (bForce)
+	{
+		checkpoint_lock.lock();
+	}
+	else if (!checkpoint_lock.try_lock() ||
+		std::chrono::steady_clock::now() - last_checkpoint < checkpoint_interval)
+	{
+		return true;
+	}
+
+	// 先取出待确认瓦片再设屏障：这些瓦片的文件都在屏障之前提交，屏障返回时已全部写完并落盘；
+	// 屏障不等待其他线程之后提交的写入，检查点线程不会被持续提交的写入拖住
+	std::vector<JournalRecord> batch;
+	{
+		std::lock_guard<std::mutex> lock(pending_mutex);
+		batch.swap(pending);
+	}
+
+	bool bFlushed = sink.Barrier();
+	last_checkpoint = std::chrono::steady_clock::now();
+
+	if (!bFlushed)
+	{
+		LOG_W("检查点输出写入失败，{} 个瓦片未记入进度日志", batch.size());
+		return false;
+	}
+
+	if (!batch.empty())
+	{
+		Append(batch);
+	}
+
+	return true;
+}
+
+bool BatchJournal::Append(const std::vector<JournalRecord>& records)
+{
+	if (!journal_file.is_open())
+	{
+		return false;
+	}
+
+	std::string strLines;
+	for (const auto& record : records)
+	{
+		strLines += ToLine(record);
+	}
+
+	journal_file.write(strLines.data(), static_cast<std::streamsize>(strLines.size()));
+	journal_file.flush();
+	if (!journal_file)
+	{
+		LOG_W("进度日志追加失败: {}", journal_path);
+		return false;
+	}
+
+	return AsyncFileWriter::SyncFile(journal_path);
+}
+
+void BatchJournal::Remove()
+{
+	if (journal_file.is_open())
+	{
+		journal_file.close();
+	}
+
+	// 同时清理重写中断后遗留的临时文件
+	std::error_code ec;
+	std::filesystem::remove(journal_path, ec);
+	std::filesystem::remove(journal_path + ".tmp", ec);
+}
@@ -0,0 +1,139 @@
+#ifndef BATCH_JOURNAL_H
+#define BATCH_JOURNAL_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class IOutputSink;
+
+/**
+ * @brief 批量转换断点续传配置
+ */
+struct ResumeSettings
+{
+	// 是否记录进度日志并在重启后续传（本地输出默认启用）
+	bool bEnable = true;
+
+	// 日志路径，为空时保存在本地输出目录下；输出到MinIO等非本地目标时必须指定才会启用
+	// （自定义的本地异步输出需启用 AsyncWriteSettings::bSyncOnBarrier，已记录的瓦片才保证落盘）
+	std::string strJournalPath;
+
+	// 检查点间隔（秒）：每隔该时间等待此前提交的输出写入完成后，把期间完成的瓦片追加到日志
+	int nCheckpointSeconds = 30;
+};
+
+/**
+ * @brief 进度日志中的一个已完成瓦片
+ */
+struct JournalRecord
+{
+	// 瓦片名称
+	std::string tile_name;
+
+	// 包围盒 [maxX, maxY, maxZ, minX, minY, minZ]
+	std::array<double, 6> bbox = {};
+
+	// 瓦片根节点几何误差
+	double geometric_error = 0.0;
+
+	// 瓦片 tileset.json 输出路径
+	std::string tileset_path;
+
+	// 瓦片输入目录指纹（IncrementalManifest::ComputeFingerprint），输入变化后记录作废
+	std::string fingerprint;
+};
+
+/**
+ * @brief 批量转换进度日志（只追加）
+ *
+ * 文件为 JSON Lines：首行记录日志版本与转换参数（含输入目录），其后每行一个已完成瓦片。
+ * 瓦片完成后先进入待确认列表，检查点时等待输出目标的屏障（Barrier）成功——只等待此前提交的
+ * 写入完成并落盘/上传，不等待其他线程之后提交的写入——再追加到日志并 fsync，
+ * 因此日志中的瓦片在进程被杀后仍然完整可用。末尾被截断的行在重新打开时丢弃（经临时文件原子替换重写）。
+ *
+ * 重启后参数一致的日志被继续使用：输入目录指纹未变化的瓦片直接使用其包围盒，
+ * 根 tileset.json 与不中断运行的结果一致。整个任务成功后删除日志。
+ *
+ * @example
+ * BatchJournal journal;
+ * journal.Open(strJournalPath, strSettingsKey, 30);
+ * JournalRecord record;
+ * if (!journal.Find("Tile_+000_+000", strFingerprint, record)) { ... 转换 ...; journal.Complete(record); journal.Checkpoint(sink, false); }
+ * journal.Remove();
+ */
+class BatchJournal
+{
+public:
+	BatchJournal() = default;
+	~BatchJournal();
+
+	BatchJournal(const BatchJournal&) = delete;
+	BatchJournal& operator=(const BatchJournal&) = delete;
+
+	/**
+	 * @brief 打开日志；参数一致时载入已完成的瓦片，否则重新开始（日志所在目录不存在时创建）
+	 * @param strPath 日志路径
+	 * @param strSettingsKey 转换参数
+	 * @param nCheckpointSeconds 检查点间隔（秒）
+	 * @return 日志可写返回 true
+	 */
+	bool Open(const std::string& strPath, const std::string& strSettingsKey, int nCheckpointSeconds);
+
+	/**
+	 * @brief 查找已完成的瓦片
+	 * @param strTileName 瓦片名称
+	 * @param strFingerprint 瓦片输入目录的当前指纹，与记录不一致时视为未完成
+	 * @param record 输出的记录
+	 */
+	bool Find(const std::string& strTileName, const std::string& strFingerprint, JournalRecord& record) const;
+
+	/**
+	 * @brief 已载入（上次运行完成）的瓦片数
+	 */
+	size_t GetResumedCount() const { return completed.size(); }
+
+	/**
+	 * @brief 登记本次完成的瓦片（线程安全），在下一个检查点写入日志
+	 */
+	void Complete(const JournalRecord& record);
+
+	/**
+	 * @brief 检查点：等待输出目标的屏障（此前提交的写入完成）后把待确认瓦片追加到日志
+	 * @param sink 输出目标
+	 * @param bForce 为 false 时未到检查点间隔或其他线程正在执行检查点则直接返回
+	 * @return 屏障前的写入失败返回 false（本批瓦片不写入日志，续传时重新转换）
+	 */
+	bool Checkpoint(IOutputSink& sink, bool bForce);
+
+	/**
+	 * @brief 关闭并删除日志（任务成功完成后调用）
+	 */
+	void Remove();
+
+private:
+	// 追加记录并 fsync
+	bool Append(const std::vector<JournalRecord>& records);
+
+	std::string journal_path;
+	std::ofstream journal_file;
+
+	// 上次运行完成的瓦片（Open 后只读）
+	std::unordered_map<std::string, JournalRecord> completed;
+
+	// 本次完成、尚未确认写入的瓦片
+	std::vector<JournalRecord> pending;
+	std::mutex pending_mutex;
+
+	// 同一时间只有一个线程执行检查点
+	std::mutex checkpoint_mutex;
+	std::chrono::steady_clock::time_point last_checkpoint;
+	std::chrono::seconds checkpoint_interval{ 30 };
+};
+
+#endif // BATCH_JOURNAL_H
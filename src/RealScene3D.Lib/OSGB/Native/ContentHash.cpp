@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include "ContentHash.h"
+
+// ============================================================================
+// 内部辅助函数（仅在本文件内使用）
+// ============================================================================
+
+namespace
+{
+	// MD5 每轮循环左移位数（RFC 1321）
+	const uint32_t kMd5Shift[64] =
+	{
+		7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+		5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+		4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+		6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+	};
+
+	// MD5 常量表 floor(abs(sin(i + 1)) * 2^32)
+	const uint32_t kMd5Table[64] =
+	{
+		0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+		0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+		0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+		0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+		0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+		0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+		0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+		0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+	};
+
+	inline uint32_t RotateLeft(uint32_t x, uint32_t c)
+	{
+		return (x << c) | (x >> (32 - c));
+	}
+
+	/**
+	 * @brief 处理一个64字节数据块
+	 */
+	void Md5Block(uint32_t state[4], const uint8_t* pBlock)
+	{
+		uint32_t m[16];
+		for (int i = 0; i < 16; ++i)
+		{
+			m[i] = static_cast<uint32_t>(pBlock[i * 4]) |
+				(static_cast<uint32_t>(pBlock[i * 4 + 1]) << 8) |
+				(static_cast<uint32_t>(pBlock[i * 4 + 2]) << 16) |
+				(static_cast<uint32_t>(pBlock[i * 4 + 3]) << 24);
+		}
+
+		uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+		for (uint32_t i = 0; i < 64; ++i)
+		{
+			uint32_t f = 0, g = 0;
+			if (i < 16)
+			{
+				f = (b & c) | (~b & d);
+				g = i;
+			}
+			else if (i < 32)
+			{
+				f = (d & b) | (~d & c);
+				g = (5 * i + 1) % 16;
+			}
+			else if (i < 48)
+			{
+				f = b ^ c ^ d;
+				g = (3 * i + 5) % 16;
+			}
+			else
+			{
+				f = c ^ (b | ~d);
+				g = (7 * i) % 16;
+			}
+
+			uint32_t tmp = d;
+			d = c;
+			c = b;
+			b = b + RotateLeft(a + f + kMd5Table[i] + m[g], kMd5Shift[i]);
+			a = tmp;
+		}
+
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+	}
+
+	/**
+	 * @brief 生成CRC32查找表（反射多项式 0xEDB88320）
+	 */
+	std::array<uint32_t, 256> MakeCrc32Table()
+	{
+		std::array<uint32_t, 256> table{};
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			uint32_t c = i;
+			for (int k = 0; k < 8; ++k)
+			{
+				c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+			}
+			table[i] = c;
+		}
+
+		return table;
+	}
+
+} // anonymous namespace
+
+ContentHash::Md5Digest ContentHash::Md5(const void* pData, size_t nSize)
+{
+	uint32_t state[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+
+	const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+	size_t nFullBlocks = nSize / 64;
+	for (size_t i = 0; i < nFullBlocks; ++i)
+	{
+		Md5Block(state, pBytes + i * 64);
+	}
+
+	// 尾部填充：0x80 + 0... + 64位小端长度
+	uint8_t tail[128] = { 0 };
+	size_t nRemain = nSize - nFullBlocks * 64;
+	if (nRemain > 0)
+	{
+		std::memcpy(tail, pBytes + nFullBlocks * 64, nRemain);
+	}
+	tail[nRemain] = 0x80;
+
+	size_t nTailSize = (nRemain < 56) ? 64 : 128;
+	uint64_t nBitLen = static_cast<uint64_t>(nSize) * 8;
+	for (int i = 0; i < 8; ++i)
+	{
+		tail[nTailSize - 8 + i] = static_cast<uint8_t>(nBitLen >> (8 * i));
+	}
+
+	for (size_t offset = 0; offset < nTailSize; offset += 64)
+	{
+		Md5Block(state, tail + offset);
+	}
+
+	Md5Digest digest;
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			digest[i * 4 + j] = static_cast<uint8_t>(state[i] >> (8 * j));
+		}
+	}
+
+	return digest;
+}
+
+std::string ContentHash::Md5Hex(const void* pData, size_t nSize)
+{
+	Md5Digest digest = Md5(pData, nSize);
+	return ToHex(digest.data(), digest.size());
+}
+
+std::string ContentHash::ToHex(const uint8_t* pDigest, size_t nSize)
+{
+	static const char kHexChars[] = "0123456789abcdef";
+
+	std::string hex;
+	hex.reserve(nSize * 2);
+	for (size_t i = 0; i < nSize; ++i)
+	{
+		hex.push_back(kHexChars[pDigest[i] >> 4]);
+		hex.push_back(kHexChars[pDigest[i] & 0x0f]);
+	}
+
+	return hex;
+}
+
+std::string ContentHash::NormalizeETag(const std::string& strETag)
+{
+	std::string etag = strETag;
+	if (etag.rfind("W/", 0) == 0)
+	{
+		etag = etag.substr(2);
+	}
+
+	etag.erase(std::remove(etag.begin(), etag.end(), '"'), etag.end());
+	std::transform(etag.begin(), etag.end(), etag.begin(),
+		[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+	return etag;
+}
+
+uint32_t ContentHash::Crc32(const void* pData, size_t nSize, uint32_t nCrc)
+{
+	static const std::array<uint32_t, 256> kCrc32Table = MakeCrc32Table();
+
+	const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+	uint32_t c = nCrc ^ 0xFFFFFFFFu;
+	for (size_t i = 0; i < nSize; ++i)
+	{
+		c = kCrc32Table[(c ^ pBytes[i]) & 0xFF] ^ (c >> 8);
+	}
+
+	return c ^ 0xFFFFFFFFu;
+}
@@ -0,0 +1,55 @@
+#ifndef CONTENT_HASH_H
+#define CONTENT_HASH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief 内容哈希工具类
+ *
+ * 提供 MD5 摘要计算，用于与对象存储的 ETag（单段上传时即内容MD5）比对，
+ * 以及在清单中记录对象内容指纹；CRC32 用于 ZIP 归档条目校验。
+ */
+class ContentHash
+{
+public:
+	// MD5摘要（16字节）
+	using Md5Digest = std::array<uint8_t, 16>;
+
+	/**
+	 * @brief 计算MD5摘要
+	 * @param pData 数据指针
+	 * @param nSize 数据大小
+	 * @return 16字节摘要
+	 */
+	static Md5Digest Md5(const void* pData, size_t nSize);
+
+	/**
+	 * @brief 计算MD5并返回小写十六进制字符串（32个字符）
+	 */
+	static std::string Md5Hex(const void* pData, size_t nSize);
+
+	/**
+	 * @brief 摘要转换为小写十六进制字符串
+	 */
+	static std::string ToHex(const uint8_t* pDigest, size_t nSize);
+
+	/**
+	 * @brief 规范化ETag：去除引号和W/前缀并转为小写
+	 * @param strETag 服务器返回的ETag
+	 * @return 规范化后的ETag，单段上传对象即为内容MD5十六进制
+	 */
+	static std::string NormalizeETag(const std::string& strETag);
+
+	/**
+	 * @brief 计算CRC32（ZIP/PNG使用的IEEE 802.3多项式）
+	 * @param pData 数据指针
+	 * @param nSize 数据大小
+	 * @param nCrc 前一段数据的CRC，用于分段累计计算
+	 */
+	static uint32_t Crc32(const void* pData, size_t nSize, uint32_t nCrc = 0);
+};
+
+#endif // CONTENT_HASH_H
@@ -0,0 +1,150 @@
+#include "ConversionJob.h"
+#include "OSGBTools.h"
+
+using namespace OSGBLog;
+
+ConversionJob::ConversionJob(ProgressListener* pListener, int nProgressIntervalMs)
+	: control(pListener, nProgressIntervalMs)
+{
+	converter.SetJobControl(&control);
+}
+
+ConversionJob::~ConversionJob()
+{
+	Cancel();
+
+	if (worker.joinable())
+	{
+		worker.join();
+	}
+}
+
+bool ConversionJob::StartB3DMBatch(
+	const std::string& strDataDir,
+	const std::string& strOutputDir,
+	double dCenterX,
+	double dCenterY,
+	int nMaxLevel,
+	bool bEnableTextureCompress,
+	bool bEnableMeshOpt,
+	bool bEnableDraco)
+{
+	return Start([=]()
+		{
+			return converter.ToB3DMBatch(strDataDir, strOutputDir, dCenterX, dCenterY, nMaxLevel,
+				bEnableTextureCompress, bEnableMeshOpt, bEnableDraco);
+		});
+}
+
+#ifdef ENABLE_MINIO
+bool ConversionJob::StartB3DMBatchToMinIO(
+	const std::string& strDataDir,
+	const std::string& strMinioPath,
+	const std::string& strMinioEndpoint,
+	const std::string& strAccessKey,
+	const std::string& strSecretKey,
+	bool bUseSSL,
+	double dCenterX,
+	double dCenterY,
+	int nMaxLevel,
+	bool bEnableTextureCompress,
+	bool bEnableMeshOpt,
+	bool bEnableDraco,
+	bool bSkipUnchanged,
+	bool bPrecompress)
+{
+	return Start([=]()
+		{
+			return converter.ToB3DMBatchToMinIO(strDataDir, strMinioPath, strMinioEndpoint, strAccessKey, strSecretKey,
+				bUseSSL, dCenterX, dCenterY, nMaxLevel, bEnableTextureCompress, bEnableMeshOpt, bEnableDraco,
+				bSkipUnchanged, bPrecompress);
+		});
+}
+#endif
+
+bool ConversionJob::StartGLB(
+	const std::string& strInPath,
+	const std::string& strOutPath,
+	bool bBinary,
+	bool bEnableTextureCompress,
+	bool bEnableMeshOpt,
+	bool bEnableDraco)
+{
+	return Start([=]()
+		{
+			control.Begin(1);
+			if (control.IsCancelled())
+			{
+				return false;
+			}
+
+			bool bOk = converter.ToGLB(strInPath, strOutPath, bBinary, bEnableTextureCompress, bEnableMeshOpt, bEnableDraco);
+			control.TileFinished(bOk);
+
+			return bOk;
+		});
+}
+
+bool ConversionJob::Wait(int nTimeoutMs)
+{
+	std::unique_lock<std::mutex> lock(state_mutex);
+
+	auto finished = [this]()
+	{
+		JobState current = state.load();
+		return current != JobState::Pending && current != JobState::Running;
+	};
+
+	if (nTimeoutMs < 0)
+	{
+		state_cv.wait(lock, finished);
+		return true;
+	}
+
+	return state_cv.wait_for(lock, std::chrono::milliseconds(nTimeoutMs), finished);
+}
+
+bool ConversionJob::Start(std::function<bool()> task)
+{
+	std::lock_guard<std::mutex> lock(state_mutex);
+	if (state.load() != JobState::Pending)
+	{
+		LOG_W("转换任务已启动，不能重复启动");
+		return false;
+	}
+
+	state = JobState::Running;
+	worker = std::thread([this, task]()
+		{
+			bool bOk = false;
+			try
+			{
+				bOk = task();
+			}
+			catch (const std::exception& e)
+			{
+				LOG_E("转换任务异常: {}", e.what());
+			}
+			catch (...)
+			{
+				// 非 std::exception 的异常也不能逃出线程（否则 std::terminate），按失败结束任务
+				LOG_E("转换任务发生未知异常");
+			}
+
+			bool bCancelled = control.IsCancelled();
+			if (bCancelled)
+			{
+				LOG_I("转换任务已取消");
+			}
+
+			// 先通知监听器再更新状态：Wait 返回时已不会再有回调
+			control.Finish(bOk && !bCancelled);
+			{
+				std::lock_guard<std::mutex> state_lock(state_mutex);
+				state = bCancelled ? JobState::Cancelled : (bOk ? JobState::Succeeded : JobState::Failed);
+			}
+			state_cv.notify_all();
+		});
+
+	return true;
+}
@@ -0,0 +1,145 @@
+#ifndef CONVERSION_JOB_H
+#define CONVERSION_JOB_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "JobControl.h"
+#include "OSGB23dTiles.h"
+
+/**
+ * @brief 转换任务状态
+ */
+enum class JobState
+{
+	Pending,
+	Running,
+	Succeeded,
+	Failed,
+	Cancelled
+};
+
+/**
+ * @brief 异步转换任务
+ *
+ * Start* 在后台线程执行转换后立即返回，调用方通过监听器接收节流后的进度（瓦片数、写入字节数、预计剩余时间），
+ * 或轮询 GetProgress / GetState。Cancel 为协作式取消：各转换线程完成当前节点后停止，
+ * 已提交的文件写完后任务以 Cancelled 结束；批量转换的进度日志保留，重新运行可续传。
+ * 析构时取消并等待任务结束。
+ *
+ * @example
+ * ConversionJob job(&listener);
+ * job.GetConverter().SetResumeSettings(resume);
+ * job.StartB3DMBatch("E:/Data/3D", "E:/Tiles/3D", 0.0, 0.0, -1);
+ * ...
+ * job.Cancel();
+ * job.Wait();
+ */
+class ConversionJob
+{
+public:
+	/**
+	 * @param pListener 进度监听器（调用方持有，生命周期须覆盖任务），可为空
+	 * @param nProgressIntervalMs 进度回调最小间隔（毫秒）
+	 */
+	explicit ConversionJob(ProgressListener* pListener = nullptr, int nProgressIntervalMs = 500);
+
+	// 取消并等待任务结束（不能在监听器回调中释放任务）
+	~ConversionJob();
+
+	ConversionJob(const ConversionJob&) = delete;
+	ConversionJob& operator=(const ConversionJob&) = delete;
+
+	/**
+	 * @brief 任务使用的转换器，启动前可设置增量、续传等配置
+	 */
+	OSGB23dTiles& GetConverter() { return converter; }
+
+	/**
+	 * @brief 启动批量转换（参数同 OSGB23dTiles::ToB3DMBatch，写入本地输出目录）
+	 * @return 任务已启动返回 true，每个任务只能启动一次
+	 */
+	bool StartB3DMBatch(
+		const std::string& strDataDir,
+		const std::string& strOutputDir,
+		double dCenterX,
+		double dCenterY,
+		int nMaxLevel,
+		bool bEnableTextureCompress = false,
+		bool bEnableMeshOpt = false,
+		bool bEnableDraco = false);
+
+#ifdef ENABLE_MINIO
+	/**
+	 * @brief 启动批量转换并写入MinIO（参数同 OSGB23dTiles::ToB3DMBatchToMinIO）
+	 * @return 任务已启动返回 true
+	 */
+	bool StartB3DMBatchToMinIO(
+		const std::string& strDataDir,
+		const std::string& strMinioPath,
+		const std::string& strMinioEndpoint,
+		const std::string& strAccessKey,
+		const std::string& strSecretKey,
+		bool bUseSSL,
+		double dCenterX,
+		double dCenterY,
+		int nMaxLevel,
+		bool bEnableTextureCompress = false,
+		bool bEnableMeshOpt = false,
+		bool bEnableDraco = false,
+		bool bSkipUnchanged = false,
+		bool bPrecompress = false);
+#endif
+
+	/**
+	 * @brief 启动单个OSGB到GLB的转换（参数同 OSGB23dTiles::ToGLB，转换开始后不可中断）
+	 * @return 任务已启动返回 true
+	 */
+	bool StartGLB(
+		const std::string& strInPath,
+		const std::string& strOutPath,
+		bool bBinary = true,
+		bool bEnableTextureCompress = false,
+		bool bEnableMeshOpt = false,
+		bool bEnableDraco = false);
+
+	/**
+	 * @brief 请求取消（线程安全，可重复调用）
+	 */
+	void Cancel() { control.Cancel(); }
+
+	/**
+	 * @brief 等待任务结束（含 OnFinished 回调）
+	 * @param nTimeoutMs 超时（毫秒），小于 0 表示一直等待
+	 * @return 任务已结束返回 true
+	 */
+	bool Wait(int nTimeoutMs = -1);
+
+	/**
+	 * @brief 任务状态
+	 */
+	JobState GetState() const { return state.load(); }
+
+	/**
+	 * @brief 当前进度
+	 */
+	ConversionProgress GetProgress() const { return control.GetProgress(); }
+
+private:
+	// 在后台线程执行 task
+	bool Start(std::function<bool()> task);
+
+	OSGB23dTiles converter;
+	JobControl control;
+
+	std::thread worker;
+	std::atomic<JobState> state{ JobState::Pending };
+	std::mutex state_mutex;
+	std::condition_variable state_cv;
+};
+
+#endif // CONVERSION_JOB_H
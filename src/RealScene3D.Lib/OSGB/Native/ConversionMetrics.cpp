@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cmath>
+
+#include <json.hpp>
+
+#include "ConversionMetrics.h"
+
+// ============================================================================
+// 内部辅助函数（仅在本文件内使用）
+// ============================================================================
+
+namespace
+{
+	const char* STAGE_NAMES[] = {
+		"read", "visit", "reproject", "normals", "simplify",
+		"encode_geometry", "encode_textures", "serialize", "write"
+	};
+
+	const char* BYTES_NAMES[] = {
+		"input_osgb", "geometry", "texture", "output_b3dm", "output_tileset", "output_other"
+	};
+
+	static_assert(static_cast<int>(MetricStage::Write) + 1 == METRIC_STAGE_COUNT &&
+		sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == METRIC_STAGE_COUNT, "STAGE_NAMES 与 MetricStage 不一致");
+	static_assert(static_cast<int>(MetricBytes::OutputOther) + 1 == METRIC_BYTES_COUNT &&
+		sizeof(BYTES_NAMES) / sizeof(BYTES_NAMES[0]) == METRIC_BYTES_COUNT, "BYTES_NAMES 与 MetricBytes 不一致");
+
+	int64_t NowNanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/**
+	 * @brief 保留3位小数（报告中的秒数）
+	 */
+	double RoundSeconds(double dSeconds)
+	{
+		return std::round(dSeconds * 1000.0) / 1000.0;
+	}
+
+} // anonymous namespace
+
+bool ConversionMetrics::Begin(int nSlowestTiles)
+{
+	if (depth++ > 0)
+	{
+		return false;
+	}
+
+	for (auto& value : stage_ns)
+	{
+		value = 0;
+	}
+	for (auto& value : stage_calls)
+	{
+		value = 0;
+	}
+	for (auto& value : bytes)
+	{
+		value = 0;
+	}
+	nodes = 0;
+	vertices = 0;
+	triangles = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(tiles_mutex);
+		tile_count = 0;
+		failed_tile_count = 0;
+		max_slowest = static_cast<size_t>(std::max(nSlowestTiles, 0));
+		slowest.clear();
+	}
+
+	end_time = 0;
+	start_time = NowNanoseconds();
+
+	return true;
+}
+
+bool ConversionMetrics::End()
+{
+	if (--depth > 0)
+	{
+		return false;
+	}
+
+	end_time = NowNanoseconds();
+
+	return true;
+}
+
+void ConversionMetrics::AddStage(MetricStage eStage, int64_t nNanoseconds)
+{
+	int index = static_cast<int>(eStage);
+	stage_ns[index] += nNanoseconds;
+	stage_calls[index]++;
+}
+
+void ConversionMetrics::AddBytes(MetricBytes eCategory, size_t nBytes)
+{
+	bytes[static_cast<int>(eCategory)] += nBytes;
+}
+
+void ConversionMetrics::AddNode(size_t nVertices, size_t nTriangles)
+{
+	nodes++;
+	vertices += nVertices;
+	triangles += nTriangles;
+}
+
+void ConversionMetrics::AddTile(const std::string& strName, double dSeconds, bool bSuccess)
+{
+	std::lock_guard<std::mutex> lock(tiles_mutex);
+
+	tile_count++;
+	if (!bSuccess)
+	{
+		failed_tile_count++;
+	}
+
+	if (max_slowest == 0)
+	{
+		return;
+	}
+
+	// 按用时降序插入，超出数量时丢弃最快的
+	auto it = std::find_if(slowest.begin(), slowest.end(),
+		[dSeconds](const TileTiming& tile) { return tile.seconds < dSeconds; });
+	if (it == slowest.end() && slowest.size() >= max_slowest)
+	{
+		return;
+	}
+
+	slowest.insert(it, { strName, dSeconds, bSuccess });
+	if (slowest.size() > max_slowest)
+	{
+		slowest.pop_back();
+	}
+}
+
+double ConversionMetrics::GetStageSeconds(MetricStage eStage) const
+{
+	return stage_ns[static_cast<int>(eStage)].load() / 1e9;
+}
+
+uint64_t ConversionMetrics::GetBytes(MetricBytes eCategory) const
+{
+	return bytes[static_cast<int>(eCategory)].load();
+}
+
+double ConversionMetrics::GetElapsedSeconds() const
+{
+	int64_t start = start_time.load();
+	if (start == 0)
+	{
+		return 0.0;
+	}
+
+	int64_t end = end_time.load();
+	return ((end != 0 ? end : NowNanoseconds()) - start) / 1e9;
+}
+
+std::string ConversionMetrics::ToJson() const
+{
+	using nlohmann::ordered_json;
+
+	ordered_json report;
+	report["elapsed_seconds"] = RoundSeconds(GetElapsedSeconds());
+
+	ordered_json stages = ordered_json::object();
+	for (int i = 0; i < METRIC_STAGE_COUNT; i++)
+	{
+		stages[STAGE_NAMES[i]] = {
+			{"seconds", RoundSeconds(stage_ns[i].load() / 1e9)},
+			{"calls", stage_calls[i].load()}
+		};
+	}
+	report["stages"] = stages;
+
+	ordered_json byte_counts = ordered_json::object();
+	for (int i = 0; i < METRIC_BYTES_COUNT; i++)
+	{
+		byte_counts[BYTES_NAMES[i]] = bytes[i].load();
+	}
+	report["bytes"] = byte_counts;
+
+	report["nodes"] = nodes.load();
+	report["vertices"] = vertices.load();
+	report["triangles"] = triangles.load();
+
+	std::lock_guard<std::mutex> lock(tiles_mutex);
+	report["tiles"] = tile_count;
+	report["failed_tiles"] = failed_tile_count;
+
+	ordered_json slowest_tiles = ordered_json::array();
+	for (const auto& tile : slowest)
+	{
+		slowest_tiles.push_back({
+			{"name", tile.name},
+			{"seconds", RoundSeconds(tile.seconds)},
+			{"success", tile.success}
+		});
+	}
+	report["slowest_tiles"] = slowest_tiles;
+
+	return report.dump(2);
+}
@@ -0,0 +1,216 @@
+#ifndef CONVERSION_METRICS_H
+#define CONVERSION_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 转换阶段
+ */
+enum class MetricStage
+{
+	Read = 0,          // 读取并解析OSGB文件
+	Visit,             // 遍历节点收集几何体与纹理（不含重投影）
+	Reproject,         // 顶点坐标重投影
+	Normals,           // 生成法线
+	Simplify,          // 网格简化
+	EncodeGeometry,    // 写入几何数据（含Draco压缩）
+	EncodeTextures,    // 纹理编码（JPEG / KTX2）
+	Serialize,         // glTF / B3DM 序列化
+	Write              // 提交给输出目标及等待写入完成
+};
+
+// 阶段数（与 MetricStage 一致）
+constexpr int METRIC_STAGE_COUNT = 9;
+
+/**
+ * @brief 字节统计类别
+ */
+enum class MetricBytes
+{
+	InputOsgb = 0,     // 读取的OSGB文件（读取节点树与转换节点时分别计入）
+	Geometry,          // GLB 中的几何数据
+	Texture,           // GLB 中的纹理数据
+	OutputB3dm,        // 写出的 B3DM 文件
+	OutputTileset,     // 写出的 tileset.json
+	OutputOther        // 写出的其他文件
+};
+
+// 字节统计类别数（与 MetricBytes 一致）
+constexpr int METRIC_BYTES_COUNT = 6;
+
+/**
+ * @brief 转换统计配置
+ */
+struct MetricsSettings
+{
+	// 是否统计（关闭后各阶段不再计时）
+	bool bEnable = true;
+
+	// 批量转换结束时是否把报告写到输出目录
+	bool bWriteReport = false;
+
+	// 报告文件名（相对输出目录）
+	std::string strReportName = "conversion-report.json";
+
+	// 报告中保留的最慢瓦片数
+	int nSlowestTiles = 10;
+};
+
+/**
+ * @brief 转换统计：分阶段耗时、字节数、三角形与顶点数、最慢的瓦片
+ *
+ * 各阶段耗时为所有线程累加，并行转换时总和可能大于实际用时（elapsed_seconds）。
+ * 所有累加接口线程安全。一次转换由 Begin / End 界定，嵌套调用（如批量转换中的单瓦片转换）
+ * 只有最外层会清空统计。
+ *
+ * @example
+ * ConversionMetrics metrics;
+ * metrics.Begin(10);
+ * {
+ *     MetricsTimer timer(&metrics, MetricStage::Read);
+ *     ...
+ * }
+ * metrics.End();
+ * std::string json = metrics.ToJson();
+ */
+class ConversionMetrics
+{
+public:
+	ConversionMetrics() = default;
+
+	ConversionMetrics(const ConversionMetrics&) = delete;
+	ConversionMetrics& operator=(const ConversionMetrics&) = delete;
+
+	/**
+	 * @brief 开始一次转换，最外层调用时清空统计并开始计时
+	 * @param nSlowestTiles 保留的最慢瓦片数
+	 * @return 是否为最外层调用
+	 */
+	bool Begin(int nSlowestTiles);
+
+	/**
+	 * @brief 结束一次转换，最外层调用时停止计时
+	 * @return 是否为最外层调用
+	 */
+	bool End();
+
+	/**
+	 * @brief 累加阶段耗时（线程安全）
+	 */
+	void AddStage(MetricStage eStage, int64_t nNanoseconds);
+
+	/**
+	 * @brief 累加字节数（线程安全）
+	 */
+	void AddBytes(MetricBytes eCategory, size_t nBytes);
+
+	/**
+	 * @brief 累加一个节点的几何统计（线程安全）
+	 */
+	void AddNode(size_t nVertices, size_t nTriangles);
+
+	/**
+	 * @brief 记录一个瓦片的转换用时（线程安全）
+	 * @param strName 瓦片名
+	 * @param dSeconds 用时（秒）
+	 * @param bSuccess 是否成功
+	 */
+	void AddTile(const std::string& strName, double dSeconds, bool bSuccess);
+
+	/**
+	 * @brief 阶段累计耗时（秒）
+	 */
+	double GetStageSeconds(MetricStage eStage) const;
+
+	/**
+	 * @brief 类别累计字节数
+	 */
+	uint64_t GetBytes(MetricBytes eCategory) const;
+
+	/**
+	 * @brief 转换用时（秒），转换进行中时为当前已用时间
+	 */
+	double GetElapsedSeconds() const;
+
+	/**
+	 * @brief 生成 JSON 报告
+	 */
+	std::string ToJson() const;
+
+private:
+	/**
+	 * @brief 一个瓦片的用时
+	 */
+	struct TileTiming
+	{
+		std::string name;
+		double seconds = 0.0;
+		bool success = false;
+	};
+
+	std::atomic<int64_t> stage_ns[METRIC_STAGE_COUNT] = {};
+	std::atomic<uint64_t> stage_calls[METRIC_STAGE_COUNT] = {};
+	std::atomic<uint64_t> bytes[METRIC_BYTES_COUNT] = {};
+	std::atomic<uint64_t> nodes{ 0 };
+	std::atomic<uint64_t> vertices{ 0 };
+	std::atomic<uint64_t> triangles{ 0 };
+
+	// 嵌套深度与计时区间（steady_clock 纳秒，end_time 为 0 表示进行中）
+	std::atomic<int> depth{ 0 };
+	std::atomic<int64_t> start_time{ 0 };
+	std::atomic<int64_t> end_time{ 0 };
+
+	// 瓦片统计与按用时降序保留的最慢瓦片
+	mutable std::mutex tiles_mutex;
+	uint64_t tile_count = 0;
+	uint64_t failed_tile_count = 0;
+	size_t max_slowest = 10;
+	std::vector<TileTiming> slowest;
+};
+
+/**
+ * @brief 阶段计时器：析构（或 Stop）时把用时累加到统计，统计为空时不计时
+ */
+class MetricsTimer
+{
+public:
+	MetricsTimer(ConversionMetrics* pMetrics, MetricStage eStage)
+		: metrics(pMetrics)
+		, stage(eStage)
+	{
+		if (metrics)
+		{
+			start = std::chrono::steady_clock::now();
+		}
+	}
+
+	~MetricsTimer() { Stop(); }
+
+	MetricsTimer(const MetricsTimer&) = delete;
+	MetricsTimer& operator=(const MetricsTimer&) = delete;
+
+	/**
+	 * @brief 结束计时（只累加一次）
+	 */
+	void Stop()
+	{
+		if (metrics)
+		{
+			metrics->AddStage(stage, std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - start).count());
+			metrics = nullptr;
+		}
+	}
+
+private:
+	ConversionMetrics* metrics = nullptr;
+	MetricStage stage;
+	std::chrono::steady_clock::time_point start;
+};
+
+#endif // CONVERSION_METRICS_H
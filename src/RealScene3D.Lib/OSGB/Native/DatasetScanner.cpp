@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <thread>
+
+#include <json.hpp>
+
+#include "DatasetScanner.h"
+#include "ContentHash.h"
+#include "OSGBTools.h"
+#include "ZipFileSystem.h"
+
+using namespace OSGBLog;
+
+// ============================================================================
+// 内部辅助函数（仅在本文件内使用）
+// ============================================================================
+
+namespace
+{
+	const int kManifestVersion = 1;
+
+	// 目录修改时间：增删子目录时变化
+	bool GetDirectoryMTime(const std::string& strDirPath, int64_t& nMTime)
+	{
+		std::error_code ec;
+		auto time = std::filesystem::last_write_time(strDirPath, ec);
+		if (ec)
+		{
+			return false;
+		}
+
+		nMTime = static_cast<int64_t>(time.time_since_epoch().count());
+
+		return true;
+	}
+
+} // anonymous namespace
+
+DatasetScanner::DatasetScanner(const DatasetScanSettings& scanSettings)
+	: settings(scanSettings)
+{
+}
+
+std::vector<DatasetEntry> DatasetScanner::ScanTiles(const std::string& strDataDir)
+{
+	return Scan(strDataDir, "tiles",
+		[](const std::string& name) { return name.find("Tile_") == 0; },
+		[](const std::string& folder, DatasetEntry& entry)
+		{
+			entry.root_path = folder + "/" + entry.name + ".osgb";
+			return StatFile(entry.root_path, entry.size, entry.mtime);
+		});
+}
+
+std::vector<DatasetEntry> DatasetScanner::ScanFolders(const std::string& strDirPath)
+{
+	return Scan(strDirPath, "folders",
+		[](const std::string&) { return true; },
+		[](const std::string& folder, DatasetEntry& entry)
+		{
+			entry.root_path = OSGBTools::FindRootOSGB(folder);
+			if (entry.root_path.empty())
+			{
+				// 没有根OSGB时使用目录中的第一个OSGB文件
+				std::vector<std::string> osgb_files = OSGBTools::ScanOSGBFiles(folder, false);
+				if (osgb_files.empty())
+				{
+					return false;
+				}
+
+				std::sort(osgb_files.begin(), osgb_files.end());
+				entry.root_path = osgb_files.front();
+				LOG_I("子目录 {} 未找到根OSGB，使用第一个文件: {}", entry.name, entry.root_path);
+			}
+
+			return StatFile(entry.root_path, entry.size, entry.mtime);
+		});
+}
+
+std::vector<DatasetEntry> DatasetScanner::Scan(
+	const std::string& strDirPath,
+	const std::string& strMode,
+	const std::function<bool(const std::string&)>& filter,
+	const std::function<bool(const std::string&, DatasetEntry&)>& probe)
+{
+	from_manifest = false;
+
+	std::string strDir = OSGBTools::NormalizePath(strDirPath);
+	while (!strDir.empty() && strDir.back() == '/')
+	{
+		strDir.pop_back();
+	}
+
+	// 1. 数据目录未变化时直接使用清单
+	int64_t nDirMTime = 0;
+	const bool bUseManifest = settings.bUseManifest && !ZipFileSystem::IsArchivePath(strDir) &&
+		GetDirectoryMTime(strDir, nDirMTime);
+
+	std::vector<DatasetEntry> entries;
+	if (bUseManifest && LoadManifest(strDir, strMode, nDirMTime, entries))
+	{
+		from_manifest = true;
+		LOG_I("使用扫描清单: {} ({} 个条目)", GetManifestPath(strDir), entries.size());
+		return entries;
+	}
+
+	// 2. 读取一次目录，收集候选子目录
+	std::vector<std::string> names;
+	OSGBTools::ForEachEntry(strDir, [&](const OSGBTools::DirectoryEntry& entry) -> bool
+	{
+		if (entry.is_directory && filter(entry.name))
+		{
+			names.emplace_back(entry.name);
+		}
+		return true;
+	});
+
+	// 3. 并行检查每个子目录的根文件
+	std::vector<DatasetEntry> candidates(names.size());
+	std::vector<char> found(names.size(), 0);
+	ParallelFor(names.size(), [&](size_t i)
+	{
+		candidates[i].name = names[i];
+		found[i] = probe(strDir + "/" + names[i], candidates[i]) ? 1 : 0;
+	});
+
+	for (size_t i = 0; i < candidates.size(); ++i)
+	{
+		if (found[i])
+		{
+			entries.emplace_back(std::move(candidates[i]));
+		}
+	}
+
+	std::sort(entries.begin(), entries.end(),
+		[](const DatasetEntry& a, const DatasetEntry& b) { return a.name < b.name; });
+
+	LOG_I("扫描 {}: {} 个子目录, {} 个有效", strDir, names.size(), entries.size());
+
+	if (bUseManifest && !entries.empty())
+	{
+		SaveManifest(strDir, strMode, nDirMTime, entries);
+	}
+
+	return entries;
+}
+
+void DatasetScanner::ParallelFor(size_t nCount, const std::function<void(size_t)>& func) const
+{
+	const size_t nThreads = std::min(nCount, static_cast<size_t>(std::max(1, settings.nThreads)));
+	if (nThreads <= 1)
+	{
+		for (size_t i = 0; i < nCount; ++i)
+		{
+			func(i);
+		}
+		return;
+	}
+
+	std::atomic<size_t> next{ 0 };
+	std::vector<std::thread> workers;
+	workers.reserve(nThreads);
+	for (size_t t = 0; t < nThreads; ++t)
+	{
+		workers.emplace_back([&]()
+		{
+			for (size_t i = next++; i < nCount; i = next++)
+			{
+				func(i);
+			}
+		});
+	}
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+bool DatasetScanner::StatFile(const std::string& strPath, uint64_t& nSize, int64_t& nMTime)
+{
+	// 压缩包内条目没有可靠的修改时间，只判断是否存在
+	if (ZipFileSystem::IsArchivePath(strPath))
+	{
+		nSize = 0;
+		nMTime = 0;
+		return OSGBTools::IsRegularFile(strPath);
+	}
+
+	std::error_code ec;
+	nSize = static_cast<uint64_t>(std::filesystem::file_size(strPath, ec));
+	if (ec)
+	{
+		return false;
+	}
+
+	auto time = std::filesystem::last_write_time(strPath, ec);
+	nMTime = ec ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+
+	return true;
+}
+
+std::string DatasetScanner::GetManifestPath(const std::string& strDirPath) const
+{
+	if (!settings.strManifestPath.empty())
+	{
+		return settings.strManifestPath;
+	}
+
+	// 输入目录可能只读（共享存储），清单默认放在本机临时目录
+	return OSGBTools::GetTempDirectory() + "/osgb-scan-" +
+		ContentHash::Md5Hex(strDirPath.data(), strDirPath.size()) + ".json";
+}
+
+bool DatasetScanner::LoadManifest(const std::string& strDirPath, const std::string& strMode, int64_t nDirMTime,
+	std::vector<DatasetEntry>& entries) const
+{
+	using nlohmann::json;
+
+	std::string strContent;
+	if (!OSGBTools::ReadFile(GetManifestPath(strDirPath), strContent))
+	{
+		return false;
+	}
+
+	try
+	{
+		json manifest = json::parse(strContent);
+		if (manifest.value("version", 0) != kManifestVersion ||
+			manifest.value("dir", "") != OSGBTools::Utf8String(strDirPath) ||
+			manifest.value("mode", "") != strMode ||
+			manifest.value("dir_mtime", int64_t(0)) != nDirMTime)
+		{
+			return false;
+		}
+
+		entries.clear();
+		for (const auto& item : manifest.at("entries"))
+		{
+			DatasetEntry entry;
+			entry.name = OSGBTools::OSGString(item.value("name", ""));
+			entry.root_path = OSGBTools::OSGString(item.value("path", ""));
+			entry.size = item.value("size", uint64_t(0));
+			entry.mtime = item.value("mtime", int64_t(0));
+			entries.emplace_back(std::move(entry));
+		}
+
+		return !entries.empty();
+	}
+	catch (const std::exception& e)
+	{
+		LOG_W("扫描清单解析失败，重新扫描: {}", e.what());
+		entries.clear();
+		return false;
+	}
+}
+
+bool DatasetScanner::SaveManifest(const std::string& strDirPath, const std::string& strMode, int64_t nDirMTime,
+	const std::vector<DatasetEntry>& entries) const
+{
+	using nlohmann::json;
+
+	// 路径以 UTF-8 保存（JSON 要求），读取时转换回本地编码
+	json items = json::array();
+	for (const auto& entry : entries)
+	{
+		items.push_back({
+			{"name", OSGBTools::Utf8String(entry.name)},
+			{"path", OSGBTools::Utf8String(entry.root_path)},
+			{"size", entry.size},
+			{"mtime", entry.mtime}
+		});
+	}
+
+	json manifest = {
+		{"version", kManifestVersion},
+		{"dir", OSGBTools::Utf8String(strDirPath)},
+		{"mode", strMode},
+		{"dir_mtime", nDirMTime},
+		{"entries", std::move(items)}
+	};
+
+	std::string strContent;
+	try
+	{
+		strContent = manifest.dump();
+	}
+	catch (const std::exception& e)
+	{
+		LOG_W("扫描清单序列化失败: {}", e.what());
+		return false;
+	}
+	std::string strManifestPath = GetManifestPath(strDirPath);
+	if (!OSGBTools::WriteFile(strManifestPath, strContent.data(), static_cast<unsigned long>(strContent.size())))
+	{
+		LOG_W("扫描清单写入失败: {}", strManifestPath);
+		return false;
+	}
+
+	return true;
+}
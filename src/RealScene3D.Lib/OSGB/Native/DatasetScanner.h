@@ -0,0 +1,108 @@
+#ifndef DATASET_SCANNER_H
+#define DATASET_SCANNER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 数据集中的一个瓦片（或OSGB子目录）
+ */
+struct DatasetEntry
+{
+	// 瓦片目录名（如 "Tile_+004_+012"）
+	std::string name;
+
+	// 根 OSGB 文件完整路径
+	std::string root_path;
+
+	// 根文件大小（字节）
+	uint64_t size = 0;
+
+	// 根文件修改时间（文件系统时钟计数，只用于比较）
+	int64_t mtime = 0;
+};
+
+/**
+ * @brief 数据集扫描配置
+ */
+struct DatasetScanSettings
+{
+	// 并行检查子目录的线程数（NFS等高延迟存储上可适当调大）
+	int nThreads = 8;
+
+	// 是否读写扫描清单
+	bool bUseManifest = true;
+
+	// 清单路径，为空时保存在临时目录（按数据目录路径区分）
+	std::string strManifestPath;
+};
+
+/**
+ * @brief 数据集并行扫描器
+ *
+ * 只读取一次数据目录，再由多个线程并行检查各子目录的根文件（Tile_X/Tile_X.osgb），
+ * 不做全量递归。扫描结果（路径、大小、修改时间）保存为清单，
+ * 下次扫描时若数据目录的修改时间未变（未增删子目录），直接使用清单跳过逐个检查。
+ * ZIP 压缩包内的路径目录树已在内存中，不使用清单。
+ *
+ * @example
+ * DatasetScanner scanner;
+ * std::vector<DatasetEntry> tiles = scanner.ScanTiles("E:/Data/3D/Data");
+ */
+class DatasetScanner
+{
+public:
+	explicit DatasetScanner(const DatasetScanSettings& settings = DatasetScanSettings());
+
+	/**
+	 * @brief 扫描倾斜摄影 Data 目录下的 Tile_* 目录
+	 * @param strDataDir Data 目录
+	 * @return 存在 Tile_X/Tile_X.osgb 的瓦片（按名称排序）
+	 */
+	std::vector<DatasetEntry> ScanTiles(const std::string& strDataDir);
+
+	/**
+	 * @brief 扫描包含OSGB文件的子目录并查找各自的根文件
+	 * @param strDirPath 父目录
+	 * @return 找到根文件的子目录（按名称排序），找不到根文件时使用目录中的第一个OSGB
+	 */
+	std::vector<DatasetEntry> ScanFolders(const std::string& strDirPath);
+
+	/**
+	 * @brief 上次扫描结果是否来自清单
+	 */
+	bool IsFromManifest() const { return from_manifest; }
+
+	/**
+	 * @brief 获取文件大小与修改时间
+	 * @return 文件存在返回 true
+	 */
+	static bool StatFile(const std::string& strPath, uint64_t& nSize, int64_t& nMTime);
+
+private:
+	// 扫描公共流程：读取清单或列目录后并行检查每个子目录
+	std::vector<DatasetEntry> Scan(
+		const std::string& strDirPath,
+		const std::string& strMode,
+		const std::function<bool(const std::string&)>& filter,
+		const std::function<bool(const std::string&, DatasetEntry&)>& probe);
+
+	// 并行执行 func(0..nCount-1)
+	void ParallelFor(size_t nCount, const std::function<void(size_t)>& func) const;
+
+	// 清单路径
+	std::string GetManifestPath(const std::string& strDirPath) const;
+
+	bool LoadManifest(const std::string& strDirPath, const std::string& strMode, int64_t nDirMTime,
+		std::vector<DatasetEntry>& entries) const;
+
+	bool SaveManifest(const std::string& strDirPath, const std::string& strMode, int64_t nDirMTime,
+		const std::vector<DatasetEntry>& entries) const;
+
+	DatasetScanSettings settings;
+	bool from_manifest = false;
+};
+
+#endif // DATASET_SCANNER_H
@@ -0,0 +1,193 @@
+#include <algorithm>
+
+#include "FilePrefetcher.h"
+#include "OSGBTools.h"
+
+using namespace OSGBLog;
+
+FilePrefetcher::FilePrefetcher(const PrefetchSettings& prefetchSettings)
+	: settings(prefetchSettings)
+{
+	size_t nThreads = static_cast<size_t>(std::max(1, settings.nThreads));
+	for (size_t i = 0; i < nThreads; ++i)
+	{
+		workers.emplace_back(&FilePrefetcher::WorkerLoop, this);
+	}
+}
+
+FilePrefetcher::~FilePrefetcher()
+{
+	{
+		std::lock_guard<std::mutex> lock(entries_mutex);
+		stopping = true;
+	}
+	work_cv.notify_all();
+	ready_cv.notify_all();
+
+	for (auto& worker : workers)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+
+	if (hit_count.load() + miss_count.load() > 0)
+	{
+		OSGB_LOG_D("输入预读统计: 命中 {} 次, 未命中 {} 次", hit_count.load(), miss_count.load());
+	}
+}
+
+void FilePrefetcher::Prefetch(const std::string& strPath)
+{
+	{
+		std::lock_guard<std::mutex> lock(entries_mutex);
+
+		auto result = entries.try_emplace(strPath);
+		result.first->second.uses++;
+		if (result.second)
+		{
+			queue.emplace_back(strPath);
+		}
+	}
+	work_cv.notify_one();
+}
+
+void FilePrefetcher::Prefetch(const std::vector<std::string>& paths)
+{
+	if (paths.empty())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(entries_mutex);
+
+		for (const auto& path : paths)
+		{
+			auto result = entries.try_emplace(path);
+			result.first->second.uses++;
+			if (result.second)
+			{
+				queue.emplace_back(path);
+			}
+		}
+	}
+	work_cv.notify_all();
+}
+
+bool FilePrefetcher::Take(const std::string& strPath, std::string& data)
+{
+	std::unique_lock<std::mutex> lock(entries_mutex);
+
+	auto it = entries.find(strPath);
+	if (it == entries.end())
+	{
+		miss_count++;
+		return false;
+	}
+
+	// 正在读取：等待完成（读取线程不会因内存上限阻塞在已开始的文件上）
+	ready_cv.wait(lock, [&]()
+	{
+		it = entries.find(strPath);
+		return stopping || it == entries.end() || it->second.state != EntryState::Loading;
+	});
+
+	if (it == entries.end() || it->second.state != EntryState::Ready)
+	{
+		// 尚未开始读取或读取失败：由调用方同步读取，排队中的任务不再执行
+		if (it != entries.end())
+		{
+			ReleaseEntry(it);
+		}
+		miss_count++;
+		return false;
+	}
+
+	Entry& entry = it->second;
+	if (entry.uses > 1)
+	{
+		data = entry.data;
+	}
+	else
+	{
+		data = std::move(entry.data);
+	}
+	ReleaseEntry(it);
+
+	hit_count++;
+
+	return true;
+}
+
+void FilePrefetcher::ReleaseEntry(std::unordered_map<std::string, Entry>::iterator it)
+{
+	if (--it->second.uses > 0)
+	{
+		return;
+	}
+
+	if (it->second.bytes > 0)
+	{
+		buffered_bytes -= it->second.bytes;
+		work_cv.notify_all();
+	}
+
+	// 仍在队列中的路径由预读线程出队时跳过
+	entries.erase(it);
+}
+
+void FilePrefetcher::WorkerLoop()
+{
+	while (true)
+	{
+		std::string path;
+		{
+			std::unique_lock<std::mutex> lock(entries_mutex);
+			work_cv.wait(lock, [this]()
+			{
+				return stopping || (!queue.empty() && buffered_bytes < settings.nMaxBufferedBytes);
+			});
+
+			if (stopping)
+			{
+				return;
+			}
+
+			path = std::move(queue.front());
+			queue.pop_front();
+
+			auto it = entries.find(path);
+			if (it == entries.end() || it->second.state != EntryState::Queued)
+			{
+				continue;
+			}
+
+			it->second.state = EntryState::Loading;
+		}
+
+		// 压缩包内的条目在预读线程中解压
+		std::string data;
+		bool bOk = OSGBTools::ReadFile(path, data);
+
+		{
+			std::lock_guard<std::mutex> lock(entries_mutex);
+
+			// Loading 状态的条目不会被 Take 移除
+			Entry& entry = entries[path];
+			if (bOk)
+			{
+				entry.state = EntryState::Ready;
+				entry.bytes = data.size();
+				entry.data = std::move(data);
+				buffered_bytes += entry.bytes;
+			}
+			else
+			{
+				entry.state = EntryState::Failed;
+			}
+		}
+		ready_cv.notify_all();
+	}
+}
@@ -0,0 +1,136 @@
+#ifndef FILE_PREFETCHER_H
+#define FILE_PREFETCHER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 输入预读配置
+ */
+struct PrefetchSettings
+{
+	// 预读线程数（网络共享等高延迟存储上可适当调大）
+	int nThreads = 2;
+
+	// 已读入内存但尚未被取走的字节上限，超过后预读线程暂停
+	size_t nMaxBufferedBytes = 64ull * 1024 * 1024;
+};
+
+/**
+ * @brief 输入文件预读器（read-ahead）
+ *
+ * 调用方预先登记即将处理的文件，预读线程按登记顺序把文件内容读入内存，
+ * 转换线程通过 Take 取走缓冲区后直接从内存反序列化，存储延迟与CPU计算重叠。
+ * 同一路径可重复登记，每次登记对应一次 Take。
+ *
+ * Take 不会等待尚未开始读取的文件：此时直接返回 false，由调用方自行同步读取，
+ * 保证预读顺序与使用顺序不一致时也不会互相等待。
+ *
+ * @example
+ * FilePrefetcher prefetcher;
+ * prefetcher.Prefetch(upcoming_files);
+ * std::string data;
+ * if (prefetcher.Take(upcoming_files[0], data)) { ... 从内存解析 ... }
+ */
+class FilePrefetcher
+{
+public:
+	explicit FilePrefetcher(const PrefetchSettings& settings = PrefetchSettings());
+
+	// 析构时停止预读线程并丢弃未取走的数据
+	~FilePrefetcher();
+
+	FilePrefetcher(const FilePrefetcher&) = delete;
+	FilePrefetcher& operator=(const FilePrefetcher&) = delete;
+
+	/**
+	 * @brief 登记即将读取的文件
+	 * @param strPath 文件路径（与 Take 时使用的路径一致）
+	 */
+	void Prefetch(const std::string& strPath);
+
+	/**
+	 * @brief 按顺序登记一批即将读取的文件
+	 */
+	void Prefetch(const std::vector<std::string>& paths);
+
+	/**
+	 * @brief 取走文件内容
+	 * @param strPath 文件路径
+	 * @param data 输出文件内容
+	 * @return 命中预读返回 true；未登记、尚未开始读取或读取失败返回 false
+	 * @note 文件正在读取时等待读取完成
+	 */
+	bool Take(const std::string& strPath, std::string& data);
+
+	// 命中预读的次数
+	size_t GetHitCount() const { return hit_count.load(); }
+
+	// 未命中（需调用方自行读取）的次数
+	size_t GetMissCount() const { return miss_count.load(); }
+
+private:
+	/**
+	 * @brief 预读条目状态
+	 */
+	enum class EntryState
+	{
+		Queued,
+		Loading,
+		Ready,
+		Failed
+	};
+
+	/**
+	 * @brief 预读条目
+	 */
+	struct Entry
+	{
+		EntryState state = EntryState::Queued;
+
+		// 剩余的 Take 次数
+		int uses = 0;
+
+		// 文件内容（Ready 时有效）
+		std::string data;
+
+		// 计入 buffered_bytes 的字节数
+		size_t bytes = 0;
+	};
+
+	// 预读线程主循环
+	void WorkerLoop();
+
+	// 减少一次使用，用完后移除条目（需持有锁）
+	void ReleaseEntry(std::unordered_map<std::string, Entry>::iterator it);
+
+	PrefetchSettings settings;
+
+	std::vector<std::thread> workers;
+
+	std::unordered_map<std::string, Entry> entries;
+	std::deque<std::string> queue;
+	std::mutex entries_mutex;
+
+	// 有新任务、缓冲区有空间或停止信号
+	std::condition_variable work_cv;
+
+	// 有文件读取完成
+	std::condition_variable ready_cv;
+
+	// 已读入内存的字节数
+	size_t buffered_bytes = 0;
+	bool stopping = false;
+
+	// 统计
+	std::atomic<size_t> hit_count{ 0 };
+	std::atomic<size_t> miss_count{ 0 };
+};
+
+#endif // FILE_PREFETCHER_H
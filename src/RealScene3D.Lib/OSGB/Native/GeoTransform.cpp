@@ -216,6 +216,53 @@ void GeoTransform::Cleanup()
 	projContext.reset();
 }
 
+glm::dvec3 GeoTransform::ToLocalEnu(const glm::dvec3& point) const
+{
+	if (IsENU)
+	{
+		glm::dvec3 absoluteENU = point + glm::dvec3(OriginX, OriginY, OriginZ);
+		glm::dvec3 ecef = CartographicToEcef(GeoOriginLon, GeoOriginLat, GeoOriginHeight);
+
+		const double pi = std::acos(-1.0);
+		double lat = GeoOriginLat * pi / 180.0;
+		double lon = GeoOriginLon * pi / 180.0;
+		double sinLat = std::sin(lat), cosLat = std::cos(lat);
+		double sinLon = std::sin(lon), cosLon = std::cos(lon);
+
+		double ecef_x = -sinLon * absoluteENU.x - sinLat * cosLon * absoluteENU.y + cosLat * cosLon * absoluteENU.z;
+		double ecef_y = cosLon * absoluteENU.x - sinLat * sinLon * absoluteENU.y + cosLat * sinLon * absoluteENU.z;
+		double ecef_z = cosLat * absoluteENU.y + sinLat * absoluteENU.z;
+		ecef = glm::dvec3(ecef.x + ecef_x, ecef.y + ecef_y, ecef.z + ecef_z);
+
+		return EcefToEnuMatrix * glm::dvec4(ecef, 1);
+	}
+
+	glm::dvec3 cartographic = point + glm::dvec3(OriginX, OriginY, OriginZ);
+
+	PJ_COORD coord;
+	coord.xyzt.x = cartographic.x;
+	coord.xyzt.y = cartographic.y;
+	coord.xyzt.z = cartographic.z;
+	coord.xyzt.t = HUGE_VAL;
+
+	PJ_COORD result;
+	{
+		std::lock_guard<std::mutex> lock(proj_mutex);
+		result = proj_trans(projTransform.get(), PJ_FWD, coord);
+	}
+
+	if (result.xyzt.x != HUGE_VAL)
+	{
+		cartographic.x = result.xyzt.x;
+		cartographic.y = result.xyzt.y;
+		cartographic.z = result.xyzt.z;
+	}
+
+	glm::dvec3 ecef = CartographicToEcef(cartographic.x, cartographic.y, cartographic.z);
+
+	return EcefToEnuMatrix * glm::dvec4(ecef, 1);
+}
+
 // ============================================================================
 // 外部公开接口实现
 // ============================================================================
@@ -422,13 +469,37 @@ bool GeoTransform::InitFromWKT(const char* wkt, double* origin)
 #endif // ENABLE_PROJ
 }
 
-const char* GeoTransform::GetLastError()
+bool GeoTransform::InitFromMetadata(const OSGBMetadata& metadata)
+{
+	double origin[3] = { metadata.dOffsetX, metadata.dOffsetY, metadata.dOffsetZ };
+
+	if (metadata.bIsENU)
+	{
+		// 注意：经度在前，纬度在后
+		return InitFromENU(metadata.dCenterLon, metadata.dCenterLat, origin);
+	}
+
+	if (metadata.bIsEPSG)
+	{
+		return InitFromEPSG(metadata.nEpsgCode, origin);
+	}
+
+	if (metadata.bIsWKT)
+	{
+		return InitFromWKT(metadata.strSrs.c_str(), origin);
+	}
+
+	lastError = "Unsupported SRS: " + metadata.strSrs;
+	return false;
+}
+
+const char* GeoTransform::GetLastError() const
 {
 	// 获取最后的错误信息
 	return lastError.empty() ? nullptr : lastError.c_str();
 }
 
-bool GeoTransform::IsInitialized()
+bool GeoTransform::IsInitialized() const
 {
 	// 检查坐标转换是否已初始化
 	return projTransform != nullptr;
@@ -4,10 +4,17 @@
 #include "glm/glm.hpp"
 #include <string>
 #include <memory>
+#include <mutex>
 #include <proj.h>
 
+struct OSGBMetadata;
+
 /**
  * @brief 坐标转换工具类, 使用PROJ库实现,支持EPSG/WKT/ENU坐标系转换
+ *
+ * 每次转换任务持有自己的实例（由数据集的 metadata.xml 初始化），
+ * 以指针传给读取节点的函数；同时运行的任务与模型预览互不影响。
+ * 同一实例可被任务的多个线程共享（PROJ 转换在内部串行执行）。
  */
 class GeoTransform
 {
@@ -35,29 +42,37 @@ private:
 		}
 	};
 
+	// PROJ 转换对象不能被多个线程同时使用
+	mutable std::mutex proj_mutex;
+
 public:
+	GeoTransform() = default;
+
+	GeoTransform(const GeoTransform&) = delete;
+	GeoTransform& operator=(const GeoTransform&) = delete;
+
 	// PROJ转换对象（坐标转换的核心）- 使用智能指针自动管理
-	static inline std::unique_ptr<PJ, ProjDeleter> projTransform = nullptr;
-	static inline std::unique_ptr<PJ_CONTEXT, ProjContextDeleter> projContext = nullptr;
+	std::unique_ptr<PJ, ProjDeleter> projTransform = nullptr;
+	std::unique_ptr<PJ_CONTEXT, ProjContextDeleter> projContext = nullptr;
 
 	// 原点坐标（局部坐标系原点）
-	static inline double OriginX = 0.0;
-	static inline double OriginY = 0.0;
-	static inline double OriginZ = 0.0;
+	double OriginX = 0.0;
+	double OriginY = 0.0;
+	double OriginZ = 0.0;
 
 	// ENU地理原点（经纬度）
-	static inline double GeoOriginLon = 0.0;
-	static inline double GeoOriginLat = 0.0;
-	static inline double GeoOriginHeight = 0.0;
+	double GeoOriginLon = 0.0;
+	double GeoOriginLat = 0.0;
+	double GeoOriginHeight = 0.0;
 
 	// ENU标志（是否使用ENU坐标系）
-	static inline bool IsENU = false;
+	bool IsENU = false;
 
 	// ECEF<->ENU转换矩阵
-	static inline glm::dmat4 EcefToEnuMatrix = glm::dmat4(1.0);
+	glm::dmat4 EcefToEnuMatrix = glm::dmat4(1.0);
 
 	// 最后的错误信息
-	static inline std::string lastError = "";
+	std::string lastError = "";
 
 	// ========================================================================
 	// Core coordinate transformation methods
@@ -83,17 +98,24 @@ public:
 	 * 2. 将原点坐标转换为地理坐标（经纬度）
 	 * 3. 计算ENU<->ECEF转换矩阵
 	 */
-	static void Init(PJ* transform, double* origin);
+	void Init(PJ* transform, double* origin);
 
 	/**
 	 * @brief 设置ENU系统的地理原点
 	 */
-	static void SetGeographicOrigin(double lon, double lat, double height);
+	void SetGeographicOrigin(double lon, double lat, double height);
 
 	/**
 	 * @brief 清理资源
 	 */
-	static void Cleanup();
+	void Cleanup();
+
+	/**
+	 * @brief 将相对原点的局部坐标转换为以地理原点为中心的ENU坐标（线程安全）
+	 * @param point 局部坐标（相对 SRSOrigin）
+	 * @return ENU坐标（米）
+	 */
+	glm::dvec3 ToLocalEnu(const glm::dvec3& point) const;
 
 	// ========================================================================
 	// Public API (convenience initialization methods)
@@ -108,9 +130,10 @@ public:
 	 *
 	 * @example
 	 * double origin[3] = {39500000.0, 3450000.0, 0.0};
-	 * GeoTransform::InitFromEPSG(4547, origin);
+	 * GeoTransform transform;
+	 * transform.InitFromEPSG(4547, origin);
 	 */
-	static bool InitFromEPSG(int epsg_code, double* origin);
+	bool InitFromEPSG(int epsg_code, double* origin);
 
 	/**
 	 * @brief ENU局部坐标系初始化
@@ -120,7 +143,7 @@ public:
 	 * @param origin_enu ENU原点偏移[x, y, z]（米）
 	 * @return true=成功, false=失败
 	 */
-	static bool InitFromENU(double lon, double lat, double* origin_enu);
+	bool InitFromENU(double lon, double lat, double* origin_enu);
 
 	/**
 	 * @brief WKT坐标系定义初始化
@@ -129,17 +152,25 @@ public:
 	 * @param origin 原点坐标[x, y, z]
 	 * @return true=成功, false=失败
 	 */
-	static bool InitFromWKT(const char* wkt, double* origin);
+	bool InitFromWKT(const char* wkt, double* origin);
+
+	/**
+	 * @brief 按 metadata.xml 的坐标系统初始化（ENU/EPSG/WKT，原点为 SRSOrigin）
+	 *
+	 * @param metadata 解析后的元数据
+	 * @return true=成功, false=失败或不支持的坐标系统
+	 */
+	bool InitFromMetadata(const OSGBMetadata& metadata);
 
 	/**
 	 * @brief 获取最后的错误信息
 	 */
-	static const char* GetLastError();
+	const char* GetLastError() const;
 
 	/**
 	 * @brief 检查坐标转换是否已初始化
 	 */
-	static bool IsInitialized();
+	bool IsInitialized() const;
 };
 
 #endif // GEOTRANSFORM_H
\ No newline at end of file
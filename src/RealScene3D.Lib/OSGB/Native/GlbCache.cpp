@@ -0,0 +1,229 @@
+#include <filesystem>
+
+#include "GlbCache.h"
+#include "DatasetScanner.h"
+#include "OSGBTools.h"
+#include "ZipFileSystem.h"
+
+GlbCache::GlbCache(const GlbCacheSettings& settings)
+	: settings(settings)
+{
+}
+
+GlbCache& GlbCache::Global()
+{
+	static GlbCache cache;
+
+	return cache;
+}
+
+void GlbCache::Configure(const GlbCacheSettings& newSettings)
+{
+	std::lock_guard<std::mutex> lock(cache_mutex);
+
+	settings = newSettings;
+	if (!settings.bEnable)
+	{
+		entries.clear();
+		lru.clear();
+		cached_bytes = 0;
+		return;
+	}
+
+	Evict();
+}
+
+GlbCacheSettings GlbCache::GetSettings() const
+{
+	std::lock_guard<std::mutex> lock(cache_mutex);
+
+	return settings;
+}
+
+bool GlbCache::GetOrCreate(const std::string& strPath, const std::string& strOptions,
+	std::shared_ptr<const std::string>& data, const Producer& producer)
+{
+	std::string key;
+	if (!GetSettings().bEnable || !MakeKey(strPath, strOptions, key))
+	{
+		std::string buf;
+		if (!producer(buf))
+		{
+			return false;
+		}
+
+		data = std::make_shared<const std::string>(std::move(buf));
+		return true;
+	}
+
+	// 1. 命中直接返回；同一键正在转换时等待其结果（锁内只取共享指针，不复制数据）
+	std::shared_ptr<Flight> flight;
+	{
+		std::unique_lock<std::mutex> lock(cache_mutex);
+
+		auto it = entries.find(key);
+		if (it != entries.end())
+		{
+			lru.splice(lru.begin(), lru, it->second.lru_it);
+			hit_count++;
+			data = it->second.data;
+			return true;
+		}
+
+		auto flight_it = flights.find(key);
+		if (flight_it != flights.end())
+		{
+			std::shared_ptr<Flight> leader = flight_it->second;
+			flights_cv.wait(lock, [&]() { return leader->done; });
+			if (!leader->ok)
+			{
+				return false;
+			}
+
+			hit_count++;
+			data = leader->data;
+			return true;
+		}
+
+		flight = std::make_shared<Flight>();
+		flights.emplace(key, flight);
+		miss_count++;
+	}
+
+	// 2. 转换在锁外执行
+	std::string buf;
+	bool bOk = false;
+	try
+	{
+		bOk = producer(buf);
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		flight->done = true;
+		flights.erase(key);
+		flights_cv.notify_all();
+		throw;
+	}
+
+	auto result = std::make_shared<const std::string>(std::move(buf));
+	{
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		flight->ok = bOk;
+		flight->data = result;
+		flight->done = true;
+		flights.erase(key);
+		if (bOk && settings.bEnable)
+		{
+			Insert(key, result);
+		}
+	}
+	flights_cv.notify_all();
+
+	if (bOk)
+	{
+		data = std::move(result);
+	}
+
+	return bOk;
+}
+
+void GlbCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(cache_mutex);
+
+	entries.clear();
+	lru.clear();
+	cached_bytes = 0;
+}
+
+GlbCacheStats GlbCache::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(cache_mutex);
+
+	GlbCacheStats stats;
+	stats.nHits = hit_count;
+	stats.nMisses = miss_count;
+	stats.nEvictions = eviction_count;
+	stats.nEntries = entries.size();
+	stats.nBytes = cached_bytes;
+
+	return stats;
+}
+
+bool GlbCache::MakeKey(const std::string& strPath, const std::string& strOptions, std::string& key)
+{
+	std::string path = OSGBTools::NormalizePath(strPath);
+
+	// 压缩包内条目没有修改时间，以压缩包本身判断是否变化
+	std::string stat_path = path;
+	if (ZipFileSystem::IsArchivePath(path))
+	{
+		std::string entry;
+		auto zip = ZipFileSystem::Resolve(path, entry);
+		if (!zip || !zip->IsRegularFile(entry))
+		{
+			return false;
+		}
+		stat_path = zip->GetArchivePath();
+	}
+	else
+	{
+		std::error_code ec;
+		std::filesystem::path canonical = std::filesystem::weakly_canonical(path, ec);
+		if (!ec)
+		{
+			path = OSGBTools::NormalizePath(canonical.string());
+			stat_path = path;
+		}
+	}
+
+	uint64_t nSize = 0;
+	int64_t nMTime = 0;
+	if (!DatasetScanner::StatFile(stat_path, nSize, nMTime))
+	{
+		return false;
+	}
+
+	key = path + "|" + std::to_string(nSize) + "|" + std::to_string(nMTime) + "|" + strOptions;
+
+	return true;
+}
+
+void GlbCache::Insert(const std::string& key, std::shared_ptr<const std::string> data)
+{
+	// 单个结果超过上限时不缓存，避免清空整个缓存
+	if (data->size() > settings.nMaxBytes)
+	{
+		return;
+	}
+
+	auto it = entries.find(key);
+	if (it != entries.end())
+	{
+		cached_bytes -= it->second.data->size();
+		lru.erase(it->second.lru_it);
+		entries.erase(it);
+	}
+
+	lru.push_front(key);
+	cached_bytes += data->size();
+	entries[key] = { std::move(data), lru.begin() };
+
+	Evict();
+}
+
+void GlbCache::Evict()
+{
+	while (cached_bytes > settings.nMaxBytes && !lru.empty())
+	{
+		auto it = entries.find(lru.back());
+		if (it != entries.end())
+		{
+			cached_bytes -= it->second.data->size();
+			entries.erase(it);
+		}
+		lru.pop_back();
+		eviction_count++;
+	}
+}
@@ -0,0 +1,161 @@
+#ifndef GLB_CACHE_H
+#define GLB_CACHE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief GLB 缓存配置
+ */
+struct GlbCacheSettings
+{
+	// 是否启用
+	bool bEnable = true;
+
+	// 缓存的 GLB 字节上限，超过后按最近最少使用淘汰
+	size_t nMaxBytes = 256ull * 1024 * 1024;
+};
+
+/**
+ * @brief GLB 缓存统计
+ */
+struct GlbCacheStats
+{
+	// 命中次数（含等待其他线程转换完成的请求）
+	size_t nHits = 0;
+
+	// 未命中（实际执行转换）的次数
+	size_t nMisses = 0;
+
+	// 因超出字节上限被淘汰的条目数
+	size_t nEvictions = 0;
+
+	// 当前条目数
+	size_t nEntries = 0;
+
+	// 当前缓存的字节数
+	size_t nBytes = 0;
+};
+
+/**
+ * @brief 进程内 GLB 转换结果缓存（LRU，按字节上限淘汰）
+ *
+ * 键为规范化路径、文件大小、修改时间与转换参数，源文件被修改后自动失效；
+ * 压缩包内的文件以压缩包本身的大小与修改时间判断。
+ * 转换结果只能由键决定：依赖其他状态（如数据集坐标转换）的结果不应经缓存转换。
+ * 同一键的并发未命中只执行一次转换，其余请求等待并共享结果。
+ *
+ * 命中时返回与缓存共享的只读数据，不复制。
+ *
+ * @example
+ * std::shared_ptr<const std::string> glb;
+ * GlbCache::Global().GetOrCreate(strPath, "-1|1|0|0|0", glb,
+ *     [&](std::string& data) { return ToGLBBuf(strPath, data, ...); });
+ */
+class GlbCache
+{
+public:
+	/**
+	 * @brief 转换函数，成功时填充数据并返回 true
+	 */
+	using Producer = std::function<bool(std::string& data)>;
+
+	explicit GlbCache(const GlbCacheSettings& settings = GlbCacheSettings());
+
+	GlbCache(const GlbCache&) = delete;
+	GlbCache& operator=(const GlbCache&) = delete;
+
+	/**
+	 * @brief 进程共享的缓存实例（ToGLB / ToGLBBuf 使用）
+	 */
+	static GlbCache& Global();
+
+	/**
+	 * @brief 修改配置，缩小上限时立即淘汰多余条目
+	 */
+	void Configure(const GlbCacheSettings& settings);
+
+	/**
+	 * @brief 获取当前配置
+	 */
+	GlbCacheSettings GetSettings() const;
+
+	/**
+	 * @brief 读取缓存，未命中时调用 producer 转换并缓存结果
+	 * @param strPath 源文件路径
+	 * @param strOptions 转换参数（不同参数的结果分别缓存）
+	 * @param data 输出的数据（与缓存共享，只读）
+	 * @param producer 转换函数
+	 * @return 转换失败返回 false（失败结果不缓存）
+	 * @note 缓存禁用或无法获取源文件信息时直接调用 producer
+	 */
+	bool GetOrCreate(const std::string& strPath, const std::string& strOptions,
+		std::shared_ptr<const std::string>& data, const Producer& producer);
+
+	/**
+	 * @brief 清空缓存（统计计数保留）
+	 */
+	void Clear();
+
+	/**
+	 * @brief 获取统计
+	 */
+	GlbCacheStats GetStats() const;
+
+private:
+	/**
+	 * @brief 缓存条目
+	 */
+	struct Entry
+	{
+		std::shared_ptr<const std::string> data;
+
+		// 在 lru 中的位置
+		std::list<std::string>::iterator lru_it;
+	};
+
+	/**
+	 * @brief 进行中的转换
+	 */
+	struct Flight
+	{
+		bool done = false;
+		bool ok = false;
+		std::shared_ptr<const std::string> data;
+	};
+
+	// 生成缓存键，无法获取源文件信息返回 false
+	static bool MakeKey(const std::string& strPath, const std::string& strOptions, std::string& key);
+
+	// 插入条目并按上限淘汰（需持有锁）
+	void Insert(const std::string& key, std::shared_ptr<const std::string> data);
+
+	// 淘汰到不超过上限（需持有锁）
+	void Evict();
+
+	GlbCacheSettings settings;
+
+	std::unordered_map<std::string, Entry> entries;
+
+	// 最近使用的在前
+	std::list<std::string> lru;
+
+	std::unordered_map<std::string, std::shared_ptr<Flight>> flights;
+	std::condition_variable flights_cv;
+
+	mutable std::mutex cache_mutex;
+
+	// 统计（需持有锁）
+	size_t cached_bytes = 0;
+	size_t hit_count = 0;
+	size_t miss_count = 0;
+	size_t eviction_count = 0;
+};
+
+#endif // GLB_CACHE_H
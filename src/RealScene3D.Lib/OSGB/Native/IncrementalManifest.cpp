@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <vector>
+
+#include <json.hpp>
+
+#include "IncrementalManifest.h"
+#include "ContentHash.h"
+#include "DatasetScanner.h"
+#include "OSGBTools.h"
+#include "ZipFileSystem.h"
+
+using namespace OSGBLog;
+
+// ============================================================================
+// 内部辅助函数（仅在本文件内使用）
+// ============================================================================
+
+namespace
+{
+	const int kManifestVersion = 1;
+
+	// 递归收集目录下所有文件的相对路径
+	void CollectFiles(const std::string& strDirPath, const std::string& strPrefix, std::vector<std::string>& files)
+	{
+		OSGBTools::ForEachEntry(strDirPath, [&](const OSGBTools::DirectoryEntry& entry) -> bool
+		{
+			std::string relative = strPrefix.empty() ? entry.name : strPrefix + "/" + entry.name;
+			if (entry.is_directory)
+			{
+				CollectFiles(strDirPath + "/" + entry.name, relative, files);
+			}
+			else if (entry.is_regular_file)
+			{
+				files.emplace_back(std::move(relative));
+			}
+			return true;
+		});
+	}
+
+} // anonymous namespace
+
+bool IncrementalManifest::Load(const std::string& strPath, const std::string& strSettingsKey)
+{
+	using nlohmann::json;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	settings_key = strSettingsKey;
+	previous.clear();
+	current.clear();
+
+	std::string strContent;
+	if (!OSGBTools::ReadFile(strPath, strContent))
+	{
+		return false;
+	}
+
+	try
+	{
+		json manifest = json::parse(strContent);
+		if (manifest.value("version", 0) != kManifestVersion)
+		{
+			return false;
+		}
+
+		if (manifest.value("settings", "") != strSettingsKey)
+		{
+			LOG_I("转换参数已变化，增量清单作废: {}", strPath);
+			return false;
+		}
+
+		for (const auto& item : manifest.at("tiles").items())
+		{
+			Record record;
+			record.fingerprint = item.value().value("fingerprint", "");
+			const auto& bbox = item.value().at("bbox");
+			for (size_t i = 0; i < record.bbox.size() && i < bbox.size(); ++i)
+			{
+				record.bbox[i] = bbox[i].get<double>();
+			}
+			previous.emplace(OSGBTools::OSGString(item.key()), std::move(record));
+		}
+
+		return true;
+	}
+	catch (const std::exception& e)
+	{
+		LOG_W("增量清单解析失败，全部重新转换: {}", e.what());
+		previous.clear();
+		return false;
+	}
+}
+
+bool IncrementalManifest::Save(const std::string& strPath) const
+{
+	using nlohmann::json;
+
+	std::string strContent;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		// 瓦片名以 UTF-8 保存（JSON 要求），读取时转换回本地编码
+		json tiles = json::object();
+		for (const auto& item : current)
+		{
+			tiles[OSGBTools::Utf8String(item.first)] = {
+				{"fingerprint", item.second.fingerprint},
+				{"bbox", item.second.bbox}
+			};
+		}
+
+		json manifest = {
+			{"version", kManifestVersion},
+			{"settings", settings_key},
+			{"tiles", std::move(tiles)}
+		};
+
+		try
+		{
+			strContent = manifest.dump();
+		}
+		catch (const std::exception& e)
+		{
+			LOG_W("增量清单序列化失败: {}", e.what());
+			return false;
+		}
+	}
+
+	if (!OSGBTools::WriteFile(strPath, strContent.data(), static_cast<unsigned long>(strContent.size())))
+	{
+		LOG_W("增量清单写入失败: {}", strPath);
+		return false;
+	}
+
+	return true;
+}
+
+bool IncrementalManifest::IsUnchanged(const std::string& strTileName, const std::string& strFingerprint,
+	std::array<double, 6>& bbox) const
+{
+	if (strFingerprint.empty())
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto it = previous.find(strTileName);
+	if (it == previous.end() || it->second.fingerprint != strFingerprint)
+	{
+		return false;
+	}
+
+	bbox = it->second.bbox;
+
+	return true;
+}
+
+void IncrementalManifest::Update(const std::string& strTileName, const std::string& strFingerprint,
+	const std::array<double, 6>& bbox)
+{
+	if (strFingerprint.empty())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	current[strTileName] = { strFingerprint, bbox };
+}
+
+std::string IncrementalManifest::ComputeFingerprint(const std::string& strDirPath, bool bContentHash)
+{
+	if (!OSGBTools::IsDirectory(strDirPath))
+	{
+		return "";
+	}
+
+	const bool bInArchive = ZipFileSystem::IsArchivePath(strDirPath);
+
+	std::vector<std::string> files;
+	CollectFiles(strDirPath, "", files);
+	std::sort(files.begin(), files.end());
+
+	// 每个文件一行：相对路径|大小|修改时间[|内容MD5]，整体再取 MD5
+	std::string lines;
+	for (const auto& file : files)
+	{
+		std::string path = strDirPath + "/" + file;
+
+		uint64_t nSize = 0;
+		int64_t nMTime = 0;
+		DatasetScanner::StatFile(path, nSize, nMTime);
+
+		lines += file;
+		lines += '|' + std::to_string(nSize) + '|' + std::to_string(nMTime);
+
+		if (bContentHash || bInArchive)
+		{
+			std::string data;
+			if (OSGBTools::ReadFile(path, data))
+			{
+				lines += '|' + ContentHash::Md5Hex(data.data(), data.size());
+			}
+		}
+
+		lines += '\n';
+	}
+
+	return ContentHash::Md5Hex(lines.data(), lines.size());
+}
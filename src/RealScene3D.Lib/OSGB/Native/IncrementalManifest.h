@@ -0,0 +1,99 @@
+#ifndef INCREMENTAL_MANIFEST_H
+#define INCREMENTAL_MANIFEST_H
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief 增量转换配置
+ */
+struct IncrementalSettings
+{
+	// 是否启用增量转换（输入与参数未变化的瓦片跳过转换）
+	bool bEnable = false;
+
+	// 指纹是否包含文件内容哈希（默认只比较文件大小与修改时间）
+	bool bContentHash = false;
+
+	// 清单路径，为空时保存在本地输出目录下；输出到MinIO等非本地目标时必须指定
+	std::string strManifestPath;
+};
+
+/**
+ * @brief 增量转换清单
+ *
+ * 记录每个瓦片输入目录的指纹（所有文件的相对路径、大小、修改时间，可选内容哈希）
+ * 及转换后的包围盒，并与转换参数绑定。再次转换时指纹与参数均未变化的瓦片直接复用
+ * 上次的输出和包围盒，只重新生成根 tileset.json。
+ *
+ * 清单只保存本次运行中登记（Update）过的瓦片：转换失败或已删除的瓦片自动移出清单，
+ * 下次运行时重新转换。
+ *
+ * @example
+ * IncrementalManifest manifest;
+ * manifest.Load(strManifestPath, strSettingsKey);
+ * std::string fp = IncrementalManifest::ComputeFingerprint(strTileDir, false);
+ * std::array<double, 6> bbox;
+ * if (!manifest.IsUnchanged("Tile_+000_+000", fp, bbox)) { ... 转换并 Update ... }
+ * manifest.Save(strManifestPath);
+ */
+class IncrementalManifest
+{
+public:
+	IncrementalManifest() = default;
+
+	/**
+	 * @brief 读取清单
+	 * @param strPath 清单路径
+	 * @param strSettingsKey 本次转换参数，与清单中记录的参数不同时清单作废
+	 * @return 清单存在且参数一致返回 true
+	 */
+	bool Load(const std::string& strPath, const std::string& strSettingsKey);
+
+	/**
+	 * @brief 保存本次登记的瓦片
+	 */
+	bool Save(const std::string& strPath) const;
+
+	/**
+	 * @brief 瓦片指纹是否与上次一致
+	 * @param bbox 一致时输出上次的包围盒 [maxX, maxY, maxZ, minX, minY, minZ]
+	 */
+	bool IsUnchanged(const std::string& strTileName, const std::string& strFingerprint,
+		std::array<double, 6>& bbox) const;
+
+	/**
+	 * @brief 登记瓦片的指纹与包围盒（线程安全）
+	 */
+	void Update(const std::string& strTileName, const std::string& strFingerprint,
+		const std::array<double, 6>& bbox);
+
+	/**
+	 * @brief 计算目录指纹
+	 * @param strDirPath 瓦片输入目录（递归包含所有文件）
+	 * @param bContentHash 是否计算文件内容哈希；压缩包内的条目没有可靠的修改时间，总是计算内容哈希
+	 * @return 指纹（MD5十六进制），目录不存在返回空字符串
+	 */
+	static std::string ComputeFingerprint(const std::string& strDirPath, bool bContentHash);
+
+private:
+	struct Record
+	{
+		std::string fingerprint;
+		std::array<double, 6> bbox = {};
+	};
+
+	std::string settings_key;
+
+	// 上次运行的记录
+	std::unordered_map<std::string, Record> previous;
+
+	// 本次运行登记的记录
+	std::unordered_map<std::string, Record> current;
+
+	mutable std::mutex mutex;
+};
+
+#endif // INCREMENTAL_MANIFEST_H
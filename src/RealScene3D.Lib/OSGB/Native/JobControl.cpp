@@ -0,0 +1,134 @@
+#include "JobControl.h"
+
+// ============================================================================
+// 内部辅助函数（仅在本文件内使用）
+// ============================================================================
+
+namespace
+{
+	int64_t NowNanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+} // anonymous namespace
+
+JobControl::JobControl(ProgressListener* pListener, int nIntervalMs)
+	: listener(pListener)
+	, interval(nIntervalMs > 0 ? nIntervalMs : 0)
+{
+	start_time = NowNanoseconds();
+}
+
+void JobControl::Begin(int nTilesTotal)
+{
+	tiles_total = nTilesTotal;
+	tiles_done = 0;
+	tiles_failed = 0;
+	EndLevels();
+	start_time = NowNanoseconds();
+
+	Report(true);
+}
+
+void JobControl::TileFinished(bool bSuccess)
+{
+	tiles_done++;
+	if (!bSuccess)
+	{
+		tiles_failed++;
+	}
+
+	Report(false);
+}
+
+void JobControl::LevelFinished(int nLevelsDone, int nLevelsTotal, double dTilesPartial)
+{
+	levels_done = nLevelsDone;
+	levels_total = nLevelsTotal;
+	tiles_partial = dTilesPartial;
+
+	Report(true);
+}
+
+void JobControl::EndLevels()
+{
+	levels_done = 0;
+	levels_total = 0;
+	tiles_partial = 0.0;
+}
+
+void JobControl::AddBytes(size_t nBytes)
+{
+	bytes_written += static_cast<long long>(nBytes);
+
+	Report(false);
+}
+
+ConversionProgress JobControl::GetProgress() const
+{
+	ConversionProgress progress;
+	progress.nTilesDone = tiles_done.load();
+	progress.nTilesFailed = tiles_failed.load();
+	progress.nTilesTotal = tiles_total.load();
+	progress.nLevelsDone = levels_done.load();
+	progress.nLevelsTotal = levels_total.load();
+	progress.nBytesWritten = bytes_written.load();
+	progress.dElapsedSeconds = (NowNanoseconds() - start_time.load()) / 1e9;
+	progress.bCancelled = IsCancelled();
+
+	// 按已完成瓦片（含渐进式发布中按节点折算的部分）的平均耗时估算
+	const double dDone = progress.nTilesDone + tiles_partial.load();
+	if (dDone > 0 && progress.nTilesTotal >= dDone)
+	{
+		progress.dEtaSeconds = progress.dElapsedSeconds / dDone * (progress.nTilesTotal - dDone);
+	}
+
+	return progress;
+}
+
+void JobControl::Finish(bool bSuccess)
+{
+	if (!listener)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(report_mutex);
+
+	ConversionProgress progress = GetProgress();
+	if (bSuccess)
+	{
+		progress.dEtaSeconds = 0.0;
+	}
+	listener->OnProgress(progress);
+	listener->OnFinished(bSuccess, progress);
+}
+
+void JobControl::Report(bool bForce)
+{
+	if (!listener)
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(report_mutex, std::defer_lock);
+	if (bForce)
+	{
+		lock.lock();
+	}
+	else if (!lock.try_lock())
+	{
+		return;
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	if (!bForce && now - last_report < interval)
+	{
+		return;
+	}
+	last_report = now;
+
+	listener->OnProgress(GetProgress());
+}
@@ -0,0 +1,158 @@
+#ifndef JOB_CONTROL_H
+#define JOB_CONTROL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @brief 转换任务进度
+ */
+struct ConversionProgress
+{
+	// 已完成的瓦片数（含跳过与续传的瓦片）
+	int nTilesDone = 0;
+
+	// 其中失败的瓦片数
+	int nTilesFailed = 0;
+
+	// 瓦片总数（扫描完成前为 0）
+	int nTilesTotal = 0;
+
+	// 渐进式发布已完成的层级数与总层级数（瓦片在全部层级完成后才计入 nTilesDone，其他阶段为 0）
+	int nLevelsDone = 0;
+	int nLevelsTotal = 0;
+
+	// 已提交给输出目标的字节数
+	long long nBytesWritten = 0;
+
+	// 已用时间（秒）
+	double dElapsedSeconds = 0.0;
+
+	// 预计剩余时间（秒），无法估计时为 -1
+	double dEtaSeconds = -1.0;
+
+	// 是否已请求取消
+	bool bCancelled = false;
+};
+
+/**
+ * @brief 进度监听器（C# 通过 SWIG director 继承）
+ *
+ * 回调在转换线程上调用，同一时间只有一个线程进入回调；
+ * 回调应尽快返回，耗时操作请转到其他线程。
+ */
+class ProgressListener
+{
+public:
+	virtual ~ProgressListener() = default;
+
+	/**
+	 * @brief 进度更新（按间隔节流）
+	 */
+	virtual void OnProgress(const ConversionProgress& /*progress*/) {}
+
+	/**
+	 * @brief 任务结束（成功、失败或取消），之后不再有回调
+	 * @param bSuccess 是否成功
+	 * @param progress 最终进度
+	 */
+	virtual void OnFinished(bool /*bSuccess*/, const ConversionProgress& /*progress*/) {}
+};
+
+/**
+ * @brief 转换任务控制：协作式取消与进度统计
+ *
+ * 转换流程在每个瓦片（及瓦片内每个节点）开始前检查 IsCancelled，
+ * 取消后正在转换的节点完成即停止，已提交的文件照常写完。
+ * 进度由转换线程在瓦片完成或写入文件时上报，按间隔节流后回调监听器；
+ * 其他线程正在回调时直接跳过，转换线程不会因监听器等待。
+ */
+class JobControl
+{
+public:
+	/**
+	 * @param pListener 进度监听器（调用方持有，可为空）
+	 * @param nIntervalMs 进度回调最小间隔（毫秒）
+	 */
+	explicit JobControl(ProgressListener* pListener = nullptr, int nIntervalMs = 500);
+
+	JobControl(const JobControl&) = delete;
+	JobControl& operator=(const JobControl&) = delete;
+
+	/**
+	 * @brief 请求取消（线程安全）
+	 */
+	void Cancel() { cancelled = true; }
+
+	/**
+	 * @brief 是否已请求取消
+	 */
+	bool IsCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief 开始计时并设置瓦片总数
+	 */
+	void Begin(int nTilesTotal);
+
+	/**
+	 * @brief 一个瓦片完成（线程安全）
+	 */
+	void TileFinished(bool bSuccess);
+
+	/**
+	 * @brief 渐进式发布完成一层（每层完成时立即回调监听器）
+	 * @param nLevelsDone 已完成的层级数
+	 * @param nLevelsTotal 总层级数
+	 * @param dTilesPartial 按已转换节点折算的瓦片数，计入剩余时间估算
+	 */
+	void LevelFinished(int nLevelsDone, int nLevelsTotal, double dTilesPartial);
+
+	/**
+	 * @brief 渐进式发布结束，之后各瓦片通过 TileFinished 计入（不回调）
+	 */
+	void EndLevels();
+
+	/**
+	 * @brief 累加写入字节数（线程安全）
+	 */
+	void AddBytes(size_t nBytes);
+
+	/**
+	 * @brief 当前进度
+	 */
+	ConversionProgress GetProgress() const;
+
+	/**
+	 * @brief 任务结束：发送最终进度并通知监听器
+	 */
+	void Finish(bool bSuccess);
+
+private:
+	// 到达间隔（或 bForce）时回调监听器
+	void Report(bool bForce);
+
+	ProgressListener* listener = nullptr;
+	std::chrono::milliseconds interval;
+
+	std::atomic<bool> cancelled{ false };
+	std::atomic<int> tiles_total{ 0 };
+	std::atomic<int> tiles_done{ 0 };
+	std::atomic<int> tiles_failed{ 0 };
+	std::atomic<long long> bytes_written{ 0 };
+
+	// 渐进式发布的层级进度
+	std::atomic<int> levels_done{ 0 };
+	std::atomic<int> levels_total{ 0 };
+	std::atomic<double> tiles_partial{ 0.0 };
+
+	// 开始时间（steady_clock 纳秒）
+	std::atomic<int64_t> start_time{ 0 };
+
+	// 同一时间只有一个线程回调监听器
+	std::mutex report_mutex;
+	std::chrono::steady_clock::time_point last_report;
+};
+
+#endif // JOB_CONTROL_H
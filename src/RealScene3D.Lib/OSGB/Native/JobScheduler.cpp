@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "JobScheduler.h"
+#include "JobControl.h"
+
+JobScheduler::Slot::Slot(Slot&& other) noexcept
+	: scheduler(other.scheduler)
+	, priority(other.priority)
+	, group(other.group)
+{
+	other.scheduler = nullptr;
+}
+
+JobScheduler::Slot& JobScheduler::Slot::operator=(Slot&& other) noexcept
+{
+	if (this != &other)
+	{
+		Release();
+		scheduler = other.scheduler;
+		priority = other.priority;
+		group = other.group;
+		other.scheduler = nullptr;
+	}
+
+	return *this;
+}
+
+void JobScheduler::Slot::Release()
+{
+	if (scheduler)
+	{
+		scheduler->Release(priority, group);
+		scheduler = nullptr;
+	}
+}
+
+JobScheduler::JobScheduler(const SchedulerSettings& settings)
+{
+	Configure(settings);
+}
+
+JobScheduler& JobScheduler::Global()
+{
+	static JobScheduler scheduler;
+
+	return scheduler;
+}
+
+void JobScheduler::Configure(const SchedulerSettings& settings)
+{
+	{
+		std::lock_guard<std::mutex> lock(scheduler_mutex);
+
+		max_slots = settings.nMaxSlots > 0 ? settings.nMaxSlots :
+			std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+		// 至少给批量工作留一个槽位
+		reserved_interactive = std::clamp(settings.nReservedInteractive, 0, max_slots - 1);
+	}
+
+	slot_cv.notify_all();
+}
+
+SchedulerSettings JobScheduler::GetSettings() const
+{
+	std::lock_guard<std::mutex> lock(scheduler_mutex);
+
+	SchedulerSettings settings;
+	settings.nMaxSlots = max_slots;
+	settings.nReservedInteractive = reserved_interactive;
+
+	return settings;
+}
+
+JobScheduler::Slot JobScheduler::Acquire(JobPriority ePriority, JobGroup* pGroup, const JobControl* pControl)
+{
+	const size_t index = static_cast<size_t>(ePriority);
+	auto start = std::chrono::steady_clock::now();
+
+	std::unique_lock<std::mutex> lock(scheduler_mutex);
+
+	waiting[index]++;
+	auto ready = [&]()
+	{
+		return CanRun(ePriority, pGroup) || (pControl && pControl->IsCancelled());
+	};
+
+	// 可取消的等待定期检查取消请求
+	if (pControl)
+	{
+		while (!ready())
+		{
+			slot_cv.wait_for(lock, std::chrono::milliseconds(100));
+		}
+	}
+	else
+	{
+		slot_cv.wait(lock, ready);
+	}
+	waiting[index]--;
+
+	// 最后一个等待的交互请求离开后，批量工作可以继续获取槽位
+	bool bWakeBatch = ePriority == JobPriority::Interactive &&
+		waiting[static_cast<size_t>(JobPriority::Interactive)] == 0;
+
+	if (pControl && pControl->IsCancelled())
+	{
+		lock.unlock();
+		if (bWakeBatch)
+		{
+			slot_cv.notify_all();
+		}
+		return Slot();
+	}
+
+	running[index]++;
+	if (pGroup)
+	{
+		pGroup->running++;
+	}
+
+	if (ePriority == JobPriority::Interactive)
+	{
+		double wait_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		interactive_count++;
+		interactive_wait_total_ms += wait_ms;
+		interactive_wait_max_ms = std::max(interactive_wait_max_ms, wait_ms);
+	}
+
+	lock.unlock();
+	if (bWakeBatch)
+	{
+		slot_cv.notify_all();
+	}
+
+	return Slot(this, ePriority, pGroup);
+}
+
+SchedulerStats JobScheduler::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(scheduler_mutex);
+
+	const size_t interactive = static_cast<size_t>(JobPriority::Interactive);
+	const size_t batch = static_cast<size_t>(JobPriority::Batch);
+
+	SchedulerStats stats;
+	stats.nRunningInteractive = running[interactive];
+	stats.nRunningBatch = running[batch];
+	stats.nWaitingInteractive = waiting[interactive];
+	stats.nWaitingBatch = waiting[batch];
+	stats.nInteractiveCount = interactive_count;
+	stats.dInteractiveWaitAvgMs = interactive_count > 0 ? interactive_wait_total_ms / interactive_count : 0.0;
+	stats.dInteractiveWaitMaxMs = interactive_wait_max_ms;
+
+	return stats;
+}
+
+bool JobScheduler::CanRun(JobPriority ePriority, const JobGroup* pGroup) const
+{
+	const size_t interactive = static_cast<size_t>(JobPriority::Interactive);
+	const size_t batch = static_cast<size_t>(JobPriority::Batch);
+
+	if (running[interactive] + running[batch] >= max_slots)
+	{
+		return false;
+	}
+
+	if (pGroup && pGroup->max_concurrency > 0 && pGroup->running >= pGroup->max_concurrency)
+	{
+		return false;
+	}
+
+	if (ePriority == JobPriority::Interactive)
+	{
+		return true;
+	}
+
+	// 有交互请求等待时批量工作让出，且不占用保留槽位
+	return waiting[interactive] == 0 && running[batch] < max_slots - reserved_interactive;
+}
+
+void JobScheduler::Release(JobPriority ePriority, JobGroup* pGroup)
+{
+	{
+		std::lock_guard<std::mutex> lock(scheduler_mutex);
+
+		running[static_cast<size_t>(ePriority)]--;
+		if (pGroup)
+		{
+			pGroup->running--;
+		}
+	}
+
+	slot_cv.notify_all();
+}
@@ -0,0 +1,179 @@
+#ifndef JOB_SCHEDULER_H
+#define JOB_SCHEDULER_H
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+class JobControl;
+
+/**
+ * @brief 转换工作的优先级
+ */
+enum class JobPriority
+{
+	// 交互请求（模型预览、按需瓦片），优先获得计算槽位
+	Interactive = 0,
+
+	// 后台批量切片，交互请求等待时在瓦片边界让出
+	Batch = 1
+};
+
+/**
+ * @brief 调度器配置
+ */
+struct SchedulerSettings
+{
+	// 同时执行转换的槽位数，0 表示使用硬件线程数
+	int nMaxSlots = 0;
+
+	// 为交互请求保留的槽位数（批量工作最多占用 nMaxSlots - nReservedInteractive 个）
+	int nReservedInteractive = 1;
+};
+
+/**
+ * @brief 调度统计
+ */
+struct SchedulerStats
+{
+	int nRunningInteractive = 0;
+	int nRunningBatch = 0;
+	int nWaitingInteractive = 0;
+	int nWaitingBatch = 0;
+
+	// 交互请求总数与等待时间（毫秒）
+	size_t nInteractiveCount = 0;
+	double dInteractiveWaitAvgMs = 0.0;
+	double dInteractiveWaitMaxMs = 0.0;
+};
+
+/**
+ * @brief 同一任务的并发上限（由调度器在持锁时读写）
+ */
+class JobGroup
+{
+public:
+	/**
+	 * @param nMaxConcurrency 该任务同时占用的槽位上限，0 表示不限制
+	 */
+	explicit JobGroup(int nMaxConcurrency = 0) : max_concurrency(nMaxConcurrency) {}
+
+	JobGroup(const JobGroup&) = delete;
+	JobGroup& operator=(const JobGroup&) = delete;
+
+private:
+	friend class JobScheduler;
+
+	int max_concurrency = 0;
+	int running = 0;
+};
+
+/**
+ * @brief 进程内转换调度器
+ *
+ * 每个瓦片（渐进式发布为每个节点）、每次交互转换开始前获取一个槽位，完成后释放；
+ * OpenMP 线程在获得槽位前阻塞，不占用CPU。
+ * 有交互请求等待时批量工作不再获得新槽位，正在转换的瓦片完成后即让出，
+ * 另有保留槽位供交互请求立即开始，批量任务运行时预览延迟约为一次转换的时间。
+ *
+ * @example
+ * JobGroup group(8);
+ * JobScheduler::Slot slot = JobScheduler::Global().Acquire(JobPriority::Batch, &group, pControl);
+ * if (slot.IsValid()) { ... 转换一个瓦片 ... }
+ */
+class JobScheduler
+{
+public:
+	/**
+	 * @brief 槽位（析构时释放）
+	 */
+	class Slot
+	{
+	public:
+		Slot() = default;
+		~Slot() { Release(); }
+
+		Slot(Slot&& other) noexcept;
+		Slot& operator=(Slot&& other) noexcept;
+
+		Slot(const Slot&) = delete;
+		Slot& operator=(const Slot&) = delete;
+
+		/**
+		 * @brief 是否持有槽位（等待期间任务被取消时为 false）
+		 */
+		bool IsValid() const { return scheduler != nullptr; }
+
+		/**
+		 * @brief 提前释放
+		 */
+		void Release();
+
+	private:
+		friend class JobScheduler;
+
+		Slot(JobScheduler* pScheduler, JobPriority ePriority, JobGroup* pGroup)
+			: scheduler(pScheduler), priority(ePriority), group(pGroup) {}
+
+		JobScheduler* scheduler = nullptr;
+		JobPriority priority = JobPriority::Batch;
+		JobGroup* group = nullptr;
+	};
+
+	explicit JobScheduler(const SchedulerSettings& settings = SchedulerSettings());
+
+	JobScheduler(const JobScheduler&) = delete;
+	JobScheduler& operator=(const JobScheduler&) = delete;
+
+	/**
+	 * @brief 进程共享的调度器
+	 */
+	static JobScheduler& Global();
+
+	/**
+	 * @brief 修改配置（已持有的槽位不受影响）
+	 */
+	void Configure(const SchedulerSettings& settings);
+
+	/**
+	 * @brief 获取当前配置
+	 */
+	SchedulerSettings GetSettings() const;
+
+	/**
+	 * @brief 获取槽位，阻塞直到可以执行
+	 * @param ePriority 优先级
+	 * @param pGroup 所属任务的并发上限（可为空）
+	 * @param pControl 任务控制，等待期间被取消时返回无效槽位（可为空）
+	 */
+	Slot Acquire(JobPriority ePriority, JobGroup* pGroup = nullptr, const JobControl* pControl = nullptr);
+
+	/**
+	 * @brief 获取统计
+	 */
+	SchedulerStats GetStats() const;
+
+private:
+	// 是否可以立即获得槽位（需持有锁）
+	bool CanRun(JobPriority ePriority, const JobGroup* pGroup) const;
+
+	void Release(JobPriority ePriority, JobGroup* pGroup);
+
+	// 生效的槽位数
+	int max_slots = 1;
+	int reserved_interactive = 0;
+
+	// 按优先级统计（下标为 JobPriority）
+	std::array<int, 2> running = {};
+	std::array<int, 2> waiting = {};
+
+	size_t interactive_count = 0;
+	double interactive_wait_total_ms = 0.0;
+	double interactive_wait_max_ms = 0.0;
+
+	mutable std::mutex scheduler_mutex;
+	std::condition_variable slot_cv;
+};
+
+#endif // JOB_SCHEDULER_H
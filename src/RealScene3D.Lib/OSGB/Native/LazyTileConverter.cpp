@@ -0,0 +1,464 @@
+#include <algorithm>
+
+#include <json.hpp>
+
+#include "LazyTileConverter.h"
+#include "ContentHash.h"
+#include "OSGBTools.h"
+#include "OutputSink.h"
+
+using namespace OSGBLog;
+
+// ============================================================================
+// 内部辅助函数（仅在本文件内使用）
+// ============================================================================
+
+namespace
+{
+	const int kIndexVersion = 3;
+
+	/**
+	 * @brief 数据集的转换参数键（与 BuildTileset 运行的 ToB3DMBatch 一致），参数变化后索引作废
+	 */
+	std::string IndexSettingsKey(const LazyDatasetSettings& settings)
+	{
+		OSGBMetadata metadata;
+		bool bHasMetadata = OSGB23dTiles::LoadDatasetMetadata(settings.strDataDir, metadata);
+
+		return OSGB23dTiles::MakeSettingsKey(settings.strDataDir,
+			settings.dCenterX, settings.dCenterY, settings.nMaxLevel,
+			settings.bEnableTextureCompress, settings.bEnableMeshOpt, settings.bEnableDraco, true, SubsetSettings(),
+			bHasMetadata ? &metadata : nullptr);
+	}
+
+	/**
+	 * @brief 由数据集的坐标系统创建坐标转换（与批量转换一致：初始化失败时不重投影）
+	 */
+	std::shared_ptr<const GeoTransform> MakeGeoTransform(bool bHasMetadata, const OSGBMetadata& metadata)
+	{
+		if (!bHasMetadata)
+		{
+			return nullptr;
+		}
+
+		auto transform = std::make_shared<GeoTransform>();
+		if (!transform->InitFromMetadata(metadata))
+		{
+			const char* error = transform->GetLastError();
+			LOG_E("延迟转换坐标转换初始化失败: {}", error ? error : metadata.strSrs);
+			return nullptr;
+		}
+
+		return transform;
+	}
+
+	nlohmann::json MetadataToJson(const OSGBMetadata& metadata)
+	{
+		return {
+			{"srs", OSGBTools::Utf8String(metadata.strSrs)},
+			{"srs_origin", metadata.strSrsOrigin},
+			{"enu", metadata.bIsENU},
+			{"epsg", metadata.bIsEPSG},
+			{"wkt", metadata.bIsWKT},
+			{"epsg_code", metadata.nEpsgCode},
+			{"center", {metadata.dCenterLat, metadata.dCenterLon}},
+			{"offset", {metadata.dOffsetX, metadata.dOffsetY, metadata.dOffsetZ}}
+		};
+	}
+
+	OSGBMetadata MetadataFromJson(const nlohmann::json& value)
+	{
+		OSGBMetadata metadata;
+		metadata.strSrs = OSGBTools::OSGString(value.at("srs").get<std::string>());
+		metadata.strSrsOrigin = value.at("srs_origin").get<std::string>();
+		metadata.bIsENU = value.at("enu").get<bool>();
+		metadata.bIsEPSG = value.at("epsg").get<bool>();
+		metadata.bIsWKT = value.at("wkt").get<bool>();
+		metadata.nEpsgCode = value.at("epsg_code").get<int>();
+		metadata.dCenterLat = value.at("center").at(0).get<double>();
+		metadata.dCenterLon = value.at("center").at(1).get<double>();
+		metadata.dOffsetX = value.at("offset").at(0).get<double>();
+		metadata.dOffsetY = value.at("offset").at(1).get<double>();
+		metadata.dOffsetZ = value.at("offset").at(2).get<double>();
+
+		return metadata;
+	}
+
+} // anonymous namespace
+
+bool LazyTileConverter::RegisterDataset(const std::string& strDatasetId, const LazyDatasetSettings& settings,
+	IOutputSink* pSink)
+{
+	auto dataset = std::make_shared<Dataset>();
+	dataset->settings = settings;
+	if (pSink)
+	{
+		dataset->sink = pSink;
+	}
+	else
+	{
+		dataset->local_sink = std::make_unique<LocalFileSink>(false);
+		dataset->sink = dataset->local_sink.get();
+	}
+
+	bool bLoaded = LoadIndex(strDatasetId, *dataset);
+
+	{
+		std::lock_guard<std::mutex> lock(datasets_mutex);
+		datasets[strDatasetId] = dataset;
+	}
+
+	if (bLoaded)
+	{
+		LOG_I("延迟转换数据集 {}: 已载入节点索引 ({} 个B3DM)", strDatasetId, dataset->nodes.size());
+	}
+
+	return bLoaded;
+}
+
+bool LazyTileConverter::BuildTileset(const std::string& strDatasetId)
+{
+	std::shared_ptr<Dataset> dataset = FindDataset(strDatasetId);
+	if (!dataset)
+	{
+		LOG_E("延迟转换数据集未登记: {}", strDatasetId);
+		return false;
+	}
+
+	const LazyDatasetSettings& settings = dataset->settings;
+
+	std::unordered_map<std::string, TileNode> nodes;
+	std::mutex nodes_mutex;
+
+	// 续传跳过的瓦片不会登记节点，索引必须由完整的一次运行建立
+	OSGB23dTiles converter;
+	ResumeSettings resume;
+	resume.bEnable = false;
+	converter.SetResumeSettings(resume);
+	converter.SetLazyConversion(true,
+		[&](const std::string& strOutFile, const std::string& strOsgbPath, int nNodeType)
+		{
+			std::lock_guard<std::mutex> lock(nodes_mutex);
+			nodes[RelativePath(settings.strOutputDir, strOutFile)] = { strOutFile, strOsgbPath, nNodeType };
+		});
+
+	// 未指定输出目标时 tileset.json 与之后的 B3DM 一样同步写入本地
+	bool bOk = converter.ToB3DMBatch(settings.strDataDir, settings.strOutputDir,
+		settings.dCenterX, settings.dCenterY, settings.nMaxLevel,
+		settings.bEnableTextureCompress, settings.bEnableMeshOpt, settings.bEnableDraco,
+		dataset->local_sink ? nullptr : dataset->sink);
+	if (!bOk)
+	{
+		return false;
+	}
+
+	// 记录生成 tileset 时的坐标系统，按需转换的顶点与 tileset.json 使用同一坐标转换
+	OSGBMetadata metadata;
+	bool bHasMetadata = OSGB23dTiles::LoadDatasetMetadata(settings.strDataDir, metadata);
+	std::shared_ptr<const GeoTransform> geo_transform = MakeGeoTransform(bHasMetadata, metadata);
+
+	{
+		std::lock_guard<std::mutex> lock(dataset->nodes_mutex);
+		dataset->nodes.swap(nodes);
+		dataset->has_metadata = bHasMetadata;
+		dataset->metadata = metadata;
+		dataset->geo_transform = std::move(geo_transform);
+	}
+
+	SaveIndex(strDatasetId, *dataset);
+	LOG_I("延迟转换数据集 {}: tileset 已生成 ({} 个B3DM待按需转换)", strDatasetId, dataset->nodes.size());
+
+	return true;
+}
+
+bool LazyTileConverter::ConvertTile(const std::string& strDatasetId, const std::string& strTilePath, std::string& data)
+{
+	std::shared_ptr<Dataset> dataset = FindDataset(strDatasetId);
+	if (!dataset)
+	{
+		LOG_E("延迟转换数据集未登记: {}", strDatasetId);
+		return false;
+	}
+
+	std::string relative = RelativePath("", OSGBTools::OSGString(strTilePath));
+	std::string key = strDatasetId + "\n" + relative;
+
+	// 同一瓦片只有第一个请求执行转换，其余请求等待结果
+	std::shared_ptr<Flight> flight;
+	bool bLeader = false;
+	{
+		std::lock_guard<std::mutex> lock(flights_mutex);
+		auto it = flights.find(key);
+		if (it != flights.end())
+		{
+			flight = it->second;
+		}
+		else
+		{
+			flight = std::make_shared<Flight>();
+			flights.emplace(key, flight);
+			bLeader = true;
+		}
+	}
+
+	if (!bLeader)
+	{
+		// 锁内只取共享指针，数据在锁外复制
+		std::shared_ptr<const std::string> result;
+		{
+			std::unique_lock<std::mutex> lock(flights_mutex);
+			flights_cv.wait(lock, [&]() { return flight->done; });
+			if (!flight->ok)
+			{
+				return false;
+			}
+			result = flight->data;
+		}
+
+		data = *result;
+		return true;
+	}
+
+	// 转换抛出异常时同样结束等待，否则其余请求永远阻塞
+	bool bOk = false;
+	try
+	{
+		bOk = ReadOrConvert(*dataset, relative, data);
+	}
+	catch (...)
+	{
+		{
+			std::lock_guard<std::mutex> lock(flights_mutex);
+			flight->done = true;
+			flights.erase(key);
+		}
+		flights_cv.notify_all();
+		throw;
+	}
+
+	std::shared_ptr<const std::string> result = bOk ? std::make_shared<const std::string>(data) : nullptr;
+	{
+		std::lock_guard<std::mutex> lock(flights_mutex);
+		flight->ok = bOk;
+		flight->data = std::move(result);
+		flight->done = true;
+		flights.erase(key);
+	}
+	flights_cv.notify_all();
+
+	return bOk;
+}
+
+std::vector<uint8_t> LazyTileConverter::ConvertTileBuf(const std::string& strDatasetId, const std::string& strTilePath)
+{
+	std::string data;
+	if (!ConvertTile(strDatasetId, strTilePath, data))
+	{
+		return {};
+	}
+
+	return std::vector<uint8_t>(data.begin(), data.end());
+}
+
+size_t LazyTileConverter::GetTileCount(const std::string& strDatasetId) const
+{
+	std::shared_ptr<Dataset> dataset = FindDataset(strDatasetId);
+	if (!dataset)
+	{
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> lock(dataset->nodes_mutex);
+
+	return dataset->nodes.size();
+}
+
+bool LazyTileConverter::ReadOrConvert(Dataset& dataset, const std::string& strRelativePath, std::string& data)
+{
+	TileNode node;
+	std::shared_ptr<const GeoTransform> geo_transform;
+	{
+		std::lock_guard<std::mutex> lock(dataset.nodes_mutex);
+		auto it = dataset.nodes.find(strRelativePath);
+		if (it == dataset.nodes.end())
+		{
+			LOG_W("请求的瓦片不在节点索引中: {}", strRelativePath);
+			return false;
+		}
+		node = it->second;
+		geo_transform = dataset.geo_transform;
+	}
+
+	// 本地输出：已转换过的文件直接读取
+	if (dataset.local_sink && OSGBTools::ReadFile(node.out_file, data))
+	{
+		return true;
+	}
+
+	const LazyDatasetSettings& settings = dataset.settings;
+
+	OSGB23dTiles converter;
+	if (!converter.ToB3DMNode(node.osgb_path, node.node_type, data,
+		settings.bEnableTextureCompress, settings.bEnableMeshOpt, settings.bEnableDraco, geo_transform.get()))
+	{
+		LOG_E("按需转换失败: {}", node.osgb_path);
+		return false;
+	}
+	convert_count++;
+
+	// 持久化到输出目标，写入失败时本次请求仍返回转换结果
+	dataset.sink->MakeDirs(OSGBTools::GetParent(node.out_file));
+	dataset.sink->Write(node.out_file, data.data(), data.size());
+	if (!dataset.sink->Flush())
+	{
+		LOG_W("按需转换结果写入失败: {}", node.out_file);
+	}
+
+	return true;
+}
+
+std::shared_ptr<LazyTileConverter::Dataset> LazyTileConverter::FindDataset(const std::string& strDatasetId) const
+{
+	std::lock_guard<std::mutex> lock(datasets_mutex);
+
+	auto it = datasets.find(strDatasetId);
+	if (it == datasets.end())
+	{
+		return nullptr;
+	}
+
+	return it->second;
+}
+
+std::string LazyTileConverter::RelativePath(const std::string& strOutputDir, const std::string& strPath)
+{
+	std::string path = strPath;
+	std::replace(path.begin(), path.end(), '\\', '/');
+
+	std::string prefix = strOutputDir;
+	std::replace(prefix.begin(), prefix.end(), '\\', '/');
+	if (!prefix.empty() && path.compare(0, prefix.size(), prefix) == 0)
+	{
+		path = path.substr(prefix.size());
+	}
+
+	size_t nStart = path.find_first_not_of('/');
+
+	return nStart == std::string::npos ? "" : path.substr(nStart);
+}
+
+std::string LazyTileConverter::GetIndexPath(const std::string& strDatasetId, const Dataset& dataset) const
+{
+	if (!dataset.settings.strIndexPath.empty())
+	{
+		return dataset.settings.strIndexPath;
+	}
+
+	return OSGBTools::GetTempDirectory() + "/osgb-lazy-" +
+		ContentHash::Md5Hex(strDatasetId.data(), strDatasetId.size()) + ".json";
+}
+
+bool LazyTileConverter::LoadIndex(const std::string& strDatasetId, Dataset& dataset) const
+{
+	using nlohmann::json;
+
+	std::string strContent;
+	if (!OSGBTools::ReadFile(GetIndexPath(strDatasetId, dataset), strContent))
+	{
+		return false;
+	}
+
+	try
+	{
+		json index = json::parse(strContent);
+		if (index.value("version", 0) != kIndexVersion ||
+			index.value("data_dir", "") != OSGBTools::Utf8String(dataset.settings.strDataDir) ||
+			index.value("output_dir", "") != OSGBTools::Utf8String(dataset.settings.strOutputDir) ||
+			index.value("settings", "") != IndexSettingsKey(dataset.settings))
+		{
+			LOG_I("节点索引与数据集配置不一致，需要重新生成 tileset");
+			return false;
+		}
+
+		std::unordered_map<std::string, TileNode> nodes;
+		for (const auto& item : index.at("nodes").items())
+		{
+			const auto& value = item.value();
+			TileNode node;
+			node.out_file = OSGBTools::OSGString(value.at(0).get<std::string>());
+			node.osgb_path = OSGBTools::OSGString(value.at(1).get<std::string>());
+			node.node_type = value.at(2).get<int>();
+			nodes.emplace(OSGBTools::OSGString(item.key()), std::move(node));
+		}
+
+		OSGBMetadata metadata;
+		bool bHasMetadata = !index.at("metadata").is_null();
+		if (bHasMetadata)
+		{
+			metadata = MetadataFromJson(index.at("metadata"));
+		}
+		std::shared_ptr<const GeoTransform> geo_transform = MakeGeoTransform(bHasMetadata, metadata);
+
+		std::lock_guard<std::mutex> lock(dataset.nodes_mutex);
+		dataset.nodes.swap(nodes);
+		dataset.has_metadata = bHasMetadata;
+		dataset.metadata = metadata;
+		dataset.geo_transform = std::move(geo_transform);
+
+		return true;
+	}
+	catch (const std::exception& e)
+	{
+		LOG_W("节点索引解析失败: {}", e.what());
+		return false;
+	}
+}
+
+bool LazyTileConverter::SaveIndex(const std::string& strDatasetId, const Dataset& dataset) const
+{
+	using nlohmann::json;
+
+	std::string strContent;
+	{
+		std::lock_guard<std::mutex> lock(dataset.nodes_mutex);
+
+		// 路径以 UTF-8 保存（JSON 要求），读取时转换回本地编码
+		json nodes = json::object();
+		for (const auto& item : dataset.nodes)
+		{
+			nodes[OSGBTools::Utf8String(item.first)] = json::array({
+				OSGBTools::Utf8String(item.second.out_file),
+				OSGBTools::Utf8String(item.second.osgb_path),
+				item.second.node_type
+			});
+		}
+
+		json index = {
+			{"version", kIndexVersion},
+			{"data_dir", OSGBTools::Utf8String(dataset.settings.strDataDir)},
+			{"output_dir", OSGBTools::Utf8String(dataset.settings.strOutputDir)},
+			{"settings", IndexSettingsKey(dataset.settings)},
+			{"metadata", dataset.has_metadata ? MetadataToJson(dataset.metadata) : json()},
+			{"nodes", std::move(nodes)}
+		};
+
+		try
+		{
+			strContent = index.dump();
+		}
+		catch (const std::exception& e)
+		{
+			LOG_W("节点索引序列化失败: {}", e.what());
+			return false;
+		}
+	}
+
+	std::string strIndexPath = GetIndexPath(strDatasetId, dataset);
+	if (!OSGBTools::WriteFile(strIndexPath, strContent.data(), static_cast<unsigned long>(strContent.size())))
+	{
+		LOG_W("节点索引写入失败: {}", strIndexPath);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,186 @@
+#ifndef LAZY_TILE_CONVERTER_H
+#define LAZY_TILE_CONVERTER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "OSGB23dTiles.h"
+#include "GeoTransform.h"
+
+/**
+ * @brief 延迟转换数据集配置
+ */
+struct LazyDatasetSettings
+{
+	// 输入数据目录
+	std::string strDataDir;
+
+	// 输出目录（本地输出为完整路径；使用自定义输出目标时与批量转换的 strOutputDir 一致，通常为空）
+	std::string strOutputDir;
+
+	// 切片中心坐标（数据集有 metadata.xml 时以其为准）
+	double dCenterX = 0.0;
+	double dCenterY = 0.0;
+
+	// 最大切片层级
+	int nMaxLevel = 0;
+
+	bool bEnableTextureCompress = false;
+	bool bEnableMeshOpt = false;
+	bool bEnableDraco = false;
+
+	// 节点索引路径，为空时保存在临时目录（按数据集ID区分）
+	std::string strIndexPath;
+};
+
+/**
+ * @brief 按需转换器：先只生成 tileset，B3DM 在首次请求时转换
+ *
+ * BuildTileset 以延迟模式运行 ToB3DMBatch：只读取节点树、由顶点范围估算包围盒，
+ * 写出全部 tileset.json，并把每个 B3DM 的输出路径与源 OSGB 节点记录为索引（保存到本地，
+ * 进程重启后 RegisterDataset 直接载入；目录或转换参数变化后索引作废）。
+ * 索引同时记录生成 tileset 时的坐标系统（metadata.xml 的 SRS 与 SRSOrigin），
+ * 按需转换使用数据集自己的坐标转换，顶点与 tileset.json 的包围盒及根节点变换一致。
+ *
+ * ConvertTile 在首次请求某个 B3DM 时转换并写入输出目标；同一瓦片的并发请求只触发一次转换，
+ * 其余请求等待并共享结果。本地输出时已转换的文件直接从磁盘读取。
+ *
+ * @example
+ * LazyTileConverter converter;
+ * LazyDatasetSettings settings;
+ * settings.strDataDir = "E:/Data/3D";
+ * settings.strOutputDir = "E:/Tiles/3D";
+ * converter.RegisterDataset("city", settings);
+ * converter.BuildTileset("city");
+ * std::string b3dm;
+ * converter.ConvertTile("city", "Data/Tile_+000_+000/Tile_+000_+000_L16_0.b3dm", b3dm);
+ */
+class LazyTileConverter
+{
+public:
+	LazyTileConverter() = default;
+
+	LazyTileConverter(const LazyTileConverter&) = delete;
+	LazyTileConverter& operator=(const LazyTileConverter&) = delete;
+
+	/**
+	 * @brief 登记数据集，已有节点索引时载入
+	 * @param strDatasetId 数据集ID
+	 * @param settings 数据集配置
+	 * @param pSink 输出目标（调用方持有，生命周期须覆盖本对象），nullptr 表示同步写入本地输出目录
+	 * @return 节点索引已可用（无需 BuildTileset）返回 true
+	 */
+	bool RegisterDataset(const std::string& strDatasetId, const LazyDatasetSettings& settings,
+		IOutputSink* pSink = nullptr);
+
+	/**
+	 * @brief 生成数据集的全部 tileset.json 并建立节点索引（不转换 B3DM）
+	 * @return 是否成功
+	 */
+	bool BuildTileset(const std::string& strDatasetId);
+
+	/**
+	 * @brief 获取（必要时转换）一个 B3DM
+	 * @param strDatasetId 数据集ID
+	 * @param strTilePath 相对于输出目录的路径（如 "Data/Tile_+000_+000/Tile_+000_+000_L16_0.b3dm"）
+	 * @param data 输出的 B3DM 数据
+	 * @return 路径不在索引中或转换失败返回 false
+	 */
+	bool ConvertTile(const std::string& strDatasetId, const std::string& strTilePath, std::string& data);
+
+	/**
+	 * @brief 获取（必要时转换）一个 B3DM（供 C# 调用）
+	 * @return B3DM 数据，失败返回空数组
+	 */
+	std::vector<uint8_t> ConvertTileBuf(const std::string& strDatasetId, const std::string& strTilePath);
+
+	/**
+	 * @brief 数据集索引中的 B3DM 数量
+	 */
+	size_t GetTileCount(const std::string& strDatasetId) const;
+
+	/**
+	 * @brief 实际执行的转换次数（不含并发合并与磁盘命中）
+	 */
+	size_t GetConvertCount() const { return convert_count.load(); }
+
+private:
+	/**
+	 * @brief 索引中的一个 B3DM
+	 */
+	struct TileNode
+	{
+		// 输出路径（写入输出目标时使用）
+		std::string out_file;
+
+		// 源 OSGB 文件
+		std::string osgb_path;
+
+		// 节点类型
+		int node_type = 1;
+	};
+
+	/**
+	 * @brief 已登记的数据集
+	 */
+	struct Dataset
+	{
+		LazyDatasetSettings settings;
+		IOutputSink* sink = nullptr;
+
+		// 未指定输出目标时使用的同步本地输出
+		std::unique_ptr<IOutputSink> local_sink;
+
+		// 相对路径 -> 节点
+		std::unordered_map<std::string, TileNode> nodes;
+
+		// 生成 tileset 时的坐标系统（数据集没有 metadata.xml 时 has_metadata 为 false）
+		bool has_metadata = false;
+		OSGBMetadata metadata;
+
+		// 由 metadata 初始化的坐标转换，为空时不重投影
+		std::shared_ptr<const GeoTransform> geo_transform;
+
+		// 保护 nodes 与坐标系统
+		mutable std::mutex nodes_mutex;
+	};
+
+	/**
+	 * @brief 进行中的转换
+	 */
+	struct Flight
+	{
+		bool done = false;
+		bool ok = false;
+		std::shared_ptr<const std::string> data;
+	};
+
+	std::shared_ptr<Dataset> FindDataset(const std::string& strDatasetId) const;
+
+	// 相对于输出目录的规范化路径
+	static std::string RelativePath(const std::string& strOutputDir, const std::string& strPath);
+
+	std::string GetIndexPath(const std::string& strDatasetId, const Dataset& dataset) const;
+	bool LoadIndex(const std::string& strDatasetId, Dataset& dataset) const;
+	bool SaveIndex(const std::string& strDatasetId, const Dataset& dataset) const;
+
+	// 读取已转换的本地文件或执行转换并写入输出目标
+	bool ReadOrConvert(Dataset& dataset, const std::string& strRelativePath, std::string& data);
+
+	std::unordered_map<std::string, std::shared_ptr<Dataset>> datasets;
+	mutable std::mutex datasets_mutex;
+
+	std::unordered_map<std::string, std::shared_ptr<Flight>> flights;
+	std::mutex flights_mutex;
+	std::condition_variable flights_cv;
+
+	std::atomic<size_t> convert_count{ 0 };
+};
+
+#endif // LAZY_TILE_CONVERTER_H
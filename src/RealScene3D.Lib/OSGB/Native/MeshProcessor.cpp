@@ -26,6 +26,7 @@
 
 #include "MeshProcessor.h"
 #include "OSGBTools.h"
+#include "TraceRecorder.h"
 
 // KTX2压缩标志
 static bool m_bUseKtx2Compression = true;
@@ -109,6 +110,8 @@ static void WriteBuf(void* pContext, void* pData, int nlen)
 // 处理纹理的函数（KTX2压缩）
 bool MeshProcessor::ProcessTexture(osg::Texture* pTexture, std::vector<unsigned char>& imageData, std::string& strMimeType, bool bEnableTextureCompress)
 {
+	TraceScope trace("ProcessTexture", "texture");
+
 	if (nullptr == pTexture || pTexture->getNumImages() == 0)
 	{
 		OSGBLog::LOG_W("osg::Texture is null or NumImages == 0");
@@ -721,6 +724,8 @@ bool MeshProcessor::CompressMeshGeometry(
 		return false;
 	}
 
+	TraceScope trace("CompressMeshGeometry", "geometry");
+
 	// 获取顶点数组
 	osg::Vec3Array* vertexArray = dynamic_cast<osg::Vec3Array*>(pGeometry->getVertexArray());
 	if (!vertexArray || vertexArray->empty())
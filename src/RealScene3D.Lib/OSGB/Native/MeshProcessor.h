@@ -142,19 +142,19 @@ public:
 	 */
 	static bool ProcessTexture(osg::Texture* pTexture, std::vector<unsigned char>& imageData, std::string& strMimeType, bool bEnableTextureCompress = false);
 
-private:
 	/**
 	 * @brief 将RGBA图像数据压缩为KTX2格式
 	 * @param rgbaData 输入的RGBA图像数据
 	 * @param nWidth 图像宽度
 	 * @param nHeight 图像高度
 	 * @param ktx2Data 输出的KTX2压缩数据
-	 * @param nTexFormat 输出的KTX2格式
+	 * @param nTexFormat 输出的KTX2格式（basist::basis_tex_format，0 = ETC1S，1 = UASTC）
 	 * @return true=成功, false=失败
 	 */
 	static bool CompressToKtx2(const std::vector<unsigned char>& rgbaData, int nWidth, int nHeight,
 		std::vector<unsigned char>& ktx2Data, int  nTexFormat = 0);
 
+private:
 	/**
 	 * @brief 使用 meshoptimizer 优化和简化网格数据
 	 * @param vertices 输入/输出的顶点数据
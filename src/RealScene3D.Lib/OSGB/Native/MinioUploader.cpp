@@ -0,0 +1,541 @@
+#ifdef ENABLE_MINIO
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include <json.hpp>
+
+#include "ContentHash.h"
+#include "MinioUploader.h"
+#include "Precompressor.h"
+#include "TraceRecorder.h"
+
+using namespace OSGBLog;
+
+MinioUploader::MinioUploader(
+	const std::string& endpoint,
+	const std::string& accessKey,
+	const std::string& secretKey,
+	const std::string& bucket,
+	const std::string& prefix,
+	bool useSSL,
+	const MinioUploadSettings& uploadSettings)
+	: settings(uploadSettings)
+{
+	size_t nConnections = static_cast<size_t>(std::max(1, settings.nConnections));
+
+	// 每个连接持有独立的 minio::s3::Client，上传线程之间互不争用
+	for (size_t i = 0; i < nConnections; ++i)
+	{
+		auto client = std::make_unique<MinioClient>(endpoint, accessKey, secretKey, bucket, prefix, useSSL);
+		if (!client->IsValid())
+		{
+			LOG_E("MinIO连接池创建连接失败: index={}", i);
+			continue;
+		}
+
+		clients.emplace_back(std::move(client));
+	}
+
+	for (size_t i = 0; i < clients.size(); ++i)
+	{
+		workers.emplace_back(&MinioUploader::WorkerLoop, this, i);
+	}
+
+	if (UseManifest())
+	{
+		LoadManifest();
+	}
+
+	LOG_I("MinIO上传器已启动: connections={}, max_in_flight={}MB, max_retries={}, skip_unchanged={}, pack_threshold={}",
+		clients.size(), settings.nMaxInFlightBytes / (1024 * 1024), settings.nMaxRetries,
+		settings.bSkipUnchanged, settings.nPackThresholdBytes);
+}
+
+MinioUploader::~MinioUploader()
+{
+	Flush();
+
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		stopping = true;
+	}
+	task_cv.notify_all();
+
+	for (auto& worker : workers)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+}
+
+bool MinioUploader::IsValid() const
+{
+	return !clients.empty();
+}
+
+bool MinioUploader::MakeBucket()
+{
+	if (clients.empty())
+	{
+		return false;
+	}
+
+	return clients.front()->MakeBucket();
+}
+
+bool MinioUploader::Submit(const std::string& strObjectName, std::string&& data, const std::string& strContentEncoding)
+{
+	if (clients.empty())
+	{
+		LOG_E("MinIO上传器无可用连接，丢弃对象: {}", strObjectName);
+		return false;
+	}
+
+	UploadTask task;
+	task.object_name = strObjectName;
+	std::replace(task.object_name.begin(), task.object_name.end(), '\\', '/');
+	task.data = std::move(data);
+	task.content_encoding = strContentEncoding;
+
+	// tileset.json 需由客户端直接按路径访问，预压缩对象依赖 Content-Encoding 头，均不参与打包
+	const bool bIsJson = task.object_name.size() >= 5 &&
+		task.object_name.compare(task.object_name.size() - 5, 5, ".json") == 0;
+	if (settings.nPackThresholdBytes > 0 && !bIsJson && task.content_encoding.empty() &&
+		task.data.size() < settings.nPackThresholdBytes)
+	{
+		return AddToPack(task.object_name, std::move(task.data));
+	}
+
+	return Enqueue(std::move(task));
+}
+
+bool MinioUploader::Enqueue(UploadTask&& task)
+{
+	const size_t nSize = task.data.size();
+	{
+		std::unique_lock<std::mutex> lock(queue_mutex);
+
+		// 在途字节超限时阻塞；队列为空时总是放行，保证超大对象也能提交
+		space_cv.wait(lock, [&]()
+		{
+			return stopping || in_flight_bytes == 0 ||
+				in_flight_bytes + nSize <= settings.nMaxInFlightBytes;
+		});
+
+		if (stopping)
+		{
+			return false;
+		}
+
+		in_flight_bytes += nSize;
+		in_flight_tasks++;
+		task.seq = next_seq++;
+		in_flight_seqs.insert(task.seq);
+		queue.emplace_back(std::move(task));
+	}
+	task_cv.notify_one();
+
+	return true;
+}
+
+bool MinioUploader::Submit(const std::string& strObjectName, const char* pData, size_t nSize)
+{
+	return Submit(strObjectName, std::string(pData, nSize));
+}
+
+bool MinioUploader::Flush()
+{
+	// 未满额的打包缓冲区也需要封包上传
+	PendingPack pack;
+	{
+		std::lock_guard<std::mutex> lock(pack_mutex);
+		pack = std::move(current_pack);
+		current_pack = PendingPack();
+	}
+	if (!pack.entries.empty())
+	{
+		SealPack(std::move(pack));
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(queue_mutex);
+		space_cv.wait(lock, [&]() { return in_flight_tasks == 0; });
+
+		// 失败已计入 failed_since_flush，由本次 Flush 报告
+		failed_seqs.clear();
+	}
+
+	size_t nFailed = failed_since_flush.exchange(0);
+	if (nFailed > 0)
+	{
+		LOG_E("MinIO上传完成，但有 {} 个对象上传失败", nFailed);
+		return false;
+	}
+
+	// 出现过失败的上传器不再写回清单（本次清单作废），下次运行仍按上次的清单比对
+	if (failed_count > 0)
+	{
+		return true;
+	}
+
+	if (UseManifest() && !SaveManifest())
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool MinioUploader::Barrier()
+{
+	// 屏障前进入打包缓冲区的小对象须封包上传后才能确认
+	PendingPack pack;
+	{
+		std::lock_guard<std::mutex> lock(pack_mutex);
+		pack = std::move(current_pack);
+		current_pack = PendingPack();
+	}
+	if (!pack.entries.empty())
+	{
+		SealPack(std::move(pack));
+	}
+
+	// 只等待序号在屏障之前的任务，其他线程之后提交的任务不影响本次等待
+	size_t nFailed = 0;
+	{
+		std::unique_lock<std::mutex> lock(queue_mutex);
+		const uint64_t nTicket = next_seq;
+		space_cv.wait(lock, [&]() { return in_flight_seqs.empty() || *in_flight_seqs.begin() >= nTicket; });
+
+		auto it = std::remove_if(failed_seqs.begin(), failed_seqs.end(),
+			[&](uint64_t nSeq) { return nSeq < nTicket; });
+		nFailed = static_cast<size_t>(failed_seqs.end() - it);
+		failed_seqs.erase(it, failed_seqs.end());
+	}
+
+	if (nFailed > 0)
+	{
+		LOG_W("检查点之前提交的对象中有 {} 个上传失败", nFailed);
+		return false;
+	}
+
+	bool bPacksRegistered = false;
+	{
+		std::lock_guard<std::mutex> lock(manifest_mutex);
+		std::swap(bPacksRegistered, packs_registered);
+	}
+	if (!bPacksRegistered)
+	{
+		return true;
+	}
+
+	// 出现过失败后清单不再写回，打包的小对象无法定位，不能确认
+	return failed_count == 0 && SaveManifest();
+}
+
+bool MinioUploader::AddToPack(const std::string& strObjectName, std::string&& data)
+{
+	const std::string strMd5 = ContentHash::Md5Hex(data.data(), data.size());
+
+	// 内容未变化且旧打包对象仍在：沿用旧条目
+	if (settings.bSkipUnchanged)
+	{
+		auto it = previous_manifest.find(strObjectName);
+		if (it != previous_manifest.end() && it->second.md5 == strMd5 && !it->second.pack.empty())
+		{
+			{
+				std::lock_guard<std::mutex> lock(manifest_mutex);
+				current_manifest[strObjectName] = it->second;
+			}
+			skipped_count++;
+			return true;
+		}
+	}
+
+	PendingPack sealed;
+	{
+		std::lock_guard<std::mutex> lock(pack_mutex);
+
+		ManifestEntry entry;
+		entry.md5 = strMd5;
+		entry.offset = current_pack.data.size();
+		entry.size = data.size();
+		current_pack.data.append(data);
+		current_pack.entries.emplace_back(strObjectName, std::move(entry));
+		packed_count++;
+
+		if (current_pack.data.size() < settings.nPackTargetBytes)
+		{
+			return true;
+		}
+
+		sealed = std::move(current_pack);
+		current_pack = PendingPack();
+	}
+
+	return SealPack(std::move(sealed));
+}
+
+bool MinioUploader::SealPack(PendingPack&& pack)
+{
+	const std::string strPackName = "packs/" + ContentHash::Md5Hex(pack.data.data(), pack.data.size()) + ".bin";
+
+	for (auto& item : pack.entries)
+	{
+		item.second.pack = strPackName;
+	}
+
+	// 以内容命名的打包对象已存在时无需重复上传，条目可直接登记
+	if (previous_packs.count(strPackName) > 0)
+	{
+		RegisterEntries(pack.entries);
+		skipped_count++;
+		return true;
+	}
+
+	UploadTask task;
+	task.object_name = strPackName;
+	task.data = std::move(pack.data);
+	task.is_pack = true;
+	task.pack_entries = std::move(pack.entries);
+
+	return Enqueue(std::move(task));
+}
+
+void MinioUploader::RegisterEntries(const std::vector<std::pair<std::string, ManifestEntry>>& entries)
+{
+	if (entries.empty())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(manifest_mutex);
+	for (const auto& item : entries)
+	{
+		current_manifest[item.first] = item.second;
+	}
+	manifest_dirty = true;
+	packs_registered = true;
+}
+
+bool MinioUploader::IsUnchanged(MinioClient& client, const UploadTask& task, const std::string& strMd5)
+{
+	auto it = previous_manifest.find(task.object_name);
+	if (it != previous_manifest.end())
+	{
+		return it->second.pack.empty() && it->second.md5 == strMd5;
+	}
+
+	if (!settings.bCompareETag)
+	{
+		return false;
+	}
+
+	// 清单中没有记录（如首次启用清单）：以服务器ETag比对，分段上传的ETag不是MD5，自然判为变化
+	std::string strETag;
+	size_t nRemoteSize = 0;
+	if (!client.Stat(task.object_name, strETag, nRemoteSize))
+	{
+		return false;
+	}
+
+	return nRemoteSize == task.data.size() && ContentHash::NormalizeETag(strETag) == strMd5;
+}
+
+void MinioUploader::LoadManifest()
+{
+	using nlohmann::json;
+
+	std::string strContent;
+	if (!clients.front()->Read(kManifestObjectName, strContent))
+	{
+		LOG_I("未找到上传清单，将全量上传");
+		return;
+	}
+
+	try
+	{
+		json manifest = json::parse(strContent);
+		for (auto& item : manifest.at("objects").items())
+		{
+			ManifestEntry entry;
+			entry.md5 = item.value().value("md5", "");
+			entry.pack = item.value().value("pack", "");
+			entry.offset = item.value().value("offset", 0ull);
+			entry.size = item.value().value("size", 0ull);
+
+			if (!entry.pack.empty())
+			{
+				previous_packs.insert(entry.pack);
+			}
+			previous_manifest.emplace(item.key(), std::move(entry));
+		}
+
+		// 上次未变化的条目原样保留，新上传的条目覆盖
+		current_manifest = previous_manifest;
+		LOG_I("已加载上传清单: {} 个对象", previous_manifest.size());
+	}
+	catch (const std::exception& e)
+	{
+		LOG_W("上传清单解析失败，将全量上传: {}", e.what());
+		previous_manifest.clear();
+		previous_packs.clear();
+	}
+}
+
+bool MinioUploader::SaveManifest()
+{
+	using nlohmann::json;
+
+	std::string strContent;
+	{
+		std::lock_guard<std::mutex> lock(manifest_mutex);
+		if (!manifest_dirty)
+		{
+			return true;
+		}
+
+		json objects = json::object();
+		for (const auto& item : current_manifest)
+		{
+			json entry = { {"md5", item.second.md5} };
+			if (!item.second.pack.empty())
+			{
+				entry["pack"] = item.second.pack;
+				entry["offset"] = item.second.offset;
+				entry["size"] = item.second.size;
+			}
+			objects[item.first] = std::move(entry);
+		}
+
+		strContent = json({ {"version", 1}, {"objects", std::move(objects)} }).dump();
+		manifest_dirty = false;
+	}
+
+	std::string strError;
+	if (!clients.front()->Write(kManifestObjectName, strContent.data(), strContent.size(), &strError))
+	{
+		LOG_E("上传清单写入失败: {}", strError);
+		std::lock_guard<std::mutex> lock(manifest_mutex);
+		manifest_dirty = true;
+		return false;
+	}
+
+	return true;
+}
+
+void MinioUploader::WorkerLoop(size_t nIndex)
+{
+	MinioClient& client = *clients[nIndex];
+
+	while (true)
+	{
+		UploadTask task;
+		{
+			std::unique_lock<std::mutex> lock(queue_mutex);
+			task_cv.wait(lock, [&]() { return stopping || !queue.empty(); });
+
+			if (queue.empty())
+			{
+				// stopping 且队列已清空
+				return;
+			}
+
+			task = std::move(queue.front());
+			queue.pop_front();
+		}
+
+		const size_t nSize = task.data.size();
+
+		// 打包对象以内容命名，其条目在封包时已登记
+		std::string strMd5;
+		if (UseManifest() && !task.is_pack)
+		{
+			strMd5 = ContentHash::Md5Hex(task.data.data(), task.data.size());
+		}
+
+		bool bSucceeded = false;
+		if (settings.bSkipUnchanged && !task.is_pack && IsUnchanged(client, task, strMd5))
+		{
+			skipped_count++;
+			bSucceeded = true;
+		}
+		else if (PutWithRetry(client, task))
+		{
+			uploaded_count++;
+			uploaded_bytes += nSize;
+			bSucceeded = true;
+		}
+		else
+		{
+			failed_count++;
+			failed_since_flush++;
+		}
+
+		// 上传成功后才登记清单条目，失败的对象（含打包对象中的小对象）下次仍会上传
+		if (bSucceeded && !strMd5.empty())
+		{
+			ManifestEntry entry;
+			entry.md5 = std::move(strMd5);
+
+			std::lock_guard<std::mutex> lock(manifest_mutex);
+			current_manifest[task.object_name] = std::move(entry);
+			manifest_dirty = true;
+		}
+		else if (bSucceeded && task.is_pack)
+		{
+			RegisterEntries(task.pack_entries);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(queue_mutex);
+			in_flight_bytes -= nSize;
+			in_flight_tasks--;
+			in_flight_seqs.erase(task.seq);
+			if (!bSucceeded)
+			{
+				failed_seqs.push_back(task.seq);
+			}
+		}
+		space_cv.notify_all();
+	}
+}
+
+bool MinioUploader::PutWithRetry(MinioClient& client, const UploadTask& task)
+{
+	TraceScope trace("MinioUpload", "io", task.object_name);
+
+	thread_local std::mt19937 rng(std::random_device{}());
+
+	std::string strError;
+	const int nMaxAttempts = std::max(0, settings.nMaxRetries) + 1;
+	for (int nAttempt = 0; nAttempt < nMaxAttempts; ++nAttempt)
+	{
+		if (nAttempt > 0)
+		{
+			// 指数退避 + 随机抖动，避免所有线程同时重试
+			const int nBase = std::max(1, settings.nRetryBaseDelayMs);
+			const int nDelay = nBase * (1 << std::min(nAttempt - 1, 10)) +
+				std::uniform_int_distribution<int>(0, nBase)(rng);
+
+			LOG_W("MinIO上传重试 {}/{}: {} ({}ms后)", nAttempt, nMaxAttempts - 1, task.object_name, nDelay);
+			std::this_thread::sleep_for(std::chrono::milliseconds(nDelay));
+		}
+
+		if (client.Write(task.object_name, task.data.data(), task.data.size(), &strError,
+			task.content_encoding, Precompressor::ContentTypeFor(task.object_name)))
+		{
+			return true;
+		}
+	}
+
+	LOG_E("MinIO上传失败（已重试{}次）: {}", nMaxAttempts - 1, strError);
+
+	return false;
+}
+
+#endif // ENABLE_MINIO
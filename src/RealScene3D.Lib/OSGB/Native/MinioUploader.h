@@ -0,0 +1,281 @@
+#ifndef MINIO_UPLOADER_H
+#define MINIO_UPLOADER_H
+
+#ifdef ENABLE_MINIO
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "OSGBTools.h"
+
+/**
+ * @brief MinIO上传配置
+ */
+struct MinioUploadSettings
+{
+	// 连接池大小（每个连接对应一个上传线程和独立的 minio::s3::Client）
+	int nConnections = 8;
+
+	// 在途字节上限（排队 + 正在上传），超过后 Submit 阻塞，防止内存无限增长
+	size_t nMaxInFlightBytes = 256ull * 1024 * 1024;
+
+	// 单个对象失败后的最大重试次数
+	int nMaxRetries = 3;
+
+	// 重试退避基准时间（毫秒），第 n 次重试等待 base * 2^n + 随机抖动
+	int nRetryBaseDelayMs = 200;
+
+	// 跳过内容未变化的对象：与上次上传清单中的MD5比对，相同则不再上传
+	bool bSkipUnchanged = false;
+
+	// 清单中没有记录的对象，是否通过 StatObject 比对服务器ETag（每个对象一次HEAD请求）
+	bool bCompareETag = false;
+
+	// 小对象打包阈值（字节）：小于该值的非JSON对象合并写入打包对象，0 表示不打包
+	// 被打包的对象只能经清单定位，tileset.json 按独立路径引用瓦片，批量转换不启用
+	size_t nPackThresholdBytes = 0;
+
+	// 打包对象的目标大小（字节），达到后封包上传
+	size_t nPackTargetBytes = 16ull * 1024 * 1024;
+};
+
+/**
+ * @brief MinIO并发上传器
+ *
+ * 转换线程通过 Submit 移交缓冲区后立即返回，由独立的连接池线程负责上传。
+ * 排队与上传中的数据总量受 nMaxInFlightBytes 约束，失败对象按指数退避重试。
+ * 上传时直接以缓冲区作为输入流（MemoryStreamBuf），不再复制到 stringstream。
+ *
+ * 启用 bSkipUnchanged 或打包时，上传器在前缀下维护清单对象 .upload-manifest.json：
+ * {"objects": {"<name>": {"md5": "...", "pack": "packs/<md5>.bin", "offset": n, "size": n}}}
+ * 内容MD5与清单一致的对象直接跳过；被打包的小对象记录其所在打包对象及字节范围，
+ * 服务端据此以 Range 请求读取。打包对象以内容MD5命名，重复切片不会覆盖仍被引用的旧包。
+ *
+ * @example
+ * MinioUploader uploader(endpoint, ak, sk, "slices", "job_1");
+ * uploader.Submit("Data/Tile_0/Tile_0.b3dm", std::move(b3dm_buf));
+ * bool ok = uploader.Flush();  // 等待全部上传完成
+ */
+class MinioUploader
+{
+public:
+	MinioUploader(const std::string& endpoint,
+		const std::string& accessKey,
+		const std::string& secretKey,
+		const std::string& bucket,
+		const std::string& prefix = "",
+		bool useSSL = false,
+		const MinioUploadSettings& settings = MinioUploadSettings());
+
+	// 析构时等待队列清空并停止上传线程
+	~MinioUploader();
+
+	MinioUploader(const MinioUploader&) = delete;
+	MinioUploader& operator=(const MinioUploader&) = delete;
+
+	/**
+	 * @brief 连接池是否可用（至少有一个有效连接）
+	 */
+	bool IsValid() const;
+
+	/**
+	 * @brief 确保 Bucket 存在
+	 */
+	bool MakeBucket();
+
+	/**
+	 * @brief 提交上传任务，缓冲区所有权移交给上传器
+	 * @param strObjectName 对象名（相对于前缀，'\\' 会被替换为 '/'）
+	 * @param data 对象数据
+	 * @param strContentEncoding 数据的 Content-Encoding（已预压缩时设置，此类对象不参与打包）
+	 * @return 任务是否入队（上传结果通过 Flush 汇总）
+	 * @note 在途字节超过上限时阻塞，直到有任务完成
+	 */
+	bool Submit(const std::string& strObjectName, std::string&& data, const std::string& strContentEncoding = "");
+
+	/**
+	 * @brief 提交上传任务（复制缓冲区）
+	 */
+	bool Submit(const std::string& strObjectName, const char* pData, size_t nSize);
+
+	/**
+	 * @brief 等待所有已提交任务完成
+	 * @return 自上次 Flush 以来没有失败对象返回 true
+	 */
+	bool Flush();
+
+	/**
+	 * @brief 检查点屏障：只等待调用前已提交的对象上传完成（不等待其他线程之后提交的对象）
+	 *
+	 * 打包缓冲区中的小对象先封包上传；有新登记的打包条目时写回清单（小对象须经清单定位），
+	 * 只启用跳过未变化对象时不写清单。
+	 * @return 屏障前提交的对象（自上次 Barrier 以来）没有失败返回 true
+	 */
+	bool Barrier();
+
+	// 已成功上传的对象数
+	size_t GetUploadedCount() const { return uploaded_count.load(); }
+
+	// 已成功上传的字节数
+	size_t GetUploadedBytes() const { return uploaded_bytes.load(); }
+
+	// 最终失败（重试耗尽）的对象数
+	size_t GetFailedCount() const { return failed_count.load(); }
+
+	// 内容未变化而跳过的对象数
+	size_t GetSkippedCount() const { return skipped_count.load(); }
+
+	// 写入打包对象的小对象数
+	size_t GetPackedCount() const { return packed_count.load(); }
+
+	// 清单对象名（相对于前缀）
+	static constexpr const char* kManifestObjectName = ".upload-manifest.json";
+
+private:
+	/**
+	 * @brief 清单条目
+	 */
+	struct ManifestEntry
+	{
+		// 内容MD5（小写十六进制）
+		std::string md5;
+
+		// 所在打包对象名，空表示独立对象
+		std::string pack;
+
+		// 在打包对象中的偏移与长度
+		uint64_t offset = 0;
+		uint64_t size = 0;
+	};
+
+	/**
+	 * @brief 上传任务
+	 */
+	struct UploadTask
+	{
+		// 对象名
+		std::string object_name;
+
+		// 对象数据
+		std::string data;
+
+		// 是否为打包对象（以内容命名，本身不写入清单条目）
+		bool is_pack = false;
+
+		// 打包对象包含的小对象条目，上传成功后才登记到清单
+		std::vector<std::pair<std::string, ManifestEntry>> pack_entries;
+
+		// Content-Encoding（预压缩对象）
+		std::string content_encoding;
+
+		// 提交序号（Barrier 据此判断任务是否在屏障之前）
+		uint64_t seq = 0;
+	};
+
+	/**
+	 * @brief 正在累积的打包缓冲区
+	 */
+	struct PendingPack
+	{
+		std::string data;
+		std::vector<std::pair<std::string, ManifestEntry>> entries;
+	};
+
+	// 任务入队（在途字节受限）
+	bool Enqueue(UploadTask&& task);
+
+	// 把小对象追加到当前打包缓冲区，满额时封包
+	bool AddToPack(const std::string& strObjectName, std::string&& data);
+
+	// 封包：以内容MD5命名并提交上传，条目在上传成功后登记
+	bool SealPack(PendingPack&& pack);
+
+	// 登记清单条目（对象已确认在服务器上）
+	void RegisterEntries(const std::vector<std::pair<std::string, ManifestEntry>>& entries);
+
+	// 判断对象是否与上次上传内容一致
+	bool IsUnchanged(MinioClient& client, const UploadTask& task, const std::string& strMd5);
+
+	// 读取上次的清单
+	void LoadManifest();
+
+	// 写回清单（仅在有变化时）
+	bool SaveManifest();
+
+	// 是否需要维护清单
+	bool UseManifest() const
+	{
+		return settings.bSkipUnchanged || settings.nPackThresholdBytes > 0;
+	}
+
+	// 上传线程主循环，nIndex 为所使用的连接序号
+	void WorkerLoop(size_t nIndex);
+
+	// 带退避重试地上传单个对象
+	bool PutWithRetry(MinioClient& client, const UploadTask& task);
+
+	MinioUploadSettings settings;
+
+	// 连接池（与上传线程一一对应）
+	std::vector<std::unique_ptr<MinioClient>> clients;
+	std::vector<std::thread> workers;
+
+	std::deque<UploadTask> queue;
+	std::mutex queue_mutex;
+
+	// 有新任务或停止信号
+	std::condition_variable task_cv;
+
+	// 在途字节下降或任务全部完成
+	std::condition_variable space_cv;
+
+	// 排队与上传中的字节数、任务数
+	size_t in_flight_bytes = 0;
+	size_t in_flight_tasks = 0;
+	bool stopping = false;
+
+	// 下一个提交序号、排队与上传中任务的序号、尚未被 Barrier 报告的失败任务序号
+	uint64_t next_seq = 1;
+	std::set<uint64_t> in_flight_seqs;
+	std::vector<uint64_t> failed_seqs;
+
+	// 统计
+	std::atomic<size_t> uploaded_count{ 0 };
+	std::atomic<size_t> uploaded_bytes{ 0 };
+	std::atomic<size_t> failed_count{ 0 };
+
+	std::atomic<size_t> skipped_count{ 0 };
+	std::atomic<size_t> packed_count{ 0 };
+
+	// 自上次 Flush 以来的失败数（出现过失败后本次清单作废，见 failed_count）
+	std::atomic<size_t> failed_since_flush{ 0 };
+
+	// 上次上传的清单（构造后只读）与已存在的打包对象
+	std::unordered_map<std::string, ManifestEntry> previous_manifest;
+	std::unordered_set<std::string> previous_packs;
+
+	// 本次上传成功（或确认未变化）的清单条目
+	std::unordered_map<std::string, ManifestEntry> current_manifest;
+	std::mutex manifest_mutex;
+	bool manifest_dirty = false;
+
+	// 上次 Barrier 以来是否登记过打包条目
+	bool packs_registered = false;
+
+	// 当前打包缓冲区
+	PendingPack current_pack;
+	std::mutex pack_mutex;
+};
+
+#endif // ENABLE_MINIO
+
+#endif // MINIO_UPLOADER_H
@@ -0,0 +1,76 @@
+#ifndef NATIVE_BUFFER_H
+#define NATIVE_BUFFER_H
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+/**
+ * @brief 交给C#的原生缓冲区句柄
+ *
+ * 转换结果留在原生内存中，C# 通过 GetData / GetSize 以 IntPtr 直接访问
+ * （包装为 ReadOnlySpan 或 UnmanagedMemoryStream），或先查询大小再用 CopyTo
+ * 一次复制到调用方固定（pinned）的缓冲区，避免逐元素封送。
+ * 句柄由C#持有，Dispose 后数据地址失效。
+ * 数据可与 GLB 缓存共享（只读），创建句柄时不复制。
+ *
+ * @example
+ * using (NativeBuffer glb = helper.ConvertToGlbHandle(path))
+ * {
+ *     ReadOnlySpan<byte> span = glb.AsSpan();
+ * }
+ */
+class NativeBuffer
+{
+public:
+	NativeBuffer() = default;
+
+	explicit NativeBuffer(std::string&& data)
+		: data(std::make_shared<const std::string>(std::move(data)))
+	{
+	}
+
+	explicit NativeBuffer(std::shared_ptr<const std::string> data)
+		: data(std::move(data))
+	{
+	}
+
+	NativeBuffer(const NativeBuffer&) = delete;
+	NativeBuffer& operator=(const NativeBuffer&) = delete;
+
+	/**
+	 * @brief 数据地址（空缓冲区返回 nullptr）
+	 */
+	const void* GetData() const { return (!data || data->empty()) ? nullptr : data->data(); }
+
+	/**
+	 * @brief 数据大小（字节）
+	 */
+	long long GetSize() const { return data ? static_cast<long long>(data->size()) : 0; }
+
+	/**
+	 * @brief 复制到调用方提供的缓冲区
+	 * @param pDest 目标地址（C# 侧须已固定）
+	 * @param nCapacity 目标缓冲区大小
+	 * @return 缓冲区不足返回 false
+	 */
+	bool CopyTo(void* pDest, long long nCapacity) const
+	{
+		if (!pDest || nCapacity < GetSize())
+		{
+			return false;
+		}
+
+		if (GetSize() > 0)
+		{
+			std::memcpy(pDest, data->data(), data->size());
+		}
+
+		return true;
+	}
+
+private:
+	std::shared_ptr<const std::string> data;
+};
+
+#endif // NATIVE_BUFFER_H
@@ -3,8 +3,13 @@
 // 将 OSGB (OpenSceneGraph Binary) 文件转换为 GLB 和 3D Tiles 格式
 // ============================================================================
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <cstdlib>
+#include <filesystem>
 #include <limits>
+#include <mutex>
 
 #include <Eigen/Eigen>
 
@@ -27,11 +32,22 @@
 #include "OSGBTools.h"
 #include "MeshProcessor.h"
 #include "GeoTransform.h"
+#include "TileArchiveWriter.h"
+#include "FilePrefetcher.h"
+#include "ZipFileSystem.h"
+#include "DatasetScanner.h"
+#include "BatchJournal.h"
+#include "GlbCache.h"
+#include "JobScheduler.h"
+#include "AsyncLog.h"
+
+#include <osg/ComputeBoundsVisitor>
+#include <osgDB/FileNameUtils>
+#include <osgDB/Registry>
 
 // USE_OSGPLUGIN 在 Linux/macOS 上需要用于静态插件注册
 // 在 Windows 上使用动态链接，插件在运行时加载
 #if defined(__unix__) || defined(__APPLE__)
-#include <osgDB/Registry>
 USE_OSGPLUGIN(osg)
 #endif
 
@@ -56,10 +72,10 @@ void InfoVisitor::apply(osg::Geometry& geometry)
 		other_geometry_array.emplace_back(&geometry);
 	}
 
-	if (GeoTransform::projTransform)
+	if (geo_transform && geo_transform->IsInitialized())
 	{
+		auto reproject_start = std::chrono::steady_clock::now();
 		osg::ref_ptr<osg::Vec3Array> vertexArr = (osg::Vec3Array*)geometry.getVertexArray();
-		PJ* transform = GeoTransform::projTransform.get();
 
 		glm::dvec3 Min = glm::dvec3(DBL_MAX);
 		glm::dvec3 Max = glm::dvec3(-DBL_MAX);
@@ -71,51 +87,6 @@ void InfoVisitor::apply(osg::Geometry& geometry)
 			Max = glm::max(vertex, Max);
 		}
 
-		auto Correction = [&](glm::dvec3 Point)
-		{
-			if (GeoTransform::IsENU)
-			{
-				glm::dvec3 absoluteENU = Point + glm::dvec3(GeoTransform::OriginX, GeoTransform::OriginY, GeoTransform::OriginZ);
-				glm::dvec3 ecef = GeoTransform::CartographicToEcef(GeoTransform::GeoOriginLon, GeoTransform::GeoOriginLat, GeoTransform::GeoOriginHeight);
-
-				const double pi = std::acos(-1.0);
-				double lat = GeoTransform::GeoOriginLat * pi / 180.0;
-				double lon = GeoTransform::GeoOriginLon * pi / 180.0;
-				double sinLat = std::sin(lat), cosLat = std::cos(lat);
-				double sinLon = std::sin(lon), cosLon = std::cos(lon);
-
-				double ecef_x = -sinLon * absoluteENU.x - sinLat * cosLon * absoluteENU.y + cosLat * cosLon * absoluteENU.z;
-				double ecef_y = cosLon * absoluteENU.x - sinLat * sinLon * absoluteENU.y + cosLat * sinLon * absoluteENU.z;
-				double ecef_z = cosLat * absoluteENU.y + sinLat * absoluteENU.z;
-				ecef = glm::dvec3(ecef.x + ecef_x, ecef.y + ecef_y, ecef.z + ecef_z);
-				glm::dvec3 enu = GeoTransform::EcefToEnuMatrix * glm::dvec4(ecef, 1);
-
-				return enu;
-			}
-			else
-			{
-				glm::dvec3 cartographic = Point + glm::dvec3(GeoTransform::OriginX, GeoTransform::OriginY, GeoTransform::OriginZ);
-
-				PJ_COORD coord;
-				coord.xyzt.x = cartographic.x;
-				coord.xyzt.y = cartographic.y;
-				coord.xyzt.z = cartographic.z;
-				coord.xyzt.t = HUGE_VAL;
-
-				PJ_COORD result = proj_trans((PJ*)transform, PJ_FWD, coord);
-				if (result.xyzt.x != HUGE_VAL)
-				{
-					cartographic.x = result.xyzt.x;
-					cartographic.y = result.xyzt.y;
-					cartographic.z = result.xyzt.z;
-				}
-
-				glm::dvec3 ecef = GeoTransform::CartographicToEcef(cartographic.x, cartographic.y, cartographic.z);
-				glm::dvec3 enu = GeoTransform::EcefToEnuMatrix * glm::dvec4(ecef, 1);
-
-				return enu;
-			}};
-
 		vector<glm::dvec4> OriginalPoints(8);
 		vector<glm::dvec4> CorrectedPoints(8);
 
@@ -130,7 +101,7 @@ void InfoVisitor::apply(osg::Geometry& geometry)
 
 		for (int i = 0; i < 8; i++)
 		{
-			CorrectedPoints[i] = glm::dvec4(Correction(OriginalPoints[i]), 1);
+			CorrectedPoints[i] = glm::dvec4(geo_transform->ToLocalEnu(glm::dvec3(OriginalPoints[i])), 1);
 		}
 
 		Eigen::MatrixXd A, B;
@@ -161,6 +132,9 @@ void InfoVisitor::apply(osg::Geometry& geometry)
 			Vertex = osg::Vec3d(v.x, v.y, v.z);
 			vertexArr->at(VertexIndex) = Vertex;
 		}
+
+		reproject_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - reproject_start).count();
 	}
 
 	if (auto state = geometry.getStateSet())
@@ -200,6 +174,7 @@ void InfoVisitor::apply(osg::PagedLOD& node)
 	{
 		std::string file_name = path + "/" + node.getFileName(i);
 		sub_node_names.emplace_back(file_name);
+		sub_node_bounds.emplace_back(node.getBound());
 	}
 
 	if (!is_loadAllType)
@@ -236,2010 +211,3443 @@ void WriteBuf(void* context, void* data, int len)
 	buf->insert(buf->end(), (char*)data, (char*)data + len);
 }
 
-template<class T>
-void AlignmentBuffer(std::vector<T>& buf)
+/**
+ * @brief 压缩包内外部纹理的读取回调
+ *
+ * OSGB 引用的外部图片按数据库路径查找，压缩包内的路径 OSG 无法直接打开，
+ * 这里在数据库路径中查找压缩包条目并通过插件的流接口读取，其余情况交给原回调。
+ */
+class ZipReadFileCallback : public osgDB::ReadFileCallback
 {
-	while (buf.size() % 4 != 0)
+public:
+	explicit ZipReadFileCallback(osgDB::ReadFileCallback* pPrevious) : previous(pPrevious) {}
+
+	osgDB::ReaderWriter::ReadResult readImage(const std::string& filename, const osgDB::Options* options) override
 	{
-		buf.emplace_back(0x00);
+		std::vector<std::string> candidates = { filename };
+		if (options)
+		{
+			for (const auto& dir : options->getDatabasePathList())
+			{
+				candidates.emplace_back(dir + "/" + filename);
+			}
+		}
+
+		for (const auto& candidate : candidates)
+		{
+			std::string entry;
+			auto zip = ZipFileSystem::Resolve(candidate, entry);
+			std::string data;
+			if (!zip || !zip->IsRegularFile(entry) || !zip->ReadFile(entry, data))
+			{
+				continue;
+			}
+
+			osgDB::ReaderWriter* rw = osgDB::Registry::instance()->getReaderWriterForExtension(
+				osgDB::getLowerCaseFileExtension(candidate));
+			if (rw == nullptr)
+			{
+				break;
+			}
+
+			MemoryStreamBuf buf(data.data(), data.size());
+			std::istream stream(&buf);
+			return rw->readImage(stream, options);
+		}
+
+		return previous.valid() ? previous->readImage(filename, options) :
+			osgDB::ReadFileCallback::readImage(filename, options);
 	}
-}
 
-void ExpandBbox3d(osg::Vec3f& point_max, osg::Vec3f& point_min, osg::Vec3f point)
-{
-	point_max.x() = std::max(point.x(), point_max.x());
-	point_min.x() = std::min(point.x(), point_min.x());
-	point_max.y() = std::max(point.y(), point_max.y());
-	point_min.y() = std::min(point.y(), point_min.y());
-	point_max.z() = std::max(point.z(), point_max.z());
-	point_min.z() = std::min(point.z(), point_min.z());
-}
+private:
+	osg::ref_ptr<osgDB::ReadFileCallback> previous;
+};
 
-void ExpandBbox2d(osg::Vec2f& point_max, osg::Vec2f& point_min, osg::Vec2f point)
+/**
+ * @brief 读取OSG节点，优先使用预读器中的内存数据
+ *
+ * 命中预读或位于ZIP压缩包内时通过插件的流接口从内存反序列化，数据库路径设为文件所在目录，
+ * 外部纹理等相对引用与按文件名读取时一致；其余情况回退到 osgDB::readNodeFiles。
+ * 指定统计时记录读取耗时与文件字节数。
+ */
+osg::ref_ptr<osg::Node> ReadOsgNode(const std::string& path, FilePrefetcher* pPrefetcher,
+	ConversionMetrics* pMetrics = nullptr)
 {
-	point_max.x() = std::max(point.x(), point_max.x());
-	point_min.x() = std::min(point.x(), point_min.x());
-	point_max.y() = std::max(point.y(), point_max.y());
-	point_min.y() = std::min(point.y(), point_min.y());
-}
+	MetricsTimer timer(pMetrics, MetricStage::Read);
 
-void ExpandBox(TileBox& box, TileBox& box_new)
-{
-	if (box_new.max.empty() || box_new.min.empty())
-	{
-		return;
-	}
+	std::string data;
+	bool bHasData = pPrefetcher && pPrefetcher->Take(path, data);
 
-	if (box.max.empty())
+	// 压缩包内的文件只能读入内存后解析，外部纹理由读取回调从压缩包获取
+	if (ZipFileSystem::IsArchivePath(path))
 	{
-		box.max = box_new.max;
-	}
+		static std::once_flag callback_flag;
+		std::call_once(callback_flag, []()
+		{
+			osgDB::Registry* registry = osgDB::Registry::instance();
+			registry->setReadFileCallback(new ZipReadFileCallback(registry->getReadFileCallback()));
+		});
 
-	if (box.min.empty())
-	{
-		box.min = box_new.min;
+		if (!bHasData)
+		{
+			bHasData = OSGBTools::ReadFile(path, data);
+		}
 	}
 
-	for (int i = 0; i < 3; i++)
+	if (bHasData)
 	{
-		if (box.min[i] > box_new.min[i])
+		osgDB::Registry* registry = osgDB::Registry::instance();
+		osgDB::ReaderWriter* rw = registry->getReaderWriterForExtension(osgDB::getLowerCaseFileExtension(path));
+		if (rw)
 		{
-			box.min[i] = box_new.min[i];
-		}
+			osg::ref_ptr<osgDB::Options> options = registry->getOptions() ?
+				registry->getOptions()->cloneOptions() : new osgDB::Options;
+			options->getDatabasePathList().push_front(osgDB::getFilePath(path));
 
-		if (box.max[i] < box_new.max[i])
-		{
-			box.max[i] = box_new.max[i];
+			MemoryStreamBuf buf(data.data(), data.size());
+			std::istream stream(&buf);
+			osgDB::ReaderWriter::ReadResult rr = rw->readNode(stream, options.get());
+			if (rr.validNode())
+			{
+				if (pMetrics)
+				{
+					pMetrics->AddBytes(MetricBytes::InputOsgb, data.size());
+				}
+
+				return rr.getNode();
+			}
 		}
 	}
-}
 
-TileBox ExtendTileBox(OSGTree& tree)
-{
-	TileBox box = tree.bbox;
-	for (auto& i : tree.sub_nodes)
+	std::vector<std::string> fileNames = { path };
+	osg::ref_ptr<osg::Node> node = osgDB::readNodeFiles(fileNames);
+	if (node && pMetrics)
 	{
-		TileBox sub_tile = ExtendTileBox(i);
-		ExpandBox(box, sub_tile);
+		std::error_code ec;
+		uintmax_t size = std::filesystem::file_size(path, ec);
+		pMetrics->AddBytes(MetricBytes::InputOsgb, ec ? 0 : static_cast<size_t>(size));
 	}
 
-	tree.bbox = box;
-
-	return box;
+	return node;
 }
 
-void CalcGeometricError(OSGTree& tree)
+/**
+ * @brief 遍历节点收集几何体与纹理，分别统计遍历与重投影耗时（重投影在遍历中进行）
+ */
+void AcceptInfoVisitor(osg::Node& node, InfoVisitor& visitor, ConversionMetrics* pMetrics)
 {
-	const double EPS = 1e-12;
+	auto start = std::chrono::steady_clock::now();
+	node.accept(visitor);
 
-	// 深度优先
-	for (auto& i : tree.sub_nodes)
+	if (pMetrics)
 	{
-		CalcGeometricError(i);
+		int64_t total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count();
+		pMetrics->AddStage(MetricStage::Visit, total_ns - visitor.reproject_ns);
+		if (visitor.reproject_ns > 0)
+		{
+			pMetrics->AddStage(MetricStage::Reproject, visitor.reproject_ns);
+		}
 	}
+}
 
-	if (tree.sub_nodes.empty())
-	{
-		tree.geometricError = 0.0;
-	}
-	else
+/**
+ * @brief 几何体的三角形数（条带与扇形按展开后的三角形计）
+ */
+size_t CountTriangles(const osg::Geometry& geometry)
+{
+	size_t count = 0;
+	for (unsigned int k = 0; k < geometry.getNumPrimitiveSets(); k++)
 	{
-		bool has = false;
-		OSGTree leaf;
-		for (auto& i : tree.sub_nodes)
+		const osg::PrimitiveSet* ps = geometry.getPrimitiveSet(k);
+		size_t n = ps->getNumIndices();
+		switch (ps->getMode())
 		{
-			if (abs(i.geometricError) > EPS)
-			{
-				has = true;
-				leaf = i;
-			}
+		case GL_TRIANGLES:
+			count += n / 3;
+			break;
+		case GL_TRIANGLE_STRIP:
+		case GL_TRIANGLE_FAN:
+			count += n >= 3 ? n - 2 : 0;
+			break;
+		case GL_QUADS:
+			count += n / 4 * 2;
+			break;
+		case GL_QUAD_STRIP:
+			count += n >= 4 ? (n - 2) / 2 * 2 : 0;
+			break;
+		default:
+			break;
 		}
+	}
 
-		auto GetGeometricError = [](TileBox& bbox)
-		{
-			if (bbox.max.empty() || bbox.min.empty())
-			{
-				LOG_E("bbox 为空！");
+	return count;
+}
 
-				return 0.0;
-			}
+/**
+ * @brief 按 DoTileJob 的处理顺序收集需要读取的文件（供预读）
+ */
+void CollectTileFiles(const OSGTree& tree, int max_lvl, std::vector<std::string>& files)
+{
+	if (tree.file_name.empty())
+	{
+		return;
+	}
 
-			double max_err = std::max((bbox.max[0] - bbox.min[0]), (bbox.max[1] - bbox.min[1]));
-			max_err = std::max(max_err, (bbox.max[2] - bbox.min[2]));
+	int lvl = OSGBTools::GetLvlNum(tree.file_name);
+	if (max_lvl != -1 && lvl > max_lvl)
+	{
+		return;
+	}
 
-			return max_err / 20.0;
-		};
+	if (tree.type > 0)
+	{
+		files.emplace_back(tree.file_name);
+	}
 
-		if (has == false)
-		{
-			tree.geometricError = GetGeometricError(tree.bbox);
-		}
-		else
-		{
-			tree.geometricError = leaf.geometricError * 2.0;
-		}
+	for (const auto& i : tree.sub_nodes)
+	{
+		CollectTileFiles(i, max_lvl, files);
 	}
 }
 
 /**
- * @brief 创建一个默认颜色的材质
- * @note 该材质使用 KHR_materials_unlit 扩展，适用于不需要光照计算的场景
+ * @brief 读取 EncodeTileJSON 结果中根节点的几何误差（根节点首个字段）
  */
-tinygltf::Material MakeDefaultColorMaterial(double r, double g, double b)
+double ReadRootGeometricError(const std::string& tile_json)
 {
-	tinygltf::Material material;
-	material.name = "default";
-
-	// PBR 材质配置
-	material.pbrMetallicRoughness.baseColorFactor = { r, g, b, 1.0 };
-	material.pbrMetallicRoughness.metallicFactor = 0.0;   // 非金属
-	material.pbrMetallicRoughness.roughnessFactor = 1.0;  // 完全粗糙（漫反射）
-
-	// 启用 unlit 扩展：禁用光照计算，等效于 shader 的 texture2D 直接输出
-	tinygltf::Value::Object unlit_ext;
-	material.extensions["KHR_materials_unlit"] = tinygltf::Value(unlit_ext);
+	const std::string key = "{\"geometricError\":";
+	if (tile_json.compare(0, key.size(), key) != 0)
+	{
+		return 0.0;
+	}
 
-	return material;
+	return std::strtod(tile_json.c_str() + key.size(), nullptr);
 }
 
 /**
- * @brief 将 OSG 材质转换为 PBR 材质
- * @note 针对已烘焙光照的OSGB纹理进行优化，大幅提升环境光贡献，确保显示亮度接近原始效果
- * @note 该方法适用于大多数常见材质类型，但可能无法完美保留所有复杂材质的外观
+ * @brief 将瓦片根节点 JSON 包装为完整的 tileset.json
  */
-tinygltf::Material ConvertOSGBMaterialToPBR(osg::Material* osgMaterial)
+std::string WrapTileTileset(const std::string& tile_json)
 {
-	tinygltf::Material gltfMaterial;
-	gltfMaterial.name = "converted_pbr";
+	std::string wrapped_json = "{";
+	wrapped_json += "\"asset\":{\"version\":\"1.0\",\"gltfUpAxis\":\"Z\"},";
+	wrapped_json += "\"geometricError\":1000,";
+	wrapped_json += "\"root\":";
+	wrapped_json += tile_json;  // 这是此瓦片的根节点
+	wrapped_json += "}";
+
+	return wrapped_json;
+}
 
-	// 1. 提取OSGB材质属性
-	osg::Vec4 ambient = osgMaterial->getAmbient(osg::Material::FRONT_AND_BACK);
-	osg::Vec4 diffuse = osgMaterial->getDiffuse(osg::Material::FRONT_AND_BACK);
-	osg::Vec4 specular = osgMaterial->getSpecular(osg::Material::FRONT_AND_BACK);
-	osg::Vec4 emission = osgMaterial->getEmission(osg::Material::FRONT_AND_BACK);
-	float shininess = osgMaterial->getShininess(osg::Material::FRONT_AND_BACK);
+/**
+ * @brief 统计写入字节数的输出目标（异步任务进度）
+ */
+class JobProgressSink : public IOutputSink
+{
+public:
+	using IOutputSink::Write;
 
-	// 2. BaseColor转换：针对烘焙纹理，使用白色baseColor
-	// OSGB模型的纹理已包含完整光照信息，材质颜色应为白色(1,1,1)以避免调制纹理
-	// 使用unlit扩展时，baseColorFactor会直接影响纹理显示亮度
-	gltfMaterial.pbrMetallicRoughness.baseColorFactor =
+	JobProgressSink(IOutputSink& inner, JobControl& control)
+		: downstream(inner)
+		, job(control)
 	{
-		1.0, 1.0, 1.0,  // 固定白色，100%显示纹理原色
-		diffuse[3]      // 保留alpha通道
-	};
-
-	// 注：原始diffuse和ambient信息已在纹理烘焙中体现，无需再次应用
-	// 3. Roughness转换：从Shininess推导粗糙度
-	// 对于已烘焙纹理，使用更高的roughness以减少额外的高光反射
-	// Shininess范围通常是0-128，值越大越光滑
-	// Roughness范围是0-1，值越大越粗糙
-	float roughness = 1.0f - std::sqrt(shininess / 128.0f);
-	roughness = std::clamp(roughness, 0.0f, 1.0f);
+	}
 
-	// 针对烘焙纹理：提升roughness基准值，降低高光反射
-	roughness = std::max(roughness, 0.6f);  // 最小粗糙度0.6（更接近漫反射）
-	gltfMaterial.pbrMetallicRoughness.roughnessFactor = roughness;
+	bool Write(const std::string& strPath, std::string&& data) override
+	{
+		job.AddBytes(data.size());
+		return downstream.Write(strPath, std::move(data));
+	}
 
-	// 4. Metallic转换：根据Specular强度推导金属度（保守策略）
-	// 对于OSGB实景数据，大部分是非金属材质
-	float specularLuminance = (specular[0] + specular[1] + specular[2]) / 3.0f;
+	bool WriteEncoded(const std::string& strPath, std::string&& data, const std::string& strContentEncoding) override
+	{
+		job.AddBytes(data.size());
+		return downstream.WriteEncoded(strPath, std::move(data), strContentEncoding);
+	}
 
-	// 更保守的金属度判断：提高阈值，降低最大金属度
-	float metallic = 0.0f;
-	if (specularLuminance > 0.7f)  // 阈值从0.5提升到0.7
+	bool MakeDirs(const std::string& strPath) override
 	{
-		// 检查Specular是否接近白色（金属特征）
-		float colorVariance = std::abs(specular[0] - specular[1]) +
-			std::abs(specular[1] - specular[2]) +
-			std::abs(specular[0] - specular[2]);
-		if (colorVariance < 0.15f)  // 从0.1放宽到0.15
-		{
-			// 限制最大金属度为0.3（实景数据很少有纯金属）
-			metallic = std::min(specularLuminance * 0.5f, 0.3f);
-		}
+		return downstream.MakeDirs(strPath);
 	}
-	gltfMaterial.pbrMetallicRoughness.metallicFactor = metallic;
 
-	// 5. Emissive转换：直接映射
-	gltfMaterial.emissiveFactor =
+	bool Flush() override
 	{
-		emission[0], emission[1], emission[2]
-	};
+		return downstream.Flush();
+	}
 
-	// 6. 添加unlit扩展：禁用实时光照计算
-	// OSGB模型的纹理已包含烘焙光照，使用unlit可以忠实还原原始效果
-	tinygltf::Value::Object unlit_ext;
-	gltfMaterial.extensions["KHR_materials_unlit"] = tinygltf::Value(unlit_ext);
+	bool Barrier() override
+	{
+		return downstream.Barrier();
+	}
 
-	return gltfMaterial;
-}
+private:
+	IOutputSink& downstream;
+	JobControl& job;
+};
 
 /**
- * @brief 将 OSG 材质转换为 PBR 材质，使用 KHR_materials_specular 扩展保留 Specular 信息
- * @note 针对已烘焙光照的OSGB纹理优化，添加环境光处理，改进金属度计算
- * @note 该方法允许更精确地保留原始材质的外观，适用于需要高保真转换的场景
+ * @brief 统计输出字节数（按文件类型）与写入耗时的输出目标
  */
-tinygltf::Material ConvertOSGBMaterialWithSpecularExt(osg::Material* osgMaterial)
+class MetricsSink : public IOutputSink
 {
-	tinygltf::Material gltfMaterial;
-	gltfMaterial.name = "converted_pbr_specular";
+public:
+	using IOutputSink::Write;
 
-	// 1. 提取OSGB材质属性
-	osg::Vec4 ambient = osgMaterial->getAmbient(osg::Material::FRONT_AND_BACK);
-	osg::Vec4 diffuse = osgMaterial->getDiffuse(osg::Material::FRONT_AND_BACK);
-	osg::Vec4 specular = osgMaterial->getSpecular(osg::Material::FRONT_AND_BACK);
-	osg::Vec4 emission = osgMaterial->getEmission(osg::Material::FRONT_AND_BACK);
-	float shininess = osgMaterial->getShininess(osg::Material::FRONT_AND_BACK);
+	MetricsSink(IOutputSink& inner, ConversionMetrics& metrics)
+		: downstream(inner)
+		, stats(metrics)
+	{
+	}
 
-	// 2. BaseColor转换：针对烘焙纹理，使用白色baseColor
-	// OSGB模型的纹理已包含完整光照信息，材质颜色应为白色(1,1,1)以避免调制纹理
-	// 使用unlit扩展时，baseColorFactor会直接影响纹理显示亮度
-	gltfMaterial.pbrMetallicRoughness.baseColorFactor =
+	bool Write(const std::string& strPath, std::string&& data) override
 	{
-		1.0, 1.0, 1.0,  // 固定白色，100%显示纹理原色
-		diffuse[3]      // 保留alpha通道
-	};
+		stats.AddBytes(Category(strPath), data.size());
+		MetricsTimer timer(&stats, MetricStage::Write);
+		return downstream.Write(strPath, std::move(data));
+	}
 
-	// 注：原始diffuse和ambient信息已在纹理烘焙中体现，无需再次应用
-	// 3. Roughness转换：从Shininess推导粗糙度
-	// 对于已烘焙纹理，提升roughness基准值
-	float roughness = 1.0f - std::sqrt(shininess / 128.0f);
-	roughness = std::clamp(roughness, 0.0f, 1.0f);
-	roughness = std::max(roughness, 0.6f);  // 最小粗糙度0.6
-	gltfMaterial.pbrMetallicRoughness.roughnessFactor = roughness;
+	bool WriteEncoded(const std::string& strPath, std::string&& data, const std::string& strContentEncoding) override
+	{
+		stats.AddBytes(Category(strPath), data.size());
+		MetricsTimer timer(&stats, MetricStage::Write);
+		return downstream.WriteEncoded(strPath, std::move(data), strContentEncoding);
+	}
 
-	// 4. Metallic转换：根据Specular强度动态计算（改进）
-	// 原实现固定为0.0，现在根据specular强度动态判断
-	float specularLuminance = (specular[0] + specular[1] + specular[2]) / 3.0f;
-	float metallic = 0.0f;
+	bool MakeDirs(const std::string& strPath) override
+	{
+		return downstream.MakeDirs(strPath);
+	}
 
-	// 保守的金属度判断
-	if (specularLuminance > 0.7f)
+	bool Flush() override
 	{
-		float colorVariance = std::abs(specular[0] - specular[1]) +
-			std::abs(specular[1] - specular[2]) +
-			std::abs(specular[0] - specular[2]);
-		if (colorVariance < 0.15f)
+		MetricsTimer timer(&stats, MetricStage::Write);
+		return downstream.Flush();
+	}
+
+	bool Barrier() override
+	{
+		MetricsTimer timer(&stats, MetricStage::Write);
+		return downstream.Barrier();
+	}
+
+private:
+	static MetricBytes Category(const std::string& strPath)
+	{
+		std::string ext = osgDB::getLowerCaseFileExtension(strPath);
+		if (ext == "b3dm")
 		{
-			// 因为使用了specular扩展，metallic可以更低
-			metallic = std::min(specularLuminance * 0.3f, 0.2f);
+			return MetricBytes::OutputB3dm;
 		}
+
+		return ext == "json" ? MetricBytes::OutputTileset : MetricBytes::OutputOther;
 	}
-	gltfMaterial.pbrMetallicRoughness.metallicFactor = metallic;
 
-	// 5. 使用KHR_materials_specular扩展保留Specular
-	tinygltf::Value::Object specularExt;
+	IOutputSink& downstream;
+	ConversionMetrics& stats;
+};
 
-	// specularFactor: Specular强度
-	float specularStrength = specularLuminance;
-	specularExt["specularFactor"] = tinygltf::Value(specularStrength);
+/**
+ * @brief 一次转换的统计区间：构造时开始，析构时结束（嵌套调用只有最外层清空统计）
+ */
+class MetricsSession
+{
+public:
+	MetricsSession(ConversionMetrics* pMetrics, int nSlowestTiles)
+		: metrics(pMetrics)
+		, outermost(pMetrics && pMetrics->Begin(nSlowestTiles))
+	{
+	}
 
-	// specularColorFactor: Specular颜色
-	tinygltf::Value::Array specularColor =
+	~MetricsSession()
 	{
-		tinygltf::Value(specular[0]),
-		tinygltf::Value(specular[1]),
-		tinygltf::Value(specular[2])
-	};
-	specularExt["specularColorFactor"] = tinygltf::Value(specularColor);
+		if (metrics)
+		{
+			metrics->End();
+		}
+	}
 
-	gltfMaterial.extensions["KHR_materials_specular"] = tinygltf::Value(specularExt);
+	MetricsSession(const MetricsSession&) = delete;
+	MetricsSession& operator=(const MetricsSession&) = delete;
 
-	// 6. Emissive转换：直接映射
-	gltfMaterial.emissiveFactor = { emission[0], emission[1], emission[2] };
+	// 是否为最外层转换
+	bool IsOutermost() const { return outermost; }
 
-	// 7. 添加unlit扩展：禁用实时光照计算
-	// OSGB模型的纹理已包含烘焙光照，使用unlit可以忠实还原原始效果
-	tinygltf::Value::Object unlit_ext;
-	gltfMaterial.extensions["KHR_materials_unlit"] = tinygltf::Value(unlit_ext);
+private:
+	ConversionMetrics* metrics = nullptr;
+	bool outermost = false;
+};
 
-	return gltfMaterial;
+/**
+ * @brief GLB 缓存键中的转换参数
+ */
+std::string GlbCacheOptions(int nNodeType, bool bBinary, bool bEnableTextureCompress, bool bEnableMeshOpt, bool bEnableDraco)
+{
+	return std::to_string(nNodeType) + (bBinary ? "|b" : "|t") +
+		(bEnableTextureCompress ? "1" : "0") + (bEnableMeshOpt ? "1" : "0") + (bEnableDraco ? "1" : "0");
 }
-//===============工具结束==================
 
-//===============OSGB23dTiles==================
-B3DMResult OSGB23dTiles::ToB3DM(
-	const std::string strInPath,
-	const std::string& strOutPath,
-	double dCenterX,
-	double dCenterY,
-	int nMaxLevel,
-	bool bEnableTextureCompress,
-	bool bEnableMeshOpt,
-	bool bEnableDraco)
+/**
+ * @brief 节点对应的 B3DM 文件名（普通几何体节点以 "o.b3dm" 结尾）
+ */
+std::string TileNodeFileName(const OSGTree& tree)
 {
-	B3DMResult result;
-	result.success = false;
-
-	std::string path = OSGBTools::OSGString(strInPath);
+	return OSGBTools::Replace(OSGBTools::GetFileName(tree.file_name), ".osgb", tree.type != 2 ? ".b3dm" : "o.b3dm");
+}
 
-	// 自动检测目录并查找根 OSGB 文件
-	if (OSGBTools::IsDirectory(path))
+/**
+ * @brief 由几何体顶点范围计算包围盒（与 ToGLBBuf 写出的顶点坐标一致）
+ */
+TileBox GeometryBox(const std::vector<osg::Geometry*>& geometries)
+{
+	TileBox box;
+	for (auto g : geometries)
 	{
-		OSGBLog::LOG_I("[INFO] 输入是目录，正在搜索根 OSGB 文件...");
-		std::string root_osgb = OSGBTools::FindRootOSGB(path);
-		if (root_osgb.empty())
+		osg::Vec3Array* vertices = dynamic_cast<osg::Vec3Array*>(g->getVertexArray());
+		if (!vertices)
 		{
-			LOG_E("在目录 [{}] 中未找到根 OSGB 文件！", strInPath.c_str());
-			return result;
+			continue;
+		}
+
+		for (const auto& v : *vertices)
+		{
+			if (box.max.empty())
+			{
+				box.max = { v.x(), v.y(), v.z() };
+				box.min = { v.x(), v.y(), v.z() };
+				continue;
+			}
+
+			for (int i = 0; i < 3; i++)
+			{
+				box.max[i] = std::max(box.max[i], static_cast<double>(v[i]));
+				box.min[i] = std::min(box.min[i], static_cast<double>(v[i]));
+			}
 		}
-		OSGBLog::LOG_I("[INFO] 找到根 OSGB：{}", root_osgb);
-		path = root_osgb;
 	}
 
-	OSGTree root = GetAllTree(path);
-	if (root.file_name.empty())
+	return box;
+}
+
+/**
+ * @brief 清除子树所有节点的包围盒
+ */
+void ClearTreeBoxes(OSGTree& tree)
+{
+	tree.bbox = TileBox();
+	for (auto& i : tree.sub_nodes)
 	{
-		LOG_E("打开文件 [{}] 失败！", strInPath.c_str());
-		return result;
+		ClearTreeBoxes(i);
 	}
+}
 
-	DoTileJob(root, strOutPath, nMaxLevel,
-		bEnableTextureCompress, bEnableMeshOpt, bEnableDraco);
-
-	ExtendTileBox(root);
+/**
+ * @brief 按树深度收集需要转换的节点（过滤规则与 DoTileJob 一致）
+ */
+void CollectLevelNodes(OSGTree& tree, size_t tile_index, int max_lvl, size_t depth,
+	std::vector<std::vector<std::pair<size_t, OSGTree*>>>& levels)
+{
+	if (tree.file_name.empty())
+	{
+		return;
+	}
 
-	if (root.bbox.max.empty() || root.bbox.min.empty())
+	int lvl = OSGBTools::GetLvlNum(tree.file_name);
+	if (max_lvl != -1 && lvl > max_lvl)
 	{
-		LOG_E("[{}] bbox 为空！", strInPath.c_str());
-		return result;
+		return;
 	}
 
-	CalcGeometricError(root);
+	if (tree.type > 0)
+	{
+		if (levels.size() <= depth)
+		{
+			levels.resize(depth + 1);
+		}
+		levels[depth].emplace_back(tile_index, &tree);
+	}
 
-	root.geometricError = 1000.0;
-	std::string strJson = EncodeTileJSON(root, dCenterX, dCenterY);
-	root.bbox.extend(0.2);
+	for (auto& i : tree.sub_nodes)
+	{
+		CollectLevelNodes(i, tile_index, max_lvl, depth + 1, levels);
+	}
+}
 
-	// 构建返回结果
-	result.success = true;
-	result.tilesetJson = strJson;
-	std::copy(root.bbox.max.begin(), root.bbox.max.end(), result.boundingBox.begin());
-	std::copy(root.bbox.min.begin(), root.bbox.min.end(), result.boundingBox.begin() + 3);
+template<class T>
+void AlignmentBuffer(std::vector<T>& buf)
+{
+	while (buf.size() % 4 != 0)
+	{
+		buf.emplace_back(0x00);
+	}
+}
 
-	return result;
+void ExpandBbox3d(osg::Vec3f& point_max, osg::Vec3f& point_min, osg::Vec3f point)
+{
+	point_max.x() = std::max(point.x(), point_max.x());
+	point_min.x() = std::min(point.x(), point_min.x());
+	point_max.y() = std::max(point.y(), point_max.y());
+	point_min.y() = std::min(point.y(), point_min.y());
+	point_max.z() = std::max(point.z(), point_max.z());
+	point_min.z() = std::min(point.z(), point_min.z());
 }
 
-bool OSGB23dTiles::ToGLB(
-	const std::string& strInPath,
-	const std::string& strOutPath,
-	bool bBinary/* = true*/,
-	bool bEnableTextureCompress/* = false*/,
-	bool bEnableMeshOpt/* = false*/,
-	bool bEnableDraco/* = false*/)
+void ExpandBbox2d(osg::Vec2f& point_max, osg::Vec2f& point_min, osg::Vec2f point)
 {
-	MeshInfo minfo;
-	std::string glb_buf = "";
-	std::string path = OSGBTools::OSGString(strInPath);
+	point_max.x() = std::max(point.x(), point_max.x());
+	point_min.x() = std::min(point.x(), point_min.x());
+	point_max.y() = std::max(point.y(), point_max.y());
+	point_min.y() = std::min(point.y(), point_min.y());
+}
 
-	// 自动检测目录并查找根 OSGB 文件
-	if (OSGBTools::IsDirectory(path))
+void ExpandBox(TileBox& box, TileBox& box_new)
+{
+	if (box_new.max.empty() || box_new.min.empty())
 	{
-		OSGBLog::LOG_I("[INFO] 输入是目录，正在搜索根 OSGB 文件...");
-		std::string root_osgb = OSGBTools::FindRootOSGB(path);
-		if (root_osgb.empty())
-		{
-			LOG_E("在目录 [{}] 中未找到根 OSGB 文件！", strInPath.c_str());
-			return false;
-		}
-		OSGBLog::LOG_I("[INFO] 找到根 OSGB：{}", root_osgb);
-		path = root_osgb;
+		return;
 	}
 
-	bool ret = ToGLBBuf(path, glb_buf, minfo, -1, bBinary, bEnableTextureCompress, bEnableMeshOpt, bEnableDraco);
-	if (!ret)
+	if (box.max.empty())
 	{
-		LOG_E("转换为 glb 失败");
+		box.max = box_new.max;
+	}
 
-		return false;
+	if (box.min.empty())
+	{
+		box.min = box_new.min;
 	}
 
-	ret = OSGBTools::WriteFile(strOutPath.c_str(), glb_buf.data(), (unsigned long)glb_buf.size());
-	if (!ret)
+	for (int i = 0; i < 3; i++)
 	{
-		LOG_E("写入 glb 文件失败");
+		if (box.min[i] > box_new.min[i])
+		{
+			box.min[i] = box_new.min[i];
+		}
 
-		return false;
+		if (box.max[i] < box_new.max[i])
+		{
+			box.max[i] = box_new.max[i];
+		}
 	}
-
-	return true;
 }
 
-std::vector<uint8_t> OSGB23dTiles::ToGLBBuf(
-	std::string strOsgbPath,
-	int nNodeType,
-	bool bBinary,
-	bool bEnableTextureCompress,
-	bool bEnableMeshOpt,
-	bool bEnableDraco)
+TileBox ExtendTileBox(OSGTree& tree)
 {
-	std::string glb_buff;
-
-	bool ret = ToGLBBuf(OSGBTools::OSGString(strOsgbPath), glb_buff, MeshInfo(),
-		nNodeType, bBinary, bEnableTextureCompress, bEnableMeshOpt, bEnableDraco, false);
-
-	if (!ret)
+	TileBox box = tree.bbox;
+	for (auto& i : tree.sub_nodes)
 	{
-		return std::vector<uint8_t>();
+		TileBox sub_tile = ExtendTileBox(i);
+		ExpandBox(box, sub_tile);
 	}
 
-	// 将 string 转换为 vector<uint8_t>
-	std::vector<uint8_t> result(glb_buff.begin(), glb_buff.end());
-	return result;
+	tree.bbox = box;
+
+	return box;
 }
 
-template<class T>
-void OSGB23dTiles::WriteOsgIndecis(T* drawElements, OsgBuildState* osgState, int componentType)
+void CalcGeometricError(OSGTree& tree)
 {
-	unsigned max_index = 0;
-	unsigned min_index = 1 << 30;
-	unsigned buffer_start = osgState->buffer->data.size();
+	const double EPS = 1e-12;
 
-	unsigned IndNum = drawElements->getNumIndices();
-	for (unsigned m = 0; m < IndNum; m++)
+	// 深度优先
+	for (auto& i : tree.sub_nodes)
 	{
-		auto idx = drawElements->at(m);
-		PutVal(osgState->buffer->data, idx);
-		if (idx > max_index) max_index = idx;
-		if (idx < min_index) min_index = idx;
+		CalcGeometricError(i);
 	}
-	AlignmentBuffer(osgState->buffer->data);
-
-	tinygltf::Accessor acc;
-	acc.bufferView = osgState->model->bufferViews.size();
-	acc.type = TINYGLTF_TYPE_SCALAR;
-	acc.componentType = componentType;
-	acc.count = IndNum;
-	acc.maxValues = { (double)max_index };
-	acc.minValues = { (double)min_index };
-	osgState->model->accessors.emplace_back(acc);
-
-	tinygltf::BufferView bfv;
-	bfv.buffer = 0;
-	bfv.target = TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER;
-	bfv.byteOffset = buffer_start;
-	bfv.byteLength = osgState->buffer->data.size() - buffer_start;
-	osgState->model->bufferViews.emplace_back(bfv);
-}
 
-void OSGB23dTiles::WriteVec3Array(osg::Vec3Array* v3f, OsgBuildState* osgState, osg::Vec3f& point_max, osg::Vec3f& point_min)
-{
-	int vec_start = 0;
-	int vec_end = v3f->size();
-	if (osgState->draw_array_first >= 0)
+	if (tree.sub_nodes.empty())
 	{
-		vec_start = osgState->draw_array_first;
-		vec_end = osgState->draw_array_count + vec_start;
+		tree.geometricError = 0.0;
 	}
-	unsigned buffer_start = osgState->buffer->data.size();
-	for (int vidx = vec_start; vidx < vec_end; vidx++)
+	else
 	{
-		osg::Vec3f point = v3f->at(vidx);
-		PutVal(osgState->buffer->data, point.x());
-		PutVal(osgState->buffer->data, point.y());
-		PutVal(osgState->buffer->data, point.z());
-		ExpandBbox3d(point_max, point_min, point);
-	}
-	AlignmentBuffer(osgState->buffer->data);
+		bool has = false;
+		OSGTree leaf;
+		for (auto& i : tree.sub_nodes)
+		{
+			if (abs(i.geometricError) > EPS)
+			{
+				has = true;
+				leaf = i;
+			}
+		}
 
-	tinygltf::Accessor acc;
-	acc.bufferView = osgState->model->bufferViews.size();
-	acc.count = vec_end - vec_start;
-	acc.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
-	acc.type = TINYGLTF_TYPE_VEC3;
-	acc.maxValues = { point_max.x(), point_max.y(), point_max.z() };
-	acc.minValues = { point_min.x(), point_min.y(), point_min.z() };
-	osgState->model->accessors.emplace_back(acc);
+		auto GetGeometricError = [](TileBox& bbox)
+		{
+			if (bbox.max.empty() || bbox.min.empty())
+			{
+				LOG_E("bbox 为空！");
 
-	tinygltf::BufferView bfv;
-	bfv.buffer = 0;
-	bfv.target = TINYGLTF_TARGET_ARRAY_BUFFER;
-	bfv.byteOffset = buffer_start;
-	bfv.byteLength = osgState->buffer->data.size() - buffer_start;
-	osgState->model->bufferViews.emplace_back(bfv);
+				return 0.0;
+			}
+
+			double max_err = std::max((bbox.max[0] - bbox.min[0]), (bbox.max[1] - bbox.min[1]));
+			max_err = std::max(max_err, (bbox.max[2] - bbox.min[2]));
+
+			return max_err / 20.0;
+		};
+
+		if (has == false)
+		{
+			tree.geometricError = GetGeometricError(tree.bbox);
+		}
+		else
+		{
+			tree.geometricError = leaf.geometricError * 2.0;
+		}
+	}
 }
 
-void OSGB23dTiles::WriteVec2Array(osg::Vec2Array* v2f, OsgBuildState* osgState)
+/**
+ * @brief 创建一个默认颜色的材质
+ * @note 该材质使用 KHR_materials_unlit 扩展，适用于不需要光照计算的场景
+ */
+tinygltf::Material MakeDefaultColorMaterial(double r, double g, double b)
 {
-	int vec_start = 0;
-	int vec_end = v2f->size();
-	if (osgState->draw_array_first >= 0)
-	{
-		vec_start = osgState->draw_array_first;
-		vec_end = osgState->draw_array_count + vec_start;
-	}
-	osg::Vec2f point_max(-1e38, -1e38);
-	osg::Vec2f point_min(1e38, 1e38);
-	unsigned buffer_start = osgState->buffer->data.size();
-	for (int vidx = vec_start; vidx < vec_end; vidx++)
-	{
-		osg::Vec2f point = v2f->at(vidx);
-		PutVal(osgState->buffer->data, point.x());
-		PutVal(osgState->buffer->data, point.y());
-		ExpandBbox2d(point_max, point_min, point);
-	}
-	AlignmentBuffer(osgState->buffer->data);
+	tinygltf::Material material;
+	material.name = "default";
 
-	tinygltf::Accessor acc;
-	acc.bufferView = osgState->model->bufferViews.size();
-	acc.count = vec_end - vec_start;
-	acc.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
-	acc.type = TINYGLTF_TYPE_VEC2;
-	acc.maxValues = { point_max.x(), point_max.y() };
-	acc.minValues = { point_min.x(), point_min.y() };
-	osgState->model->accessors.emplace_back(acc);
+	// PBR 材质配置
+	material.pbrMetallicRoughness.baseColorFactor = { r, g, b, 1.0 };
+	material.pbrMetallicRoughness.metallicFactor = 0.0;   // 非金属
+	material.pbrMetallicRoughness.roughnessFactor = 1.0;  // 完全粗糙（漫反射）
 
-	tinygltf::BufferView bfv;
-	bfv.buffer = 0;
-	bfv.target = TINYGLTF_TARGET_ARRAY_BUFFER;
-	bfv.byteOffset = buffer_start;
-	bfv.byteLength = osgState->buffer->data.size() - buffer_start;
-	osgState->model->bufferViews.emplace_back(bfv);
+	// 启用 unlit 扩展：禁用光照计算，等效于 shader 的 texture2D 直接输出
+	tinygltf::Value::Object unlit_ext;
+	material.extensions["KHR_materials_unlit"] = tinygltf::Value(unlit_ext);
+
+	return material;
 }
 
-int OSGB23dTiles::WriteIndexVector(const std::vector<uint32_t>& indices, OsgBuildState* osgState, DracoState* dracoState)
+/**
+ * @brief 将 OSG 材质转换为 PBR 材质
+ * @note 针对已烘焙光照的OSGB纹理进行优化，大幅提升环境光贡献，确保显示亮度接近原始效果
+ * @note 该方法适用于大多数常见材质类型，但可能无法完美保留所有复杂材质的外观
+ */
+tinygltf::Material ConvertOSGBMaterialToPBR(osg::Material* osgMaterial)
 {
-	if (indices.empty())
-	{
-		return -1;
-	}
+	tinygltf::Material gltfMaterial;
+	gltfMaterial.name = "converted_pbr";
 
-	uint32_t max_index = 0;
-	uint32_t min_index = std::numeric_limits<uint32_t>::max();
-	for (auto idx : indices)
-	{
-		max_index = std::max(max_index, idx);
-		min_index = std::min(min_index, idx);
-	}
+	// 1. 提取OSGB材质属性
+	osg::Vec4 ambient = osgMaterial->getAmbient(osg::Material::FRONT_AND_BACK);
+	osg::Vec4 diffuse = osgMaterial->getDiffuse(osg::Material::FRONT_AND_BACK);
+	osg::Vec4 specular = osgMaterial->getSpecular(osg::Material::FRONT_AND_BACK);
+	osg::Vec4 emission = osgMaterial->getEmission(osg::Material::FRONT_AND_BACK);
+	float shininess = osgMaterial->getShininess(osg::Material::FRONT_AND_BACK);
 
-	// 选择可以容纳给定最大索引的最小 glTF 组件类型。
-	// 根据 max_index 返回 UNSIGNED_BYTE、UNSIGNED_SHORT 或 UNSIGNED_INT。
-	auto PickIndexComponentType = [](uint32_t max_index)
+	// 2. BaseColor转换：针对烘焙纹理，使用白色baseColor
+	// OSGB模型的纹理已包含完整光照信息，材质颜色应为白色(1,1,1)以避免调制纹理
+	// 使用unlit扩展时，baseColorFactor会直接影响纹理显示亮度
+	gltfMaterial.pbrMetallicRoughness.baseColorFactor =
 	{
-		if (max_index <= std::numeric_limits<uint8_t>::max())
-		{
-			return TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
-		}
+		1.0, 1.0, 1.0,  // 固定白色，100%显示纹理原色
+		diffuse[3]      // 保留alpha通道
+	};
 
-		if (max_index <= std::numeric_limits<uint16_t>::max())
+	// 注：原始diffuse和ambient信息已在纹理烘焙中体现，无需再次应用
+	// 3. Roughness转换：从Shininess推导粗糙度
+	// 对于已烘焙纹理，使用更高的roughness以减少额外的高光反射
+	// Shininess范围通常是0-128，值越大越光滑
+	// Roughness范围是0-1，值越大越粗糙
+	float roughness = 1.0f - std::sqrt(shininess / 128.0f);
+	roughness = std::clamp(roughness, 0.0f, 1.0f);
+
+	// 针对烘焙纹理：提升roughness基准值，降低高光反射
+	roughness = std::max(roughness, 0.6f);  // 最小粗糙度0.6（更接近漫反射）
+	gltfMaterial.pbrMetallicRoughness.roughnessFactor = roughness;
+
+	// 4. Metallic转换：根据Specular强度推导金属度（保守策略）
+	// 对于OSGB实景数据，大部分是非金属材质
+	float specularLuminance = (specular[0] + specular[1] + specular[2]) / 3.0f;
+
+	// 更保守的金属度判断：提高阈值，降低最大金属度
+	float metallic = 0.0f;
+	if (specularLuminance > 0.7f)  // 阈值从0.5提升到0.7
+	{
+		// 检查Specular是否接近白色（金属特征）
+		float colorVariance = std::abs(specular[0] - specular[1]) +
+			std::abs(specular[1] - specular[2]) +
+			std::abs(specular[0] - specular[2]);
+		if (colorVariance < 0.15f)  // 从0.1放宽到0.15
 		{
-			return TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT;
+			// 限制最大金属度为0.3（实景数据很少有纯金属）
+			metallic = std::min(specularLuminance * 0.5f, 0.3f);
 		}
+	}
+	gltfMaterial.pbrMetallicRoughness.metallicFactor = metallic;
 
-		return TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
+	// 5. Emissive转换：直接映射
+	gltfMaterial.emissiveFactor =
+	{
+		emission[0], emission[1], emission[2]
 	};
 
-	const int componentType = PickIndexComponentType(max_index);
-	if (dracoState && dracoState->compressed)
-	{
-		tinygltf::Accessor acc;
-		acc.bufferView = -1;
-		acc.type = TINYGLTF_TYPE_SCALAR;
-		acc.componentType = componentType;
-		acc.count = indices.size();
-		acc.maxValues = { (double)max_index };
-		acc.minValues = { (double)min_index };
-		int accIdx = (int)osgState->model->accessors.size();
-		osgState->model->accessors.emplace_back(acc);
+	// 6. 添加unlit扩展：禁用实时光照计算
+	// OSGB模型的纹理已包含烘焙光照，使用unlit可以忠实还原原始效果
+	tinygltf::Value::Object unlit_ext;
+	gltfMaterial.extensions["KHR_materials_unlit"] = tinygltf::Value(unlit_ext);
 
-		return accIdx;
-	}
+	return gltfMaterial;
+}
 
-	unsigned buffer_start = osgState->buffer->data.size();
-	switch (componentType)
-	{
-		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
-			for (auto idx : indices)
-			{
-				PutVal(osgState->buffer->data, static_cast<uint8_t>(idx));
-			}
-			break;
-		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
-			for (auto idx : indices)
-			{
-				PutVal(osgState->buffer->data, static_cast<uint16_t>(idx));
-			}
-			break;
-		default:
-			for (auto idx : indices)
-			{
-				PutVal(osgState->buffer->data, static_cast<uint32_t>(idx));
-			}
-			break;
-	}
-
-	AlignmentBuffer(osgState->buffer->data);
+/**
+ * @brief 将 OSG 材质转换为 PBR 材质，使用 KHR_materials_specular 扩展保留 Specular 信息
+ * @note 针对已烘焙光照的OSGB纹理优化，添加环境光处理，改进金属度计算
+ * @note 该方法允许更精确地保留原始材质的外观，适用于需要高保真转换的场景
+ */
+tinygltf::Material ConvertOSGBMaterialWithSpecularExt(osg::Material* osgMaterial)
+{
+	tinygltf::Material gltfMaterial;
+	gltfMaterial.name = "converted_pbr_specular";
 
-	tinygltf::Accessor acc;
-	acc.bufferView = osgState->model->bufferViews.size();
-	acc.type = TINYGLTF_TYPE_SCALAR;
-	acc.componentType = componentType;
-	acc.count = indices.size();
-	acc.maxValues = { (double)max_index };
-	acc.minValues = { (double)min_index };
-	int accIdx = (int)osgState->model->accessors.size();
-	osgState->model->accessors.emplace_back(acc);
+	// 1. 提取OSGB材质属性
+	osg::Vec4 ambient = osgMaterial->getAmbient(osg::Material::FRONT_AND_BACK);
+	osg::Vec4 diffuse = osgMaterial->getDiffuse(osg::Material::FRONT_AND_BACK);
+	osg::Vec4 specular = osgMaterial->getSpecular(osg::Material::FRONT_AND_BACK);
+	osg::Vec4 emission = osgMaterial->getEmission(osg::Material::FRONT_AND_BACK);
+	float shininess = osgMaterial->getShininess(osg::Material::FRONT_AND_BACK);
 
-	tinygltf::BufferView bfv;
-	bfv.buffer = 0;
-	bfv.target = TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER;
-	bfv.byteOffset = buffer_start;
-	bfv.byteLength = osgState->buffer->data.size() - buffer_start;
-	osgState->model->bufferViews.emplace_back(bfv);
+	// 2. BaseColor转换：针对烘焙纹理，使用白色baseColor
+	// OSGB模型的纹理已包含完整光照信息，材质颜色应为白色(1,1,1)以避免调制纹理
+	// 使用unlit扩展时，baseColorFactor会直接影响纹理显示亮度
+	gltfMaterial.pbrMetallicRoughness.baseColorFactor =
+	{
+		1.0, 1.0, 1.0,  // 固定白色，100%显示纹理原色
+		diffuse[3]      // 保留alpha通道
+	};
 
-	return accIdx;
-}
+	// 注：原始diffuse和ambient信息已在纹理烘焙中体现，无需再次应用
+	// 3. Roughness转换：从Shininess推导粗糙度
+	// 对于已烘焙纹理，提升roughness基准值
+	float roughness = 1.0f - std::sqrt(shininess / 128.0f);
+	roughness = std::clamp(roughness, 0.0f, 1.0f);
+	roughness = std::max(roughness, 0.6f);  // 最小粗糙度0.6
+	gltfMaterial.pbrMetallicRoughness.roughnessFactor = roughness;
 
-// 将 GL_QUADS 或 GL_QUAD_STRIP 索引序列转换为三角形索引。
-// GL_QUADS: 每4个索引形成一个四边形，分割成2个三角形。
-// GL_QUAD_STRIP: 索引对形成条带顺序的四边形，每个四边形分割成2个三角形。
-// 如果三角化成功并填充 'out'，返回 true，否则返回 false。
-bool TriangulateQuadLike(const std::vector<uint32_t>& indices, GLenum mode, std::vector<uint32_t>& out)
-{
-	out.clear();
+	// 4. Metallic转换：根据Specular强度动态计算（改进）
+	// 原实现固定为0.0，现在根据specular强度动态判断
+	float specularLuminance = (specular[0] + specular[1] + specular[2]) / 3.0f;
+	float metallic = 0.0f;
 
-	if (mode == GL_QUADS)
+	// 保守的金属度判断
+	if (specularLuminance > 0.7f)
 	{
-		if (indices.size() < 4)
-		{
-			return false;
-		}
-
-		if (indices.size() % 4 != 0)
+		float colorVariance = std::abs(specular[0] - specular[1]) +
+			std::abs(specular[1] - specular[2]) +
+			std::abs(specular[0] - specular[2]);
+		if (colorVariance < 0.15f)
 		{
-			LOG_E("GL_QUADS index count ({:zu}) is not divisible by 4, trailing vertices will be ignored", indices.size());
+			// 因为使用了specular扩展，metallic可以更低
+			metallic = std::min(specularLuminance * 0.3f, 0.2f);
 		}
+	}
+	gltfMaterial.pbrMetallicRoughness.metallicFactor = metallic;
 
-		size_t quad_count = indices.size() / 4;
-		out.reserve(quad_count * 6);
-		for (size_t q = 0; q < quad_count; ++q)
-		{
-			size_t base = q * 4;
-			out.emplace_back(indices[base]);
-			out.emplace_back(indices[base + 1]);
-			out.emplace_back(indices[base + 2]);
-			out.emplace_back(indices[base]);
-			out.emplace_back(indices[base + 2]);
-			out.emplace_back(indices[base + 3]);
-		}
+	// 5. 使用KHR_materials_specular扩展保留Specular
+	tinygltf::Value::Object specularExt;
 
-		return !out.empty();
-	}
+	// specularFactor: Specular强度
+	float specularStrength = specularLuminance;
+	specularExt["specularFactor"] = tinygltf::Value(specularStrength);
 
-	if (mode == GL_QUAD_STRIP)
+	// specularColorFactor: Specular颜色
+	tinygltf::Value::Array specularColor =
 	{
-		if (indices.size() < 4)
-		{
-			return false;
-		}
+		tinygltf::Value(specular[0]),
+		tinygltf::Value(specular[1]),
+		tinygltf::Value(specular[2])
+	};
+	specularExt["specularColorFactor"] = tinygltf::Value(specularColor);
 
-		if (indices.size() % 2 != 0)
-		{
-			LOG_E("GL_QUAD_STRIP index count ({:zu}) is not even, trailing vertex will be ignored",
-				indices.size());
-		}
+	gltfMaterial.extensions["KHR_materials_specular"] = tinygltf::Value(specularExt);
 
-		size_t pair_count = indices.size() / 2;
-		if (pair_count < 2)
-		{
-			return false;
-		}
-		out.reserve((pair_count - 1) * 6);
-		for (size_t i = 0; i + 1 < pair_count; ++i)
-		{
-			size_t base = i * 2;
-			if (base + 3 >= indices.size())
-			{
-				break;
-			}
-			uint32_t a = indices[base];
-			uint32_t b = indices[base + 1];
-			uint32_t c = indices[base + 2];
-			uint32_t d = indices[base + 3];
-			out.emplace_back(a);
-			out.emplace_back(b);
-			out.emplace_back(c);
-			out.emplace_back(b);
-			out.emplace_back(d);
-			out.emplace_back(c);
-		}
+	// 6. Emissive转换：直接映射
+	gltfMaterial.emissiveFactor = { emission[0], emission[1], emission[2] };
 
-		return !out.empty();
-	}
+	// 7. 添加unlit扩展：禁用实时光照计算
+	// OSGB模型的纹理已包含烘焙光照，使用unlit可以忠实还原原始效果
+	tinygltf::Value::Object unlit_ext;
+	gltfMaterial.extensions["KHR_materials_unlit"] = tinygltf::Value(unlit_ext);
 
-	return false;
+	return gltfMaterial;
 }
+//===============工具结束==================
 
-void OSGB23dTiles::WriteElementArrayPrimitive(osg::Geometry* g, osg::PrimitiveSet* ps, OsgBuildState* osgState, PrimitiveState* pmtState, DracoState* dracoState)
+//===============OSGB23dTiles==================
+B3DMResult OSGB23dTiles::ToB3DM(
+	const std::string strInPath,
+	const std::string& strOutPath,
+	double dCenterX,
+	double dCenterY,
+	int nMaxLevel,
+	bool bEnableTextureCompress,
+	bool bEnableMeshOpt,
+	bool bEnableDraco,
+	IOutputSink* pSink)
 {
-	tinygltf::Primitive primits;
-	primits.indices = osgState->model->accessors.size();
-	// reset draw_array state
-	osgState->draw_array_first = -1;
-	const GLenum gl_mode = ps->getMode();
-	const bool needs_quad_triangulation = (gl_mode == GL_QUADS || gl_mode == GL_QUAD_STRIP);
-	std::vector<uint32_t> triangulated_indices;
+	// 单独调用时没有数据集的 SRSOrigin，子集区域按节点本地坐标处理
+	SubsetFilter filter(subset);
 
-	auto collect_and_triangulate = [&](auto* drawElements)
+	return ToB3DM(strInPath, strOutPath, dCenterX, dCenterY, nMaxLevel,
+		bEnableTextureCompress, bEnableMeshOpt, bEnableDraco, pSink, &filter, nullptr);
+}
+
+B3DMResult OSGB23dTiles::ToB3DM(
+	const std::string strInPath,
+	const std::string& strOutPath,
+	double dCenterX,
+	double dCenterY,
+	int nMaxLevel,
+	bool bEnableTextureCompress,
+	bool bEnableMeshOpt,
+	bool bEnableDraco,
+	IOutputSink* pSink,
+	const SubsetFilter* pFilter,
+	const GeoTransform* pGeoTransform)
+{
+	TraceScope trace("ToB3DM", "tile", strInPath);
+
+	B3DMResult result;
+	result.success = false;
+
+	// 未指定输出目标时同步写入本地文件（与单文件调用的原有行为一致）
+	LocalFileSink local_sink(false);
+	IOutputSink* pOutput = pSink ? pSink : &local_sink;
+
+	// 单独调用时统计本次转换（批量转换中的瓦片计入批量转换的统计）
+	MetricsSession metrics_session(ActiveMetrics(), metrics_settings.nSlowestTiles);
+	std::unique_ptr<IOutputSink> metrics_sink;
+	if (metrics_session.IsOutermost())
 	{
-		std::vector<uint32_t> source;
-		source.reserve(drawElements->getNumIndices());
-		for (unsigned m = 0; m < drawElements->getNumIndices(); ++m)
+		metrics_sink = std::make_unique<MetricsSink>(*pOutput, metrics);
+		pOutput = metrics_sink.get();
+	}
+	IOutputSink& sink = *pOutput;
+
+	std::string path = OSGBTools::OSGString(strInPath);
+
+	// 自动检测目录并查找根 OSGB 文件
+	if (OSGBTools::IsDirectory(path))
+	{
+		OSGBLog::LOG_I("[INFO] 输入是目录，正在搜索根 OSGB 文件...");
+		std::string root_osgb = OSGBTools::FindRootOSGB(path);
+		if (root_osgb.empty())
 		{
-			source.emplace_back(drawElements->at(m));
+			LOG_E("在目录 [{}] 中未找到根 OSGB 文件！", strInPath.c_str());
+			return result;
 		}
+		OSGBLog::LOG_I("[INFO] 找到根 OSGB：{}", root_osgb);
+		path = root_osgb;
+	}
 
-		return TriangulateQuadLike(source, gl_mode, triangulated_indices);
-	};
+	// 输入预读：遍历树时预读子节点，转换前按处理顺序预读全部瓦片文件，
+	// 存储延迟与解析/转换重叠（每个任务独立的预读线程与内存上限）
+	FilePrefetcher prefetcher;
 
-	auto write_triangulated = [&](auto* drawElements, int componentType)
+	OSGTree root = GetAllTree(path, &prefetcher, false, nMaxLevel, pFilter, pGeoTransform);
+	if (root.file_name.empty())
 	{
-		if (!needs_quad_triangulation)
-		{
-			if (dracoState && dracoState->compressed)
-			{
-				tinygltf::Accessor acc;
-				acc.bufferView = -1;
-				acc.type = TINYGLTF_TYPE_SCALAR;
-				acc.componentType = componentType;
-				acc.count = drawElements->getNumIndices();
-				int accIdx = (int)osgState->model->accessors.size();
-				osgState->model->accessors.emplace_back(acc);
-				primits.indices = accIdx;
-			}
-			else
-			{
-				WriteOsgIndecis(drawElements, osgState, componentType);
-			}
+		LOG_E("打开文件 [{}] 失败！", strInPath.c_str());
+		return result;
+	}
 
-			return;
-		}
+	std::vector<std::string> tile_files;
+	CollectTileFiles(root, nMaxLevel, tile_files);
+	prefetcher.Prefetch(tile_files);
 
-		if (collect_and_triangulate(drawElements))
-		{
-			primits.indices = WriteIndexVector(triangulated_indices, osgState, dracoState);
-		}
-		else
-		{
-			primits.indices = -1;
-		}
-	};
+	DoTileJob(root, sink, strOutPath, nMaxLevel,
+		bEnableTextureCompress, bEnableMeshOpt, bEnableDraco, &prefetcher, pGeoTransform);
 
-	osg::PrimitiveSet::Type t = ps->getType();
-	switch (t)
+	result = FinishTileTree(root, dCenterX, dCenterY);
+	if (!result.success)
 	{
-		case (osg::PrimitiveSet::DrawElementsUBytePrimitiveType):
+		LOG_E("[{}] bbox 为空！", strInPath.c_str());
+	}
+
+	if (metrics_session.IsOutermost())
+	{
+		result.metricsJson = metrics.ToJson();
+		if (metrics_settings.bWriteReport)
 		{
-			const osg::DrawElementsUByte* drawElements = static_cast<const osg::DrawElementsUByte*>(ps);
+			sink.Write(strOutPath + "/" + metrics_settings.strReportName, std::string(result.metricsJson));
+		}
+	}
+
+	return result;
+}
+
+B3DMResult OSGB23dTiles::FinishTileTree(OSGTree& root, double dCenterX, double dCenterY)
+{
+	B3DMResult result;
+	result.success = false;
+
+	ExtendTileBox(root);
+
+	if (root.bbox.max.empty() || root.bbox.min.empty())
+	{
+		return result;
+	}
+
+	CalcGeometricError(root);
+
+	root.geometricError = 1000.0;
+	std::string strJson = EncodeTileJSON(root, dCenterX, dCenterY);
+	root.bbox.extend(0.2);
+
+	// 构建返回结果
+	result.success = true;
+	result.tilesetJson = strJson;
+	std::copy(root.bbox.max.begin(), root.bbox.max.end(), result.boundingBox.begin());
+	std::copy(root.bbox.min.begin(), root.bbox.min.end(), result.boundingBox.begin() + 3);
+
+	return result;
+}
+
+B3DMResult OSGB23dTiles::ToB3DMLazy(
+	const std::string& strInPath,
+	const std::string& strOutPath,
+	double dCenterX,
+	double dCenterY,
+	int nMaxLevel,
+	const SubsetFilter* pFilter,
+	const GeoTransform* pGeoTransform)
+{
+	B3DMResult result;
+	result.success = false;
+
+	std::string path = strInPath;
+
+	FilePrefetcher prefetcher;
+	OSGTree root = GetAllTree(path, &prefetcher, true, nMaxLevel, pFilter, pGeoTransform);
+	if (root.file_name.empty())
+	{
+		LOG_E("打开文件 [{}] 失败！", strInPath.c_str());
+		return result;
+	}
+
+	RegisterLazyNodes(root, strOutPath, nMaxLevel);
+
+	result = FinishTileTree(root, dCenterX, dCenterY);
+	if (!result.success)
+	{
+		LOG_E("[{}] bbox 为空！", strInPath.c_str());
+	}
+
+	return result;
+}
+
+void OSGB23dTiles::RegisterLazyNodes(OSGTree& tree, const std::string& out_path, int max_lvl)
+{
+	if (tree.file_name.empty())
+	{
+		return;
+	}
+
+	// 超过最大层级的节点不会被转换，不能出现在 tileset.json 中
+	int lvl = OSGBTools::GetLvlNum(tree.file_name);
+	if (max_lvl != -1 && lvl > max_lvl)
+	{
+		ClearTreeBoxes(tree);
+		return;
+	}
+
+	if (tree.type > 0 && !tree.bbox.max.empty() && lazy_callback)
+	{
+		lazy_callback(out_path + "/" + TileNodeFileName(tree), tree.file_name, tree.type);
+	}
+
+	for (auto& i : tree.sub_nodes)
+	{
+		RegisterLazyNodes(i, out_path, max_lvl);
+	}
+}
+
+bool OSGB23dTiles::ToB3DMNode(
+	const std::string& strInPath,
+	int nNodeType,
+	std::string& strB3dm,
+	bool bEnableTextureCompress,
+	bool bEnableMeshOpt,
+	bool bEnableDraco,
+	const GeoTransform* pGeoTransform)
+{
+	strB3dm.clear();
+
+	// 按需请求的瓦片优先于批量切片
+	JobScheduler::Slot slot = JobScheduler::Global().Acquire(JobPriority::Interactive);
+
+	TileBox tile_box;
+	return ToB3DMBuf(strInPath, strB3dm, tile_box, nNodeType,
+		bEnableTextureCompress, bEnableMeshOpt, bEnableDraco, nullptr, pGeoTransform) && !strB3dm.empty();
+}
+
+bool OSGB23dTiles::ToGLB(
+	const std::string& strInPath,
+	const std::string& strOutPath,
+	bool bBinary/* = true*/,
+	bool bEnableTextureCompress/* = false*/,
+	bool bEnableMeshOpt/* = false*/,
+	bool bEnableDraco/* = false*/)
+{
+	std::shared_ptr<const std::string> glb_buf;
+	std::string path = OSGBTools::OSGString(strInPath);
+
+	// 自动检测目录并查找根 OSGB 文件
+	if (OSGBTools::IsDirectory(path))
+	{
+		OSGBLog::LOG_I("[INFO] 输入是目录，正在搜索根 OSGB 文件...");
+		std::string root_osgb = OSGBTools::FindRootOSGB(path);
+		if (root_osgb.empty())
+		{
+			LOG_E("在目录 [{}] 中未找到根 OSGB 文件！", strInPath.c_str());
+			return false;
+		}
+		OSGBLog::LOG_I("[INFO] 找到根 OSGB：{}", root_osgb);
+		path = root_osgb;
+	}
+
+	// 重复预览同一模型时直接使用缓存的转换结果
+	bool ret = ToGLBCached(path, glb_buf, -1, bBinary, bEnableTextureCompress, bEnableMeshOpt, bEnableDraco);
+	if (!ret)
+	{
+		LOG_E("转换为 glb 失败");
+
+		return false;
+	}
+
+	ret = OSGBTools::WriteFile(strOutPath.c_str(), glb_buf->data(), (unsigned long)glb_buf->size());
+	if (!ret)
+	{
+		LOG_E("写入 glb 文件失败");
+
+		return false;
+	}
+
+	return true;
+}
+
+std::vector<uint8_t> OSGB23dTiles::ToGLBBuf(
+	std::string strOsgbPath,
+	int nNodeType,
+	bool bBinary,
+	bool bEnableTextureCompress,
+	bool bEnableMeshOpt,
+	bool bEnableDraco)
+{
+	std::shared_ptr<const std::string> glb_buff;
+	std::string path = OSGBTools::OSGString(strOsgbPath);
+
+	bool ret = ToGLBCached(path, glb_buff, nNodeType, bBinary, bEnableTextureCompress, bEnableMeshOpt, bEnableDraco);
+
+	if (!ret)
+	{
+		return std::vector<uint8_t>();
+	}
+
+	// 将 string 转换为 vector<uint8_t>
+	std::vector<uint8_t> result(glb_buff->begin(), glb_buff->end());
+	return result;
+}
+
+NativeBuffer* OSGB23dTiles::ToGLBHandle(
+	const std::string& strOsgbPath,
+	int nNodeType,
+	bool bBinary,
+	bool bEnableTextureCompress,
+	bool bEnableMeshOpt,
+	bool bEnableDraco)
+{
+	// 句柄直接共享缓存中的数据，不复制
+	std::shared_ptr<const std::string> glb_buff;
+	bool ret = ToGLBCached(OSGBTools::OSGString(strOsgbPath), glb_buff,
+		nNodeType, bBinary, bEnableTextureCompress, bEnableMeshOpt, bEnableDraco);
+	if (!ret || glb_buff->empty())
+	{
+		return nullptr;
+	}
+
+	return new NativeBuffer(std::move(glb_buff));
+}
+
+bool OSGB23dTiles::ToGLBCached(
+	const std::string& path,
+	std::shared_ptr<const std::string>& glb_buff,
+	int node_type,
+	bool bBinary,
+	bool enable_texture_compress,
+	bool enable_meshopt,
+	bool enable_draco,
+	const GeoTransform* pGeoTransform)
+{
+	auto producer = [&](std::string& data)
+	{
+		// 模型预览优先于批量切片（缓存命中时无需等待）
+		JobScheduler::Slot slot = JobScheduler::Global().Acquire(JobPriority::Interactive);
+
+		MeshInfo minfo;
+		return ToGLBBuf(path, data, minfo, node_type, bBinary,
+			enable_texture_compress, enable_meshopt, enable_draco, false, nullptr, pGeoTransform);
+	};
+
+	// 缓存键只包含文件与转换参数，重投影的结果随数据集坐标系统变化，不进入缓存
+	if (pGeoTransform && pGeoTransform->IsInitialized())
+	{
+		std::string data;
+		if (!producer(data))
+		{
+			return false;
+		}
+
+		glb_buff = std::make_shared<const std::string>(std::move(data));
+		return true;
+	}
+
+	return GlbCache::Global().GetOrCreate(path,
+		GlbCacheOptions(node_type, bBinary, enable_texture_compress, enable_meshopt, enable_draco), glb_buff, producer);
+}
+
+template<class T>
+void OSGB23dTiles::WriteOsgIndecis(T* drawElements, OsgBuildState* osgState, int componentType)
+{
+	unsigned max_index = 0;
+	unsigned min_index = 1 << 30;
+	unsigned buffer_start = osgState->buffer->data.size();
+
+	unsigned IndNum = drawElements->getNumIndices();
+	for (unsigned m = 0; m < IndNum; m++)
+	{
+		auto idx = drawElements->at(m);
+		PutVal(osgState->buffer->data, idx);
+		if (idx > max_index) max_index = idx;
+		if (idx < min_index) min_index = idx;
+	}
+	AlignmentBuffer(osgState->buffer->data);
+
+	tinygltf::Accessor acc;
+	acc.bufferView = osgState->model->bufferViews.size();
+	acc.type = TINYGLTF_TYPE_SCALAR;
+	acc.componentType = componentType;
+	acc.count = IndNum;
+	acc.maxValues = { (double)max_index };
+	acc.minValues = { (double)min_index };
+	osgState->model->accessors.emplace_back(acc);
+
+	tinygltf::BufferView bfv;
+	bfv.buffer = 0;
+	bfv.target = TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER;
+	bfv.byteOffset = buffer_start;
+	bfv.byteLength = osgState->buffer->data.size() - buffer_start;
+	osgState->model->bufferViews.emplace_back(bfv);
+}
+
+void OSGB23dTiles::WriteVec3Array(osg::Vec3Array* v3f, OsgBuildState* osgState, osg::Vec3f& point_max, osg::Vec3f& point_min)
+{
+	int vec_start = 0;
+	int vec_end = v3f->size();
+	if (osgState->draw_array_first >= 0)
+	{
+		vec_start = osgState->draw_array_first;
+		vec_end = osgState->draw_array_count + vec_start;
+	}
+	unsigned buffer_start = osgState->buffer->data.size();
+	for (int vidx = vec_start; vidx < vec_end; vidx++)
+	{
+		osg::Vec3f point = v3f->at(vidx);
+		PutVal(osgState->buffer->data, point.x());
+		PutVal(osgState->buffer->data, point.y());
+		PutVal(osgState->buffer->data, point.z());
+		ExpandBbox3d(point_max, point_min, point);
+	}
+	AlignmentBuffer(osgState->buffer->data);
+
+	tinygltf::Accessor acc;
+	acc.bufferView = osgState->model->bufferViews.size();
+	acc.count = vec_end - vec_start;
+	acc.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+	acc.type = TINYGLTF_TYPE_VEC3;
+	acc.maxValues = { point_max.x(), point_max.y(), point_max.z() };
+	acc.minValues = { point_min.x(), point_min.y(), point_min.z() };
+	osgState->model->accessors.emplace_back(acc);
+
+	tinygltf::BufferView bfv;
+	bfv.buffer = 0;
+	bfv.target = TINYGLTF_TARGET_ARRAY_BUFFER;
+	bfv.byteOffset = buffer_start;
+	bfv.byteLength = osgState->buffer->data.size() - buffer_start;
+	osgState->model->bufferViews.emplace_back(bfv);
+}
+
+void OSGB23dTiles::WriteVec2Array(osg::Vec2Array* v2f, OsgBuildState* osgState)
+{
+	int vec_start = 0;
+	int vec_end = v2f->size();
+	if (osgState->draw_array_first >= 0)
+	{
+		vec_start = osgState->draw_array_first;
+		vec_end = osgState->draw_array_count + vec_start;
+	}
+	osg::Vec2f point_max(-1e38, -1e38);
+	osg::Vec2f point_min(1e38, 1e38);
+	unsigned buffer_start = osgState->buffer->data.size();
+	for (int vidx = vec_start; vidx < vec_end; vidx++)
+	{
+		osg::Vec2f point = v2f->at(vidx);
+		PutVal(osgState->buffer->data, point.x());
+		PutVal(osgState->buffer->data, point.y());
+		ExpandBbox2d(point_max, point_min, point);
+	}
+	AlignmentBuffer(osgState->buffer->data);
+
+	tinygltf::Accessor acc;
+	acc.bufferView = osgState->model->bufferViews.size();
+	acc.count = vec_end - vec_start;
+	acc.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+	acc.type = TINYGLTF_TYPE_VEC2;
+	acc.maxValues = { point_max.x(), point_max.y() };
+	acc.minValues = { point_min.x(), point_min.y() };
+	osgState->model->accessors.emplace_back(acc);
+
+	tinygltf::BufferView bfv;
+	bfv.buffer = 0;
+	bfv.target = TINYGLTF_TARGET_ARRAY_BUFFER;
+	bfv.byteOffset = buffer_start;
+	bfv.byteLength = osgState->buffer->data.size() - buffer_start;
+	osgState->model->bufferViews.emplace_back(bfv);
+}
+
+int OSGB23dTiles::WriteIndexVector(const std::vector<uint32_t>& indices, OsgBuildState* osgState, DracoState* dracoState)
+{
+	if (indices.empty())
+	{
+		return -1;
+	}
+
+	uint32_t max_index = 0;
+	uint32_t min_index = std::numeric_limits<uint32_t>::max();
+	for (auto idx : indices)
+	{
+		max_index = std::max(max_index, idx);
+		min_index = std::min(min_index, idx);
+	}
+
+	// 选择可以容纳给定最大索引的最小 glTF 组件类型。
+	// 根据 max_index 返回 UNSIGNED_BYTE、UNSIGNED_SHORT 或 UNSIGNED_INT。
+	auto PickIndexComponentType = [](uint32_t max_index)
+	{
+		if (max_index <= std::numeric_limits<uint8_t>::max())
+		{
+			return TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+		}
+
+		if (max_index <= std::numeric_limits<uint16_t>::max())
+		{
+			return TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT;
+		}
+
+		return TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
+	};
+
+	const int componentType = PickIndexComponentType(max_index);
+	if (dracoState && dracoState->compressed)
+	{
+		tinygltf::Accessor acc;
+		acc.bufferView = -1;
+		acc.type = TINYGLTF_TYPE_SCALAR;
+		acc.componentType = componentType;
+		acc.count = indices.size();
+		acc.maxValues = { (double)max_index };
+		acc.minValues = { (double)min_index };
+		int accIdx = (int)osgState->model->accessors.size();
+		osgState->model->accessors.emplace_back(acc);
+
+		return accIdx;
+	}
+
+	unsigned buffer_start = osgState->buffer->data.size();
+	switch (componentType)
+	{
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+			for (auto idx : indices)
+			{
+				PutVal(osgState->buffer->data, static_cast<uint8_t>(idx));
+			}
+			break;
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+			for (auto idx : indices)
+			{
+				PutVal(osgState->buffer->data, static_cast<uint16_t>(idx));
+			}
+			break;
+		default:
+			for (auto idx : indices)
+			{
+				PutVal(osgState->buffer->data, static_cast<uint32_t>(idx));
+			}
+			break;
+	}
+
+	AlignmentBuffer(osgState->buffer->data);
+
+	tinygltf::Accessor acc;
+	acc.bufferView = osgState->model->bufferViews.size();
+	acc.type = TINYGLTF_TYPE_SCALAR;
+	acc.componentType = componentType;
+	acc.count = indices.size();
+	acc.maxValues = { (double)max_index };
+	acc.minValues = { (double)min_index };
+	int accIdx = (int)osgState->model->accessors.size();
+	osgState->model->accessors.emplace_back(acc);
+
+	tinygltf::BufferView bfv;
+	bfv.buffer = 0;
+	bfv.target = TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER;
+	bfv.byteOffset = buffer_start;
+	bfv.byteLength = osgState->buffer->data.size() - buffer_start;
+	osgState->model->bufferViews.emplace_back(bfv);
+
+	return accIdx;
+}
+
+// 将 GL_QUADS 或 GL_QUAD_STRIP 索引序列转换为三角形索引。
+// GL_QUADS: 每4个索引形成一个四边形，分割成2个三角形。
+// GL_QUAD_STRIP: 索引对形成条带顺序的四边形，每个四边形分割成2个三角形。
+// 如果三角化成功并填充 'out'，返回 true，否则返回 false。
+bool TriangulateQuadLike(const std::vector<uint32_t>& indices, GLenum mode, std::vector<uint32_t>& out)
+{
+	out.clear();
+
+	if (mode == GL_QUADS)
+	{
+		if (indices.size() < 4)
+		{
+			return false;
+		}
+
+		if (indices.size() % 4 != 0)
+		{
+			LOG_E("GL_QUADS index count ({:zu}) is not divisible by 4, trailing vertices will be ignored", indices.size());
+		}
+
+		size_t quad_count = indices.size() / 4;
+		out.reserve(quad_count * 6);
+		for (size_t q = 0; q < quad_count; ++q)
+		{
+			size_t base = q * 4;
+			out.emplace_back(indices[base]);
+			out.emplace_back(indices[base + 1]);
+			out.emplace_back(indices[base + 2]);
+			out.emplace_back(indices[base]);
+			out.emplace_back(indices[base + 2]);
+			out.emplace_back(indices[base + 3]);
+		}
+
+		return !out.empty();
+	}
+
+	if (mode == GL_QUAD_STRIP)
+	{
+		if (indices.size() < 4)
+		{
+			return false;
+		}
+
+		if (indices.size() % 2 != 0)
+		{
+			LOG_E("GL_QUAD_STRIP index count ({:zu}) is not even, trailing vertex will be ignored",
+				indices.size());
+		}
+
+		size_t pair_count = indices.size() / 2;
+		if (pair_count < 2)
+		{
+			return false;
+		}
+		out.reserve((pair_count - 1) * 6);
+		for (size_t i = 0; i + 1 < pair_count; ++i)
+		{
+			size_t base = i * 2;
+			if (base + 3 >= indices.size())
+			{
+				break;
+			}
+			uint32_t a = indices[base];
+			uint32_t b = indices[base + 1];
+			uint32_t c = indices[base + 2];
+			uint32_t d = indices[base + 3];
+			out.emplace_back(a);
+			out.emplace_back(b);
+			out.emplace_back(c);
+			out.emplace_back(b);
+			out.emplace_back(d);
+			out.emplace_back(c);
+		}
+
+		return !out.empty();
+	}
+
+	return false;
+}
+
+void OSGB23dTiles::WriteElementArrayPrimitive(osg::Geometry* g, osg::PrimitiveSet* ps, OsgBuildState* osgState, PrimitiveState* pmtState, DracoState* dracoState)
+{
+	tinygltf::Primitive primits;
+	primits.indices = osgState->model->accessors.size();
+	// reset draw_array state
+	osgState->draw_array_first = -1;
+	const GLenum gl_mode = ps->getMode();
+	const bool needs_quad_triangulation = (gl_mode == GL_QUADS || gl_mode == GL_QUAD_STRIP);
+	std::vector<uint32_t> triangulated_indices;
+
+	auto collect_and_triangulate = [&](auto* drawElements)
+	{
+		std::vector<uint32_t> source;
+		source.reserve(drawElements->getNumIndices());
+		for (unsigned m = 0; m < drawElements->getNumIndices(); ++m)
+		{
+			source.emplace_back(drawElements->at(m));
+		}
+
+		return TriangulateQuadLike(source, gl_mode, triangulated_indices);
+	};
+
+	auto write_triangulated = [&](auto* drawElements, int componentType)
+	{
+		if (!needs_quad_triangulation)
+		{
+			if (dracoState && dracoState->compressed)
+			{
+				tinygltf::Accessor acc;
+				acc.bufferView = -1;
+				acc.type = TINYGLTF_TYPE_SCALAR;
+				acc.componentType = componentType;
+				acc.count = drawElements->getNumIndices();
+				int accIdx = (int)osgState->model->accessors.size();
+				osgState->model->accessors.emplace_back(acc);
+				primits.indices = accIdx;
+			}
+			else
+			{
+				WriteOsgIndecis(drawElements, osgState, componentType);
+			}
+
+			return;
+		}
+
+		if (collect_and_triangulate(drawElements))
+		{
+			primits.indices = WriteIndexVector(triangulated_indices, osgState, dracoState);
+		}
+		else
+		{
+			primits.indices = -1;
+		}
+	};
+
+	osg::PrimitiveSet::Type t = ps->getType();
+	switch (t)
+	{
+		case (osg::PrimitiveSet::DrawElementsUBytePrimitiveType):
+		{
+			const osg::DrawElementsUByte* drawElements = static_cast<const osg::DrawElementsUByte*>(ps);
 			write_triangulated(drawElements, TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE);
 			break;
 		}
-		case (osg::PrimitiveSet::DrawElementsUShortPrimitiveType):
+		case (osg::PrimitiveSet::DrawElementsUShortPrimitiveType):
+		{
+			const osg::DrawElementsUShort* drawElements = static_cast<const osg::DrawElementsUShort*>(ps);
+			write_triangulated(drawElements, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT);
+			break;
+		}
+		case (osg::PrimitiveSet::DrawElementsUIntPrimitiveType):
+		{
+			const osg::DrawElementsUInt* drawElements = static_cast<const osg::DrawElementsUInt*>(ps);
+			write_triangulated(drawElements, TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT);
+			break;
+		}
+		case osg::PrimitiveSet::DrawArraysPrimitiveType:
+		{
+			primits.indices = -1;
+			osg::DrawArrays* da = dynamic_cast<osg::DrawArrays*>(ps);
+			osgState->draw_array_first = da->getFirst();
+			osgState->draw_array_count = da->getCount();
+			if (needs_quad_triangulation && da->getCount() > 0)
+			{
+				std::vector<uint32_t> source;
+				source.reserve(da->getCount());
+				for (int i = 0; i < da->getCount(); ++i)
+				{
+					source.emplace_back(i);
+				}
+
+				if (TriangulateQuadLike(source, gl_mode, triangulated_indices))
+				{
+					primits.indices = WriteIndexVector(triangulated_indices, osgState, dracoState);
+				}
+			}
+			break;
+		}
+		default:
+		{
+			LOG_E("unsupport osg::PrimitiveSet::Type [{}]", static_cast<int>(t));
+			exit(1);
+			break;
+		}
+	}
+
+	// 顶点：完整顶点和部分索引
+	if (pmtState->vertexAccessor > -1 && osgState->draw_array_first == -1)
+	{
+		primits.attributes["POSITION"] = pmtState->vertexAccessor;
+	}
+	else
+	{
+		osg::Vec3Array* vertexArr = (osg::Vec3Array*)g->getVertexArray();
+		if (dracoState && dracoState->compressed)
+		{
+			// 创建一个占位符访问器（无bufferView），并设置正确的计数/类型
+			tinygltf::Accessor acc;
+			acc.bufferView = -1;
+			acc.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+			acc.count = (osgState->draw_array_first >= 0) ? osgState->draw_array_count : (int)vertexArr->size();
+			acc.type = TINYGLTF_TYPE_VEC3;
+
+			// 计算最大、最小值包围盒
+			osg::Vec3f point_max(-1e38, -1e38, -1e38);
+			osg::Vec3f point_min(1e38, 1e38, 1e38);
+			int vec_start = (osgState->draw_array_first >= 0) ? osgState->draw_array_first : 0;
+			int vec_end = (osgState->draw_array_first >= 0) ? (osgState->draw_array_count + vec_start) : (int)vertexArr->size();
+			for (int vidx = vec_start; vidx < vec_end; vidx++)
+			{
+				osg::Vec3f point = vertexArr->at(vidx);
+				ExpandBbox3d(point_max, point_min, point);
+			}
+			acc.minValues = { point_min.x(), point_min.y(), point_min.z() };
+			acc.maxValues = { point_max.x(), point_max.y(), point_max.z() };
+			int accIdx = (int)osgState->model->accessors.size();
+			osgState->model->accessors.emplace_back(acc);
+			primits.attributes["POSITION"] = accIdx;
+			if (pmtState->vertexAccessor == -1 && osgState->draw_array_first == -1)
+			{
+				pmtState->vertexAccessor = accIdx;
+			}
+
+			if (point_min.x() <= point_max.x() && point_min.y() <= point_max.y() && point_min.z() <= point_max.z())
+			{
+				ExpandBbox3d(osgState->point_max, osgState->point_min, point_max);
+				ExpandBbox3d(osgState->point_max, osgState->point_min, point_min);
+			}
+		}
+		else
+		{
+			osg::Vec3f point_max(-1e38, -1e38, -1e38);
+			osg::Vec3f point_min(1e38, 1e38, 1e38);
+			primits.attributes["POSITION"] = osgState->model->accessors.size();
+			if (pmtState->vertexAccessor == -1 && osgState->draw_array_first == -1)
+			{
+				pmtState->vertexAccessor = osgState->model->accessors.size();
+			}
+			WriteVec3Array(vertexArr, osgState, point_max, point_min);
+			if (point_min.x() <= point_max.x() && point_min.y() <= point_max.y() &&
+				point_min.z() <= point_max.z())
+			{
+				ExpandBbox3d(osgState->point_max, osgState->point_min, point_max);
+				ExpandBbox3d(osgState->point_max, osgState->point_min, point_min);
+			}
+		}
+	}
+
+	// 法线
+	osg::Vec3Array* normalArr = (osg::Vec3Array*)g->getNormalArray();
+	if (normalArr)
+	{
+		if (pmtState->normalAccessor > -1 && osgState->draw_array_first == -1)
+		{
+			primits.attributes["NORMAL"] = pmtState->normalAccessor;
+		}
+		else
+		{
+			if (dracoState && dracoState->compressed)
+			{
+				tinygltf::Accessor acc;
+				acc.bufferView = -1;
+				acc.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+				acc.count = (osgState->draw_array_first >= 0) ? osgState->draw_array_count : (int)normalArr->size();
+				acc.type = TINYGLTF_TYPE_VEC3;
+				int accIdx = (int)osgState->model->accessors.size();
+				osgState->model->accessors.emplace_back(acc);
+				primits.attributes["NORMAL"] = accIdx;
+				if (pmtState->normalAccessor == -1 && osgState->draw_array_first == -1)
+				{
+					pmtState->normalAccessor = accIdx;
+				}
+			}
+			else
+			{
+				osg::Vec3f point_max(-1e38, -1e38, -1e38);
+				osg::Vec3f point_min(1e38, 1e38, 1e38);
+				primits.attributes["NORMAL"] = osgState->model->accessors.size();
+				if (pmtState->normalAccessor == -1 && osgState->draw_array_first == -1)
+				{
+					pmtState->normalAccessor = osgState->model->accessors.size();
+				}
+				WriteVec3Array(normalArr, osgState, point_max, point_min);
+			}
+		}
+	}
+
+	// 纹理坐标
+	osg::Vec2Array* texArr = (osg::Vec2Array*)g->getTexCoordArray(0);
+	if (texArr)
+	{
+		if (pmtState->textcdAccessor > -1 && osgState->draw_array_first == -1)
+		{
+			primits.attributes["TEXCOORD_0"] = pmtState->textcdAccessor;
+		}
+		else
+		{
+			if (dracoState && dracoState->compressed)
+			{
+				tinygltf::Accessor acc;
+				acc.bufferView = -1;
+				acc.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+				acc.count = (osgState->draw_array_first >= 0) ? osgState->draw_array_count : (int)texArr->size();
+				acc.type = TINYGLTF_TYPE_VEC2;
+				int accIdx = (int)osgState->model->accessors.size();
+				osgState->model->accessors.emplace_back(acc);
+				primits.attributes["TEXCOORD_0"] = accIdx;
+				if (pmtState->textcdAccessor == -1 && osgState->draw_array_first == -1)
+				{
+					pmtState->textcdAccessor = accIdx;
+				}
+			}
+			else
+			{
+				primits.attributes["TEXCOORD_0"] = osgState->model->accessors.size();
+				if (pmtState->textcdAccessor == -1 && osgState->draw_array_first == -1)
+				{
+					pmtState->textcdAccessor = osgState->model->accessors.size();
+				}
+				WriteVec2Array(texArr, osgState);
+			}
+		}
+	}
+
+	// 材质
+	primits.material = -1;
+
+	switch (ps->getMode())
+	{
+		case GL_POINTS:
+			primits.mode = TINYGLTF_MODE_POINTS;
+			break;
+		case GL_LINES:
+			primits.mode = TINYGLTF_MODE_LINE;
+			break;
+		case GL_LINE_LOOP:
+			primits.mode = TINYGLTF_MODE_LINE_LOOP;
+			break;
+		case GL_LINE_STRIP:
+			primits.mode = TINYGLTF_MODE_LINE_STRIP;
+			break;
+		case GL_TRIANGLES:
+			primits.mode = TINYGLTF_MODE_TRIANGLES;
+			break;
+		case GL_TRIANGLE_STRIP:
+			primits.mode = TINYGLTF_MODE_TRIANGLE_STRIP;
+			break;
+		case GL_TRIANGLE_FAN:
+			primits.mode = TINYGLTF_MODE_TRIANGLE_FAN;
+			break;
+		case GL_QUADS:
+			primits.mode = TINYGLTF_MODE_TRIANGLES;
+			break;
+		case GL_QUAD_STRIP:
+			primits.mode = TINYGLTF_MODE_TRIANGLES;
+			break;
+		default:
+			LOG_E("Unsupport Primitive Mode: {}", static_cast<int>(ps->getMode()));
+			exit(1);
+			break;
+	}
+
+	osgState->model->meshes.back().primitives.emplace_back(primits);
+	if (dracoState && dracoState->compressed)
+	{
+		tinygltf::Primitive& backPrim = osgState->model->meshes.back().primitives.back();
+		tinygltf::Value::Object dracoExt;
+		dracoExt["bufferView"] = tinygltf::Value(dracoState->bufferView);
+		tinygltf::Value::Object dracoAttribs;
+		if (dracoState->posId != -1)
+		{
+			dracoAttribs["POSITION"] = tinygltf::Value(dracoState->posId);
+		}
+
+		if (dracoState->normId != -1)
 		{
-			const osg::DrawElementsUShort* drawElements = static_cast<const osg::DrawElementsUShort*>(ps);
-			write_triangulated(drawElements, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT);
-			break;
+			dracoAttribs["NORMAL"] = tinygltf::Value(dracoState->normId);
 		}
-		case (osg::PrimitiveSet::DrawElementsUIntPrimitiveType):
+
+		if (dracoState->texId != -1)
 		{
-			const osg::DrawElementsUInt* drawElements = static_cast<const osg::DrawElementsUInt*>(ps);
-			write_triangulated(drawElements, TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT);
-			break;
+			dracoAttribs["TEXCOORD_0"] = tinygltf::Value(dracoState->texId);
 		}
-		case osg::PrimitiveSet::DrawArraysPrimitiveType:
+
+		if (dracoState->batchId != -1)
 		{
-			primits.indices = -1;
-			osg::DrawArrays* da = dynamic_cast<osg::DrawArrays*>(ps);
-			osgState->draw_array_first = da->getFirst();
-			osgState->draw_array_count = da->getCount();
-			if (needs_quad_triangulation && da->getCount() > 0)
+			dracoAttribs["_BATCHID"] = tinygltf::Value(dracoState->batchId);
+		}
+
+		dracoExt["attributes"] = tinygltf::Value(dracoAttribs);
+		backPrim.extensions["KHR_draco_mesh_compression"] = tinygltf::Value(dracoExt);
+	}
+}
+
+void OSGB23dTiles::WriteOsgGeometry(osg::Geometry* pGeometry, OsgBuildState* osgState, bool bEnableSimplification, bool bEnableDraco)
+{
+	if (bEnableSimplification)
+	{
+		MetricsTimer timer(ActiveMetrics(), MetricStage::Simplify);
+		SimplificationParams simplication_params;
+		simplication_params.bEnableSimplification = true;
+		MeshProcessor::SimplifyMeshGeometry(pGeometry, simplication_params);
+	}
+
+	MetricsTimer encode_timer(ActiveMetrics(), MetricStage::EncodeGeometry);
+
+	DracoState dracoState = { false, -1, -1, -1, -1, -1 };
+
+	if (bEnableDraco)
+	{
+		std::vector<unsigned char> compressed_data;
+		size_t compressed_size = 0;
+		DracoCompressionParams draco_params;
+		draco_params.bEnableCompression = true;
+		int dracoPosId = -1, dracoNormId = -1, dracoTexId = -1, dracoBatchId = -1;
+		bool ok = MeshProcessor::CompressMeshGeometry(
+			pGeometry, draco_params, compressed_data, compressed_size, &dracoPosId, &dracoNormId, &dracoTexId, &dracoBatchId, nullptr);
+		if (ok && compressed_size > 0)
+		{
+			unsigned bufOffset = osgState->buffer->data.size();
+			AlignmentBuffer(osgState->buffer->data);
+			bufOffset = osgState->buffer->data.size();
+			osgState->buffer->data.resize(bufOffset + compressed_size);
+			std::memcpy(osgState->buffer->data.data() + bufOffset, compressed_data.data(), compressed_size);
+			tinygltf::BufferView bv;
+			bv.buffer = 0;
+			bv.byteOffset = bufOffset;
+			bv.byteLength = compressed_size;
+			int bvIdx = (int)osgState->model->bufferViews.size();
+			osgState->model->bufferViews.emplace_back(bv);
+			dracoState.compressed = true;
+			dracoState.bufferView = bvIdx;
+			dracoState.posId = dracoPosId;
+			dracoState.normId = dracoNormId;
+			dracoState.texId = dracoTexId;
+			dracoState.batchId = dracoBatchId;
+		}
+	}
+
+	osg::PrimitiveSet::Type t = pGeometry->getPrimitiveSet(0)->getType();
+	PrimitiveState pmtState = { -1, -1, -1 };
+	for (unsigned int k = 0; k < pGeometry->getNumPrimitiveSets(); k++)
+	{
+		osg::PrimitiveSet* ps = pGeometry->getPrimitiveSet(k);
+		//if (t != ps->getType())
+		//{
+		//	LOG_E("osgb 中 PrimitiveSets 类型不相同");
+		//	exit(1);
+		//}
+
+		WriteElementArrayPrimitive(pGeometry, ps, osgState, &pmtState, &dracoState);
+	}
+}
+
+bool OSGB23dTiles::ToGLBBuf(
+	std::string path,
+	std::string& glb_buff,
+	MeshInfo& mesh_info,
+	int node_type,
+	bool bBinary,
+	bool enable_texture_compress,
+	bool enable_meshopt,
+	bool enable_draco,
+	bool need_mesh_info/* = true*/,
+	FilePrefetcher* pPrefetcher/* = nullptr*/,
+	const GeoTransform* pGeoTransform/* = nullptr*/)
+{
+	TraceScope trace("ToGLBBuf", "convert", path);
+
+	std::string parent_path = OSGBTools::GetParent(path);
+	ConversionMetrics* pMetrics = ActiveMetrics();
+
+	osg::ref_ptr<osg::Node> root = ReadOsgNode(path, pPrefetcher, pMetrics);
+	if (!root.valid())
+	{
+		return false;
+	}
+
+	InfoVisitor infoVisitor(parent_path, node_type == -1, pGeoTransform);
+	AcceptInfoVisitor(*root, infoVisitor, pMetrics);
+
+	if (node_type == 2 || infoVisitor.geometry_array.empty())
+	{
+		infoVisitor.geometry_array = infoVisitor.other_geometry_array;
+		infoVisitor.texture_array = infoVisitor.other_texture_array;
+	}
+
+	if (infoVisitor.geometry_array.empty())
+	{
+		return false;
+	}
+
+	{
+		MetricsTimer timer(pMetrics, MetricStage::Normals);
+		osgUtil::SmoothingVisitor sv;
+		root->accept(sv);
+	}
+
+	tinygltf::TinyGLTF gltf;
+	tinygltf::Model model;
+	tinygltf::Buffer buffer;
+
+	osg::Vec3f point_max, point_min;
+	OsgBuildState osgState =
+	{
+		&buffer, &model, osg::Vec3f(-1e38,-1e38,-1e38), osg::Vec3f(1e38,1e38,1e38), -1, -1
+	};
+	model.meshes.resize(1);
+	int primitive_idx = 0;
+	size_t vertex_count = 0;
+	size_t triangle_count = 0;
+	for (auto g : infoVisitor.geometry_array)
+	{
+		if (!g->getVertexArray() || g->getVertexArray()->getDataSize() == 0)
+		{
+			continue;
+		}
+
+		WriteOsgGeometry(g, &osgState, enable_meshopt, enable_draco);
+		vertex_count += g->getVertexArray()->getNumElements();
+		triangle_count += CountTriangles(*g);
+		if (infoVisitor.texture_array.size())
+		{
+			for (unsigned int k = 0; k < g->getNumPrimitiveSets(); k++)
+			{
+				auto tex = infoVisitor.texture_map[g];
+				if (tex)
+				{
+					for (auto texture : infoVisitor.texture_array)
+					{
+						model.meshes[0].primitives[primitive_idx].material++;
+						if (tex == texture)
+						{
+							break;
+						}
+					}
+				}
+
+				primitive_idx++;
+			}
+		}
+	}
+
+	if (model.meshes[0].primitives.empty())
+	{
+		return false;
+	}
+
+	if (need_mesh_info)
+	{
+		mesh_info.min =
+		{
+			osgState.point_min.x(),
+			osgState.point_min.y(),
+			osgState.point_min.z()
+		};
+
+		mesh_info.max =
+		{
+			osgState.point_max.x(),
+			osgState.point_max.y(),
+			osgState.point_max.z()
+		};
+	}
+
+	if (pMetrics)
+	{
+		pMetrics->AddNode(vertex_count, triangle_count);
+		pMetrics->AddBytes(MetricBytes::Geometry, buffer.data.size());
+	}
+
+	// image
+	{
+		MetricsTimer timer(pMetrics, MetricStage::EncodeTextures);
+		for (auto tex : infoVisitor.texture_array)
+		{
+			unsigned buffer_start = buffer.data.size();
+
+			std::vector<unsigned char> image_data;
+			std::string mime_type;
+			if (MeshProcessor::ProcessTexture(tex, image_data, mime_type, enable_texture_compress))
 			{
-				std::vector<uint32_t> source;
-				source.reserve(da->getCount());
-				for (int i = 0; i < da->getCount(); ++i)
+				if (pMetrics)
 				{
-					source.emplace_back(i);
+					pMetrics->AddBytes(MetricBytes::Texture, image_data.size());
 				}
 
-				if (TriangulateQuadLike(source, gl_mode, triangulated_indices))
-				{
-					primits.indices = WriteIndexVector(triangulated_indices, osgState, dracoState);
-				}
+				buffer.data.insert(buffer.data.end(), image_data.begin(), image_data.end());
+
+				tinygltf::Image image;
+				image.mimeType = mime_type;
+				image.bufferView = model.bufferViews.size();
+				model.images.emplace_back(image);
+
+				tinygltf::BufferView bfv;
+				bfv.buffer = 0;
+				bfv.byteOffset = buffer_start;
+				AlignmentBuffer(buffer.data);
+				bfv.byteLength = buffer.data.size() - buffer_start;
+				model.bufferViews.emplace_back(bfv);
 			}
-			break;
-		}
-		default:
-		{
-			LOG_E("unsupport osg::PrimitiveSet::Type [{}]", static_cast<int>(t));
-			exit(1);
-			break;
 		}
 	}
 
-	// 顶点：完整顶点和部分索引
-	if (pmtState->vertexAccessor > -1 && osgState->draw_array_first == -1)
+	// node
 	{
-		primits.attributes["POSITION"] = pmtState->vertexAccessor;
+		tinygltf::Node node;
+		node.mesh = 0;
+		model.nodes.emplace_back(node);
 	}
-	else
+
+	// scene
 	{
-		osg::Vec3Array* vertexArr = (osg::Vec3Array*)g->getVertexArray();
-		if (dracoState && dracoState->compressed)
-		{
-			// 创建一个占位符访问器（无bufferView），并设置正确的计数/类型
-			tinygltf::Accessor acc;
-			acc.bufferView = -1;
-			acc.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
-			acc.count = (osgState->draw_array_first >= 0) ? osgState->draw_array_count : (int)vertexArr->size();
-			acc.type = TINYGLTF_TYPE_VEC3;
+		tinygltf::Scene sence;
+		sence.nodes.emplace_back(0);
+		model.scenes = { sence };
+		model.defaultScene = 0;
+	}
 
-			// 计算最大、最小值包围盒
-			osg::Vec3f point_max(-1e38, -1e38, -1e38);
-			osg::Vec3f point_min(1e38, 1e38, 1e38);
-			int vec_start = (osgState->draw_array_first >= 0) ? osgState->draw_array_first : 0;
-			int vec_end = (osgState->draw_array_first >= 0) ? (osgState->draw_array_count + vec_start) : (int)vertexArr->size();
-			for (int vidx = vec_start; vidx < vec_end; vidx++)
-			{
-				osg::Vec3f point = vertexArr->at(vidx);
-				ExpandBbox3d(point_max, point_min, point);
-			}
-			acc.minValues = { point_min.x(), point_min.y(), point_min.z() };
-			acc.maxValues = { point_max.x(), point_max.y(), point_max.z() };
-			int accIdx = (int)osgState->model->accessors.size();
-			osgState->model->accessors.emplace_back(acc);
-			primits.attributes["POSITION"] = accIdx;
-			if (pmtState->vertexAccessor == -1 && osgState->draw_array_first == -1)
-			{
-				pmtState->vertexAccessor = accIdx;
-			}
+	// sample
+	{
+		tinygltf::Sampler sample;
+		sample.magFilter = TINYGLTF_TEXTURE_FILTER_LINEAR;
+		sample.minFilter = TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_LINEAR;
+		sample.wrapS = TINYGLTF_TEXTURE_WRAP_REPEAT;
+		sample.wrapT = TINYGLTF_TEXTURE_WRAP_REPEAT;
+		model.samplers = { sample };
+	}
 
-			if (point_min.x() <= point_max.x() && point_min.y() <= point_max.y() && point_min.z() <= point_max.z())
-			{
-				ExpandBbox3d(osgState->point_max, osgState->point_min, point_max);
-				ExpandBbox3d(osgState->point_max, osgState->point_min, point_min);
-			}
-		}
-		else
-		{
-			osg::Vec3f point_max(-1e38, -1e38, -1e38);
-			osg::Vec3f point_min(1e38, 1e38, 1e38);
-			primits.attributes["POSITION"] = osgState->model->accessors.size();
-			if (pmtState->vertexAccessor == -1 && osgState->draw_array_first == -1)
-			{
-				pmtState->vertexAccessor = osgState->model->accessors.size();
-			}
-			WriteVec3Array(vertexArr, osgState, point_max, point_min);
-			if (point_min.x() <= point_max.x() && point_min.y() <= point_max.y() &&
-				point_min.z() <= point_max.z())
-			{
-				ExpandBbox3d(osgState->point_max, osgState->point_min, point_max);
-				ExpandBbox3d(osgState->point_max, osgState->point_min, point_min);
-			}
-		}
+	// 
+	model.extensionsRequired = { "KHR_materials_unlit" };
+	model.extensionsUsed = { "KHR_materials_unlit" };
+
+	if (enable_texture_compress)
+	{
+		model.extensionsRequired = { "KHR_materials_unlit", "KHR_texture_basisu" };
+		model.extensionsUsed = { "KHR_materials_unlit", "KHR_texture_basisu" };
 	}
 
-	// 法线
-	osg::Vec3Array* normalArr = (osg::Vec3Array*)g->getNormalArray();
-	if (normalArr)
+	if (enable_draco)
 	{
-		if (pmtState->normalAccessor > -1 && osgState->draw_array_first == -1)
-		{
-			primits.attributes["NORMAL"] = pmtState->normalAccessor;
-		}
-		else
+		model.extensionsRequired.emplace_back("KHR_draco_mesh_compression");
+		model.extensionsUsed.emplace_back("KHR_draco_mesh_compression");
+	}
+
+	for (int i = 0; i < infoVisitor.texture_array.size(); i++)
+	{
+		tinygltf::Material mat = MakeDefaultColorMaterial(1.0, 1.0, 1.0);
+		mat.pbrMetallicRoughness.baseColorTexture.index = i;
+		model.materials.emplace_back(mat);
+	}
+
+	// RPB作为备选方案吧
+	//for (auto geom : infoVisitor.geometry_array)
+	//{
+	//	tinygltf::Material mat;
+
+	//	// 如果有材质属性，进行转换                                                                                                                                                  
+	//	if (infoVisitor.material_map.find(geom) != infoVisitor.material_map.end())
+	//	{
+	//		osg::Material* osgMat = infoVisitor.material_map[geom];
+	//		//mat = ConvertOSGBMaterialToPBR(osgMat);
+	//		
+	//		 model.extensionsUsed.emplace_back("KHR_materials_specular");  
+	//		// 如果使用ConvertOSGBMaterialWithSpecularExt, 需要添加的扩展声明
+	//		 mat = ConvertOSGBMaterialWithSpecularExt(osgMat);   
+	//	}
+	//	else
+	//	{
+	//		mat = MakeDefaultColorMaterial(1.0, 1.0, 1.0);
+	//	}
+
+	//	// 关联纹理
+	//	if (infoVisitor.texture_map.find(geom) != infoVisitor.texture_map.end())
+	//	{
+	//		auto tex = infoVisitor.texture_map[geom];
+	//		if (tex)
+	//		{
+	//			int texIndex = 0;
+	//			for (auto texture : infoVisitor.texture_array)
+	//			{
+	//				if (tex == texture)
+	//				{
+	//					mat.pbrMetallicRoughness.baseColorTexture.index = texIndex;
+	//					break;
+	//				}
+	//				texIndex++;
+	//			}
+	//		}
+	//	}
+
+	//	model.materials.emplace_back(mat);
+	//}
+
+	// finish buffer
+	model.buffers.emplace_back(std::move(buffer));
+
+	// texture
+	{
+		int texture_index = 0;
+		for (auto tex : infoVisitor.texture_array)
 		{
-			if (dracoState && dracoState->compressed)
+			tinygltf::Texture texture;
+			texture.sampler = 0;
+
+			if (enable_texture_compress)
 			{
-				tinygltf::Accessor acc;
-				acc.bufferView = -1;
-				acc.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
-				acc.count = (osgState->draw_array_first >= 0) ? osgState->draw_array_count : (int)normalArr->size();
-				acc.type = TINYGLTF_TYPE_VEC3;
-				int accIdx = (int)osgState->model->accessors.size();
-				osgState->model->accessors.emplace_back(acc);
-				primits.attributes["NORMAL"] = accIdx;
-				if (pmtState->normalAccessor == -1 && osgState->draw_array_first == -1)
-				{
-					pmtState->normalAccessor = accIdx;
-				}
+				tinygltf::Value::Object basisu_ext;
+				basisu_ext["source"] = tinygltf::Value(texture_index);
+				texture.extensions["KHR_texture_basisu"] = tinygltf::Value(basisu_ext);
 			}
 			else
 			{
-				osg::Vec3f point_max(-1e38, -1e38, -1e38);
-				osg::Vec3f point_min(1e38, 1e38, 1e38);
-				primits.attributes["NORMAL"] = osgState->model->accessors.size();
-				if (pmtState->normalAccessor == -1 && osgState->draw_array_first == -1)
-				{
-					pmtState->normalAccessor = osgState->model->accessors.size();
-				}
-				WriteVec3Array(normalArr, osgState, point_max, point_min);
+				texture.source = texture_index;
 			}
+
+			texture_index++;
+			model.textures.emplace_back(texture);
 		}
 	}
+	model.asset.version = "2.0";
+	model.asset.generator = "RealScene3D";
+
+	MetricsTimer serialize_timer(pMetrics, MetricStage::Serialize);
+	std::ostringstream ss;
+	bool res = gltf.WriteGltfSceneToStream(&model, ss, false, bBinary);
+	if (res)
+	{
+		glb_buff = ss.str();
+	}
+
+	return res;
+}
+
+bool OSGB23dTiles::ToB3DMBuf(
+	std::string path,
+	std::string& b3dm_buf,
+	TileBox& tile_box,
+	int node_type,
+	bool enable_texture_compress,
+	bool enable_meshopt,
+	bool enable_draco,
+	FilePrefetcher* pPrefetcher,
+	const GeoTransform* pGeoTransform)
+{
+	using nlohmann::json;
+
+	std::string glb_buf;
+	MeshInfo minfo;
+	if (!ToGLBBuf(path, glb_buf, minfo, node_type, true, enable_texture_compress, enable_meshopt, enable_draco,
+		true, pPrefetcher, pGeoTransform))
+	{
+		return false;
+	}
+
+	tile_box.max = minfo.max;
+	tile_box.min = minfo.min;
+
+	MetricsTimer timer(ActiveMetrics(), MetricStage::Serialize);
+
+	int mesh_count = 1;
+	std::string feature_json_string;
+	feature_json_string += "{\"BATCH_LENGTH\":";
+	feature_json_string += std::to_string(mesh_count);
+	feature_json_string += "}";
+	while ((feature_json_string.size() + 28) % 8 != 0)
+	{
+		feature_json_string.push_back(' ');
+	}
 
-	// 纹理坐标
-	osg::Vec2Array* texArr = (osg::Vec2Array*)g->getTexCoordArray(0);
-	if (texArr)
+	json batch_json;
+	std::vector<int> ids;
+	for (int i = 0; i < mesh_count; ++i)
 	{
-		if (pmtState->textcdAccessor > -1 && osgState->draw_array_first == -1)
-		{
-			primits.attributes["TEXCOORD_0"] = pmtState->textcdAccessor;
-		}
-		else
-		{
-			if (dracoState && dracoState->compressed)
-			{
-				tinygltf::Accessor acc;
-				acc.bufferView = -1;
-				acc.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
-				acc.count = (osgState->draw_array_first >= 0) ? osgState->draw_array_count : (int)texArr->size();
-				acc.type = TINYGLTF_TYPE_VEC2;
-				int accIdx = (int)osgState->model->accessors.size();
-				osgState->model->accessors.emplace_back(acc);
-				primits.attributes["TEXCOORD_0"] = accIdx;
-				if (pmtState->textcdAccessor == -1 && osgState->draw_array_first == -1)
-				{
-					pmtState->textcdAccessor = accIdx;
-				}
-			}
-			else
-			{
-				primits.attributes["TEXCOORD_0"] = osgState->model->accessors.size();
-				if (pmtState->textcdAccessor == -1 && osgState->draw_array_first == -1)
-				{
-					pmtState->textcdAccessor = osgState->model->accessors.size();
-				}
-				WriteVec2Array(texArr, osgState);
-			}
-		}
+		ids.emplace_back(i);
 	}
 
-	// 材质
-	primits.material = -1;
-
-	switch (ps->getMode())
+	std::vector<std::string> names;
+	for (int i = 0; i < mesh_count; ++i)
 	{
-		case GL_POINTS:
-			primits.mode = TINYGLTF_MODE_POINTS;
-			break;
-		case GL_LINES:
-			primits.mode = TINYGLTF_MODE_LINE;
-			break;
-		case GL_LINE_LOOP:
-			primits.mode = TINYGLTF_MODE_LINE_LOOP;
-			break;
-		case GL_LINE_STRIP:
-			primits.mode = TINYGLTF_MODE_LINE_STRIP;
-			break;
-		case GL_TRIANGLES:
-			primits.mode = TINYGLTF_MODE_TRIANGLES;
-			break;
-		case GL_TRIANGLE_STRIP:
-			primits.mode = TINYGLTF_MODE_TRIANGLE_STRIP;
-			break;
-		case GL_TRIANGLE_FAN:
-			primits.mode = TINYGLTF_MODE_TRIANGLE_FAN;
-			break;
-		case GL_QUADS:
-			primits.mode = TINYGLTF_MODE_TRIANGLES;
-			break;
-		case GL_QUAD_STRIP:
-			primits.mode = TINYGLTF_MODE_TRIANGLES;
-			break;
-		default:
-			LOG_E("Unsupport Primitive Mode: {}", static_cast<int>(ps->getMode()));
-			exit(1);
-			break;
+		std::string mesh_name = "mesh_";
+		mesh_name += std::to_string(i);
+		names.emplace_back(mesh_name);
 	}
 
-	osgState->model->meshes.back().primitives.emplace_back(primits);
-	if (dracoState && dracoState->compressed)
+	batch_json["batchId"] = ids;
+	batch_json["name"] = names;
+	std::string batch_json_string = batch_json.dump();
+	while (batch_json_string.size() % 8 != 0)
 	{
-		tinygltf::Primitive& backPrim = osgState->model->meshes.back().primitives.back();
-		tinygltf::Value::Object dracoExt;
-		dracoExt["bufferView"] = tinygltf::Value(dracoState->bufferView);
-		tinygltf::Value::Object dracoAttribs;
-		if (dracoState->posId != -1)
-		{
-			dracoAttribs["POSITION"] = tinygltf::Value(dracoState->posId);
-		}
-
-		if (dracoState->normId != -1)
-		{
-			dracoAttribs["NORMAL"] = tinygltf::Value(dracoState->normId);
-		}
+		batch_json_string.push_back(' ');
+	}
 
-		if (dracoState->texId != -1)
-		{
-			dracoAttribs["TEXCOORD_0"] = tinygltf::Value(dracoState->texId);
-		}
+	int feature_json_len = feature_json_string.size();
+	int feature_bin_len = 0;
+	int batch_json_len = batch_json_string.size();
+	int batch_bin_len = 0;
+	int total_len = 28 /*header size*/ + feature_json_len + batch_json_len + glb_buf.size();
 
-		if (dracoState->batchId != -1)
-		{
-			dracoAttribs["_BATCHID"] = tinygltf::Value(dracoState->batchId);
-		}
+	b3dm_buf += "b3dm";
+	int version = 1;
+	PutVal(b3dm_buf, version);
+	PutVal(b3dm_buf, total_len);
+	PutVal(b3dm_buf, feature_json_len);
+	PutVal(b3dm_buf, feature_bin_len);
+	PutVal(b3dm_buf, batch_json_len);
+	PutVal(b3dm_buf, batch_bin_len);
+	b3dm_buf.append(feature_json_string.begin(), feature_json_string.end());
+	b3dm_buf.append(batch_json_string.begin(), batch_json_string.end());
+	b3dm_buf.append(glb_buf);
 
-		dracoExt["attributes"] = tinygltf::Value(dracoAttribs);
-		backPrim.extensions["KHR_draco_mesh_compression"] = tinygltf::Value(dracoExt);
-	}
+	return true;
 }
 
-void OSGB23dTiles::WriteOsgGeometry(osg::Geometry* pGeometry, OsgBuildState* osgState, bool bEnableSimplification, bool bEnableDraco)
+void OSGB23dTiles::DoTileJob(
+	OSGTree& tree,
+	IOutputSink& sink,
+	std::string out_path,
+	int max_lvl,
+	bool enable_texture_compress,
+	bool enable_meshopt,
+	bool enable_draco,
+	FilePrefetcher* pPrefetcher,
+	const GeoTransform* pGeoTransform)
 {
-	if (bEnableSimplification)
+	// 任务取消后不再转换剩余节点（调用方丢弃该瓦片的结果）
+	if (tree.file_name.empty() || IsCancelled())
 	{
-		SimplificationParams simplication_params;
-		simplication_params.bEnableSimplification = true;
-		MeshProcessor::SimplifyMeshGeometry(pGeometry, simplication_params);
+		return;
 	}
 
-	DracoState dracoState = { false, -1, -1, -1, -1, -1 };
-
-	if (bEnableDraco)
+	int lvl = OSGBTools::GetLvlNum(tree.file_name);
+	if (max_lvl != -1 && lvl > max_lvl)
 	{
-		std::vector<unsigned char> compressed_data;
-		size_t compressed_size = 0;
-		DracoCompressionParams draco_params;
-		draco_params.bEnableCompression = true;
-		int dracoPosId = -1, dracoNormId = -1, dracoTexId = -1, dracoBatchId = -1;
-		bool ok = MeshProcessor::CompressMeshGeometry(
-			pGeometry, draco_params, compressed_data, compressed_size, &dracoPosId, &dracoNormId, &dracoTexId, &dracoBatchId, nullptr);
-		if (ok && compressed_size > 0)
-		{
-			unsigned bufOffset = osgState->buffer->data.size();
-			AlignmentBuffer(osgState->buffer->data);
-			bufOffset = osgState->buffer->data.size();
-			osgState->buffer->data.resize(bufOffset + compressed_size);
-			std::memcpy(osgState->buffer->data.data() + bufOffset, compressed_data.data(), compressed_size);
-			tinygltf::BufferView bv;
-			bv.buffer = 0;
-			bv.byteOffset = bufOffset;
-			bv.byteLength = compressed_size;
-			int bvIdx = (int)osgState->model->bufferViews.size();
-			osgState->model->bufferViews.emplace_back(bv);
-			dracoState.compressed = true;
-			dracoState.bufferView = bvIdx;
-			dracoState.posId = dracoPosId;
-			dracoState.normId = dracoNormId;
-			dracoState.texId = dracoTexId;
-			dracoState.batchId = dracoBatchId;
-		}
+		return;
 	}
 
-	osg::PrimitiveSet::Type t = pGeometry->getPrimitiveSet(0)->getType();
-	PrimitiveState pmtState = { -1, -1, -1 };
-	for (unsigned int k = 0; k < pGeometry->getNumPrimitiveSets(); k++)
+	TraceScope trace("DoTileJob", "tile", tree.file_name);
+
+	if (tree.type > 0)
 	{
-		osg::PrimitiveSet* ps = pGeometry->getPrimitiveSet(k);
-		//if (t != ps->getType())
-		//{
-		//	LOG_E("osgb 中 PrimitiveSets 类型不相同");
-		//	exit(1);
-		//}
+		WriteTileNode(tree, sink, out_path, enable_texture_compress, enable_meshopt, enable_draco, pPrefetcher,
+			pGeoTransform);
+	}
 
-		WriteElementArrayPrimitive(pGeometry, ps, osgState, &pmtState, &dracoState);
+	for (auto& i : tree.sub_nodes)
+	{
+		DoTileJob(i, sink, out_path, max_lvl, enable_texture_compress, enable_meshopt, enable_draco, pPrefetcher,
+			pGeoTransform);
 	}
 }
 
-bool OSGB23dTiles::ToGLBBuf(
-	std::string path,
-	std::string& glb_buff,
-	MeshInfo& mesh_info,
-	int node_type,
-	bool bBinary,
+void OSGB23dTiles::WriteTileNode(
+	OSGTree& tree,
+	IOutputSink& sink,
+	const std::string& out_path,
 	bool enable_texture_compress,
 	bool enable_meshopt,
 	bool enable_draco,
-	bool need_mesh_info/* = true*/)
+	FilePrefetcher* pPrefetcher,
+	const GeoTransform* pGeoTransform)
 {
-	vector<string> fileNames = { path };
-	std::string parent_path = OSGBTools::GetParent(path);
+	std::string b3dm_buf;
+	ToB3DMBuf(tree.file_name, b3dm_buf, tree.bbox, tree.type, enable_texture_compress, enable_meshopt, enable_draco,
+		pPrefetcher, pGeoTransform);
+	std::string out_file = out_path;
+	out_file += "/";
+	out_file += TileNodeFileName(tree);
+	if (!b3dm_buf.empty())
+	{
+		sink.Write(out_file, std::move(b3dm_buf));
+	}
+}
 
-	osg::ref_ptr<osg::Node> root = osgDB::readNodeFiles(fileNames);
-	if (!root.valid())
+std::string OSGB23dTiles::EncodeTileJSON(OSGTree& tree, double x, double y)
+{
+	if (tree.bbox.max.empty() || tree.bbox.min.empty())
 	{
-		return false;
+		return "";
 	}
 
-	InfoVisitor infoVisitor(parent_path, node_type == -1);
-	root->accept(infoVisitor);
+	// 使用 TilesetNode 简化边界体积和内容生成（遵循KISS/DRY原则）
+	TilesetNode node;
+	node.geometricError = tree.geometricError;
+	node.boundingVolume = BoundingVolumeFromTileBox(tree.bbox);
 
-	if (node_type == 2 || infoVisitor.geometry_array.empty())
+	// 可选：添加内容URI
+	if (tree.type > 0)
 	{
-		infoVisitor.geometry_array = infoVisitor.other_geometry_array;
-		infoVisitor.texture_array = infoVisitor.other_texture_array;
+		std::string file_name = OSGBTools::GetFileName(tree.file_name);
+		std::string uri = OSGBTools::Replace(file_name, ".osgb", tree.type != 2 ? ".b3dm" : "o.b3dm");
+		node.contentUri = "./" + uri;
 	}
 
-	if (infoVisitor.geometry_array.empty())
+	// 构建JSON（部分使用结构化方法，部分保持递归兼容性）
+	std::string json = "{";
+	json += "\"geometricError\":" + std::to_string(node.geometricError) + ",";
+	json += node.boundingVolume.ToJson();
+
+	// 添加内容（3D Tiles规范：content不需要单独的boundingVolume）
+	if (!node.contentUri.empty())
 	{
-		return false;
+		json += ",\"content\":{\"uri\":\"" + node.contentUri + "\"}";
+	}
+
+	// 递归添加子节点
+	json += ",\"children\":[";
+	for (auto& child : tree.sub_nodes)
+	{
+		std::string child_json = EncodeTileJSON(child, x, y);
+		if (!child_json.empty())
+		{
+			json += child_json + ",";
+		}
+	}
+
+	// 移除末尾的逗号
+	if (json.back() == ',')
+	{
+		json.pop_back();
 	}
 
-	osgUtil::SmoothingVisitor sv;
-	root->accept(sv);
+	json += "]}";
+
+	return json;
+}
+
+OSGTree OSGB23dTiles::GetAllTree(std::string& file_name, FilePrefetcher* pPrefetcher, bool bEstimateBox, int nMaxLevel,
+	const SubsetFilter* pFilter, const GeoTransform* pGeoTransform)
+{
+	OSGTree root_tile;
 
-	tinygltf::TinyGLTF gltf;
-	tinygltf::Model model;
-	tinygltf::Buffer buffer;
+	// 层级低于子集下限的节点只用于查找子节点，作为容器节点并入上级（type 0），不生成内容
+	bool has_content = !pFilter || !pFilter->IsBelowMinLevel(OSGBTools::GetLvlNum(file_name));
 
-	osg::Vec3f point_max, point_min;
-	OsgBuildState osgState =
-	{
-		&buffer, &model, osg::Vec3f(-1e38,-1e38,-1e38), osg::Vec3f(1e38,1e38,1e38), -1, -1
-	};
-	model.meshes.resize(1);
-	int primitive_idx = 0;
-	for (auto g : infoVisitor.geometry_array)
+	InfoVisitor infoVisitor(OSGBTools::GetParent(file_name), false, pGeoTransform);
 	{
-		if (!g->getVertexArray() || g->getVertexArray()->getDataSize() == 0)
+		osg::ref_ptr<osg::Node> root = ReadOsgNode(file_name, pPrefetcher, ActiveMetrics());
+		if (!root)
 		{
-			continue;
+			std::string name = OSGBTools::Utf8String(file_name.c_str());
+			LOG_E("read node files [{}] fail!", name.c_str());
+			return root_tile;
 		}
+		root_tile.file_name = file_name;
+		root_tile.type = has_content ? 1 : 0;
+		AcceptInfoVisitor(*root, infoVisitor, ActiveMetrics());
 
-		WriteOsgGeometry(g, &osgState, enable_meshopt, enable_draco);
-		if (infoVisitor.texture_array.size())
+		// 与 ToGLBBuf 的选择一致：没有 PagedLOD 几何体时使用普通几何体
+		if (bEstimateBox && has_content)
 		{
-			for (unsigned int k = 0; k < g->getNumPrimitiveSets(); k++)
-			{
-				auto tex = infoVisitor.texture_map[g];
-				if (tex)
-				{
-					for (auto texture : infoVisitor.texture_array)
-					{
-						model.meshes[0].primitives[primitive_idx].material++;
-						if (tex == texture)
-						{
-							break;
-						}
-					}
-				}
-
-				primitive_idx++;
-			}
+			root_tile.bbox = GeometryBox(infoVisitor.geometry_array.empty() ?
+				infoVisitor.other_geometry_array : infoVisitor.geometry_array);
 		}
 	}
 
-	if (model.meshes[0].primitives.empty())
-	{
-		return false;
-	}
-
-	if (need_mesh_info)
+	// 超过层级上限或与子集区域不相交的子节点（及其所有下级文件）不读取
+	std::vector<std::string> sub_node_names;
+	for (size_t i = 0; i < infoVisitor.sub_node_names.size(); i++)
 	{
-		mesh_info.min =
+		const std::string& name = infoVisitor.sub_node_names[i];
+		int lvl = OSGBTools::GetLvlNum(name);
+		if ((nMaxLevel != -1 && lvl > nMaxLevel) || (pFilter && pFilter->IsAboveMaxLevel(lvl)))
 		{
-			osgState.point_min.x(),
-			osgState.point_min.y(),
-			osgState.point_min.z()
-		};
+			continue;
+		}
 
-		mesh_info.max =
+		const osg::BoundingSphere& bound = infoVisitor.sub_node_bounds[i];
+		if (pFilter && bound.valid() &&
+			!pFilter->IntersectsSphere(bound.center().x(), bound.center().y(), bound.radius()))
 		{
-			osgState.point_max.x(),
-			osgState.point_max.y(),
-			osgState.point_max.z()
-		};
+			continue;
+		}
+
+		sub_node_names.emplace_back(name);
 	}
 
-	// image
+	if (pPrefetcher)
 	{
-		for (auto tex : infoVisitor.texture_array)
-		{
-			unsigned buffer_start = buffer.data.size();
+		pPrefetcher->Prefetch(sub_node_names);
+	}
 
-			std::vector<unsigned char> image_data;
-			std::string mime_type;
-			if (MeshProcessor::ProcessTexture(tex, image_data, mime_type, enable_texture_compress))
+	for (auto& i : sub_node_names)
+	{
+		OSGTree tree = GetAllTree(i, pPrefetcher, bEstimateBox, nMaxLevel, pFilter, pGeoTransform);
+		if (!tree.file_name.empty())
+		{
+			if (tree.type == 0)
 			{
-				buffer.data.insert(buffer.data.end(), image_data.begin(), image_data.end());
-
-				tinygltf::Image image;
-				image.mimeType = mime_type;
-				image.bufferView = model.bufferViews.size();
-				model.images.emplace_back(image);
-
-				tinygltf::BufferView bfv;
-				bfv.buffer = 0;
-				bfv.byteOffset = buffer_start;
-				AlignmentBuffer(buffer.data);
-				bfv.byteLength = buffer.data.size() - buffer_start;
-				model.bufferViews.emplace_back(bfv);
+				for (auto& node : tree.sub_nodes)
+				{
+					root_tile.sub_nodes.emplace_back(node);
+				}
+			}
+			else
+			{
+				root_tile.sub_nodes.emplace_back(tree);
 			}
 		}
 	}
 
-	// node
+	if (has_content && !infoVisitor.other_geometry_array.empty() && !infoVisitor.geometry_array.empty())
 	{
-		tinygltf::Node node;
-		node.mesh = 0;
-		model.nodes.emplace_back(node);
+		OSGTree new_root_tile;
+		new_root_tile.type = 0;
+		new_root_tile.file_name = file_name;
+		OSGTree tile;
+		tile.type = 2;
+		tile.file_name = file_name;
+		if (bEstimateBox)
+		{
+			tile.bbox = GeometryBox(infoVisitor.other_geometry_array);
+		}
+		new_root_tile.sub_nodes.emplace_back(root_tile);
+		new_root_tile.sub_nodes.emplace_back(tile);
+		root_tile = new_root_tile;
 	}
 
-	// scene
-	{
-		tinygltf::Scene sence;
-		sence.nodes.emplace_back(0);
-		model.scenes = { sence };
-		model.defaultScene = 0;
-	}
+	return root_tile;
+}
 
-	// sample
-	{
-		tinygltf::Sampler sample;
-		sample.magFilter = TINYGLTF_TEXTURE_FILTER_LINEAR;
-		sample.minFilter = TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_LINEAR;
-		sample.wrapS = TINYGLTF_TEXTURE_WRAP_REPEAT;
-		sample.wrapT = TINYGLTF_TEXTURE_WRAP_REPEAT;
-		model.samplers = { sample };
-	}
+//===============OSGB23dTiles 批量处理==================
 
-	// 
-	model.extensionsRequired = { "KHR_materials_unlit" };
-	model.extensionsUsed = { "KHR_materials_unlit" };
+bool OSGB23dTiles::ToB3DMBatch(
+	const std::string& pDataDir,
+	const std::string& strOutputDir,
+	double dCenterX,
+	double dCenterY,
+	int nMaxLevel,
+	bool bEnableTextureCompress,
+	bool bEnableMeshOpt,
+	bool bEnableDraco,
+	IOutputSink* pSink)
+{
+	// 统计本次批量转换（各瓦片的转换计入同一统计），启用跟踪时记录本次转换的时间线
+	MetricsSession metrics_session(ActiveMetrics(), metrics_settings.nSlowestTiles);
+	TraceSession trace_session(trace_settings);
 
-	if (enable_texture_compress)
-	{
-		model.extensionsRequired = { "KHR_materials_unlit", "KHR_texture_basisu" };
-		model.extensionsUsed = { "KHR_materials_unlit", "KHR_texture_basisu" };
-	}
+	// 1. 构建 Data 目录路径
+	std::string data_path = OSGBTools::OSGString(pDataDir);
 
-	if (enable_draco)
+	// 移除尾部斜杠
+	if (!data_path.empty() && data_path.back() == '/')
 	{
-		model.extensionsRequired.emplace_back("KHR_draco_mesh_compression");
-		model.extensionsUsed.emplace_back("KHR_draco_mesh_compression");
+		data_path.pop_back();
 	}
 
-	for (int i = 0; i < infoVisitor.texture_array.size(); i++)
+	// 输入位于ZIP压缩包内（如 "D:/survey.zip" 或 "D:/survey.zip/Data"）时直接读取包内条目，
+	// 任务结束后释放压缩包（其他任务仍在读取同一压缩包时保留映射）
+	struct ZipReleaseGuard
 	{
-		tinygltf::Material mat = MakeDefaultColorMaterial(1.0, 1.0, 1.0);
-		mat.pbrMetallicRoughness.baseColorTexture.index = i;
-		model.materials.emplace_back(mat);
+		std::shared_ptr<ZipFileSystem> zip;
+		~ZipReleaseGuard()
+		{
+			if (zip)
+			{
+				ZipFileSystem::Release(zip->GetArchivePath());
+			}
+		}
+	};
+	std::string zip_entry;
+	ZipReleaseGuard zip_guard{ ZipFileSystem::Acquire(data_path, zip_entry) };
+	if (zip_guard.zip)
+	{
+		LOG_I("从压缩包读取输入: {} (包内路径: {})", zip_guard.zip->GetArchivePath(), zip_entry);
 	}
 
-	// RPB作为备选方案吧
-	//for (auto geom : infoVisitor.geometry_array)
-	//{
-	//	tinygltf::Material mat;
+	// 2. 尝试解析 metadata.xml 以获取坐标系统信息
+	// 坐标转换只属于本次转换（与子集过滤器一样逐层传给读取节点的函数），同时运行的任务互不影响
+	OSGBMetadata metadata;
+	bool has_metadata = false;
+	GeoTransform geo_transform;
 
-	//	// 如果有材质属性，进行转换                                                                                                                                                  
-	//	if (infoVisitor.material_map.find(geom) != infoVisitor.material_map.end())
-	//	{
-	//		osg::Material* osgMat = infoVisitor.material_map[geom];
-	//		//mat = ConvertOSGBMaterialToPBR(osgMat);
-	//		
-	//		 model.extensionsUsed.emplace_back("KHR_materials_specular");  
-	//		// 如果使用ConvertOSGBMaterialWithSpecularExt, 需要添加的扩展声明
-	//		 mat = ConvertOSGBMaterialWithSpecularExt(osgMat);   
-	//	}
-	//	else
-	//	{
-	//		mat = MakeDefaultColorMaterial(1.0, 1.0, 1.0);
-	//	}
+	if (LoadDatasetMetadata(pDataDir, metadata))
+	{
+		has_metadata = true;
 
-	//	// 关联纹理
-	//	if (infoVisitor.texture_map.find(geom) != infoVisitor.texture_map.end())
-	//	{
-	//		auto tex = infoVisitor.texture_map[geom];
-	//		if (tex)
-	//		{
-	//			int texIndex = 0;
-	//			for (auto texture : infoVisitor.texture_array)
-	//			{
-	//				if (tex == texture)
-	//				{
-	//					mat.pbrMetallicRoughness.baseColorTexture.index = texIndex;
-	//					break;
-	//				}
-	//				texIndex++;
-	//			}
-	//		}
-	//	}
+		if (metadata.bIsENU)
+		{
+			// ENU 坐标系统
+			LOG_I("使用 ENU 坐标系统");
+			LOG_I("  地理原点：纬度={:.6f}，经度={:.6f}", metadata.dCenterLat, metadata.dCenterLon);
+			LOG_I("  SRSOrigin 偏移：x={:.3f}, y={:.3f}, z={:.3f}", metadata.dOffsetX, metadata.dOffsetY, metadata.dOffsetZ);
 
-	//	model.materials.emplace_back(mat);
-	//}
+			// 调用 enu_init 初始化 GeoTransform
+			// 注意：enu_init 需要经度在前，纬度在后
+			double origin_enu[3] = { metadata.dOffsetX, metadata.dOffsetY, metadata.dOffsetZ };
+			if (geo_transform.InitFromENU(metadata.dCenterLon, metadata.dCenterLat, origin_enu))
+			{
+				LOG_I("ENU 系统 GeoTransform 初始化成功");
 
-	// finish buffer
-	model.buffers.emplace_back(std::move(buffer));
+				// 使用 metadata 中的坐标作为中心点
+				dCenterX = metadata.dCenterLon;
+				dCenterY = metadata.dCenterLat;
+			}
+			else
+			{
+				LOG_E("ENU 系统 GeoTransform 初始化失败");
+			}
+		}
+		else if (metadata.bIsEPSG)
+		{
+			// EPSG 坐标系统
+			LOG_I("使用 EPSG:{} 坐标系统", metadata.nEpsgCode);
+			LOG_I("  SRSOrigin: {}", metadata.strSrsOrigin.c_str());
 
-	// texture
-	{
-		int texture_index = 0;
-		for (auto tex : infoVisitor.texture_array)
+			// 解析 SRSOrigin 为投影坐标
+			double origin[3] = { metadata.dOffsetX, metadata.dOffsetY, metadata.dOffsetZ };
+			// 调用 epsg_convert 转换为经纬度
+			if (geo_transform.InitFromEPSG(metadata.nEpsgCode, origin))
+			{
+				LOG_I("EPSG:{} 系统 GeoTransform 初始化成功", metadata.nEpsgCode);
+				LOG_I("  转换为地理坐标：经度={:.6f}，纬度={:.6f}，海拔={:.3f}", origin[0], origin[1], origin[2]);
+
+				// 使用转换后的经纬度作为中心点
+				dCenterX = origin[0];
+				dCenterY = origin[1];
+			}
+			else
+			{
+				LOG_E("EPSG:{} 坐标转换失败", metadata.nEpsgCode);
+			}
+		}
+		else if (metadata.bIsWKT)
 		{
-			tinygltf::Texture texture;
-			texture.sampler = 0;
+			// WKT 格式坐标系统
+			LOG_I("使用 WKT 投影");
+			LOG_I("  SRSOrigin: {}", metadata.strSrsOrigin.c_str());
+			// 解析 SRSOrigin 为投影坐标
+			double origin[3] = { metadata.dOffsetX, metadata.dOffsetY, metadata.dOffsetZ };
 
-			if (enable_texture_compress)
+			// 调用 InitFromWKT 转换为经纬度
+			if (geo_transform.InitFromWKT(metadata.strSrs.c_str(), origin))
 			{
-				tinygltf::Value::Object basisu_ext;
-				basisu_ext["source"] = tinygltf::Value(texture_index);
-				texture.extensions["KHR_texture_basisu"] = tinygltf::Value(basisu_ext);
+				LOG_I("WKT 投影 GeoTransform 初始化成功");
+				LOG_I("  转换为地理坐标：经度={:.6f}，纬度={:.6f}，海拔={:.3f}", origin[0], origin[1], origin[2]);
+
+				// 使用转换后的经纬度作为中心点
+				dCenterX = origin[0];
+				dCenterY = origin[1];
 			}
 			else
 			{
-				texture.source = texture_index;
+				LOG_E("WKT 坐标转换失败");
 			}
-
-			texture_index++;
-			model.textures.emplace_back(texture);
 		}
 	}
-	model.asset.version = "2.0";
-	model.asset.generator = "RealScene3D";
-
-	std::ostringstream ss;
-	bool res = gltf.WriteGltfSceneToStream(&model, ss, false, bBinary);
-	if (res)
+	else
 	{
-		glb_buff = ss.str();
+		LOG_W("metadata.xml 未找到或解析失败，使用提供的 center_x={:.6f}, center_y={:.6f}", dCenterX, dCenterY);
 	}
 
-	return res;
-}
+	// 子集区域为数据集坐标系，节点坐标相对 SRSOrigin；过滤器只属于本次转换，逐层传给读取节点树的函数
+	const SubsetFilter subset_filter = has_metadata ?
+		SubsetFilter(subset, metadata.dOffsetX, metadata.dOffsetY) : SubsetFilter(subset);
 
-bool OSGB23dTiles::ToB3DMBuf(
-	std::string path,
-	std::string& b3dm_buf,
-	TileBox& tile_box,
-	int node_type,
-	bool enable_texture_compress,
-	bool enable_meshopt,
-	bool enable_draco)
-{
-	using nlohmann::json;
+	// 3. 检测数据源类型
+	bool is_oblique_data = false;  // 是否为倾斜摄影数据集
+	std::string check_data_dir = data_path;
 
-	std::string glb_buf;
-	MeshInfo minfo;
-	if (!ToGLBBuf(path, glb_buf, minfo, node_type, true, enable_texture_compress, enable_meshopt, enable_draco))
+	// 检查路径是否以 "/Data" 结尾
+	size_t data_pos = data_path.rfind("/Data");
+	if (data_pos == std::string::npos || data_pos != data_path.length() - 5)
 	{
-		return false;
+		// 不以 "/Data" 结尾，追加它
+		check_data_dir = data_path + "/Data";
 	}
 
-	tile_box.max = minfo.max;
-	tile_box.min = minfo.min;
-
-	int mesh_count = 1;
-	std::string feature_json_string;
-	feature_json_string += "{\"BATCH_LENGTH\":";
-	feature_json_string += std::to_string(mesh_count);
-	feature_json_string += "}";
-	while ((feature_json_string.size() + 28) % 8 != 0)
+	// 检测是否为倾斜摄影数据集
+	if (OSGBTools::IsDirectory(check_data_dir) && has_metadata)
 	{
-		feature_json_string.push_back(' ');
+		is_oblique_data = true;
+		LOG_I("检测到倾斜摄影数据集模式 (Data目录 + metadata.xml)");
+		OSGBLog::LOG_I("[INFO] 在以下位置搜索瓦片：{}", check_data_dir);
+	}
+	else
+	{
+		// 尝试纯OSGB文件夹模式
+		check_data_dir = data_path;
+		LOG_I("检测到纯OSGB文件夹模式");
+		OSGBLog::LOG_I("[INFO] 扫描OSGB文件夹：{}", check_data_dir);
 	}
 
-	json batch_json;
-	std::vector<int> ids;
-	for (int i = 0; i < mesh_count; ++i)
+	// 4. 准备输出目标并创建输出目录；未指定时异步写入本地文件系统
+	std::unique_ptr<IOutputSink> local_sink;
+	if (pSink == nullptr)
 	{
-		ids.emplace_back(i);
+		// 记录进度日志时，检查点屏障对此前写入的瓦片文件执行 fsync，再把瓦片记入（fsync 的）日志
+		AsyncWriteSettings write_settings = local_write;
+		write_settings.bSyncOnBarrier = write_settings.bSyncOnBarrier || resume.bEnable;
+		local_sink = std::make_unique<LocalFileSink>(true, write_settings);
+		pSink = local_sink.get();
 	}
 
-	std::vector<std::string> names;
-	for (int i = 0; i < mesh_count; ++i)
+	// 异步任务：统计写入字节数
+	std::unique_ptr<IOutputSink> progress_sink;
+	if (job_control)
 	{
-		std::string mesh_name = "mesh_";
-		mesh_name += std::to_string(i);
-		names.emplace_back(mesh_name);
+		progress_sink = std::make_unique<JobProgressSink>(*pSink, *job_control);
+		pSink = progress_sink.get();
 	}
 
-	batch_json["batchId"] = ids;
-	batch_json["name"] = names;
-	std::string batch_json_string = batch_json.dump();
-	while (batch_json_string.size() % 8 != 0)
+	// 转换统计：输出字节数与写入耗时
+	std::unique_ptr<IOutputSink> metrics_sink;
+	if (metrics_session.IsOutermost())
 	{
-		batch_json_string.push_back(' ');
+		metrics_sink = std::make_unique<MetricsSink>(*pSink, metrics);
+		pSink = metrics_sink.get();
 	}
 
-	int feature_json_len = feature_json_string.size();
-	int feature_bin_len = 0;
-	int batch_json_len = batch_json_string.size();
-	int batch_bin_len = 0;
-	int total_len = 28 /*header size*/ + feature_json_len + batch_json_len + glb_buf.size();
+	pSink->MakeDirs(strOutputDir);
 
-	b3dm_buf += "b3dm";
-	int version = 1;
-	PutVal(b3dm_buf, version);
-	PutVal(b3dm_buf, total_len);
-	PutVal(b3dm_buf, feature_json_len);
-	PutVal(b3dm_buf, feature_bin_len);
-	PutVal(b3dm_buf, batch_json_len);
-	PutVal(b3dm_buf, batch_bin_len);
-	b3dm_buf.append(feature_json_string.begin(), feature_json_string.end());
-	b3dm_buf.append(batch_json_string.begin(), batch_json_string.end());
-	b3dm_buf.append(glb_buf);
+	// 5. 收集所有子目录/OSGB文件
+	struct TileInfo {
+		std::string tile_name;
+		std::string osgb_path;
+		std::string output_path;
+		std::string source_dir;
+		TileBox bbox;
+	};
 
-	return true;
-}
+	std::vector<TileInfo> tiles;
+	TileBox global_bbox;
 
-void OSGB23dTiles::DoTileJob(
-	OSGTree& tree,
-	std::string out_path,
-	int max_lvl,
-	bool enable_texture_compress,
-	bool enable_meshopt,
-	bool enable_draco)
-{
-	if (tree.file_name.empty())
+	if (is_oblique_data)
 	{
-		return;
+		// 倾斜摄影模式：扫描 Tile_* 目录
+		std::string out_data_path = strOutputDir + "/Data";
+		pSink->MakeDirs(out_data_path);
+
+		// 并行扫描 Tile_* 目录（数据目录未变化时复用扫描清单）
+		DatasetScanner scanner;
+		std::vector<DatasetEntry> tile_entries = scanner.ScanTiles(check_data_dir);
+		if (tile_entries.empty())
+		{
+			LOG_E("未找到任何 Tile_* 目录：{}", check_data_dir.c_str());
+			return false;
+		}
+
+		for (const auto& tile_entry : tile_entries)
+		{
+			TileInfo info;
+			info.tile_name = tile_entry.name;
+			info.osgb_path = tile_entry.root_path;
+			info.output_path = out_data_path + "/" + tile_entry.name;
+			info.source_dir = check_data_dir + "/" + tile_entry.name;
+			tiles.emplace_back(info);
+		}
 	}
+	else
+	{
+		// 纯OSGB文件夹模式：
+		// 1. 先检查输入目录本身是否包含OSGB文件
+		// 2. 如果不包含，再扫描子目录
 
-	int lvl = OSGBTools::GetLvlNum(tree.file_name);
-	if (max_lvl != -1 && lvl > max_lvl)
+		std::vector<std::string> osgb_files_in_root = OSGBTools::ScanOSGBFiles(check_data_dir, false);
+
+		if (!osgb_files_in_root.empty())
+		{
+			// 情况1：输入目录本身就包含OSGB文件（如 E:\Data\3D\Tile_+005_+006）
+			LOG_I("输入目录本身包含 {:zu} 个OSGB文件", osgb_files_in_root.size());
+
+			// 查找根OSGB文件
+			std::string root_osgb = OSGBTools::FindRootOSGB(check_data_dir);
+			if (root_osgb.empty())
+			{
+				// 如果没有找到根OSGB，使用第一个文件
+				root_osgb = osgb_files_in_root[0];
+				LOG_I("未找到根OSGB，使用第一个文件: {}", root_osgb.c_str());
+			}
+			else
+			{
+				LOG_I("找到根OSGB: {}", root_osgb.c_str());
+			}
+
+			// 获取目录名作为tile名称
+			std::string dir_name = OSGBTools::GetFileName(check_data_dir);
+			if (dir_name.empty())
+			{
+				dir_name = "output";
+			}
+
+			TileInfo info;
+			info.tile_name = dir_name;
+			info.osgb_path = root_osgb;
+			info.output_path = strOutputDir + "/" + dir_name;
+			info.source_dir = check_data_dir;
+			tiles.emplace_back(info);
+		}
+		else
+		{
+			// 情况2：输入目录不包含OSGB，并行扫描子目录并查找各自的根OSGB
+			DatasetScanner scanner;
+			std::vector<DatasetEntry> folder_entries = scanner.ScanFolders(check_data_dir);
+
+			LOG_I("找到 {} 个包含OSGB文件的子目录", folder_entries.size());
+
+			for (const auto& folder_entry : folder_entries)
+			{
+				TileInfo info;
+				info.tile_name = folder_entry.name;
+				info.osgb_path = folder_entry.root_path;
+				info.output_path = strOutputDir + "/" + folder_entry.name;
+				info.source_dir = check_data_dir + "/" + folder_entry.name;
+				tiles.emplace_back(info);
+			}
+		}
+	}
+
+	if (tiles.empty())
 	{
-		return;
+		LOG_E("未找到任何OSGB数据");
+		return false;
 	}
 
-	if (tree.type > 0)
+	// 转换子集：只读取各瓦片的根OSGB，与区域不相交的瓦片不再处理
+	if (subset_filter.HasRegion())
 	{
-		std::string b3dm_buf;
-		ToB3DMBuf(tree.file_name, b3dm_buf, tree.bbox, tree.type, enable_texture_compress, enable_meshopt, enable_draco);
-		std::string out_file = out_path;
-		out_file += "/";
-		out_file += OSGBTools::Replace(OSGBTools::GetFileName(tree.file_name), ".osgb", tree.type != 2 ? ".b3dm" : "o.b3dm");
-		if (!b3dm_buf.empty())
+		std::vector<char> keep(tiles.size(), 1);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int i = 0; i < static_cast<int>(tiles.size()); i++)
+		{
+			// 读取失败的瓦片保留，由转换时报告错误
+			osg::ref_ptr<osg::Node> node = ReadOsgNode(tiles[i].osgb_path, nullptr, ActiveMetrics());
+			if (!node)
+			{
+				continue;
+			}
+
+			const osg::BoundingSphere& bound = node->getBound();
+			if (bound.valid() && !subset_filter.IntersectsSphere(bound.center().x(), bound.center().y(), bound.radius()))
+			{
+				keep[i] = 0;
+			}
+		}
+
+		std::vector<TileInfo> selected;
+		for (size_t i = 0; i < tiles.size(); i++)
+		{
+			if (keep[i])
+			{
+				selected.emplace_back(std::move(tiles[i]));
+			}
+		}
+
+		LOG_I("转换子集：{} 个瓦片中 {} 个与区域相交", tiles.size(), selected.size());
+		tiles = std::move(selected);
+
+		if (tiles.empty())
 		{
-			OSGBTools::WriteFile(out_file.c_str(), b3dm_buf.data(), b3dm_buf.size());
+			LOG_E("没有与转换区域相交的瓦片");
+			return false;
 		}
 	}
 
-	for (auto& i : tree.sub_nodes)
+	for (const auto& tile : tiles)
 	{
-		DoTileJob(i, out_path, max_lvl, enable_texture_compress, enable_meshopt, enable_draco);
+		pSink->MakeDirs(tile.output_path);
 	}
-}
 
-std::string OSGB23dTiles::EncodeTileJSON(OSGTree& tree, double x, double y)
-{
-	if (tree.bbox.max.empty() || tree.bbox.min.empty())
+	OSGBLog::LOG_I("[INFO] 找到 {} 个瓦片目录待处理", tiles.size());
+
+	if (job_control)
 	{
-		return "";
+		job_control->Begin(static_cast<int>(tiles.size()));
 	}
 
-	// 使用 TilesetNode 简化边界体积和内容生成（遵循KISS/DRY原则）
-	TilesetNode node;
-	node.geometricError = tree.geometricError;
-	node.boundingVolume = BoundingVolumeFromTileBox(tree.bbox);
+	// 影响瓦片输出的参数，任何一项变化都会使增量清单与进度日志作废
+	const std::string settings_key = MakeSettingsKey(data_path, dCenterX, dCenterY, nMaxLevel,
+		bEnableTextureCompress, bEnableMeshOpt, bEnableDraco, lazy, subset, has_metadata ? &metadata : nullptr);
 
-	// 可选：添加内容URI
-	if (tree.type > 0)
+	// 增量转换：读取上次的清单，清单默认保存在本地输出目录
+	std::unique_ptr<IncrementalManifest> manifest;
+	std::string manifest_path;
+	if (incremental.bEnable)
 	{
-		std::string file_name = OSGBTools::GetFileName(tree.file_name);
-		std::string uri = OSGBTools::Replace(file_name, ".osgb", tree.type != 2 ? ".b3dm" : "o.b3dm");
-		node.contentUri = "./" + uri;
-	}
+		manifest_path = incremental.strManifestPath;
+		if (manifest_path.empty() && local_sink)
+		{
+			manifest_path = strOutputDir + "/.osgb-incremental.json";
+		}
 
-	// 构建JSON（部分使用结构化方法，部分保持递归兼容性）
-	std::string json = "{";
-	json += "\"geometricError\":" + std::to_string(node.geometricError) + ",";
-	json += node.boundingVolume.ToJson();
+		if (manifest_path.empty())
+		{
+			LOG_W("输出目标不是本地目录且未指定增量清单路径，本次全部转换");
+		}
+		else
+		{
+			manifest = std::make_unique<IncrementalManifest>();
+			if (manifest->Load(manifest_path, settings_key))
+			{
+				LOG_I("使用增量清单: {}", manifest_path);
+			}
+		}
+	}
 
-	// 添加内容（3D Tiles规范：content不需要单独的boundingVolume）
-	if (!node.contentUri.empty())
+	// 断点续传：上次运行中断时留下的进度日志中的瓦片不再转换
+	std::unique_ptr<BatchJournal> journal;
+	if (resume.bEnable)
 	{
-		json += ",\"content\":{\"uri\":\"" + node.contentUri + "\"}";
+		std::string journal_path = resume.strJournalPath;
+		if (journal_path.empty() && local_sink)
+		{
+			journal_path = strOutputDir + "/.osgb-journal.jsonl";
+		}
+
+		if (!journal_path.empty())
+		{
+			journal = std::make_unique<BatchJournal>();
+			if (!journal->Open(journal_path, settings_key, resume.nCheckpointSeconds))
+			{
+				journal.reset();
+			}
+		}
 	}
+	std::atomic<bool> checkpoint_failed{ false };
+	int resumed_count = 0;
+
+	// 5. 处理每个瓦片（使用 OpenMP 并行加速）
+	std::vector<std::string> tile_jsons;
+	int skipped_count = 0;
 
-	// 递归添加子节点
-	json += ",\"children\":[";
-	for (auto& child : tree.sub_nodes)
+	// 记录瓦片包围盒并合并到全局包围盒（调用方须在 data_update 临界区内）
+	auto AddTileBox = [&global_bbox](TileInfo& tile, const std::array<double, 6>& bbox)
 	{
-		std::string child_json = EncodeTileJSON(child, x, y);
-		if (!child_json.empty())
+		tile.bbox.max = { bbox[0], bbox[1], bbox[2] };
+		tile.bbox.min = { bbox[3], bbox[4], bbox[5] };
+
+		if (global_bbox.max.empty())
 		{
-			json += child_json + ",";
+			global_bbox = tile.bbox;
 		}
-	}
+		else
+		{
+			ExpandBox(global_bbox, tile.bbox);
+		}
+	};
 
-	// 移除末尾的逗号
-	if (json.back() == ',')
+	// 瓦片转换完成：合并包围盒、登记增量清单、写入瓦片 tileset.json 并记入进度日志
+	auto OnTileConverted = [&](TileInfo& tile, const std::string& fingerprint, const B3DMResult& result)
 	{
-		json.pop_back();
-	}
+		if (job_control)
+		{
+			job_control->TileFinished(result.success && !result.tilesetJson.empty());
+		}
 
-	json += "]}";
+		if (!result.success || result.tilesetJson.empty())
+		{
+			LOG_E("处理瓦片失败：{}", tile.tile_name.c_str());
+			return;
+		}
 
-	return json;
-}
+		// 临界区：保护共享数据（tile_jsons 和 global_bbox）
+#ifdef _OPENMP
+#pragma omp critical(data_update)
+#endif
+		{
+			tile_jsons.emplace_back(result.tilesetJson);
 
-OSGTree OSGB23dTiles::GetAllTree(std::string& file_name)
-{
-	OSGTree root_tile;
-	vector<string> fileNames = { file_name };
+			// 更新边界框并合并到全局边界框
+			AddTileBox(tile, result.boundingBox);
+		}
 
-	InfoVisitor infoVisitor(OSGBTools::GetParent(file_name));
-	{
-		osg::ref_ptr<osg::Node> root = osgDB::readNodeFiles(fileNames);
-		if (!root)
+		if (manifest)
 		{
-			std::string name = OSGBTools::Utf8String(file_name.c_str());
-			LOG_E("read node files [{}] fail!", name.c_str());
-			return root_tile;
+			manifest->Update(tile.tile_name, fingerprint, result.boundingBox);
 		}
-		root_tile.file_name = file_name;
-		root_tile.type = 1;
-		root->accept(infoVisitor);
-	}
 
-	for (auto& i : infoVisitor.sub_node_names)
+		// 保存单个瓦片的 tileset.json（文件写入通常是线程安全的）
+		std::string tileset_path = tile.output_path + "/tileset.json";
+		pSink->Write(tileset_path, WrapTileTileset(result.tilesetJson));
+
+		// 瓦片的全部文件已提交，下一个检查点确认写入后记入进度日志
+		if (journal)
+		{
+			journal->Complete({ tile.tile_name, result.boundingBox,
+				ReadRootGeometricError(result.tilesetJson), tileset_path, fingerprint });
+			if (!journal->Checkpoint(*pSink, false))
+			{
+				checkpoint_failed = true;
+			}
+		}
+	};
+
+	// 生成根 tileset.json，子瓦片使用 tiles 中记录的包围盒
+	auto BuildRootTileset = [&](const TileBox& bbox_all)
 	{
-		OSGTree tree = GetAllTree(i);
-		if (!tree.file_name.empty())
+		// 6. 计算变换矩阵
+		std::vector<double> transform_matrix(16);
 		{
-			if (tree.type == 0)
+			// 使用合并的全局边界框的最小高度
+			double height_min = bbox_all.min.empty() ? 0.0 : bbox_all.min[2];
+
+			// 对于ENU坐标系，需要应用SRSOrigin偏移到根节点变换矩阵
+			if (has_metadata && metadata.bIsENU)
 			{
-				for (auto& node : tree.sub_nodes)
-				{
-					root_tile.sub_nodes.emplace_back(node);
-				}
+				LOG_I("应用ENU offset到根节点变换矩阵: ({:.3f}, {:.3f}, {:.3f})",
+					metadata.dOffsetX, metadata.dOffsetY, metadata.dOffsetZ);
+				OSGBTools::TransformCWithEnuOffset(
+					dCenterX, dCenterY, height_min,
+					metadata.dOffsetX, metadata.dOffsetY, metadata.dOffsetZ,
+					transform_matrix.data());
 			}
 			else
 			{
-				root_tile.sub_nodes.emplace_back(tree);
+				OSGBTools::TransformC(dCenterX, dCenterY, height_min, transform_matrix.data());
 			}
 		}
-	}
 
-	if (!infoVisitor.other_geometry_array.empty() && !infoVisitor.geometry_array.empty())
-	{
-		OSGTree new_root_tile;
-		new_root_tile.type = 0;
-		new_root_tile.file_name = file_name;
-		OSGTree tile;
-		tile.type = 2;
-		tile.file_name = file_name;
-		new_root_tile.sub_nodes.emplace_back(root_tile);
-		new_root_tile.sub_nodes.emplace_back(tile);
-		root_tile = new_root_tile;
-	}
+		// 7. 生成根 tileset.json（使用 TilesetNode，减少73%代码）
+		TilesetNode rootNode;
+		rootNode.geometricError = 2000;
+		rootNode.boundingVolume = BoundingVolumeFromTileBox(bbox_all);
+		rootNode.transform = transform_matrix;
 
-	return root_tile;
-}
+		// 添加子瓦片节点
+		for (const auto& tile : tiles)
+		{
+			TilesetNode childNode;
+			childNode.geometricError = 1000;
+			childNode.boundingVolume = BoundingVolumeFromTileBox(tile.bbox);
 
-//===============OSGB23dTiles 批量处理==================
+			// 根据数据集类型生成URI
+			if (is_oblique_data)
+			{
+				childNode.contentUri = "./Data/" + tile.tile_name + "/tileset.json";
+			}
+			else
+			{
+				childNode.contentUri = "./" + tile.tile_name + "/tileset.json";
+			}
 
-bool OSGB23dTiles::ToB3DMBatch(
-	const std::string& pDataDir,
-	const std::string& strOutputDir,
-	double dCenterX,
-	double dCenterY,
-	int nMaxLevel,
-	bool bEnableTextureCompress,
-	bool bEnableMeshOpt,
-	bool bEnableDraco,
-	bool bWriteToMinio)
-{
-	// 1. 构建 Data 目录路径
-	std::string data_path = OSGBTools::OSGString(pDataDir);
+			rootNode.children.emplace_back(childNode);
+		}
 
-	// 移除尾部斜杠
-	if (!data_path.empty() && data_path.back() == '/')
-	{
-		data_path.pop_back();
-	}
+		// 生成JSON,includeAsset=true
+		return rootNode.ToJson(true);
+	};
 
-	// 获取根目录（data_dir 的父目录，用于查找 metadata.xml）
-	std::string root_dir = data_path;
-	size_t data_pos = data_path.rfind("/Data");
-	if (data_pos != std::string::npos && data_pos == data_path.length() - 5)
-	{
-		// 如果已经是 /Data 结尾，去掉它
-		root_dir = data_path.substr(0, data_pos);
-	}
+	// 渐进式发布时先完成跳过检查，需要转换的瓦片在循环后按LOD层级统一转换
+	std::vector<std::string> fingerprints(tiles.size());
+	std::vector<int> progressive_tiles;
 
-	// 2. 尝试解析 metadata.xml 以获取坐标系统信息
-	std::string metadata_path = root_dir + "/metadata.xml";
-	OSGBMetadata metadata;
-	bool has_metadata = false;
+	// 本任务占用的调度槽位上限
+	JobGroup job_group(max_concurrency);
+
+	// 进度日志限流：瓦片很多时按时间间隔输出
+	LogThrottle progress_log(AsyncLog::ProgressIntervalMs());
+
+#ifdef _OPENMP
+	// 获取可用线程数
+	int num_threads = omp_get_max_threads();
+	OSGBLog::LOG_I("[INFO] 使用 OpenMP 并行处理，线程数：{}", num_threads);
 
-	if (OSGBTools::ParseMetadataXml(metadata_path, metadata))
+	// 使用 dynamic 调度以平衡不同瓦片的处理时间差异
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for (int i = 0; i < static_cast<int>(tiles.size()); i++)
 	{
-		has_metadata = true;
+		// 任务已取消：剩余瓦片不再处理（OpenMP 循环不能提前退出）
+		if (IsCancelled())
+		{
+			continue;
+		}
 
-		if (metadata.bIsENU)
+		TileInfo& tile = tiles[i];
+
+		// 输入目录指纹：增量清单与进度日志据此判断瓦片输入是否变化
+		std::string& fingerprint = fingerprints[i];
+		if (manifest || journal)
 		{
-			// ENU 坐标系统
-			LOG_I("使用 ENU 坐标系统");
-			LOG_I("  地理原点：纬度={:.6f}，经度={:.6f}", metadata.dCenterLat, metadata.dCenterLon);
-			LOG_I("  SRSOrigin 偏移：x={:.3f}, y={:.3f}, z={:.3f}", metadata.dOffsetX, metadata.dOffsetY, metadata.dOffsetZ);
+			fingerprint = IncrementalManifest::ComputeFingerprint(tile.source_dir, incremental.bContentHash);
+		}
 
-			// 调用 enu_init 初始化 GeoTransform
-			// 注意：enu_init 需要经度在前，纬度在后
-			double origin_enu[3] = { metadata.dOffsetX, metadata.dOffsetY, metadata.dOffsetZ };
-			if (GeoTransform::InitFromENU(metadata.dCenterLon, metadata.dCenterLat, origin_enu))
+		// 中断前已完成并确认写入、且输入未变化的瓦片：使用日志中的包围盒
+		JournalRecord record;
+		if (journal && journal->Find(tile.tile_name, fingerprint, record))
+		{
+#ifdef _OPENMP
+#pragma omp critical(data_update)
+#endif
 			{
-				LOG_I("ENU 系统 GeoTransform 初始化成功");
+				tile_jsons.emplace_back();
+				AddTileBox(tile, record.bbox);
+				resumed_count++;
+			}
 
-				// 使用 metadata 中的坐标作为中心点
-				dCenterX = metadata.dCenterLon;
-				dCenterY = metadata.dCenterLat;
+			if (manifest)
+			{
+				manifest->Update(tile.tile_name, fingerprint, record.bbox);
 			}
-			else
+
+			if (job_control)
 			{
-				LOG_E("ENU 系统 GeoTransform 初始化失败");
+				job_control->TileFinished(true);
 			}
+
+			continue;
 		}
-		else if (metadata.bIsEPSG)
-		{
-			// EPSG 坐标系统
-			LOG_I("使用 EPSG:{} 坐标系统", metadata.nEpsgCode);
-			LOG_I("  SRSOrigin: {}", metadata.strSrsOrigin.c_str());
 
-			// 解析 SRSOrigin 为投影坐标
-			double origin[3] = { metadata.dOffsetX, metadata.dOffsetY, metadata.dOffsetZ };
-			// 调用 epsg_convert 转换为经纬度
-			if (GeoTransform::InitFromEPSG(metadata.nEpsgCode, origin))
+		// 输入与参数均未变化且输出仍在：复用上次的包围盒，跳过转换
+		if (manifest)
+		{
+			std::array<double, 6> last_bbox;
+			if (manifest->IsUnchanged(tile.tile_name, fingerprint, last_bbox) &&
+				(!local_sink || OSGBTools::IsRegularFile(tile.output_path + "/tileset.json")))
 			{
-				LOG_I("EPSG:{} 系统 GeoTransform 初始化成功", metadata.nEpsgCode);
-				LOG_I("  转换为地理坐标：经度={:.6f}，纬度={:.6f}，海拔={:.3f}", origin[0], origin[1], origin[2]);
+#ifdef _OPENMP
+#pragma omp critical(data_update)
+#endif
+				{
+					tile_jsons.emplace_back();
+					AddTileBox(tile, last_bbox);
+					skipped_count++;
+				}
+				manifest->Update(tile.tile_name, fingerprint, last_bbox);
 
-				// 使用转换后的经纬度作为中心点
-				dCenterX = origin[0];
-				dCenterY = origin[1];
+				if (job_control)
+				{
+					job_control->TileFinished(true);
+				}
+
+				continue;
 			}
-			else
+		}
+
+		if (progressive && !lazy)
+		{
+#ifdef _OPENMP
+#pragma omp critical(data_update)
+#endif
 			{
-				LOG_E("EPSG:{} 坐标转换失败", metadata.nEpsgCode);
+				progressive_tiles.emplace_back(i);
 			}
+
+			continue;
 		}
-		else if (metadata.bIsWKT)
+
+		if (spdlog::should_log(spdlog::level::info) && progress_log.Allow())
 		{
-			// WKT 格式坐标系统
-			LOG_I("使用 WKT 投影");
-			LOG_I("  SRSOrigin: {}", metadata.strSrsOrigin.c_str());
-			// 解析 SRSOrigin 为投影坐标
-			double origin[3] = { metadata.dOffsetX, metadata.dOffsetY, metadata.dOffsetZ };
+			OSGB_LOG_I("[INFO] 处理瓦片 {}/{}：{}", i + 1, tiles.size(), tile.tile_name);
+		}
 
-			// 调用 InitFromWKT 转换为经纬度
-			if (GeoTransform::InitFromWKT(metadata.strSrs.c_str(), origin))
-			{
-				LOG_I("WKT 投影 GeoTransform 初始化成功");
-				LOG_I("  转换为地理坐标：经度={:.6f}，纬度={:.6f}，海拔={:.3f}", origin[0], origin[1], origin[2]);
+		// 每个瓦片获取一个调度槽位，有交互请求等待时在此让出；等待期间任务被取消则不再转换
+		JobScheduler::Slot slot = JobScheduler::Global().Acquire(priority, &job_group, job_control);
+		if (!slot.IsValid())
+		{
+			continue;
+		}
 
-				// 使用转换后的经纬度作为中心点
-				dCenterX = origin[0];
-				dCenterY = origin[1];
-			}
-			else
-			{
-				LOG_E("WKT 坐标转换失败");
-			}
+		// 延迟转换模式只生成 tileset.json，B3DM 在首次请求时转换
+		auto tile_start = std::chrono::steady_clock::now();
+		B3DMResult result = lazy ?
+			ToB3DMLazy(tile.osgb_path, tile.output_path, dCenterX, dCenterY, nMaxLevel, &subset_filter, &geo_transform) :
+			ToB3DM(
+				tile.osgb_path,
+				tile.output_path,
+				dCenterX,
+				dCenterY,
+				nMaxLevel,
+				bEnableTextureCompress,
+				bEnableMeshOpt,
+				bEnableDraco,
+				pSink,
+				&subset_filter,
+				&geo_transform
+			);
+		slot.Release();
+
+		if (ConversionMetrics* pMetrics = ActiveMetrics())
+		{
+			pMetrics->AddTile(tile.tile_name, std::chrono::duration<double>(
+				std::chrono::steady_clock::now() - tile_start).count(), result.success);
 		}
-	}
-	else
-	{
-		LOG_W("metadata.xml 未找到或解析失败，使用提供的 center_x={:.6f}, center_y={:.6f}", dCenterX, dCenterY);
-	}
 
-	// 3. 检测数据源类型
-	bool is_oblique_data = false;  // 是否为倾斜摄影数据集
-	std::string check_data_dir = data_path;
+		// 取消时瓦片可能只转换了部分节点，不记录结果，续传时重新转换
+		if (IsCancelled())
+		{
+			continue;
+		}
 
-	// 检查路径是否以 "/Data" 结尾
-	data_pos = data_path.rfind("/Data");  // 复用之前定义的 data_pos 变量
-	if (data_pos == std::string::npos || data_pos != data_path.length() - 5)
-	{
-		// 不以 "/Data" 结尾，追加它
-		check_data_dir = data_path + "/Data";
+		OnTileConverted(tile, fingerprint, result);
 	}
 
-	// 检测是否为倾斜摄影数据集
-	if (OSGBTools::IsDirectory(check_data_dir) && has_metadata)
-	{
-		is_oblique_data = true;
-		LOG_I("检测到倾斜摄影数据集模式 (Data目录 + metadata.xml)");
-		OSGBLog::LOG_I("[INFO] 在以下位置搜索瓦片：{}", check_data_dir);
-	}
-	else
+	// 渐进式发布：先用各瓦片根节点的包围盒发布骨架，再按LOD层级由粗到细转换
+	if (!progressive_tiles.empty() && !IsCancelled())
 	{
-		// 尝试纯OSGB文件夹模式
-		check_data_dir = data_path;
-		LOG_I("检测到纯OSGB文件夹模式");
-		OSGBLog::LOG_I("[INFO] 扫描OSGB文件夹：{}", check_data_dir);
-	}
+		std::sort(progressive_tiles.begin(), progressive_tiles.end());
 
-	// 4. 创建输出目录
-	if (!bWriteToMinio)
-	{
-		OSGBTools::MkDirs(strOutputDir);
-	}
+		// 估算待转换瓦片的包围盒（只读取根OSGB文件）
+		std::vector<TileBox> estimated(progressive_tiles.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (int k = 0; k < static_cast<int>(progressive_tiles.size()); k++)
+		{
+			EstimateTileBox(tiles[progressive_tiles[k]].osgb_path, estimated[k]);
+		}
 
-	// 5. 收集所有子目录/OSGB文件
-	struct TileInfo {
-		std::string tile_name;
-		std::string osgb_path;
-		std::string output_path;
-		TileBox bbox;
-	};
+		TileBox skeleton_bbox = global_bbox;
+		std::vector<std::string> input_paths;
+		std::vector<std::string> output_paths;
+		for (size_t k = 0; k < progressive_tiles.size(); ++k)
+		{
+			TileInfo& tile = tiles[progressive_tiles[k]];
+			input_paths.emplace_back(tile.osgb_path);
+			output_paths.emplace_back(tile.output_path);
 
-	std::vector<TileInfo> tiles;
-	TileBox global_bbox;
+			// 占位 tileset.json：只有包围盒，第一层转换完成后被替换
+			tile.bbox = estimated[k];
+			ExpandBox(skeleton_bbox, tile.bbox);
+			if (!tile.bbox.max.empty())
+			{
+				TilesetNode placeholder;
+				placeholder.boundingVolume = BoundingVolumeFromTileBox(tile.bbox);
+				pSink->Write(tile.output_path + "/tileset.json", placeholder.ToJson(true));
+			}
+		}
+
+		pSink->Write(strOutputDir + "/tileset.json", BuildRootTileset(skeleton_bbox));
+		if (!pSink->Flush())
+		{
+			checkpoint_failed = true;
+		}
+		LOG_I("渐进式发布：已发布 tileset 骨架 ({} 个瓦片待转换)", progressive_tiles.size());
+
+		// 失败的瓦片不保留估算的包围盒，与非渐进模式一致
+		for (int index : progressive_tiles)
+		{
+			tiles[index].bbox = TileBox();
+		}
 
-	if (is_oblique_data)
-	{
-		// 倾斜摄影模式：扫描 Tile_* 目录
-		std::string out_data_path = strOutputDir + "/Data";
-		if (!bWriteToMinio)
+		bool publish_failed = false;
+		std::vector<B3DMResult> results = ToB3DMProgressive(input_paths, output_paths, *pSink,
+			dCenterX, dCenterY, nMaxLevel, bEnableTextureCompress, bEnableMeshOpt, bEnableDraco, publish_failed,
+			&subset_filter, &geo_transform);
+		if (publish_failed)
 		{
-			OSGBTools::MkDirs(out_data_path);
+			checkpoint_failed = true;
 		}
 
-		// 使用 OSGBTools 统一的目录扫描函数
-		std::vector<std::string> tile_names = OSGBTools::ScanTileDirectories(check_data_dir);
-		if (tile_names.empty())
+		// 之后各瓦片按完成计入，不再重复计入折算的部分
+		if (job_control)
 		{
-			LOG_E("未找到任何 Tile_* 目录：{}", check_data_dir.c_str());
-			return false;
+			job_control->EndLevels();
 		}
 
-		for (const auto& tile_name : tile_names)
+		for (size_t k = 0; k < progressive_tiles.size() && !IsCancelled(); ++k)
 		{
-			std::string tile_dir = check_data_dir + "/" + tile_name;
-			std::string osgb_file = tile_dir + "/" + tile_name + ".osgb";
+			TileInfo& tile = tiles[progressive_tiles[k]];
+			OnTileConverted(tile, fingerprints[progressive_tiles[k]], results[k]);
+		}
+	}
 
-			TileInfo info;
-			info.tile_name = tile_name;
-			info.osgb_path = osgb_file;
-			info.output_path = out_data_path + "/" + tile_name;
-			if (!bWriteToMinio)
-			{
-				OSGBTools::MkDirs(info.output_path);
-			}
-			tiles.emplace_back(info);
+	// 任务已取消：等待已提交的文件写完（已完成瓦片记入进度日志），不生成根 tileset.json
+	if (IsCancelled())
+	{
+		if (journal)
+		{
+			journal->Checkpoint(*pSink, true);
 		}
+		pSink->Flush();
+
+		LOG_W("批量转换已取消：{}", strOutputDir.c_str());
+
+		return false;
 	}
-	else
+
+	if (tile_jsons.empty())
 	{
-		// 纯OSGB文件夹模式：
-		// 1. 先检查输入目录本身是否包含OSGB文件
-		// 2. 如果不包含，再扫描子目录
+		LOG_E("没有成功处理任何瓦片");
 
-		std::vector<std::string> osgb_files_in_root = OSGBTools::ScanOSGBFiles(check_data_dir, false);
+		return false;
+	}
 
-		if (!osgb_files_in_root.empty())
-		{
-			// 情况1：输入目录本身就包含OSGB文件（如 E:\Data\3D\Tile_+005_+006）
-			LOG_I("输入目录本身包含 {:zu} 个OSGB文件", osgb_files_in_root.size());
+	// 8. 保存根 tileset.json
+	std::string root_tileset_path = strOutputDir + "/tileset.json";
+	pSink->Write(root_tileset_path, BuildRootTileset(global_bbox));
 
-			// 查找根OSGB文件
-			std::string root_osgb = OSGBTools::FindRootOSGB(check_data_dir);
-			if (root_osgb.empty())
-			{
-				// 如果没有找到根OSGB，使用第一个文件
-				root_osgb = osgb_files_in_root[0];
-				LOG_I("未找到根OSGB，使用第一个文件: {}", root_osgb.c_str());
-			}
-			else
-			{
-				LOG_I("找到根OSGB: {}", root_osgb.c_str());
-			}
+	// 等待输出目标写入完成，任何文件写入失败（包括检查点时发现的失败）都视为整体失败
+	bool flushed = !journal || journal->Checkpoint(*pSink, true);
+	flushed = pSink->Flush() && flushed;
+	if (!flushed || checkpoint_failed)
+	{
+		LOG_E("输出文件写入失败：{}", strOutputDir.c_str());
 
-			// 获取目录名作为tile名称
-			std::string dir_name = OSGBTools::GetFileName(check_data_dir);
-			if (dir_name.empty())
-			{
-				dir_name = "output";
-			}
+		return false;
+	}
 
-			TileInfo info;
-			info.tile_name = dir_name;
-			info.osgb_path = root_osgb;
-			info.output_path = strOutputDir + "/" + dir_name;
-			if (!bWriteToMinio)
-			{
-				OSGBTools::MkDirs(info.output_path);
-			}
-			tiles.emplace_back(info);
-		}
-		else
+	// 任务完成，不再需要进度日志
+	if (journal)
+	{
+		journal->Remove();
+		if (resumed_count > 0)
 		{
-			// 情况2：输入目录不包含OSGB，扫描子目录
-			std::vector<std::string> osgb_folders = OSGBTools::ScanOSGBFolders(check_data_dir);
+			LOG_I("断点续传：{} 个瓦片使用进度日志中的结果", resumed_count);
+		}
+	}
 
-			LOG_I("找到 {:zu} 个包含OSGB文件的子目录", osgb_folders.size());
+	// 输出全部写入成功后才更新增量清单
+	if (manifest)
+	{
+		manifest->Save(manifest_path);
+		LOG_I("增量转换：跳过 {} 个未变化瓦片，转换 {} 个瓦片", skipped_count, tiles.size() - skipped_count);
+	}
 
-			for (const auto& folder_name : osgb_folders)
-			{
-				std::string folder_path = check_data_dir + "/" + folder_name;
+	OSGBLog::LOG_I("[INFO] 批量处理完成！生成了包含 {} 个瓦片的根 tileset.json", tiles.size());
 
-				// 在子目录中查找根OSGB文件
-				std::string root_osgb = OSGBTools::FindRootOSGB(folder_path);
-				if (root_osgb.empty())
-				{
-					// 如果没有找到根OSGB，尝试扫描该目录下的所有OSGB文件，使用第一个
-					std::vector<std::string> osgb_files = OSGBTools::ScanOSGBFiles(folder_path, false);
-					if (!osgb_files.empty())
-					{
-						root_osgb = osgb_files[0];
-						LOG_I("子目录 {} 未找到根OSGB，使用第一个文件: {}", folder_name.c_str(), root_osgb.c_str());
-					}
-					else
-					{
-						LOG_W("子目录 {} 中未找到OSGB文件，跳过", folder_name.c_str());
-						continue;
-					}
-				}
-				else
-				{
-					LOG_I("子目录 {} 找到根OSGB: {}", folder_name.c_str(), root_osgb.c_str());
-				}
+	// 转换报告与时间线写在根 tileset.json 旁（它们本身的写入不计入）
+	bool has_diagnostics = false;
+	if (metrics_session.IsOutermost() && metrics_settings.bWriteReport)
+	{
+		pSink->Write(strOutputDir + "/" + metrics_settings.strReportName, metrics.ToJson());
+		has_diagnostics = true;
+	}
 
-				TileInfo info;
-				info.tile_name = folder_name;
-				info.osgb_path = root_osgb;
-				info.output_path = strOutputDir + "/" + folder_name;
-				if (!bWriteToMinio)
-				{
-					OSGBTools::MkDirs(info.output_path);
-				}
-				tiles.emplace_back(info);
-			}
-		}
+	if (trace_session.IsActive())
+	{
+		pSink->Write(strOutputDir + "/" + trace_settings.strFileName, trace_session.ToChromeTrace());
+		has_diagnostics = true;
 	}
 
-	if (tiles.empty())
+	if (has_diagnostics && !pSink->Flush())
 	{
-		LOG_E("未找到任何OSGB数据");
-		return false;
+		LOG_W("写入转换报告或时间线失败：{}", strOutputDir.c_str());
 	}
 
-	OSGBLog::LOG_I("[INFO] 找到 {} 个瓦片目录待处理", tiles.size());
+	AsyncLog::Flush();
 
-	// 5. 处理每个瓦片（使用 OpenMP 并行加速）
-	std::vector<std::string> tile_jsons;
+	return true;
+}
 
-#ifdef _OPENMP
-	// 获取可用线程数
-	int num_threads = omp_get_max_threads();
-	OSGBLog::LOG_I("[INFO] 使用 OpenMP 并行处理，线程数：{}", num_threads);
+std::vector<B3DMResult> OSGB23dTiles::ToB3DMProgressive(
+	const std::vector<std::string>& input_paths,
+	const std::vector<std::string>& output_paths,
+	IOutputSink& sink,
+	double dCenterX,
+	double dCenterY,
+	int nMaxLevel,
+	bool bEnableTextureCompress,
+	bool bEnableMeshOpt,
+	bool bEnableDraco,
+	bool& bPublishFailed,
+	const SubsetFilter* pFilter,
+	const GeoTransform* pGeoTransform)
+{
+	const int tile_count = static_cast<int>(input_paths.size());
+	std::vector<B3DMResult> results(tile_count);
+	std::vector<OSGTree> trees(tile_count);
 
-	// 使用 dynamic 调度以平衡不同瓦片的处理时间差异
+	// 本任务占用的调度槽位上限
+	JobGroup job_group(max_concurrency);
+
+	// 所有瓦片共用预读线程与内存上限
+	FilePrefetcher prefetcher;
+
+	// 1. 读取全部瓦片的节点树
+#ifdef _OPENMP
 #pragma omp parallel for schedule(dynamic)
 #endif
-	for (int i = 0; i < static_cast<int>(tiles.size()); i++)
+	for (int i = 0; i < tile_count; i++)
 	{
-		TileInfo& tile = tiles[i];
+		std::string path = input_paths[i];
+		trees[i] = GetAllTree(path, &prefetcher, false, nMaxLevel, pFilter, pGeoTransform);
+	}
 
-		// 线程安全的控制台输出
-#ifdef _OPENMP
-#pragma omp critical(console_output)
-#endif
+	// 2. 按树深度分组待转换节点（trees 不再改变大小，节点指针保持有效）
+	std::vector<std::vector<std::pair<size_t, OSGTree*>>> levels;
+	for (size_t i = 0; i < trees.size(); ++i)
+	{
+		CollectLevelNodes(trees[i], i, nMaxLevel, 0, levels);
+	}
+
+	size_t nodes_total = 0;
+	for (const auto& level : levels)
+	{
+		nodes_total += level.size();
+	}
+
+	// 3. 逐层转换所有瓦片的节点，每层完成后发布各瓦片当前的 tileset.json 并上报进度
+	size_t nodes_done = 0;
+	for (size_t depth = 0; depth < levels.size(); ++depth)
+	{
+		if (IsCancelled())
 		{
-			OSGBLog::LOG_I("[INFO] 处理瓦片 {}/{}：{}", i + 1, tiles.size(), tile.tile_name);
+			break;
 		}
 
-		B3DMResult result = ToB3DM(
-			tile.osgb_path,
-			tile.output_path,
-			dCenterX,
-			dCenterY,
-			nMaxLevel,
-			bEnableTextureCompress,
-			bEnableMeshOpt,
-			bEnableDraco
-		);
+		auto& nodes = levels[depth];
 
-		if (result.success && !result.tilesetJson.empty())
+		std::vector<std::string> files;
+		files.reserve(nodes.size());
+		for (const auto& node : nodes)
 		{
-			// 临界区：保护共享数据（tile_jsons 和 global_bbox）
+			files.emplace_back(node.second->file_name);
+		}
+		prefetcher.Prefetch(files);
+
 #ifdef _OPENMP
-#pragma omp critical(data_update)
+#pragma omp parallel for schedule(dynamic)
 #endif
+		for (int k = 0; k < static_cast<int>(nodes.size()); k++)
+		{
+			// 每个节点获取一个调度槽位，有交互请求等待时在此让出
+			JobScheduler::Slot slot = JobScheduler::Global().Acquire(priority, &job_group, job_control);
+			if (!slot.IsValid())
 			{
-				tile_jsons.emplace_back(result.tilesetJson);
-
-				// 更新边界框
-				tile.bbox.max = { result.boundingBox[0], result.boundingBox[1], result.boundingBox[2] };
-				tile.bbox.min = { result.boundingBox[3], result.boundingBox[4], result.boundingBox[5] };
-
-				// 合并到全局边界框
-				if (global_bbox.max.empty())
-				{
-					global_bbox = tile.bbox;
-				}
-				else
-				{
-					ExpandBox(global_bbox, tile.bbox);
-				}
+				continue;
 			}
 
-			// 将瓦片 JSON 包装在完整的 tileset 结构中
-			std::string wrapped_json = "{";
-			wrapped_json += "\"asset\":{\"version\":\"1.0\",\"gltfUpAxis\":\"Z\"},";
-			wrapped_json += "\"geometricError\":1000,";
-			wrapped_json += "\"root\":";
-			wrapped_json += result.tilesetJson;  // 这是此瓦片的根节点
-			wrapped_json += "}";
+			WriteTileNode(*nodes[k].second, sink, output_paths[nodes[k].first],
+				bEnableTextureCompress, bEnableMeshOpt, bEnableDraco, &prefetcher, pGeoTransform);
+		}
 
-			// 保存单个瓦片的 tileset.json（文件写入通常是线程安全的）
-			std::string tileset_path = tile.output_path + "/tileset.json";
-			OSGBTools::WriteFile(tileset_path.c_str(), wrapped_json.data(), wrapped_json.size());
+		// 瓦片在全部层级完成后才计入进度，各层按节点数折算
+		nodes_done += nodes.size();
+		if (job_control)
+		{
+			job_control->LevelFinished(static_cast<int>(depth + 1), static_cast<int>(levels.size()),
+				static_cast<double>(tile_count) * nodes_done / std::max<size_t>(nodes_total, 1));
 		}
-		else
+
+		// 最后一层的 tileset.json 由调用方随最终结果写入
+		if (depth + 1 == levels.size())
 		{
-			// 线程安全的错误日志输出
-#ifdef _OPENMP
-#pragma omp critical(console_output)
-#endif
+			break;
+		}
+
+		// 未转换的深层节点没有包围盒，EncodeTileJSON 不会输出它们
+		for (int i = 0; i < tile_count; i++)
+		{
+			OSGTree snapshot = trees[i];
+			B3DMResult partial = FinishTileTree(snapshot, dCenterX, dCenterY);
+			if (partial.success)
 			{
-				LOG_E("处理瓦片失败：{}", tile.tile_name.c_str());
+				sink.Write(output_paths[i] + "/tileset.json", WrapTileTileset(partial.tilesetJson));
 			}
 		}
-	}
 
-	if (tile_jsons.empty())
-	{
-		LOG_E("没有成功处理任何瓦片");
+		if (!sink.Flush())
+		{
+			bPublishFailed = true;
+		}
 
-		return false;
+		LOG_I("渐进式发布：第 {}/{} 层已发布 ({} 个节点)", depth + 1, levels.size(), nodes.size());
 	}
 
-	// 6. 计算变换矩阵
-	std::vector<double> transform_matrix(16);
+	// 4. 生成最终结果
+	for (int i = 0; i < tile_count; i++)
 	{
-		// 使用合并的全局边界框的最小高度
-		double height_min = global_bbox.min.empty() ? 0.0 : global_bbox.min[2];
-
-		// 对于ENU坐标系，需要应用SRSOrigin偏移到根节点变换矩阵
-		if (has_metadata && metadata.bIsENU)
+		if (trees[i].file_name.empty())
 		{
-			LOG_I("应用ENU offset到根节点变换矩阵: ({:.3f}, {:.3f}, {:.3f})",
-				metadata.dOffsetX, metadata.dOffsetY, metadata.dOffsetZ);
-			OSGBTools::TransformCWithEnuOffset(
-				dCenterX, dCenterY, height_min,
-				metadata.dOffsetX, metadata.dOffsetY, metadata.dOffsetZ,
-				transform_matrix.data());
+			LOG_E("打开文件 [{}] 失败！", input_paths[i].c_str());
+			continue;
 		}
-		else
+
+		results[i] = FinishTileTree(trees[i], dCenterX, dCenterY);
+		if (!results[i].success)
 		{
-			OSGBTools::TransformC(dCenterX, dCenterY, height_min, transform_matrix.data());
+			LOG_E("[{}] bbox 为空！", input_paths[i].c_str());
 		}
 	}
 
-	// 7. 生成根 tileset.json（使用 TilesetNode，减少73%代码）
-	TilesetNode rootNode;
-	rootNode.geometricError = 2000;
-	rootNode.boundingVolume = BoundingVolumeFromTileBox(global_bbox);
-	rootNode.transform = transform_matrix;
+	return results;
+}
 
-	// 添加子瓦片节点
-	for (const auto& tile : tiles)
+bool OSGB23dTiles::EstimateTileBox(const std::string& strOsgbPath, TileBox& box)
+{
+	osg::ref_ptr<osg::Node> root = ReadOsgNode(strOsgbPath, nullptr, ActiveMetrics());
+	if (!root)
 	{
-		TilesetNode childNode;
-		childNode.geometricError = 1000;
-		childNode.boundingVolume = BoundingVolumeFromTileBox(tile.bbox);
+		return false;
+	}
 
-		// 根据数据集类型生成URI
-		if (is_oblique_data)
-		{
-			childNode.contentUri = "./Data/" + tile.tile_name + "/tileset.json";
-		}
-		else
-		{
-			childNode.contentUri = "./" + tile.tile_name + "/tileset.json";
-		}
+	// 根文件是最粗的LOD，几何体覆盖整个瓦片；没有几何体时使用 PagedLOD 的包围球
+	osg::ComputeBoundsVisitor visitor;
+	root->accept(visitor);
+	const osg::BoundingBox& bound = visitor.getBoundingBox();
+	if (bound.valid())
+	{
+		box.max = { bound.xMax(), bound.yMax(), bound.zMax() };
+		box.min = { bound.xMin(), bound.yMin(), bound.zMin() };
 
-		rootNode.children.emplace_back(childNode);
+		return true;
 	}
 
-	// 生成JSON,includeAsset=true
-	std::string root_json = rootNode.ToJson(true);
+	const osg::BoundingSphere& sphere = root->getBound();
+	if (!sphere.valid())
+	{
+		return false;
+	}
 
-	// 8. 保存根 tileset.json
-	std::string root_tileset_path = strOutputDir + "/tileset.json";
-	OSGBTools::WriteFile(root_tileset_path.c_str(), root_json.data(), root_json.size());
+	const osg::Vec3d center = sphere.center();
+	const double radius = sphere.radius();
+	box.max = { center.x() + radius, center.y() + radius, center.z() + radius };
+	box.min = { center.x() - radius, center.y() - radius, center.z() - radius };
 
-	OSGBLog::LOG_I("[INFO] 批量处理完成！生成了包含 {} 个瓦片的根 tileset.json", tiles.size());
+	return true;
+}
 
-	// 9. 清理 GeoTransform 资源（谁调用谁释放）
-	GeoTransform::Cleanup();
+bool OSGB23dTiles::LoadDatasetMetadata(const std::string& strDataDir, OSGBMetadata& metadata)
+{
+	std::string data_path = OSGBTools::OSGString(strDataDir);
+	if (!data_path.empty() && data_path.back() == '/')
+	{
+		data_path.pop_back();
+	}
 
-	return true;
+	// 获取根目录（data_dir 的父目录，用于查找 metadata.xml）
+	std::string root_dir = data_path;
+	size_t data_pos = data_path.rfind("/Data");
+	if (data_pos != std::string::npos && data_pos == data_path.length() - 5)
+	{
+		// 如果已经是 /Data 结尾，去掉它
+		root_dir = data_path.substr(0, data_pos);
+	}
+
+	return OSGBTools::ParseMetadataXml(root_dir + "/metadata.xml", metadata);
+}
+
+std::string OSGB23dTiles::MakeSettingsKey(
+	const std::string& strDataDir,
+	double dCenterX,
+	double dCenterY,
+	int nMaxLevel,
+	bool bEnableTextureCompress,
+	bool bEnableMeshOpt,
+	bool bEnableDraco,
+	bool bLazy,
+	const SubsetSettings& subset,
+	const OSGBMetadata* pMetadata)
+{
+	nlohmann::json settings_json = {
+		{"data_dir", OSGBTools::Utf8String(strDataDir)},
+		{"center_x", dCenterX},
+		{"center_y", dCenterY},
+		{"max_level", nMaxLevel},
+		{"texture_compress", bEnableTextureCompress},
+		{"meshopt", bEnableMeshOpt},
+		{"draco", bEnableDraco},
+		{"lazy", bLazy}
+	};
+	if (SubsetFilter(subset).IsActive())
+	{
+		settings_json["subset"] = {
+			{"region", subset.vecRegion},
+			{"min_level", subset.nMinLevel},
+			{"max_level", subset.nMaxLevel}
+		};
+	}
+	if (pMetadata)
+	{
+		settings_json["srs"] = OSGBTools::Utf8String(pMetadata->strSrs);
+		settings_json["srs_origin"] = OSGBTools::Utf8String(pMetadata->strSrsOrigin);
+	}
+
+	return settings_json.dump();
+}
+
+bool OSGB23dTiles::ToB3DMBatchToArchive(
+	const std::string& pDataDir,
+	const std::string& strArchivePath,
+	double dCenterX,
+	double dCenterY,
+	int nMaxLevel,
+	bool bEnableTextureCompress,
+	bool bEnableMeshOpt,
+	bool bEnableDraco)
+{
+	LOG_I("========== 开始批量处理并写入归档 ==========");
+	LOG_I("输入目录: {}", pDataDir.c_str());
+	LOG_I("归档文件: {}", strArchivePath.c_str());
+
+	// 1. 创建归档（父目录不存在时先创建）
+	std::string archive_dir = std::filesystem::path(strArchivePath).parent_path().string();
+	if (!archive_dir.empty())
+	{
+		OSGBTools::MkDirs(archive_dir);
+	}
+
+	TileArchiveWriter archive;
+	if (!archive.Open(strArchivePath))
+	{
+		return false;
+	}
+
+	// 2. 调用 ToB3DMBatch，strOutputDir 传空字符串，文件路径即归档内条目名
+	//    归档每次重新生成，跳过的瓦片不会出现在新归档中，因此临时关闭增量模式
+	ArchiveSink sink(archive);
+	//    进度日志同理：中断时归档尚未写入中央目录，已完成的瓦片无法复用；
+	//    归档不能重复写入同一条目，也不使用渐进式发布与延迟转换
+	IncrementalSettings saved_incremental = incremental;
+	ResumeSettings saved_resume = resume;
+	bool saved_progressive = progressive;
+	bool saved_lazy = lazy;
+	incremental.bEnable = false;
+	resume.bEnable = false;
+	progressive = false;
+	lazy = false;
+
+	bool success = false;
+	try
+	{
+		success = ToB3DMBatch(pDataDir, "", dCenterX, dCenterY, nMaxLevel,
+			bEnableTextureCompress, bEnableMeshOpt, bEnableDraco, &sink);
+	}
+	catch (const std::exception& e)
+	{
+		LOG_E("切片处理异常: {}", e.what());
+	}
+
+	incremental = saved_incremental;
+	resume = saved_resume;
+	progressive = saved_progressive;
+	lazy = saved_lazy;
+
+	// 3. 写入索引与中央目录
+	if (!archive.Close())
+	{
+		success = false;
+	}
+
+	if (success)
+	{
+		LOG_I("========== 批量处理并写入归档完成 ==========");
+	}
+	else
+	{
+		LOG_E("========== 批量处理并写入归档失败 ==========");
+	}
+
+	return success;
 }
 
 #ifdef ENABLE_MINIO
-#include <miniocpp/client.h>
+#include "MinioUploader.h"
 
 bool OSGB23dTiles::ToB3DMBatchToMinIO(
 	const std::string& pDataDir,
@@ -2253,7 +3661,9 @@ bool OSGB23dTiles::ToB3DMBatchToMinIO(
 	int nMaxLevel,
 	bool bEnableTextureCompress,
 	bool bEnableMeshOpt,
-	bool bEnableDraco)
+	bool bEnableDraco,
+	bool bSkipUnchanged,
+	bool bPrecompress)
 {
 	LOG_I("========== 开始批量处理并直接写入MinIO ==========");
 	LOG_I("输入目录: {}", pDataDir.c_str());
@@ -2275,11 +3685,15 @@ bool OSGB23dTiles::ToB3DMBatchToMinIO(
 	LOG_I("MinIO Bucket: {}", bucket_name.c_str());
 	LOG_I("对象前缀: {}", object_prefix.c_str());
 
-	// 2. 创建 MinIO 客户端并设置为当前线程的写入目标
-	g_minio_client = std::make_shared<MinioClient>(
-		strMinioEndpoint, strAccessKey, strSecretKey, bucket_name, object_prefix, bUseSSL);
+	// 2. 创建 MinIO 上传器（独立连接池，转换线程只负责提交缓冲区）
+	MinioUploadSettings upload_settings;
+	upload_settings.bSkipUnchanged = bSkipUnchanged;
+	upload_settings.bCompareETag = bSkipUnchanged;
+
+	auto uploader = std::make_unique<MinioUploader>(
+		strMinioEndpoint, strAccessKey, strSecretKey, bucket_name, object_prefix, bUseSSL, upload_settings);
 
-	if (!g_minio_client->IsValid())
+	if (!uploader->IsValid())
 	{
 		LOG_E("MinIO客户端创建失败");
 
@@ -2287,31 +3701,43 @@ bool OSGB23dTiles::ToB3DMBatchToMinIO(
 	}
 
 	// 确保 Bucket 存在
-	if (!g_minio_client->MakeBucket())
+	if (!uploader->MakeBucket())
 	{
 		LOG_E("MinIO创建Bucket失败");
 
 		return false;	
 	}
 
-	// 3. 设置MinIO写入器（后续所有WriteFile调用都会自动写入MinIO）
-	OSGBTools::SetMinioWriter(g_minio_client.get());
+	// 3. 调用 ToB3DMBatch，所有文件经 MinioSink 写入MinIO
+	// strOutputDir 传空字符串，实际路径由上传器的 object_prefix 控制
+	MinioSink sink(*uploader);
 
-	// 4. 调用 ToB3DMBatch，所有文件会直接写入MinIO
-	// strOutputDir 传空字符串，实际路径由 MinIO client 的 object_prefix 控制
+	// 预压缩：对象只保存一种编码并设置 Content-Encoding，由 CDN/浏览器解压
+	PrecompressSettings precompress_settings;
+	precompress_settings.eMode = PrecompressMode::EncodedOnly;
+	PrecompressSink precompress_sink(sink, precompress_settings);
+
+	IOutputSink* pSink = bPrecompress ? static_cast<IOutputSink*>(&precompress_sink) : &sink;
 	bool success = false;
 	try
 	{
 		success = ToB3DMBatch(pDataDir, "", dCenterX, dCenterY, nMaxLevel,
-			bEnableTextureCompress, bEnableMeshOpt, bEnableDraco, true);
+			bEnableTextureCompress, bEnableMeshOpt, bEnableDraco, pSink);
 	}
 	catch (const std::exception& e)
 	{
 		LOG_E("切片处理异常: {}", e.what());
 	}
 
-	// 5. 清除MinIO写入器
-	OSGBTools::SetMinioWriter(nullptr);
+	// 4. 等待上传队列清空（ToB3DMBatch 中途失败时可能仍有排队对象）
+	if (!uploader->Flush())
+	{
+		success = false;
+	}
+
+	LOG_I("MinIO上传统计: 成功 {} 个对象 ({} 字节), 跳过未变化 {} 个, 打包 {} 个, 失败 {} 个",
+		uploader->GetUploadedCount(), uploader->GetUploadedBytes(),
+		uploader->GetSkippedCount(), uploader->GetPackedCount(), uploader->GetFailedCount());
 
 	if (success)
 	{
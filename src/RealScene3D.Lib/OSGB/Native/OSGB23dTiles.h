@@ -9,6 +9,7 @@
 #include <iostream>
 #include <iomanip>
 #include <memory>
+#include <functional>
 
 #include <osg/Material>
 #include <osg/PagedLOD>
@@ -31,6 +32,18 @@
 
 #include "Tileset.h"
 #include "OSGBTools.h"
+#include "OutputSink.h"
+#include "IncrementalManifest.h"
+#include "BatchJournal.h"
+#include "NativeBuffer.h"
+#include "JobControl.h"
+#include "JobScheduler.h"
+#include "SubsetFilter.h"
+#include "ConversionMetrics.h"
+#include "TraceRecorder.h"
+
+class FilePrefetcher;
+class GeoTransform;
 
 using namespace std;
 
@@ -99,6 +112,9 @@ struct B3DMResult
 
 	// 包围盒：[maxX, maxY, maxZ, minX, minY, minZ]
 	std::array<double, 6> boundingBox = {};
+
+	// 转换统计报告（JSON，见 ConversionMetrics::ToJson），批量转换中的单个瓦片为空
+	std::string metricsJson = "";
 };
 
 /**
@@ -158,11 +174,14 @@ private:
 	// 文件路径
 	std::string path;
 
+	// 数据集坐标转换，为空时不重投影顶点
+	const GeoTransform* geo_transform;
+
 public:
 	// 构造函数
-	InfoVisitor(std::string _path, bool loadAllType = false)
+	InfoVisitor(std::string _path, bool loadAllType = false, const GeoTransform* pGeoTransform = nullptr)
 		:osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
-		, path(_path), is_loadAllType(loadAllType), is_pagedlod(loadAllType)
+		, path(_path), geo_transform(pGeoTransform), is_loadAllType(loadAllType), is_pagedlod(loadAllType)
 	{
 	}
 
@@ -196,6 +215,9 @@ public:
 	// 子节点名称列表
 	std::vector<std::string> sub_node_names;
 
+	// 子节点所属 PagedLOD 的包围球（与 sub_node_names 一一对应）
+	std::vector<osg::BoundingSphere> sub_node_bounds;
+
 	// 加载所有类型标志, true: 所有几何体都存储到geometry_array, false: 分类存储
 	bool is_loadAllType;
 
@@ -207,8 +229,19 @@ public:
 
 	// 存储其他纹理（非PagedLOD）
 	std::set<osg::Texture*> other_texture_array;
+
+	// 顶点重投影累计耗时（纳秒）
+	int64_t reproject_ns = 0;
 };
 
+/**
+ * @brief 延迟转换时登记节点的回调
+ * @param strOutFile B3DM 输出路径（与批量转换写入的路径一致）
+ * @param strOsgbPath 节点的 OSGB 文件路径
+ * @param nNodeType 节点类型（见 OSGTree::type）
+ */
+using LazyNodeCallback = std::function<void(const std::string& strOutFile, const std::string& strOsgbPath, int nNodeType)>;
+
 /**
  * @brief OSGB转3D Tiles工具类
  */
@@ -221,6 +254,191 @@ public:
 	// 析构函数
 	~OSGB23dTiles() = default;
 
+	/**
+	 * @brief 设置批量转换的增量模式
+	 *
+	 * 启用后 ToB3DMBatch / ToB3DMBatchToMinIO 只转换输入目录或转换参数发生变化的瓦片，
+	 * 未变化瓦片复用上次的输出和包围盒，只重新生成根 tileset.json。
+	 * 写入3TZ归档时每次生成新文件，不使用增量模式。
+	 * @param settings 增量配置，对之后的批量转换生效
+	 */
+	void SetIncrementalSettings(const IncrementalSettings& settings) { incremental = settings; }
+
+	/**
+	 * @brief 获取增量配置
+	 */
+	const IncrementalSettings& GetIncrementalSettings() const { return incremental; }
+
+	/**
+	 * @brief 设置批量转换的断点续传
+	 *
+	 * 启用后 ToB3DMBatch 在转换过程中定期确认输出已写入，并把完成的瓦片（包围盒、几何误差、
+	 * 输出路径）追加到进度日志；进程中断后以相同参数重新运行时只转换未完成的瓦片，
+	 * 生成的根 tileset.json 与不中断运行一致。任务成功后删除日志。
+	 * @param settings 续传配置，对之后的批量转换生效
+	 */
+	void SetResumeSettings(const ResumeSettings& settings) { resume = settings; }
+
+	/**
+	 * @brief 获取续传配置
+	 */
+	const ResumeSettings& GetResumeSettings() const { return resume; }
+
+	/**
+	 * @brief 设置批量转换写入本地输出目录时的异步写入配置
+	 *
+	 * 未指定输出目标时 ToB3DMBatch 按此配置创建本地异步写入器。启用 bSyncOnFlush 后
+	 * 任务结束前对全部输出文件执行一次 fsync，返回成功时瓦片已落盘。
+	 * 启用断点续传时总是对检查点前的文件执行 fsync（bSyncOnBarrier）。
+	 * @param settings 写入配置，对之后的批量转换生效
+	 */
+	void SetLocalWriteSettings(const AsyncWriteSettings& settings) { local_write = settings; }
+
+	/**
+	 * @brief 获取本地异步写入配置
+	 */
+	const AsyncWriteSettings& GetLocalWriteSettings() const { return local_write; }
+
+	/**
+	 * @brief 设置批量转换的渐进式发布
+	 *
+	 * 启用后 ToB3DMBatch 先读取各瓦片的根OSGB估算包围盒，立即发布根 tileset.json 骨架，
+	 * 再按LOD层级由粗到细转换所有瓦片，每完成一层就更新各瓦片的 tileset.json，
+	 * 用户可在精细层级仍在转换时浏览粗层级数据。转换完成后根 tileset.json 改用精确包围盒。
+	 * 写入3TZ归档时不使用。
+	 * @param bEnable 是否启用
+	 */
+	void SetProgressivePublish(bool bEnable) { progressive = bEnable; }
+
+	/**
+	 * @brief 是否启用渐进式发布
+	 */
+	bool IsProgressivePublish() const { return progressive; }
+
+	/**
+	 * @brief 设置批量转换的延迟转换模式
+	 *
+	 * 启用后 ToB3DMBatch 只读取节点树，由几何体顶点范围估算各节点包围盒，
+	 * 生成全部 tileset.json 而不写 B3DM；每个 B3DM 节点通过回调登记，
+	 * 之后由 LazyTileConverter 在首次请求时调用 ToB3DMNode 转换。优先于渐进式发布。
+	 * @param bEnable 是否启用
+	 * @param callback 节点登记回调（多个转换线程并发调用）
+	 */
+	void SetLazyConversion(bool bEnable, LazyNodeCallback callback = nullptr)
+	{
+		lazy = bEnable;
+		lazy_callback = std::move(callback);
+	}
+
+	/**
+	 * @brief 设置批量转换的子集（区域与层级范围）
+	 *
+	 * 区域为数据集坐标系的平面多边形，ToB3DMBatch 按 metadata.xml 的 SRSOrigin 换算到节点坐标。
+	 * 读取节点树时与区域不相交的瓦片、PagedLOD 子节点以及超过层级上限的文件都不会被读取，
+	 * 低于层级下限的节点不生成 B3DM，转换耗时与子集大小成正比。
+	 * @param settings 子集配置，对之后的转换生效
+	 */
+	void SetSubsetSettings(const SubsetSettings& settings)
+	{
+		subset = settings;
+	}
+
+	/**
+	 * @brief 获取子集配置
+	 */
+	const SubsetSettings& GetSubsetSettings() const { return subset; }
+
+	/**
+	 * @brief 设置转换统计
+	 *
+	 * 启用后 ToB3DM / ToB3DMBatch 统计各阶段耗时、输入输出字节数、三角形与顶点数及最慢的瓦片，
+	 * 转换结束后通过 GetMetricsReport 获取；bWriteReport 时批量转换把报告写到输出目录。
+	 * @param settings 统计配置，对之后的转换生效
+	 */
+	void SetMetricsSettings(const MetricsSettings& settings) { metrics_settings = settings; }
+
+	/**
+	 * @brief 获取统计配置
+	 */
+	const MetricsSettings& GetMetricsSettings() const { return metrics_settings; }
+
+	/**
+	 * @brief 最近一次转换的统计
+	 */
+	const ConversionMetrics& GetMetrics() const { return metrics; }
+
+	/**
+	 * @brief 最近一次转换的统计报告（JSON）
+	 */
+	std::string GetMetricsReport() const { return metrics.ToJson(); }
+
+	/**
+	 * @brief 设置批量转换的时间线跟踪
+	 *
+	 * 启用后 ToB3DMBatch 运行期间记录各线程的瓦片、节点、纹理编码、Draco压缩与文件写入/上传事件，
+	 * 成功结束时把 Chrome trace JSON 写到输出目录，可在 chrome://tracing 或 Perfetto 中查看。
+	 * @param settings 跟踪配置，对之后的批量转换生效
+	 */
+	void SetTraceSettings(const TraceSettings& settings) { trace_settings = settings; }
+
+	/**
+	 * @brief 获取跟踪配置
+	 */
+	const TraceSettings& GetTraceSettings() const { return trace_settings; }
+
+	/**
+	 * @brief 设置任务控制（由 ConversionJob 使用）
+	 *
+	 * 设置后 ToB3DMBatch 在每个瓦片与节点开始前检查取消请求，并上报瓦片完成数与写入字节数。
+	 * 取消时已提交的文件写完后返回 false，不生成根 tileset.json，进度日志保留以便续传。
+	 * @param pControl 任务控制（调用方持有），nullptr 表示不使用
+	 */
+	void SetJobControl(JobControl* pControl) { job_control = pControl; }
+
+	/**
+	 * @brief 设置批量转换的调度方式
+	 *
+	 * 批量转换的每个瓦片（渐进式发布为每个节点）从进程共享的 JobScheduler 获取槽位；
+	 * 单个模型的转换（ToGLB / ToGLBBuf / ToB3DMNode）总是以交互优先级执行。
+	 * @param ePriority 批量转换的优先级，默认 Batch
+	 * @param nMaxConcurrency 本对象每次批量转换同时占用的槽位上限，0 表示不限制
+	 */
+	void SetScheduling(JobPriority ePriority, int nMaxConcurrency = 0)
+	{
+		priority = ePriority;
+		max_concurrency = nMaxConcurrency;
+	}
+
+	/**
+	 * @brief 批量转换的优先级
+	 */
+	JobPriority GetSchedulingPriority() const { return priority; }
+
+	/**
+	 * @brief 批量转换的并发上限
+	 */
+	int GetMaxConcurrency() const { return max_concurrency; }
+
+	/**
+	 * @brief 将单个OSGB节点转换为B3DM数据
+	 * @param strInPath OSGB文件路径
+	 * @param nNodeType 节点类型：1 PagedLOD几何体，2 普通几何体
+	 * @param strB3dm 输出的B3DM数据
+	 * @param bEnableTextureCompress 是否启用纹理压缩
+	 * @param bEnableMeshOpt 是否启用网格优化
+	 * @param bEnableDraco 是否启用Draco压缩
+	 * @param pGeoTransform 数据集坐标转换（与生成 tileset 的批量转换一致），为空时不重投影
+	 * @return 是否成功
+	 */
+	bool ToB3DMNode(
+		const std::string& strInPath,
+		int nNodeType,
+		std::string& strB3dm,
+		bool bEnableTextureCompress = false,
+		bool bEnableMeshOpt = false,
+		bool bEnableDraco = false,
+		const GeoTransform* pGeoTransform = nullptr);
+
 	/**
 	 * @brief 将单个OSGB文件转换为B3DM
 	 * @param strInPath 输入OSGB文件路径
@@ -231,6 +449,7 @@ public:
 	 * @param bEnableTextureCompress 是否启用纹理压缩
 	 * @param bEnableMeshOpt 是否启用网格优化
 	 * @param bEnableDraco 是否启用Draco压缩
+	 * @param pSink 输出目标，nullptr 表示同步写入本地文件
 	 * @return B3DMResult结构体，包含成功标志、tileset.json字符串和包围盒
 	 */
 	B3DMResult ToB3DM(
@@ -241,7 +460,8 @@ public:
 		int nMaxLevel,
 		bool bEnableTextureCompress = false,
 		bool bEnableMeshOpt = false,
-		bool bEnableDraco = false);
+		bool bEnableDraco = false,
+		IOutputSink* pSink = nullptr);
 
 	/**
 	 * @brief 将单个OSGB文件转换为GLB文件
@@ -279,6 +499,24 @@ public:
 		bool bEnableMeshOpt = false, 
 		bool bEnableDraco = false);
 
+	/**
+	 * @brief 将单个OSGB文件转换为GLB，结果留在原生缓冲区中（供C#零拷贝访问）
+	 * @param strOsgbPath 输入OSGB文件路径
+	 * @param nNodeType 节点类型
+	 * @param bBinary 是否输出二进制文件
+	 * @param bEnableTextureCompress 是否启用纹理压缩
+	 * @param bEnableMeshOpt 是否启用网格优化
+	 * @param bEnableDraco 是否启用Draco压缩
+	 * @return 缓冲区句柄（调用方负责释放），失败返回 nullptr
+	 */
+	NativeBuffer* ToGLBHandle(
+		const std::string& strOsgbPath,
+		int nNodeType,
+		bool bBinary = true,
+		bool bEnableTextureCompress = false,
+		bool bEnableMeshOpt = false,
+		bool bEnableDraco = false);
+
 	/**
 	 * @brief 批量处理整个倾斜摄影数据集
 	 * @param pDataDir 输入数据目录路径
@@ -289,6 +527,7 @@ public:
 	 * @param bEnableTextureCompress 是否启用纹理压缩
 	 * @param bEnableMeshOpt 是否启用网格优化
 	 * @param bEnableDraco 是否启用Draco压缩
+	 * @param pSink 输出目标（本任务独占，结束时调用其 Flush），nullptr 表示异步写入本地文件
 	 * @return 返回成功或失败
 	 */
 	bool ToB3DMBatch(
@@ -300,7 +539,57 @@ public:
 		bool bEnableTextureCompress = false, 
 		bool bEnableMeshOpt = false, 
 		bool bEnableDraco = false,
-		bool bWriteToMinio = false);
+		IOutputSink* pSink = nullptr);
+
+	/**
+	 * @brief 读取数据目录对应的 metadata.xml（数据目录以 /Data 结尾时位于其父目录，与 ToB3DMBatch 一致）
+	 * @param strDataDir 输入数据目录
+	 * @param metadata 输出的元数据
+	 * @return 未找到或解析失败返回 false
+	 */
+	static bool LoadDatasetMetadata(const std::string& strDataDir, OSGBMetadata& metadata);
+
+	/**
+	 * @brief 生成影响瓦片输出的转换参数键（增量清单、进度日志与延迟转换索引据此判断是否作废）
+	 * @param strDataDir 输入数据目录
+	 * @param bLazy 是否延迟转换
+	 * @param subset 子集配置
+	 * @param pMetadata 数据集的 metadata.xml，为空表示没有（坐标系统变化后同样作废）
+	 * @return 参数的 JSON 字符串
+	 */
+	static std::string MakeSettingsKey(
+		const std::string& strDataDir,
+		double dCenterX,
+		double dCenterY,
+		int nMaxLevel,
+		bool bEnableTextureCompress,
+		bool bEnableMeshOpt,
+		bool bEnableDraco,
+		bool bLazy,
+		const SubsetSettings& subset,
+		const OSGBMetadata* pMetadata = nullptr);
+
+	/**
+	 * @brief 批量处理倾斜摄影数据集并写入单个3TZ归档文件
+	 * @param pDataDir 输入数据目录路径
+	 * @param strArchivePath 输出归档文件路径（如 "D:/out/city.3tz"）
+	 * @param dCenterX 切片中心X坐标
+	 * @param dCenterY 切片中心Y坐标
+	 * @param nMaxLevel 最大切片层级
+	 * @param bEnableTextureCompress 是否启用纹理压缩
+	 * @param bEnableMeshOpt 是否启用网格优化
+	 * @param bEnableDraco 是否启用Draco压缩
+	 * @return 返回成功或失败
+	 */
+	bool ToB3DMBatchToArchive(
+		const std::string& pDataDir,
+		const std::string& strArchivePath,
+		double dCenterX,
+		double dCenterY,
+		int nMaxLevel,
+		bool bEnableTextureCompress = false,
+		bool bEnableMeshOpt = false,
+		bool bEnableDraco = false);
 
 #ifdef ENABLE_MINIO
 	/**
@@ -317,6 +606,8 @@ public:
 	 * @param bEnableTextureCompress 是否启用纹理压缩
 	 * @param bEnableMeshOpt 是否启用网格优化
 	 * @param bEnableDraco 是否启用Draco压缩
+	 * @param bSkipUnchanged 是否跳过内容未变化的对象（依据上次的上传清单）
+	 * @param bPrecompress 是否预压缩（JSON/未压缩瓦片以 brotli 或 gzip 保存并设置 Content-Encoding）
 	 * @return 返回成功或失败
 	 */
 	bool ToB3DMBatchToMinIO(
@@ -331,7 +622,9 @@ public:
 		int nMaxLevel,
 		bool bEnableTextureCompress = false,
 		bool bEnableMeshOpt = false,
-		bool bEnableDraco = false);
+		bool bEnableDraco = false,
+		bool bSkipUnchanged = false,
+		bool bPrecompress = false);
 #endif
 
 private:
@@ -404,6 +697,8 @@ private:
 	 * @param enable_texture_compress 是否启用纹理压缩
 	 * @param enable_meshopt 是否启用网格优化
 	 * @param enable_draco 是否启用Draco压缩
+	 * @param pPrefetcher 输入预读器，命中时从内存反序列化（可为空）
+	 * @param pGeoTransform 数据集坐标转换，为空时不重投影
 	 * @return 返回转换是否成功
 	 */
 	bool ToGLBBuf(
@@ -415,7 +710,26 @@ private:
 		bool enable_texture_compress = false, 
 		bool enable_meshopt = false, 
 		bool enable_draco = false, 
-		bool need_mesh_info = true);
+		bool need_mesh_info = true,
+		FilePrefetcher* pPrefetcher = nullptr,
+		const GeoTransform* pGeoTransform = nullptr);
+
+	/**
+	 * @brief 经进程共享的 GLB 缓存转换单个OSGB文件
+	 * @param path 输入OSGB文件路径（本地编码）
+	 * @param glb_buff 输出GLB缓冲区（与缓存共享，只读）
+	 * @param pGeoTransform 坐标转换，已初始化时结果不进入缓存（缓存键不含坐标系统）
+	 * @return 返回转换是否成功
+	 */
+	bool ToGLBCached(
+		const std::string& path,
+		std::shared_ptr<const std::string>& glb_buff,
+		int node_type,
+		bool bBinary,
+		bool enable_texture_compress,
+		bool enable_meshopt,
+		bool enable_draco,
+		const GeoTransform* pGeoTransform = nullptr);
 
 	/**
 	 * @brief 将OSGB文件转换为B3DM缓冲区
@@ -426,6 +740,8 @@ private:
 	 * @param enable_texture_compress 是否启用纹理压缩
 	 * @param enable_meshopt 是否启用网格优化
 	 * @param enable_draco 是否启用Draco压缩
+	 * @param pPrefetcher 输入预读器（可为空）
+	 * @param pGeoTransform 数据集坐标转换，为空时不重投影
 	 * @return 返回转换是否成功
 	 */
 	bool ToB3DMBuf(
@@ -435,25 +751,129 @@ private:
 		int node_type,
 		bool enable_texture_compress = false, 
 		bool enable_meshopt = false, 
-		bool enable_draco = false);
+		bool enable_draco = false,
+		FilePrefetcher* pPrefetcher = nullptr,
+		const GeoTransform* pGeoTransform = nullptr);
 
 	/**
 	 * @brief 处理切片任务
 	 * @param tree OSG树节点结构体
+	 * @param sink 输出目标
 	 * @param out_path 输出目录路径
 	 * @param max_lvl 最大切片层级
 	 * @param enable_texture_compress 是否启用纹理压缩
 	 * @param enable_meshopt 是否启用网格优化
 	 * @param enable_draco 是否启用Draco压缩
+	 * @param pPrefetcher 输入预读器（可为空）
+	 * @param pGeoTransform 数据集坐标转换，为空时不重投影
 	 * @return void
 	 */
 	void DoTileJob(
 		OSGTree& tree, 
+		IOutputSink& sink,
 		std::string out_path, 
 		int max_lvl, 
 		bool enable_texture_compress = false, 
 		bool enable_meshopt = false, 
-		bool enable_draco = false);
+		bool enable_draco = false,
+		FilePrefetcher* pPrefetcher = nullptr,
+		const GeoTransform* pGeoTransform = nullptr);
+
+	/**
+	 * @brief 转换单个节点并写入 B3DM 文件（同时填充节点包围盒）
+	 * @param tree OSG树节点结构体（type > 0）
+	 * @param sink 输出目标
+	 * @param out_path 输出目录路径
+	 * @param enable_texture_compress 是否启用纹理压缩
+	 * @param enable_meshopt 是否启用网格优化
+	 * @param enable_draco 是否启用Draco压缩
+	 * @param pPrefetcher 输入预读器（可为空）
+	 * @param pGeoTransform 数据集坐标转换，为空时不重投影
+	 */
+	void WriteTileNode(
+		OSGTree& tree,
+		IOutputSink& sink,
+		const std::string& out_path,
+		bool enable_texture_compress,
+		bool enable_meshopt,
+		bool enable_draco,
+		FilePrefetcher* pPrefetcher,
+		const GeoTransform* pGeoTransform);
+
+	/**
+	 * @brief 由已转换的节点树生成瓦片结果（合并包围盒、计算几何误差、编码JSON）
+	 * @param root 瓦片根节点（包围盒会被修改）
+	 * @param dCenterX 中心点经度
+	 * @param dCenterY 中心点纬度
+	 * @return 根节点没有包围盒时 success 为 false
+	 */
+	B3DMResult FinishTileTree(OSGTree& root, double dCenterX, double dCenterY);
+
+	/**
+	 * @brief 按LOD层级广度优先转换多个瓦片（渐进式发布）
+	 * @param input_paths 各瓦片根OSGB文件路径
+	 * @param output_paths 各瓦片输出目录
+	 * @param sink 输出目标
+	 * @param bPublishFailed 输出：中间层级发布时有文件写入失败
+	 * @param pFilter 读取节点树时使用的子集过滤器（可为空）
+	 * @param pGeoTransform 数据集坐标转换，为空时不重投影
+	 * @return 各瓦片的转换结果，顺序与 input_paths 一致
+	 */
+	std::vector<B3DMResult> ToB3DMProgressive(
+		const std::vector<std::string>& input_paths,
+		const std::vector<std::string>& output_paths,
+		IOutputSink& sink,
+		double dCenterX,
+		double dCenterY,
+		int nMaxLevel,
+		bool bEnableTextureCompress,
+		bool bEnableMeshOpt,
+		bool bEnableDraco,
+		bool& bPublishFailed,
+		const SubsetFilter* pFilter,
+		const GeoTransform* pGeoTransform);
+
+	/**
+	 * @brief 转换单个瓦片（批量转换使用，子集过滤器由调用方按数据集坐标换算）
+	 * @param pFilter 读取节点树时使用的子集过滤器（可为空）
+	 * @param pGeoTransform 数据集坐标转换，为空时不重投影
+	 * @return 与公开的 ToB3DM 相同
+	 */
+	B3DMResult ToB3DM(
+		const std::string strInPath,
+		const std::string& strOutPath,
+		double dCenterX,
+		double dCenterY,
+		int nMaxLevel,
+		bool bEnableTextureCompress,
+		bool bEnableMeshOpt,
+		bool bEnableDraco,
+		IOutputSink* pSink,
+		const SubsetFilter* pFilter,
+		const GeoTransform* pGeoTransform);
+
+	/**
+	 * @brief 延迟模式下生成瓦片：只读取节点树并估算包围盒，不转换 B3DM
+	 * @param strInPath 瓦片根OSGB文件路径
+	 * @param strOutPath 瓦片输出目录
+	 * @param pFilter 读取节点树时使用的子集过滤器（可为空）
+	 * @param pGeoTransform 数据集坐标转换（估算的包围盒与转换结果一致），为空时不重投影
+	 * @return 与 ToB3DM 相同的结果结构
+	 */
+	B3DMResult ToB3DMLazy(const std::string& strInPath, const std::string& strOutPath,
+		double dCenterX, double dCenterY, int nMaxLevel, const SubsetFilter* pFilter,
+		const GeoTransform* pGeoTransform);
+
+	/**
+	 * @brief 登记延迟转换的节点，清除超过最大层级的节点的估算包围盒（过滤规则与 DoTileJob 一致）
+	 */
+	void RegisterLazyNodes(OSGTree& tree, const std::string& out_path, int max_lvl);
+
+	/**
+	 * @brief 读取根OSGB文件估算瓦片包围盒（用于渐进式发布的骨架）
+	 * @return 无法读取或没有有效包围盒返回 false
+	 */
+	bool EstimateTileBox(const std::string& strOsgbPath, TileBox& box);
 
 	/**
 	 * @brief 编码切片JSON字符串
@@ -467,11 +887,54 @@ private:
 	/**
 	 * @brief 获取OSGB文件的完整树结构
 	 * @param file_name 输入OSGB文件路径
+	 * @param pPrefetcher 输入预读器，读取每个节点后预读其子节点文件（可为空）
+	 * @param bEstimateBox 是否由几何体顶点范围填充节点包围盒（延迟转换模式）
+	 * @param nMaxLevel 最大层级，超过的子节点文件不读取，-1 表示不限制
+	 * @param pFilter 子集过滤器（区域为节点本地坐标），为空表示不过滤
+	 * @param pGeoTransform 数据集坐标转换（估算包围盒时使用），为空时不重投影
 	 * @return 返回OSG树节点结构体
 	 */
-	OSGTree GetAllTree(std::string& file_name);
+	OSGTree GetAllTree(std::string& file_name, FilePrefetcher* pPrefetcher = nullptr, bool bEstimateBox = false,
+		int nMaxLevel = -1, const SubsetFilter* pFilter = nullptr, const GeoTransform* pGeoTransform = nullptr);
+
+	// 批量转换的增量配置
+	IncrementalSettings incremental;
+
+	// 批量转换的断点续传配置
+	ResumeSettings resume;
+
+	// 批量转换写入本地输出目录时的异步写入配置
+	AsyncWriteSettings local_write;
+
+	// 批量转换是否渐进式发布
+	bool progressive = false;
+
+	// 转换子集配置（过滤器在每次转换时按数据集坐标生成，作为参数传递）
+	SubsetSettings subset;
+
+	// 批量转换是否延迟转换及节点登记回调
+	bool lazy = false;
+	LazyNodeCallback lazy_callback;
+
+	// 任务控制（取消与进度），可为空
+	JobControl* job_control = nullptr;
+
+	// 批量转换的调度优先级与并发上限
+	JobPriority priority = JobPriority::Batch;
+	int max_concurrency = 0;
+
+	// 转换统计配置及统计结果
+	MetricsSettings metrics_settings;
+	ConversionMetrics metrics;
+
+	// 批量转换的时间线跟踪配置
+	TraceSettings trace_settings;
+
+	// 启用统计时返回统计对象，否则为 nullptr
+	ConversionMetrics* ActiveMetrics() { return metrics_settings.bEnable ? &metrics : nullptr; }
 
-	std::shared_ptr<MinioClient> g_minio_client = nullptr;
+	// 任务是否已被取消
+	bool IsCancelled() const { return job_control && job_control->IsCancelled(); }
 };
 
 #endif // !OSGBREADER_H
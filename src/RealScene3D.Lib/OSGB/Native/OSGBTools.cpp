@@ -10,6 +10,8 @@
 
 #include "OSGBTools.h"
 #include "GeoTransform.h"
+#include "TraceRecorder.h"
+#include "ZipFileSystem.h"
 
 using namespace OSGBLog;
 
@@ -38,7 +40,7 @@ MinioClient::MinioClient(
 		base_url.host = endpoint;
 		base_url.https = useSSL;
 
-		LOG_D("BaseUrl: host={}, https={}", base_url.host.c_str(), base_url.https);
+		OSGB_LOG_D("BaseUrl: host={}, https={}", base_url.host.c_str(), base_url.https);
 
 		minio::creds::StaticProvider* provider = new minio::creds::StaticProvider(accessKey, secretKey);
 
@@ -67,7 +69,17 @@ MinioClient::~MinioClient()
 	}
 }
 
-bool MinioClient::Write(const std::string& objectName, const char* data, size_t size)
+std::string MinioClient::FullName(const std::string& objectName) const
+{
+	// 构造完整对象名：去除开头的斜杠避免双斜杠
+	size_t nSkip = objectName.find_first_not_of('/');
+	std::string clean_name = (nSkip == std::string::npos) ? std::string() : objectName.substr(nSkip);
+
+	return object_prefix.empty() ? clean_name : object_prefix + "/" + clean_name;
+}
+
+bool MinioClient::Write(const std::string& objectName, const char* data, size_t size, std::string* pError,
+	const std::string& strContentEncoding, const std::string& strContentType)
 {
 	if (!client_ptr)
 	{
@@ -80,24 +92,13 @@ bool MinioClient::Write(const std::string& objectName, const char* data, size_t
 	{
 		minio::s3::Client* client = static_cast<minio::s3::Client*>(client_ptr);
 
-		// 构造完整对象名：去除开头的斜杠避免双斜杠
-		std::string clean_name = objectName;
-		while (!clean_name.empty() && clean_name[0] == '/')
-		{
-			clean_name = clean_name.substr(1);
-		}
+		std::string full_name = FullName(objectName);
 
-		std::string full_name = object_prefix.empty() ? clean_name : object_prefix + "/" + clean_name;
+		OSGB_LOG_D("MinIO写入: bucket={}, object={}, size={}", bucket_name.c_str(), full_name.c_str(), size);
 
-		LOG_D("MinIO写入: bucket={}, object={}, size={}", bucket_name.c_str(), full_name.c_str(), size);
-
-		// 创建字符串流（使用 stringstream 而非 istringstream）
-		std::stringstream stream;
-		stream.write(data, static_cast<std::streamsize>(size));
-		stream.seekg(0, std::ios::beg);  // 重置读取位置
-
-		LOG_D("Stream状态: good={}, eof={}, fail={}, bad={}, pos={}",
-			stream.good(), stream.eof(), stream.fail(), stream.bad(), (long)stream.tellg());
+		// 直接以调用者缓冲区作为输入流，避免复制到 stringstream
+		MemoryStreamBuf stream_buf(data, size);
+		std::istream stream(&stream_buf);
 
 		// 构造 PutObjectArgs
 		constexpr uint64_t kMaxPartSize = 5'368'709'120;        // 5GiB
@@ -117,14 +118,27 @@ bool MinioClient::Write(const std::string& objectName, const char* data, size_t
 		minio::s3::PutObjectArgs args(stream, object_size, part_size);
 		args.bucket = bucket_name;
 		args.object = full_name;
-
-		LOG_D("PutObjectArgs验证通过，准备上传");
+		if (!strContentType.empty())
+		{
+			args.content_type = strContentType;
+		}
+		if (!strContentEncoding.empty())
+		{
+			args.headers.Add("Content-Encoding", strContentEncoding);
+		}
 
 		auto resp = client->PutObject(args);
-		LOG_D("PutObject返回: status_code={}, code={}, message={}", resp.status_code, resp.code.c_str(), resp.message.c_str());
-
 		if (!resp)
 		{
+			// 由调用者决定是否重试，此时只返回错误信息而不输出错误日志
+			if (pError)
+			{
+				*pError = fmt::format("object={}, status_code={}, code={}, message={}",
+					full_name, resp.status_code, resp.code, resp.message);
+
+				return false;
+			}
+
 			LOG_E("MinIO写入失败:");
 			LOG_E("  bucket={}, object={}", bucket_name.c_str(), full_name.c_str());
 			LOG_E("  status_code={}, code={}, message={}", resp.status_code, resp.code.c_str(), resp.message.c_str());
@@ -134,17 +148,96 @@ bool MinioClient::Write(const std::string& objectName, const char* data, size_t
 			return false;
 		}
 
-		LOG_D("MinIO写入成功: {}", full_name.c_str());
+		OSGB_LOG_D("MinIO写入成功: {}", full_name.c_str());
 		return true;
 	}
 	catch (const std::exception& e)
 	{
+		if (pError)
+		{
+			*pError = e.what();
+
+			return false;
+		}
+
 		LOG_E("MinIO写入异常: {}", e.what());
 
 		return false;
 	}
 }
 
+bool MinioClient::Stat(const std::string& objectName, std::string& strETag, size_t& nSize)
+{
+	if (!client_ptr)
+	{
+		return false;
+	}
+
+	try
+	{
+		minio::s3::Client* client = static_cast<minio::s3::Client*>(client_ptr);
+
+		minio::s3::StatObjectArgs args;
+		args.bucket = bucket_name;
+		args.object = FullName(objectName);
+
+		auto resp = client->StatObject(args);
+		if (!resp)
+		{
+			return false;
+		}
+
+		strETag = resp.etag;
+		nSize = static_cast<size_t>(resp.size);
+
+		return true;
+	}
+	catch (const std::exception& e)
+	{
+		LOG_W("MinIO查询对象异常: {}", e.what());
+
+		return false;
+	}
+}
+
+bool MinioClient::Read(const std::string& objectName, std::string& out)
+{
+	if (!client_ptr)
+	{
+		return false;
+	}
+
+	try
+	{
+		minio::s3::Client* client = static_cast<minio::s3::Client*>(client_ptr);
+
+		out.clear();
+		minio::s3::GetObjectArgs args;
+		args.bucket = bucket_name;
+		args.object = FullName(objectName);
+		args.datafunc = [&out](minio::http::DataFunctionArgs data_args) -> bool
+		{
+			out.append(data_args.datachunk.data(), data_args.datachunk.size());
+			return true;
+		};
+
+		auto resp = client->GetObject(args);
+		if (!resp)
+		{
+			out.clear();
+			return false;
+		}
+
+		return true;
+	}
+	catch (const std::exception& e)
+	{
+		LOG_W("MinIO读取对象异常: {}", e.what());
+
+		return false;
+	}
+}
+
 bool MinioClient::MakeBucket()
 {
 	if (!client_ptr)
@@ -200,27 +293,8 @@ bool OSGBTools::MkDirs(const std::string& strPath)
 
 bool OSGBTools::WriteFile(const std::string& strFileName, const char* pszBuf, unsigned long nBufLen)
 {
-#ifdef ENABLE_MINIO
-	// 先获取MinIO客户端指针（锁内操作）
-	MinioClient* client = nullptr;
-	{
-		std::lock_guard<std::mutex> lock(g_minio_mutex);
-		client = g_minio_client;
-	}
-
-	// 在锁外执行网络I/O，避免阻塞其他线程
-	if (client && client->IsValid())
-	{
-		std::string object_name = strFileName;
-		for (char& c : object_name)
-		{
-			if (c == '\\') c = '/';
-		}
-		return client->Write(object_name, pszBuf, nBufLen);
-	}
-#endif
+	TraceScope trace("WriteFile", "io", strFileName);
 
-	// 默认：写入本地文件
 	try
 	{
 		std::ofstream ofs(strFileName, std::ios::binary);
@@ -240,8 +314,40 @@ bool OSGBTools::WriteFile(const std::string& strFileName, const char* pszBuf, un
 	}
 }
 
+bool OSGBTools::ReadFile(const std::string& strFileName, std::string& data)
+{
+	std::string entry;
+	if (auto zip = ZipFileSystem::Resolve(strFileName, entry))
+	{
+		return zip->ReadFile(entry, data);
+	}
+
+	std::ifstream file(strFileName, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		return false;
+	}
+
+	std::streamsize nSize = file.tellg();
+	if (nSize < 0)
+	{
+		return false;
+	}
+
+	data.resize(static_cast<size_t>(nSize));
+	file.seekg(0, std::ios::beg);
+
+	return nSize == 0 || static_cast<bool>(file.read(&data[0], nSize));
+}
+
 bool OSGBTools::IsDirectory(const std::string& strPath)
 {
+	std::string entry;
+	if (auto zip = ZipFileSystem::Resolve(strPath, entry))
+	{
+		return zip->IsDirectory(entry);
+	}
+
 	try
 	{
 		return std::filesystem::is_directory(strPath);
@@ -254,6 +360,12 @@ bool OSGBTools::IsDirectory(const std::string& strPath)
 
 bool OSGBTools::IsRegularFile(const std::string& strPath)
 {
+	std::string entry;
+	if (auto zip = ZipFileSystem::Resolve(strPath, entry))
+	{
+		return zip->IsRegularFile(entry);
+	}
+
 	try
 	{
 		return std::filesystem::is_regular_file(strPath);
@@ -267,6 +379,30 @@ bool OSGBTools::IsRegularFile(const std::string& strPath)
 bool OSGBTools::ForEachEntry(const std::string& strDirPath,
 	std::function<bool(const DirectoryEntry&)> callback)
 {
+	std::string entry;
+	if (auto zip = ZipFileSystem::Resolve(strDirPath, entry))
+	{
+		const auto* children = zip->GetChildren(entry);
+		if (children == nullptr)
+		{
+			return false;
+		}
+
+		for (const auto& child : *children)
+		{
+			DirectoryEntry dirEntry;
+			dirEntry.name = child.name;
+			dirEntry.is_directory = child.is_directory;
+			dirEntry.is_regular_file = !child.is_directory;
+
+			if (!callback(dirEntry))
+			{
+				return true;
+			}
+		}
+		return true;
+	}
+
 	try
 	{
 		for (const auto& entry : std::filesystem::directory_iterator(strDirPath))
@@ -304,7 +440,59 @@ std::string OSGBTools::FindRootOSGB(const std::string& strDirPath)
 		strNormalizedPath.pop_back();
 	}
 
-	// 在目录中递归搜索根 OSGB 的辅助函数
+	auto IsRootName = [](const std::string& filename) -> bool
+	{
+		return filename.length() > 5 &&
+			filename.substr(filename.length() - 5) == ".osgb" &&
+			filename.find("_L") == std::string::npos;
+	};
+
+	// 按 Tile_X/Tile_X.osgb 约定查找（只访问当前目录和直接子目录，不递归）
+	auto SearchByConvention = [&IsRootName](const std::string& strSearchPath) -> std::string
+	{
+		// 目录本身就是瓦片目录
+		std::string strSelf = strSearchPath + "/" + GetFileName(strSearchPath) + ".osgb";
+		if (IsRegularFile(strSelf))
+		{
+			return strSelf;
+		}
+
+		std::vector<std::string> rootFiles;
+		std::vector<std::string> subDirs;
+		ForEachEntry(strSearchPath, [&](const DirectoryEntry& entry) -> bool
+		{
+			if (entry.is_regular_file && IsRootName(entry.name))
+			{
+				rootFiles.emplace_back(entry.name);
+			}
+			else if (entry.is_directory)
+			{
+				subDirs.emplace_back(entry.name);
+			}
+			return true;
+		});
+
+		// 当前目录下不带级别后缀的 OSGB
+		if (!rootFiles.empty())
+		{
+			return strSearchPath + "/" + *std::min_element(rootFiles.begin(), rootFiles.end());
+		}
+
+		// 子目录 S 中的 S/S.osgb
+		std::sort(subDirs.begin(), subDirs.end());
+		for (const auto& subDir : subDirs)
+		{
+			std::string strCandidate = strSearchPath + "/" + subDir + "/" + subDir + ".osgb";
+			if (IsRegularFile(strCandidate))
+			{
+				return strCandidate;
+			}
+		}
+
+		return "";
+	};
+
+	// 在目录中递归搜索根 OSGB 的辅助函数（不符合命名约定时的兜底）
 	auto SearchDir = [](const std::string& strSearchPath) -> std::string
 	{
 		std::vector<std::string> osgbFiles = ScanOSGBFiles(strSearchPath, true);
@@ -322,15 +510,27 @@ std::string OSGBTools::FindRootOSGB(const std::string& strDirPath)
 		return "";
 	};
 
+	std::string strDataDir = strNormalizedPath + "/Data";
+
+	// 先按命名约定查找输入路径及其 Data 子目录
+	std::string result = SearchByConvention(strNormalizedPath);
+	if (result.empty() && IsDirectory(strDataDir))
+	{
+		result = SearchByConvention(strDataDir);
+	}
+	if (!result.empty())
+	{
+		return result;
+	}
+
 	// 检查输入路径本身
-	std::string result = SearchDir(strNormalizedPath);
+	result = SearchDir(strNormalizedPath);
 	if (!result.empty())
 	{
 		return result;
 	}
 
 	// 尝试 Data 子目录
-	std::string strDataDir = strNormalizedPath + "/Data";
 	{
 		result = SearchDir(strDataDir);
 		if (!result.empty())
@@ -443,6 +643,21 @@ std::vector<std::string> OSGBTools::ScanOSGBFiles(const std::string& strDirPath,
 {
 	std::vector<std::string> files;
 
+	// 压缩包内：直接查询内存中的目录树
+	std::string entry;
+	if (auto zip = ZipFileSystem::Resolve(strDirPath, entry))
+	{
+		for (const auto& name : zip->ListFiles(entry, bRecursive))
+		{
+			if (name.length() > 5 && name.substr(name.length() - 5) == ".osgb")
+			{
+				files.emplace_back(zip->GetArchivePath() + "/" + name);
+			}
+		}
+
+		return files;
+	}
+
 	try
 	{
 		if (bRecursive)
@@ -748,19 +963,14 @@ std::string trim(const std::string& str)
 
 bool OSGBTools::ParseMetadataXml(const std::string& strXmlPath, OSGBMetadata& outMetadata)
 {
-	// 读取文件
-	std::ifstream file(strXmlPath);
-	if (!file.is_open())
+	// 读取文件（支持压缩包内路径）
+	std::string strXmlContent;
+	if (!ReadFile(strXmlPath, strXmlContent))
 	{
 		LOG_E("Failed to open metadata.xml: {}", strXmlPath.c_str());
 		return false;
 	}
 
-	std::stringstream buffer;
-	buffer << file.rdbuf();
-	std::string strXmlContent = buffer.str();
-	file.close();
-
 	// 解析 version
 	outMetadata.strVersion = extractXmlTag(strXmlContent, "ModelMetadata version");
 	if (outMetadata.strVersion.empty())
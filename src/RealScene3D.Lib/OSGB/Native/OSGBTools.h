@@ -10,12 +10,18 @@
 #include <functional>
 #include <filesystem>
 #include <fstream>
+#include <streambuf>
 #include <fmt/format.h>
 #include <spdlog/spdlog.h>
 
 #include "MeshProcessor.h"
 #include "Tileset.h"  
 
+// 编译期日志级别（SPDLOG_LEVEL_*），低于此级别的日志调用不生成代码，由 CMake 的 OSGB_LOG_LEVEL 设置
+#ifndef OSGB_LOG_ACTIVE_LEVEL
+#define OSGB_LOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+
 namespace OSGBLog
 {
 	/**
@@ -27,7 +33,10 @@ namespace OSGBLog
 	template<typename... Args>
 	inline void LOG_D(fmt::format_string<Args...> format, Args&&... args)
 	{
-		spdlog::log(spdlog::level::debug, format, std::forward<Args>(args)...);
+		if constexpr (OSGB_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG)
+		{
+			spdlog::log(spdlog::level::debug, format, std::forward<Args>(args)...);
+		}
 	}
 
 	/**
@@ -39,7 +48,10 @@ namespace OSGBLog
 	template<typename... Args>
 	inline void LOG_I(fmt::format_string<Args...> format, Args&&... args)
 	{
-		spdlog::log(spdlog::level::info, format, std::forward<Args>(args)...);
+		if constexpr (OSGB_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO)
+		{
+			spdlog::log(spdlog::level::info, format, std::forward<Args>(args)...);
+		}
 	}
 
 	/**
@@ -51,7 +63,10 @@ namespace OSGBLog
 	template<typename... Args>
 	inline void LOG_W(fmt::format_string<Args...> format, Args&&... args)
 	{
-		spdlog::log(spdlog::level::warn, format, std::forward<Args>(args)...);
+		if constexpr (OSGB_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN)
+		{
+			spdlog::log(spdlog::level::warn, format, std::forward<Args>(args)...);
+		}
 	}
 
 	/**
@@ -63,7 +78,10 @@ namespace OSGBLog
 	template<typename... Args>
 	inline void LOG_E(fmt::format_string<Args...> format, Args&&... args)
 	{
-		spdlog::log(spdlog::level::err, format, std::forward<Args>(args)...);
+		if constexpr (OSGB_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR)
+		{
+			spdlog::log(spdlog::level::err, format, std::forward<Args>(args)...);
+		}
 	}
 
 	/**
@@ -75,10 +93,58 @@ namespace OSGBLog
 	template<typename... Args>
 	inline void LOG_T(fmt::format_string<Args...> format, Args&&... args)
 	{
-		spdlog::log(spdlog::level::trace, format, std::forward<Args>(args)...);
+		if constexpr (OSGB_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE)
+		{
+			spdlog::log(spdlog::level::trace, format, std::forward<Args>(args)...);
+		}
 	}
 }
 
+/**
+ * @brief 热路径上的 Info / Debug / Trace 日志：编译期或运行期级别关闭时不求值参数
+ *
+ * LOG_I / LOG_D / LOG_T 是函数，即使日志被过滤，调用前也会先求值参数；
+ * 转换线程中每个瓦片、每次写入都会执行的日志，或参数需要计算（如格式化路径、读取流位置）时使用这些宏。
+ *
+ * @example
+ * OSGB_LOG_D("MinIO写入: object={}, size={}", full_name, size);
+ */
+#define OSGB_LOG_I(...) \
+	do \
+	{ \
+		if constexpr (OSGB_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO) \
+		{ \
+			if (spdlog::should_log(spdlog::level::info)) \
+			{ \
+				OSGBLog::LOG_I(__VA_ARGS__); \
+			} \
+		} \
+	} while (0)
+
+#define OSGB_LOG_D(...) \
+	do \
+	{ \
+		if constexpr (OSGB_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG) \
+		{ \
+			if (spdlog::should_log(spdlog::level::debug)) \
+			{ \
+				OSGBLog::LOG_D(__VA_ARGS__); \
+			} \
+		} \
+	} while (0)
+
+#define OSGB_LOG_T(...) \
+	do \
+	{ \
+		if constexpr (OSGB_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE) \
+		{ \
+			if (spdlog::should_log(spdlog::level::trace)) \
+			{ \
+				OSGBLog::LOG_T(__VA_ARGS__); \
+			} \
+		} \
+	} while (0)
+
 /**
  * @brief metadata.xml 元数据结构
  */
@@ -162,6 +228,68 @@ struct LODPipelineSettings
 	std::vector<LODLevelSettings> levels;
 };
 
+/**
+ * @brief 只读内存流缓冲区（零拷贝）
+ *
+ * 直接以外部缓冲区作为 std::istream 的数据源，不复制数据，
+ * 支持 seekg/tellg，可用于 PutObject 等需要 std::istream 的接口。
+ * 调用者需保证缓冲区在流使用期间有效。
+ *
+ * @example
+ * MemoryStreamBuf buf(data.data(), data.size());
+ * std::istream stream(&buf);
+ */
+class MemoryStreamBuf : public std::streambuf
+{
+public:
+	MemoryStreamBuf(const char* pData, size_t nSize)
+	{
+		char* pBegin = const_cast<char*>(pData);
+		setg(pBegin, pBegin, pBegin + nSize);
+	}
+
+protected:
+	pos_type seekoff(off_type nOffset, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+	{
+		if (!(which & std::ios_base::in))
+		{
+			return pos_type(off_type(-1));
+		}
+
+		char* pTarget = nullptr;
+		if (dir == std::ios_base::beg)
+		{
+			pTarget = eback() + nOffset;
+		}
+		else if (dir == std::ios_base::cur)
+		{
+			pTarget = gptr() + nOffset;
+		}
+		else
+		{
+			pTarget = egptr() + nOffset;
+		}
+
+		if (pTarget < eback() || pTarget > egptr())
+		{
+			return pos_type(off_type(-1));
+		}
+
+		setg(eback(), pTarget, egptr());
+		return pos_type(off_type(pTarget - eback()));
+	}
+
+	pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+	{
+		return seekoff(off_type(pos), std::ios_base::beg, which);
+	}
+
+	std::streamsize showmanyc() override
+	{
+		return egptr() - gptr();
+	}
+};
+
 #ifdef ENABLE_MINIO
 /**
  * @brief MinIO客户端包装类（复用连接）
@@ -178,7 +306,35 @@ public:
 
 	~MinioClient();
 
-	bool Write(const std::string& objectName, const char* data, size_t size);
+	/**
+	 * @brief 上传单个对象（同步）
+	 * @param objectName 对象名（相对于前缀）
+	 * @param data 数据指针（上传期间需保持有效，不会被复制）
+	 * @param size 数据大小
+	 * @param pError 可选输出错误信息；非空时失败不输出错误日志，由调用者处理（如重试）
+	 * @param strContentEncoding 可选 Content-Encoding（如 "gzip"、"br"），数据须已按该编码压缩
+	 * @param strContentType 可选 Content-Type
+	 * @return true=成功, false=失败
+	 */
+	bool Write(const std::string& objectName, const char* data, size_t size, std::string* pError = nullptr,
+		const std::string& strContentEncoding = "", const std::string& strContentType = "");
+
+	/**
+	 * @brief 查询对象元数据
+	 * @param objectName 对象名（相对于前缀）
+	 * @param strETag 输出ETag（原样返回，可用 ContentHash::NormalizeETag 规范化）
+	 * @param nSize 输出对象大小
+	 * @return 对象存在返回 true
+	 */
+	bool Stat(const std::string& objectName, std::string& strETag, size_t& nSize);
+
+	/**
+	 * @brief 下载对象内容
+	 * @param objectName 对象名（相对于前缀）
+	 * @param out 输出对象内容
+	 * @return 对象存在且读取成功返回 true
+	 */
+	bool Read(const std::string& objectName, std::string& out);
 
 	bool MakeBucket();
 
@@ -193,6 +349,9 @@ public:
 	}
 
 private:
+	// 拼接前缀得到完整对象名
+	std::string FullName(const std::string& objectName) const;
+
 	void* client_ptr;  // minio::s3::Client*
 	std::string bucket_name;
 	std::string object_prefix;  // 对象前缀
@@ -219,6 +378,14 @@ public:
 	// 写文件函数
 	static bool WriteFile(const std::string& strFileName, const char* pszBuf, unsigned long nBufLen);
 
+	/**
+	 * @brief 读取整个文件
+	 * @param strFileName 文件路径（可位于 ZIP 压缩包内，如 "D:/survey.zip/metadata.xml"）
+	 * @param data 输出文件内容
+	 * @return 是否成功
+	 */
+	static bool ReadFile(const std::string& strFileName, std::string& data);
+
 	// 判断路径是否为目录
 	static bool IsDirectory(const std::string& strPath);
 
@@ -248,7 +415,12 @@ public:
 	 */
 	static bool ForEachEntry(const std::string& strDirPath, std::function<bool(const DirectoryEntry&)> callback);
 
-	// 在目录中查找根 OSGB 文件
+	/**
+	 * @brief 在目录中查找根 OSGB 文件
+	 *
+	 * 优先按 Tile_X/Tile_X.osgb 命名约定查找目录本身、直接子目录及 Data 子目录，
+	 * 只有约定不适用时才递归扫描。
+	 */
 	static std::string FindRootOSGB(const std::string& strDirPath);
 
 	/**
@@ -403,31 +575,6 @@ public:
 	 * @return 是否成功
 	 */
 	static bool RemoveDirectory(const std::string& dir);
-
-	/**
-	 * @brief 设置当前线程的MinIO客户端（用于WriteFile路由）
-	 * @param client MinIO客户端指针（nullptr表示写本地文件）
-	 */
-	static void SetMinioWriter(MinioClient* client)
-	{
-		std::lock_guard<std::mutex> lock(g_minio_mutex);
-		g_minio_client = client;
-	}
-
-	/**
-	 * @brief 获取当前线程的MinIO客户端
-	 */
-	static MinioClient* GetMinioWriter()
-	{
-		std::lock_guard<std::mutex> lock(g_minio_mutex);
-		return g_minio_client;
-	}
-
-private:
-	static inline MinioClient* g_minio_client = nullptr;
-
-	// MinIO客户端访问需要线程安全，使用互斥锁保护
-	static inline std::mutex g_minio_mutex;
 };
 
 #endif // !OSGBTOOLS_H
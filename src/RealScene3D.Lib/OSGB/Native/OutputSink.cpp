@@ -0,0 +1,324 @@
+#include <algorithm>
+
+#include "OutputSink.h"
+#include "OSGBTools.h"
+#include "Precompressor.h"
+#include "TileArchiveWriter.h"
+
+#ifdef ENABLE_MINIO
+#include "MinioUploader.h"
+#endif
+
+using namespace OSGBLog;
+
+// ============================================================================
+// IOutputSink
+// ============================================================================
+
+bool IOutputSink::WriteEncoded(const std::string& strPath, std::string&& data, const std::string& strContentEncoding)
+{
+	return Write(strPath + Precompressor::ExtensionFor(strContentEncoding), std::move(data));
+}
+
+// ============================================================================
+// LocalFileSink
+// ============================================================================
+
+LocalFileSink::LocalFileSink(bool bAsync, const AsyncWriteSettings& settings)
+{
+	if (bAsync)
+	{
+		async_writer = std::make_unique<AsyncFileWriter>(settings);
+	}
+}
+
+bool LocalFileSink::Write(const std::string& strPath, std::string&& data)
+{
+	if (async_writer)
+	{
+		return async_writer->Submit(strPath, std::move(data));
+	}
+
+	return OSGBTools::WriteFile(strPath, data.data(), static_cast<unsigned long>(data.size()));
+}
+
+bool LocalFileSink::MakeDirs(const std::string& strPath)
+{
+	if (async_writer)
+	{
+		async_writer->RequestDirectory(strPath);
+		return true;
+	}
+
+	return OSGBTools::MkDirs(strPath);
+}
+
+bool LocalFileSink::Flush()
+{
+	return async_writer ? async_writer->Flush() : true;
+}
+
+bool LocalFileSink::Barrier()
+{
+	return async_writer ? async_writer->Barrier() : true;
+}
+
+// ============================================================================
+// ArchiveSink
+// ============================================================================
+
+bool ArchiveSink::Write(const std::string& strPath, std::string&& data)
+{
+	return archive.Append(strPath, data.data(), data.size());
+}
+
+bool ArchiveSink::Write(const std::string& strPath, const char* pData, size_t nSize)
+{
+	return archive.Append(strPath, pData, nSize);
+}
+
+// ============================================================================
+// MinioSink
+// ============================================================================
+
+#ifdef ENABLE_MINIO
+bool MinioSink::Write(const std::string& strPath, std::string&& data)
+{
+	return minio.Submit(strPath, std::move(data));
+}
+
+bool MinioSink::WriteEncoded(const std::string& strPath, std::string&& data, const std::string& strContentEncoding)
+{
+	return minio.Submit(strPath, std::move(data), strContentEncoding);
+}
+
+bool MinioSink::Flush()
+{
+	return minio.Flush();
+}
+
+bool MinioSink::Barrier()
+{
+	return minio.Barrier();
+}
+#endif
+
+// ============================================================================
+// PrecompressSink
+// ============================================================================
+
+PrecompressSink::PrecompressSink(IOutputSink& inner, const PrecompressSettings& precompressSettings)
+	: downstream(inner), settings(precompressSettings)
+{
+	if (settings.bGzip && !Precompressor::IsGzipAvailable())
+	{
+		LOG_W("未编译 zlib 支持，跳过 gzip 预压缩");
+		settings.bGzip = false;
+	}
+
+	if (settings.bBrotli && !Precompressor::IsBrotliAvailable())
+	{
+		LOG_W("未编译 brotli 支持，跳过 brotli 预压缩");
+		settings.bBrotli = false;
+	}
+}
+
+bool PrecompressSink::ShouldCompress(const std::string& strPath, size_t nSize, bool& bText) const
+{
+	if ((!settings.bGzip && !settings.bBrotli) || nSize < settings.nMinSizeBytes)
+	{
+		return false;
+	}
+
+	std::string ext;
+	size_t nDot = strPath.find_last_of('.');
+	if (nDot != std::string::npos)
+	{
+		ext = strPath.substr(nDot);
+		std::transform(ext.begin(), ext.end(), ext.begin(),
+			[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	}
+
+	bText = (ext == ".json");
+	if (bText)
+	{
+		return true;
+	}
+
+	return settings.bCompressTiles &&
+		(ext == ".b3dm" || ext == ".glb" || ext == ".i3dm" || ext == ".pnts" || ext == ".cmpt");
+}
+
+bool PrecompressSink::Write(const std::string& strPath, std::string&& data)
+{
+	bool bText = false;
+	if (!ShouldCompress(strPath, data.size(), bText))
+	{
+		return downstream.Write(strPath, std::move(data));
+	}
+
+	const size_t nLimit = static_cast<size_t>(data.size() * settings.dMaxRatio);
+
+	std::string br_buf;
+	std::string gz_buf;
+	bool bHasBrotli = settings.bBrotli &&
+		Precompressor::Brotli(data.data(), data.size(), br_buf, settings.nBrotliQuality, bText) &&
+		br_buf.size() <= nLimit;
+	bool bHasGzip = settings.bGzip &&
+		Precompressor::Gzip(data.data(), data.size(), gz_buf, settings.nGzipLevel) &&
+		gz_buf.size() <= nLimit;
+
+	// 压缩收益不足（已压缩的数据），原样写出
+	if (!bHasBrotli && !bHasGzip)
+	{
+		return downstream.Write(strPath, std::move(data));
+	}
+
+	compressed_count++;
+	original_bytes += data.size();
+
+	if (settings.eMode == PrecompressMode::EncodedOnly)
+	{
+		// 只能保存一种编码，优先 brotli（压缩率更高）
+		std::string& encoded = bHasBrotli ? br_buf : gz_buf;
+		compressed_bytes += encoded.size();
+
+		return downstream.WriteEncoded(strPath, std::move(encoded),
+			bHasBrotli ? Precompressor::kEncodingBrotli : Precompressor::kEncodingGzip);
+	}
+
+	// 统计按客户端实际获取的编码（优先 brotli）
+	compressed_bytes += bHasBrotli ? br_buf.size() : gz_buf.size();
+
+	bool bOk = true;
+	if (bHasGzip)
+	{
+		bOk = downstream.WriteEncoded(strPath, std::move(gz_buf), Precompressor::kEncodingGzip) && bOk;
+	}
+	if (bHasBrotli)
+	{
+		bOk = downstream.WriteEncoded(strPath, std::move(br_buf), Precompressor::kEncodingBrotli) && bOk;
+	}
+
+	return downstream.Write(strPath, std::move(data)) && bOk;
+}
+
+bool PrecompressSink::MakeDirs(const std::string& strPath)
+{
+	return downstream.MakeDirs(strPath);
+}
+
+bool PrecompressSink::Flush()
+{
+	if (compressed_count.load() > 0)
+	{
+		LOG_I("预压缩统计: {} 个文件, 原始 {} 字节 -> {} 字节",
+			compressed_count.load(), original_bytes.load(), compressed_bytes.load());
+	}
+
+	return downstream.Flush();
+}
+
+bool PrecompressSink::Barrier()
+{
+	return downstream.Barrier();
+}
+
+// ============================================================================
+// MemorySink
+// ============================================================================
+
+bool MemorySink::Write(const std::string& strPath, std::string&& data)
+{
+	std::string path = strPath;
+	std::replace(path.begin(), path.end(), '\\', '/');
+
+	std::lock_guard<std::mutex> lock(files_mutex);
+	files[path] = std::move(data);
+
+	return true;
+}
+
+bool MemorySink::Get(const std::string& strPath, std::string& out) const
+{
+	std::string path = strPath;
+	std::replace(path.begin(), path.end(), '\\', '/');
+
+	std::lock_guard<std::mutex> lock(files_mutex);
+	auto it = files.find(path);
+	if (it == files.end())
+	{
+		return false;
+	}
+
+	out = it->second;
+
+	return true;
+}
+
+std::vector<uint8_t> MemorySink::GetData(const std::string& strPath) const
+{
+	std::string data;
+	if (!Get(strPath, data))
+	{
+		return {};
+	}
+
+	return std::vector<uint8_t>(data.begin(), data.end());
+}
+
+std::vector<std::string> MemorySink::GetPaths() const
+{
+	std::lock_guard<std::mutex> lock(files_mutex);
+
+	std::vector<std::string> paths;
+	paths.reserve(files.size());
+	for (const auto& item : files)
+	{
+		paths.emplace_back(item.first);
+	}
+
+	return paths;
+}
+
+size_t MemorySink::GetFileCount() const
+{
+	std::lock_guard<std::mutex> lock(files_mutex);
+	return files.size();
+}
+
+size_t MemorySink::GetTotalBytes() const
+{
+	std::lock_guard<std::mutex> lock(files_mutex);
+
+	size_t nTotal = 0;
+	for (const auto& item : files)
+	{
+		nTotal += item.second.size();
+	}
+
+	return nTotal;
+}
+
+void MemorySink::Clear()
+{
+	std::lock_guard<std::mutex> lock(files_mutex);
+	files.clear();
+}
+
+// ============================================================================
+// NullSink
+// ============================================================================
+
+bool NullSink::Write(const std::string& strPath, std::string&& data)
+{
+	return Write(strPath, data.data(), data.size());
+}
+
+bool NullSink::Write(const std::string& /*strPath*/, const char* /*pData*/, size_t nSize)
+{
+	file_count++;
+	total_bytes += nSize;
+
+	return true;
+}
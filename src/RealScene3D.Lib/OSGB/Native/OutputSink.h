@@ -0,0 +1,280 @@
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "AsyncFileWriter.h"
+
+class TileArchiveWriter;
+class MinioUploader;
+
+/**
+ * @brief 切片输出目标接口
+ *
+ * 每个转换任务持有自己的输出目标，通过参数传入 ToB3DMBatch / ToB3DM，
+ * 同一进程内的多个任务可以写往不同目的地而互不干扰。
+ * 实现需保证 Write/MakeDirs 可被多个转换线程并发调用，可自行排队、批量或并行写入；
+ * 任务结束时调用 Flush 汇总结果。
+ */
+class IOutputSink
+{
+public:
+	virtual ~IOutputSink() = default;
+
+	/**
+	 * @brief 写入一个文件，缓冲区所有权移交给输出目标
+	 * @param strPath 文件路径（本地输出为完整路径，其他目标为相对路径/对象名）
+	 * @param data 文件内容
+	 * @return 是否成功（异步实现表示已入队，最终结果由 Flush 返回）
+	 */
+	virtual bool Write(const std::string& strPath, std::string&& data) = 0;
+
+	/**
+	 * @brief 写入一个文件（复制缓冲区）
+	 */
+	virtual bool Write(const std::string& strPath, const char* pData, size_t nSize)
+	{
+		return Write(strPath, std::string(pData, nSize));
+	}
+
+	/**
+	 * @brief 写入已压缩的文件
+	 * @param strPath 原始文件路径
+	 * @param data 压缩后的数据
+	 * @param strContentEncoding 编码（"gzip" / "br"）
+	 * @note 默认实现写为带扩展名的旁路文件（如 tileset.json.gz）；
+	 *       支持对象元数据的目标（MinIO）以原路径保存并设置 Content-Encoding
+	 */
+	virtual bool WriteEncoded(const std::string& strPath, std::string&& data, const std::string& strContentEncoding);
+
+	/**
+	 * @brief 准备目录（只有本地文件系统需要）
+	 */
+	virtual bool MakeDirs(const std::string& /*strPath*/)
+	{
+		return true;
+	}
+
+	/**
+	 * @brief 等待所有写入完成
+	 * @return 自上次 Flush 以来没有失败返回 true
+	 */
+	virtual bool Flush()
+	{
+		return true;
+	}
+
+	/**
+	 * @brief 检查点屏障：等待调用前提交的写入完成并持久化，不等待其他线程之后提交的写入
+	 * @return 屏障前的写入没有失败返回 true
+	 * @note 默认实现等待全部写入（Flush）
+	 */
+	virtual bool Barrier()
+	{
+		return Flush();
+	}
+};
+
+/**
+ * @brief 本地文件系统输出
+ *
+ * bAsync 为 true 时由 AsyncFileWriter 的I/O线程池写入（目录延迟创建），
+ * 否则在调用线程同步写入。
+ */
+class LocalFileSink : public IOutputSink
+{
+public:
+	using IOutputSink::Write;
+
+	explicit LocalFileSink(bool bAsync = true, const AsyncWriteSettings& settings = AsyncWriteSettings());
+
+	bool Write(const std::string& strPath, std::string&& data) override;
+	bool MakeDirs(const std::string& strPath) override;
+	bool Flush() override;
+
+	// 同步模式下写入已在调用线程完成，直接返回
+	bool Barrier() override;
+
+private:
+	// 异步写入器，同步模式下为空
+	std::unique_ptr<AsyncFileWriter> async_writer;
+};
+
+/**
+ * @brief 3TZ归档输出（路径作为归档内条目名，归档由调用方 Open/Close）
+ */
+class ArchiveSink : public IOutputSink
+{
+public:
+	explicit ArchiveSink(TileArchiveWriter& writer) : archive(writer) {}
+
+	bool Write(const std::string& strPath, std::string&& data) override;
+	bool Write(const std::string& strPath, const char* pData, size_t nSize) override;
+
+private:
+	TileArchiveWriter& archive;
+};
+
+#ifdef ENABLE_MINIO
+/**
+ * @brief MinIO对象存储输出（上传器由调用方创建）
+ */
+class MinioSink : public IOutputSink
+{
+public:
+	using IOutputSink::Write;
+
+	explicit MinioSink(MinioUploader& uploader) : minio(uploader) {}
+
+	bool Write(const std::string& strPath, std::string&& data) override;
+	bool WriteEncoded(const std::string& strPath, std::string&& data, const std::string& strContentEncoding) override;
+	bool Flush() override;
+	bool Barrier() override;
+
+private:
+	MinioUploader& minio;
+};
+#endif
+
+/**
+ * @brief 预压缩输出方式
+ */
+enum class PrecompressMode
+{
+	// 保留原文件，另外生成 .gz / .br 旁路文件（适合 nginx gzip_static/brotli_static 等）
+	Variants,
+
+	// 只保存压缩数据并标记 Content-Encoding（适合对象存储 + CDN）
+	EncodedOnly
+};
+
+/**
+ * @brief 预压缩配置
+ */
+struct PrecompressSettings
+{
+	PrecompressMode eMode = PrecompressMode::Variants;
+
+	// 生成 gzip / brotli（未编译对应库时自动忽略）
+	bool bGzip = true;
+	bool bBrotli = true;
+
+	// 是否压缩瓦片数据（.b3dm/.glb/.i3dm/.pnts/.cmpt），JSON 总是压缩
+	bool bCompressTiles = true;
+
+	// 小于该大小的文件不压缩
+	size_t nMinSizeBytes = 1024;
+
+	// 压缩后与原始大小之比超过该值视为不可压缩（如已Draco/KTX2压缩的瓦片），保留原文件
+	double dMaxRatio = 0.9;
+
+	int nGzipLevel = 9;
+	int nBrotliQuality = 9;
+};
+
+/**
+ * @brief 预压缩输出：在转换线程中压缩后交给下游输出目标
+ *
+ * 压缩发生在调用 Write 的转换线程上，随转换并行进行，服务端无需再压缩。
+ * 下游目标的生命周期须覆盖本对象。
+ */
+class PrecompressSink : public IOutputSink
+{
+public:
+	using IOutputSink::Write;
+
+	PrecompressSink(IOutputSink& inner, const PrecompressSettings& settings = PrecompressSettings());
+
+	bool Write(const std::string& strPath, std::string&& data) override;
+	bool MakeDirs(const std::string& strPath) override;
+	bool Flush() override;
+	bool Barrier() override;
+
+	// 生成的压缩对象数
+	size_t GetCompressedCount() const { return compressed_count.load(); }
+
+	// 原始字节数与压缩后字节数（仅统计已压缩的文件，用于估算节省量）
+	size_t GetOriginalBytes() const { return original_bytes.load(); }
+	size_t GetCompressedBytes() const { return compressed_bytes.load(); }
+
+private:
+	// 是否需要压缩该文件
+	bool ShouldCompress(const std::string& strPath, size_t nSize, bool& bText) const;
+
+	IOutputSink& downstream;
+	PrecompressSettings settings;
+
+	std::atomic<size_t> compressed_count{ 0 };
+	std::atomic<size_t> original_bytes{ 0 };
+	std::atomic<size_t> compressed_bytes{ 0 };
+};
+
+/**
+ * @brief 内存输出：把所有文件保存在内存中，供测试或调用方直接取用
+ */
+class MemorySink : public IOutputSink
+{
+public:
+	using IOutputSink::Write;
+
+	bool Write(const std::string& strPath, std::string&& data) override;
+
+	/**
+	 * @brief 获取文件内容
+	 * @return 文件存在返回 true
+	 */
+	bool Get(const std::string& strPath, std::string& out) const;
+
+	/**
+	 * @brief 获取文件内容（SWIG友好）
+	 * @return 文件内容，不存在返回空数组
+	 */
+	std::vector<uint8_t> GetData(const std::string& strPath) const;
+
+	/**
+	 * @brief 已写入的文件路径（按字典序）
+	 */
+	std::vector<std::string> GetPaths() const;
+
+	// 文件数
+	size_t GetFileCount() const;
+
+	// 总字节数
+	size_t GetTotalBytes() const;
+
+	// 清空
+	void Clear();
+
+private:
+	// 路径使用 '/' 分隔
+	std::map<std::string, std::string> files;
+	mutable std::mutex files_mutex;
+};
+
+/**
+ * @brief 空输出：丢弃所有数据，只做计数，用于测量纯转换性能
+ */
+class NullSink : public IOutputSink
+{
+public:
+	bool Write(const std::string& strPath, std::string&& data) override;
+	bool Write(const std::string& strPath, const char* pData, size_t nSize) override;
+
+	// 文件数
+	size_t GetFileCount() const { return file_count.load(); }
+
+	// 总字节数
+	size_t GetTotalBytes() const { return total_bytes.load(); }
+
+private:
+	std::atomic<size_t> file_count{ 0 };
+	std::atomic<size_t> total_bytes{ 0 };
+};
+
+#endif // OUTPUT_SINK_H
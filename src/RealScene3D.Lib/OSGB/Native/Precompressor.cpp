@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cctype>
+
+#ifdef ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef ENABLE_BROTLI
+#include <brotli/encode.h>
+#endif
+
+#include "Precompressor.h"
+
+#ifdef ENABLE_ZLIB
+bool Precompressor::Gzip(const char* pData, size_t nSize, std::string& out, int nLevel)
+{
+	z_stream zs = {};
+
+	// windowBits 加 16 输出 gzip 格式（而不是 zlib 格式）
+	if (deflateInit2(&zs, std::clamp(nLevel, 1, 9), Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+	{
+		return false;
+	}
+
+	out.resize(deflateBound(&zs, static_cast<uLong>(nSize)));
+	zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(pData));
+	zs.avail_in = static_cast<uInt>(nSize);
+	zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+	zs.avail_out = static_cast<uInt>(out.size());
+
+	int ret = deflate(&zs, Z_FINISH);
+	out.resize(zs.total_out);
+	deflateEnd(&zs);
+
+	return ret == Z_STREAM_END;
+}
+#else
+bool Precompressor::Gzip(const char* /*pData*/, size_t /*nSize*/, std::string& /*out*/, int /*nLevel*/)
+{
+	return false;
+}
+#endif
+
+#ifdef ENABLE_BROTLI
+bool Precompressor::Brotli(const char* pData, size_t nSize, std::string& out, int nQuality, bool bText)
+{
+	size_t nOutSize = BrotliEncoderMaxCompressedSize(nSize);
+	if (nOutSize == 0)
+	{
+		return false;
+	}
+
+	out.resize(nOutSize);
+	BROTLI_BOOL ok = BrotliEncoderCompress(
+		std::clamp(nQuality, BROTLI_MIN_QUALITY, BROTLI_MAX_QUALITY),
+		BROTLI_DEFAULT_WINDOW,
+		bText ? BROTLI_MODE_TEXT : BROTLI_MODE_GENERIC,
+		nSize,
+		reinterpret_cast<const uint8_t*>(pData),
+		&nOutSize,
+		reinterpret_cast<uint8_t*>(&out[0]));
+
+	out.resize(ok ? nOutSize : 0);
+
+	return ok == BROTLI_TRUE;
+}
+#else
+bool Precompressor::Brotli(const char* /*pData*/, size_t /*nSize*/, std::string& /*out*/, int /*nQuality*/, bool /*bText*/)
+{
+	return false;
+}
+#endif
+
+bool Precompressor::IsGzipAvailable()
+{
+#ifdef ENABLE_ZLIB
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool Precompressor::IsBrotliAvailable()
+{
+#ifdef ENABLE_BROTLI
+	return true;
+#else
+	return false;
+#endif
+}
+
+std::string Precompressor::ExtensionFor(const std::string& strEncoding)
+{
+	if (strEncoding == kEncodingGzip)
+	{
+		return ".gz";
+	}
+
+	if (strEncoding == kEncodingBrotli)
+	{
+		return ".br";
+	}
+
+	return "";
+}
+
+std::string Precompressor::ContentTypeFor(const std::string& strPath)
+{
+	std::string ext;
+	size_t nDot = strPath.find_last_of('.');
+	if (nDot != std::string::npos)
+	{
+		ext = strPath.substr(nDot);
+		std::transform(ext.begin(), ext.end(), ext.begin(),
+			[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	}
+
+	if (ext == ".json")
+	{
+		return "application/json";
+	}
+
+	if (ext == ".glb")
+	{
+		return "model/gltf-binary";
+	}
+
+	return "application/octet-stream";
+}
@@ -0,0 +1,59 @@
+#ifndef PRECOMPRESSOR_H
+#define PRECOMPRESSOR_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief 预压缩工具类
+ *
+ * 在转换阶段生成 gzip / brotli 压缩数据，服务端按 Accept-Encoding 直接返回，
+ * 不再在每次请求时压缩。gzip 依赖 zlib（ENABLE_ZLIB），brotli 依赖 libbrotlienc（ENABLE_BROTLI），
+ * 未启用时对应函数返回 false。
+ */
+class Precompressor
+{
+public:
+	// HTTP Content-Encoding 取值
+	static constexpr const char* kEncodingGzip = "gzip";
+	static constexpr const char* kEncodingBrotli = "br";
+
+	/**
+	 * @brief gzip 压缩
+	 * @param pData 输入数据
+	 * @param nSize 输入大小
+	 * @param out 输出的 gzip 数据（含 gzip 头和尾）
+	 * @param nLevel 压缩级别 1-9
+	 * @return 是否成功
+	 */
+	static bool Gzip(const char* pData, size_t nSize, std::string& out, int nLevel = 9);
+
+	/**
+	 * @brief brotli 压缩
+	 * @param pData 输入数据
+	 * @param nSize 输入大小
+	 * @param out 输出的 brotli 数据
+	 * @param nQuality 压缩质量 0-11
+	 * @param bText 输入是否为文本（JSON），影响编码模式
+	 * @return 是否成功
+	 */
+	static bool Brotli(const char* pData, size_t nSize, std::string& out, int nQuality = 11, bool bText = false);
+
+	// 是否编译了 gzip 支持
+	static bool IsGzipAvailable();
+
+	// 是否编译了 brotli 支持
+	static bool IsBrotliAvailable();
+
+	/**
+	 * @brief 编码对应的文件扩展名（".gz" / ".br"）
+	 */
+	static std::string ExtensionFor(const std::string& strEncoding);
+
+	/**
+	 * @brief 根据路径扩展名推断 Content-Type
+	 */
+	static std::string ContentTypeFor(const std::string& strPath);
+};
+
+#endif // PRECOMPRESSOR_H
@@ -0,0 +1,95 @@
+#include <algorithm>
+
+#include "SubsetFilter.h"
+
+// ============================================================================
+// 内部辅助函数（仅在本文件内使用）
+// ============================================================================
+
+namespace
+{
+	/**
+	 * @brief 点到线段距离的平方
+	 */
+	double SegmentDistanceSquared(double px, double py, double ax, double ay, double bx, double by)
+	{
+		double dx = bx - ax;
+		double dy = by - ay;
+		double len2 = dx * dx + dy * dy;
+
+		double t = len2 > 0.0 ? ((px - ax) * dx + (py - ay) * dy) / len2 : 0.0;
+		t = std::clamp(t, 0.0, 1.0);
+
+		double cx = ax + t * dx - px;
+		double cy = ay + t * dy - py;
+
+		return cx * cx + cy * cy;
+	}
+
+} // anonymous namespace
+
+SubsetFilter::SubsetFilter(const SubsetSettings& settings, double dOriginX, double dOriginY)
+	: min_level(settings.nMinLevel)
+	, max_level(settings.nMaxLevel)
+{
+	size_t count = settings.vecRegion.size() / 2;
+	if (count < 3)
+	{
+		return;
+	}
+
+	polygon.reserve(count * 2);
+	for (size_t i = 0; i < count; i++)
+	{
+		double x = settings.vecRegion[i * 2] - dOriginX;
+		double y = settings.vecRegion[i * 2 + 1] - dOriginY;
+		polygon.emplace_back(x);
+		polygon.emplace_back(y);
+
+		min_x = i == 0 ? x : std::min(min_x, x);
+		min_y = i == 0 ? y : std::min(min_y, y);
+		max_x = i == 0 ? x : std::max(max_x, x);
+		max_y = i == 0 ? y : std::max(max_y, y);
+	}
+}
+
+std::vector<double> SubsetFilter::BoxRegion(double dMinX, double dMinY, double dMaxX, double dMaxY)
+{
+	return { dMinX, dMinY, dMaxX, dMinY, dMaxX, dMaxY, dMinX, dMaxY };
+}
+
+bool SubsetFilter::IntersectsSphere(double dX, double dY, double dRadius) const
+{
+	if (polygon.empty())
+	{
+		return true;
+	}
+
+	// 外包矩形快速排除
+	if (dX + dRadius < min_x || dX - dRadius > max_x || dY + dRadius < min_y || dY - dRadius > max_y)
+	{
+		return false;
+	}
+
+	// 圆心在多边形内（射线法），或圆与任一条边相交（含多边形整体在圆内）
+	size_t count = polygon.size() / 2;
+	bool inside = false;
+	double r2 = dRadius * dRadius;
+	for (size_t i = 0, j = count - 1; i < count; j = i++)
+	{
+		double xi = polygon[i * 2], yi = polygon[i * 2 + 1];
+		double xj = polygon[j * 2], yj = polygon[j * 2 + 1];
+
+		if (SegmentDistanceSquared(dX, dY, xi, yi, xj, yj) <= r2)
+		{
+			return true;
+		}
+
+		if ((yi > dY) != (yj > dY) && dX < (xj - xi) * (dY - yi) / (yj - yi) + xi)
+		{
+			inside = !inside;
+		}
+	}
+
+	return inside;
+}
@@ -0,0 +1,90 @@
+#ifndef SUBSET_FILTER_H
+#define SUBSET_FILTER_H
+
+#include <vector>
+
+/**
+ * @brief 转换子集配置（区域与层级范围）
+ */
+struct SubsetSettings
+{
+	// 区域多边形顶点（数据集坐标系的平面坐标，依次为 x0, y0, x1, y1, ...），少于3个顶点表示不限制区域
+	std::vector<double> vecRegion;
+
+	// 最低层级（含，按文件名中的 _L 层级），-1 表示不限制
+	int nMinLevel = -1;
+
+	// 最高层级（含），-1 表示不限制；与转换接口的 nMaxLevel 同时设置时取较小者
+	int nMaxLevel = -1;
+};
+
+/**
+ * @brief 转换子集过滤器
+ *
+ * 在读取节点树时使用：PagedLOD 子节点的包围球与区域在平面上不相交、或层级超过上限时，
+ * 该子节点文件及其所有下级文件都不会被读取；层级低于下限的节点只读取以获得子节点列表，不生成 B3DM。
+ * 无法从文件名识别层级（如瓦片根文件）的节点不按层级过滤。
+ *
+ * @example
+ * SubsetSettings settings;
+ * settings.vecRegion = SubsetFilter::BoxRegion(500100.0, 3500200.0, 500900.0, 3500800.0);
+ * settings.nMaxLevel = 18;
+ * SubsetFilter filter(settings, dSrsOriginX, dSrsOriginY);
+ */
+class SubsetFilter
+{
+public:
+	SubsetFilter() = default;
+
+	/**
+	 * @param settings 子集配置
+	 * @param dOriginX 节点本地坐标到数据集坐标系的X平移（metadata.xml 的 SRSOrigin）
+	 * @param dOriginY 节点本地坐标到数据集坐标系的Y平移
+	 */
+	SubsetFilter(const SubsetSettings& settings, double dOriginX = 0.0, double dOriginY = 0.0);
+
+	/**
+	 * @brief 由矩形范围生成区域多边形
+	 */
+	static std::vector<double> BoxRegion(double dMinX, double dMinY, double dMaxX, double dMaxY);
+
+	/**
+	 * @brief 是否限制了区域
+	 */
+	bool HasRegion() const { return !polygon.empty(); }
+
+	/**
+	 * @brief 是否设置了任何过滤条件
+	 */
+	bool IsActive() const { return HasRegion() || min_level != -1 || max_level != -1; }
+
+	/**
+	 * @brief 包围球（节点本地坐标）与区域在平面上是否相交，未限制区域时总是相交
+	 */
+	bool IntersectsSphere(double dX, double dY, double dRadius) const;
+
+	/**
+	 * @brief 层级是否超过上限（超过的文件不读取）
+	 */
+	bool IsAboveMaxLevel(int nLevel) const { return max_level != -1 && nLevel != -1 && nLevel > max_level; }
+
+	/**
+	 * @brief 层级是否低于下限（低于的节点不生成内容）
+	 */
+	bool IsBelowMinLevel(int nLevel) const { return min_level != -1 && nLevel != -1 && nLevel < min_level; }
+
+private:
+	// 区域多边形顶点（节点本地坐标）
+	std::vector<double> polygon;
+
+	// 区域外包矩形（节点本地坐标）
+	double min_x = 0.0;
+	double min_y = 0.0;
+	double max_x = 0.0;
+	double max_y = 0.0;
+
+	int min_level = -1;
+	int max_level = -1;
+};
+
+#endif // SUBSET_FILTER_H
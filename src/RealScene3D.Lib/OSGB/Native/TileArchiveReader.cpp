@@ -0,0 +1,465 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#ifdef ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "TileArchiveReader.h"
+#include "TileArchiveWriter.h"
+#include "OSGBTools.h"
+
+using namespace OSGBLog;
+
+// ============================================================================
+// 内部辅助函数（仅在本文件内使用）
+// ============================================================================
+
+namespace
+{
+	const uint32_t kLocalHeaderSig = 0x04034b50;
+	const uint32_t kCentralHeaderSig = 0x02014b50;
+	const uint32_t kZip64EndSig = 0x06064b50;
+	const uint32_t kZip64LocatorSig = 0x07064b50;
+	const uint32_t kEndSig = 0x06054b50;
+
+	const uint64_t kMax32 = 0xFFFFFFFFull;
+	const uint64_t kMax16 = 0xFFFFull;
+
+	// 结束记录固定长度与最大注释长度
+	const size_t kEndRecordSize = 22;
+	const size_t kMaxCommentSize = 0xFFFF;
+
+	uint16_t Get16(const uint8_t* p)
+	{
+		return static_cast<uint16_t>(p[0] | (p[1] << 8));
+	}
+
+	uint32_t Get32(const uint8_t* p)
+	{
+		return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+			(static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+	}
+
+	uint64_t Get64(const uint8_t* p)
+	{
+		return static_cast<uint64_t>(Get32(p)) | (static_cast<uint64_t>(Get32(p + 4)) << 32);
+	}
+
+} // anonymous namespace
+
+TileArchiveReader::~TileArchiveReader()
+{
+	Close();
+}
+
+bool TileArchiveReader::Open(const std::string& strArchivePath)
+{
+	Close();
+
+	if (!MapFile(strArchivePath))
+	{
+		LOG_E("无法映射归档文件: {}", strArchivePath);
+		return false;
+	}
+
+	if (!ParseCentralDirectory())
+	{
+		LOG_E("归档格式无效: {}", strArchivePath);
+		Close();
+		return false;
+	}
+
+	LOG_I("已打开归档: {} ({} 个条目, {} 字节)", strArchivePath, entries.size(), mapped_size);
+
+	return true;
+}
+
+void TileArchiveReader::Close()
+{
+	entries.clear();
+	UnmapFile();
+}
+
+bool TileArchiveReader::MapFile(const std::string& strArchivePath)
+{
+#ifdef _WIN32
+	std::wstring wpath = std::filesystem::u8path(strArchivePath).wstring();
+	HANDLE hFile = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(hFile, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+
+	HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (hMapping == nullptr)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+
+	void* pView = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (pView == nullptr)
+	{
+		CloseHandle(hMapping);
+		CloseHandle(hFile);
+		return false;
+	}
+
+	file_handle = hFile;
+	mapping_handle = hMapping;
+	mapped_data = static_cast<const uint8_t*>(pView);
+	mapped_size = static_cast<size_t>(size.QuadPart);
+#else
+	int fd = ::open(strArchivePath.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat st;
+	if (::fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		::close(fd);
+		return false;
+	}
+
+	void* pView = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (pView == MAP_FAILED)
+	{
+		return false;
+	}
+
+	// 瓦片访问是随机的，关闭预读
+	::madvise(pView, static_cast<size_t>(st.st_size), MADV_RANDOM);
+
+	mapped_data = static_cast<const uint8_t*>(pView);
+	mapped_size = static_cast<size_t>(st.st_size);
+#endif
+
+	return true;
+}
+
+void TileArchiveReader::UnmapFile()
+{
+	if (mapped_data == nullptr)
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(mapped_data);
+	CloseHandle(static_cast<HANDLE>(mapping_handle));
+	CloseHandle(static_cast<HANDLE>(file_handle));
+	mapping_handle = nullptr;
+	file_handle = nullptr;
+#else
+	::munmap(const_cast<uint8_t*>(mapped_data), mapped_size);
+#endif
+
+	mapped_data = nullptr;
+	mapped_size = 0;
+}
+
+bool TileArchiveReader::ParseCentralDirectory()
+{
+	if (mapped_size < kEndRecordSize)
+	{
+		return false;
+	}
+
+	// 1. 从文件尾部向前查找结束记录（可能带注释）
+	const size_t nSearchStart = mapped_size > kEndRecordSize + kMaxCommentSize ?
+		mapped_size - kEndRecordSize - kMaxCommentSize : 0;
+	size_t nEndPos = std::string::npos;
+	for (size_t pos = mapped_size - kEndRecordSize + 1; pos-- > nSearchStart;)
+	{
+		if (Get32(mapped_data + pos) == kEndSig)
+		{
+			nEndPos = pos;
+			break;
+		}
+	}
+
+	if (nEndPos == std::string::npos)
+	{
+		return false;
+	}
+
+	const uint8_t* pEnd = mapped_data + nEndPos;
+	uint64_t nEntries = Get16(pEnd + 10);
+	uint64_t nCentralSize = Get32(pEnd + 12);
+	uint64_t nCentralOffset = Get32(pEnd + 16);
+
+	// 2. ZIP64：结束记录之前是 ZIP64 定位记录
+	if ((nEntries == kMax16 || nCentralSize == kMax32 || nCentralOffset == kMax32) && nEndPos >= 20)
+	{
+		const uint8_t* pLocator = pEnd - 20;
+		if (Get32(pLocator) == kZip64LocatorSig)
+		{
+			uint64_t nZip64EndPos = Get64(pLocator + 8);
+			if (nZip64EndPos > mapped_size || mapped_size - nZip64EndPos < 56 ||
+				Get32(mapped_data + nZip64EndPos) != kZip64EndSig)
+			{
+				return false;
+			}
+
+			const uint8_t* pZip64End = mapped_data + nZip64EndPos;
+			nEntries = Get64(pZip64End + 32);
+			nCentralSize = Get64(pZip64End + 40);
+			nCentralOffset = Get64(pZip64End + 48);
+		}
+	}
+
+	// 各字段来自文件内容，比较前避免加法溢出
+	if (nCentralOffset > mapped_size || nCentralSize > mapped_size - nCentralOffset)
+	{
+		return false;
+	}
+
+	// 3. 遍历中央目录，路径载入哈希表（每个条目至少 46 字节，条目数按中央目录大小截断后再预留）
+	entries.reserve(static_cast<size_t>(std::min<uint64_t>(nEntries, nCentralSize / 46)));
+
+	const uint8_t* p = mapped_data + nCentralOffset;
+	const uint8_t* pCentralEnd = p + nCentralSize;
+	for (uint64_t i = 0; i < nEntries; ++i)
+	{
+		if (p + 46 > pCentralEnd || Get32(p) != kCentralHeaderSig)
+		{
+			return false;
+		}
+
+		EntryRecord record;
+		record.method = Get16(p + 10);
+		record.crc32 = Get32(p + 16);
+		record.compressed_size = Get32(p + 20);
+		record.uncompressed_size = Get32(p + 24);
+		const uint16_t nNameLen = Get16(p + 28);
+		const uint16_t nExtraLen = Get16(p + 30);
+		const uint16_t nCommentLen = Get16(p + 32);
+		record.local_header_offset = Get32(p + 42);
+
+		const uint8_t* pName = p + 46;
+		const uint8_t* pExtra = pName + nNameLen;
+		if (pExtra + nExtraLen + nCommentLen > pCentralEnd)
+		{
+			return false;
+		}
+
+		// ZIP64 扩展字段：按顺序仅包含值为 0xFFFFFFFF 的字段
+		for (const uint8_t* q = pExtra; q + 4 <= pExtra + nExtraLen;)
+		{
+			const uint16_t nTag = Get16(q);
+			const uint16_t nLen = Get16(q + 2);
+			if (nTag == 0x0001)
+			{
+				const uint8_t* v = q + 4;
+				const uint8_t* vEnd = v + nLen;
+				if (record.uncompressed_size == kMax32 && v + 8 <= vEnd)
+				{
+					record.uncompressed_size = Get64(v);
+					v += 8;
+				}
+				if (record.compressed_size == kMax32 && v + 8 <= vEnd)
+				{
+					record.compressed_size = Get64(v);
+					v += 8;
+				}
+				if (record.local_header_offset == kMax32 && v + 8 <= vEnd)
+				{
+					record.local_header_offset = Get64(v);
+				}
+				break;
+			}
+			q += 4 + nLen;
+		}
+
+		std::string name(reinterpret_cast<const char*>(pName), nNameLen);
+		if (name != TileArchiveWriter::kIndexEntryName && (name.empty() || name.back() != '/'))
+		{
+			entries[std::move(name)] = record;
+		}
+
+		p = pExtra + nExtraLen + nCommentLen;
+	}
+
+	return true;
+}
+
+bool TileArchiveReader::Contains(const std::string& strPath) const
+{
+	return entries.count(TileArchiveWriter::NormalizePath(strPath)) > 0;
+}
+
+bool TileArchiveReader::Find(const std::string& strPath, TileArchiveSpan& span) const
+{
+	auto it = entries.find(TileArchiveWriter::NormalizePath(strPath));
+	if (it == entries.end())
+	{
+		return false;
+	}
+
+	// 数据起点由本地文件头决定（本地扩展字段长度可能与中央目录不同）
+	const EntryRecord& record = it->second;
+	if (record.local_header_offset > mapped_size || mapped_size - record.local_header_offset < 30)
+	{
+		return false;
+	}
+
+	const uint8_t* pLocal = mapped_data + record.local_header_offset;
+	if (Get32(pLocal) != kLocalHeaderSig)
+	{
+		return false;
+	}
+
+	const uint64_t nDataOffset = record.local_header_offset + 30 + Get16(pLocal + 26) + Get16(pLocal + 28);
+	if (nDataOffset > mapped_size || record.compressed_size > mapped_size - nDataOffset)
+	{
+		return false;
+	}
+
+	span.data = mapped_data + nDataOffset;
+	span.size = static_cast<size_t>(record.compressed_size);
+	span.uncompressed_size = static_cast<size_t>(record.uncompressed_size);
+	span.method = record.method;
+	span.crc32 = record.crc32;
+
+	return true;
+}
+
+const void* TileArchiveReader::GetTileData(const std::string& strPath) const
+{
+	TileArchiveSpan span;
+	if (!Find(strPath, span) || span.method != 0)
+	{
+		return nullptr;
+	}
+
+	return span.data;
+}
+
+long long TileArchiveReader::GetTileSize(const std::string& strPath) const
+{
+	TileArchiveSpan span;
+	if (!Find(strPath, span))
+	{
+		return -1;
+	}
+
+	return static_cast<long long>(span.size);
+}
+
+bool TileArchiveReader::ReadEntry(const std::string& strPath, std::string& data) const
+{
+	TileArchiveSpan span;
+	if (!Find(strPath, span))
+	{
+		return false;
+	}
+
+	if (span.method == 0)
+	{
+		data.assign(reinterpret_cast<const char*>(span.data), span.size);
+		return true;
+	}
+
+#ifdef ENABLE_ZLIB
+	if (span.method == 8)
+	{
+		data.resize(span.uncompressed_size);
+		if (span.uncompressed_size == 0)
+		{
+			return true;
+		}
+
+		// ZIP 中为裸 Deflate 流（windowBits 取负值）
+		z_stream zs = {};
+		if (inflateInit2(&zs, -MAX_WBITS) != Z_OK)
+		{
+			return false;
+		}
+
+		zs.next_in = const_cast<Bytef*>(span.data);
+		zs.next_out = reinterpret_cast<Bytef*>(&data[0]);
+
+		// 大于 4GB 的条目分段输入/输出
+		int ret = Z_OK;
+		size_t nInLeft = span.size;
+		size_t nOutLeft = data.size();
+		while (ret == Z_OK)
+		{
+			if (zs.avail_in == 0 && nInLeft > 0)
+			{
+				zs.avail_in = static_cast<uInt>(std::min<size_t>(nInLeft, 0x40000000));
+				nInLeft -= zs.avail_in;
+			}
+			if (zs.avail_out == 0 && nOutLeft > 0)
+			{
+				zs.avail_out = static_cast<uInt>(std::min<size_t>(nOutLeft, 0x40000000));
+				nOutLeft -= zs.avail_out;
+			}
+			ret = inflate(&zs, Z_NO_FLUSH);
+		}
+		inflateEnd(&zs);
+
+		if (ret != Z_STREAM_END || zs.total_out != span.uncompressed_size)
+		{
+			LOG_E("归档条目解压失败: {}", strPath);
+			return false;
+		}
+
+		return true;
+	}
+#endif
+
+	LOG_W("不支持的归档条目压缩方式: {} (method={})", strPath, span.method);
+
+	return false;
+}
+
+std::vector<uint8_t> TileArchiveReader::ReadTile(const std::string& strPath) const
+{
+	std::string data;
+	if (!ReadEntry(strPath, data))
+	{
+		return {};
+	}
+
+	return std::vector<uint8_t>(data.begin(), data.end());
+}
+
+std::vector<std::string> TileArchiveReader::ListEntries() const
+{
+	std::vector<std::string> names;
+	names.reserve(entries.size());
+	for (const auto& item : entries)
+	{
+		names.emplace_back(item.first);
+	}
+
+	std::sort(names.begin(), names.end());
+
+	return names;
+}
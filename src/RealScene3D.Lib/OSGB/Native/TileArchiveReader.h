@@ -0,0 +1,158 @@
+#ifndef TILE_ARCHIVE_READER_H
+#define TILE_ARCHIVE_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 归档条目数据视图（指向内存映射区域，不复制）
+ */
+struct TileArchiveSpan
+{
+	// 条目数据起始地址，Reader 关闭前有效
+	const uint8_t* data = nullptr;
+
+	// 条目数据大小（压缩条目为压缩后大小）
+	size_t size = 0;
+
+	// 解压后大小
+	size_t uncompressed_size = 0;
+
+	// ZIP 压缩方式：0=存储，8=Deflate
+	uint16_t method = 0;
+
+	// 条目 CRC32
+	uint32_t crc32 = 0;
+};
+
+/**
+ * @brief 瓦片归档读取器（3TZ / zip-store）
+ *
+ * Open 时以只读方式内存映射整个归档，解析中央目录（支持 ZIP64）并把条目路径
+ * 载入哈希表；此后 Find 只做一次哈希查找和一次本地文件头读取，返回指向映射区域的
+ * 视图，不产生文件系统调用。Open 之后对象只读，多个线程可同时调用 Find/ReadTile。
+ *
+ * @example
+ * TileArchiveReader reader;
+ * reader.Open("D:/out/city.3tz");
+ * TileArchiveSpan span;
+ * if (reader.Find("Data/Tile_0/Tile_0.b3dm", span) && span.method == 0)
+ * {
+ *     // 直接把 span.data / span.size 写入HTTP响应
+ * }
+ */
+class TileArchiveReader
+{
+public:
+	TileArchiveReader() = default;
+
+	// 析构时解除映射
+	~TileArchiveReader();
+
+	TileArchiveReader(const TileArchiveReader&) = delete;
+	TileArchiveReader& operator=(const TileArchiveReader&) = delete;
+
+	/**
+	 * @brief 打开并映射归档，加载条目索引
+	 * @param strArchivePath 归档文件路径
+	 * @return 是否成功
+	 */
+	bool Open(const std::string& strArchivePath);
+
+	/**
+	 * @brief 解除映射并清空索引（调用前须确保没有线程仍在使用返回的视图）
+	 */
+	void Close();
+
+	/**
+	 * @brief 是否已打开
+	 */
+	bool IsOpen() const { return mapped_data != nullptr; }
+
+	/**
+	 * @brief 条目数量（不含 3TZ 索引条目）
+	 */
+	size_t GetEntryCount() const { return entries.size(); }
+
+	/**
+	 * @brief 是否包含指定条目
+	 */
+	bool Contains(const std::string& strPath) const;
+
+	/**
+	 * @brief 查找条目，返回零拷贝视图
+	 * @param strPath 条目路径（'\\' 与开头的 '/'、"./" 会被规范化）
+	 * @param span 输出的数据视图
+	 * @return 条目存在且本地文件头有效返回 true
+	 */
+	bool Find(const std::string& strPath, TileArchiveSpan& span) const;
+
+	/**
+	 * @brief 获取存储条目的数据地址（供C#以 IntPtr 零拷贝访问）
+	 * @return 条目不存在或为压缩条目时返回 nullptr
+	 */
+	const void* GetTileData(const std::string& strPath) const;
+
+	/**
+	 * @brief 获取条目大小
+	 * @return 条目不存在返回 -1
+	 */
+	long long GetTileSize(const std::string& strPath) const;
+
+	/**
+	 * @brief 读取条目数据（Deflate 条目在调用线程解压，需 ENABLE_ZLIB）
+	 * @param strPath 条目路径
+	 * @param data 输出的条目数据
+	 * @return 条目存在且读取/解压成功返回 true
+	 */
+	bool ReadEntry(const std::string& strPath, std::string& data) const;
+
+	/**
+	 * @brief 复制条目的数据
+	 * @return 条目数据，不存在或无法解压时返回空数组
+	 */
+	std::vector<uint8_t> ReadTile(const std::string& strPath) const;
+
+	/**
+	 * @brief 列出所有条目路径
+	 */
+	std::vector<std::string> ListEntries() const;
+
+private:
+	/**
+	 * @brief 中央目录中的条目记录
+	 */
+	struct EntryRecord
+	{
+		uint64_t local_header_offset = 0;
+		uint64_t compressed_size = 0;
+		uint64_t uncompressed_size = 0;
+		uint16_t method = 0;
+		uint32_t crc32 = 0;
+	};
+
+	// 映射文件
+	bool MapFile(const std::string& strArchivePath);
+
+	// 解除映射
+	void UnmapFile();
+
+	// 解析结束记录与中央目录
+	bool ParseCentralDirectory();
+
+	const uint8_t* mapped_data = nullptr;
+	size_t mapped_size = 0;
+
+#ifdef _WIN32
+	void* file_handle = nullptr;
+	void* mapping_handle = nullptr;
+#endif
+
+	// 条目路径 -> 记录
+	std::unordered_map<std::string, EntryRecord> entries;
+};
+
+#endif // TILE_ARCHIVE_READER_H
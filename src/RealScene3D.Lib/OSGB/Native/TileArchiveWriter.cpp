@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <cstring>
+
+#include "TileArchiveWriter.h"
+#include "OSGBTools.h"
+
+using namespace OSGBLog;
+
+// ============================================================================
+// 内部辅助函数（仅在本文件内使用）
+// ============================================================================
+
+namespace
+{
+	// ZIP 记录签名
+	const uint32_t kLocalHeaderSig = 0x04034b50;
+	const uint32_t kCentralHeaderSig = 0x02014b50;
+	const uint32_t kZip64EndSig = 0x06064b50;
+	const uint32_t kZip64LocatorSig = 0x07064b50;
+	const uint32_t kEndSig = 0x06054b50;
+
+	// 需要 ZIP64 的版本号（4.5）与普通版本号（2.0）
+	const uint16_t kVersionZip64 = 45;
+	const uint16_t kVersionDefault = 20;
+
+	// 通用标志位 11：文件名为 UTF-8
+	const uint16_t kFlagUtf8 = 0x0800;
+
+	// DOS 日期 1980-01-01 00:00:00，保证输出可复现
+	const uint16_t kDosTime = 0;
+	const uint16_t kDosDate = (0 << 9) | (1 << 5) | 1;
+
+	const uint64_t kMax32 = 0xFFFFFFFFull;
+	const uint64_t kMax16 = 0xFFFFull;
+
+	/**
+	 * @brief 小端字节序追加写入缓冲区
+	 */
+	void PutLE(std::string& buf, uint64_t nValue, int nBytes)
+	{
+		for (int i = 0; i < nBytes; ++i)
+		{
+			buf.push_back(static_cast<char>((nValue >> (8 * i)) & 0xFF));
+		}
+	}
+
+	uint64_t ReadLE64(const uint8_t* p)
+	{
+		uint64_t v = 0;
+		for (int i = 7; i >= 0; --i)
+		{
+			v = (v << 8) | p[i];
+		}
+
+		return v;
+	}
+
+} // anonymous namespace
+
+bool TileArchiveIndexEntry::Less(const ContentHash::Md5Digest& a, const ContentHash::Md5Digest& b)
+{
+	const uint64_t aHi = ReadLE64(a.data() + 8);
+	const uint64_t bHi = ReadLE64(b.data() + 8);
+	if (aHi != bHi)
+	{
+		return aHi < bHi;
+	}
+
+	return ReadLE64(a.data()) < ReadLE64(b.data());
+}
+
+TileArchiveWriter::~TileArchiveWriter()
+{
+	if (IsOpen())
+	{
+		Close();
+	}
+}
+
+bool TileArchiveWriter::Open(const std::string& strArchivePath)
+{
+	std::lock_guard<std::mutex> lock(write_mutex);
+
+	ofs.open(strArchivePath, std::ios::binary | std::ios::trunc);
+	if (!ofs.is_open())
+	{
+		LOG_E("无法创建归档文件: {}", strArchivePath);
+		return false;
+	}
+
+	archive_path = strArchivePath;
+	position = 0;
+	entries.clear();
+	entry_lookup.clear();
+	failed = false;
+
+	return true;
+}
+
+std::string TileArchiveWriter::NormalizePath(const std::string& strPath)
+{
+	std::string name = strPath;
+	std::replace(name.begin(), name.end(), '\\', '/');
+
+	size_t nStart = 0;
+	while (nStart < name.size())
+	{
+		if (name[nStart] == '/')
+		{
+			nStart++;
+		}
+		else if (name.compare(nStart, 2, "./") == 0)
+		{
+			nStart += 2;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	return name.substr(nStart);
+}
+
+bool TileArchiveWriter::Append(const std::string& strPath, const char* pData, size_t nSize)
+{
+	const std::string name = NormalizePath(strPath);
+	if (name.empty() || name == kIndexEntryName)
+	{
+		LOG_E("归档条目路径无效: {}", strPath);
+		return false;
+	}
+
+	// CRC 在锁外计算，多个转换线程可以并行
+	const uint32_t nCrc = ContentHash::Crc32(pData, nSize);
+
+	std::lock_guard<std::mutex> lock(write_mutex);
+	if (!ofs.is_open())
+	{
+		return false;
+	}
+
+	if (entry_lookup.count(name) > 0)
+	{
+		LOG_W("归档条目重复写入，索引将指向最新数据: {}", name);
+	}
+
+	return WriteEntry(name, pData, nSize, nCrc);
+}
+
+bool TileArchiveWriter::WriteEntry(const std::string& strName, const char* pData, size_t nSize, uint32_t nCrc)
+{
+	EntryRecord record;
+	record.name = strName;
+	record.crc32 = nCrc;
+	record.size = nSize;
+	record.offset = position;
+
+	const bool bZip64 = nSize >= kMax32;
+
+	std::string header;
+	header.reserve(30 + strName.size() + 20);
+	PutLE(header, kLocalHeaderSig, 4);
+	PutLE(header, bZip64 ? kVersionZip64 : kVersionDefault, 2);
+	PutLE(header, kFlagUtf8, 2);
+	PutLE(header, 0, 2);	// 存储，不压缩
+	PutLE(header, kDosTime, 2);
+	PutLE(header, kDosDate, 2);
+	PutLE(header, nCrc, 4);
+	PutLE(header, bZip64 ? kMax32 : nSize, 4);
+	PutLE(header, bZip64 ? kMax32 : nSize, 4);
+	PutLE(header, strName.size(), 2);
+	PutLE(header, bZip64 ? 20 : 0, 2);
+	header += strName;
+	if (bZip64)
+	{
+		PutLE(header, 0x0001, 2);
+		PutLE(header, 16, 2);
+		PutLE(header, nSize, 8);
+		PutLE(header, nSize, 8);
+	}
+
+	ofs.write(header.data(), static_cast<std::streamsize>(header.size()));
+	ofs.write(pData, static_cast<std::streamsize>(nSize));
+	if (ofs.fail())
+	{
+		LOG_E("写入归档条目失败: {}", strName);
+		failed = true;
+		return false;
+	}
+
+	position += header.size() + nSize;
+	entry_lookup[strName] = entries.size();
+	entries.emplace_back(std::move(record));
+
+	return true;
+}
+
+bool TileArchiveWriter::Close()
+{
+	std::lock_guard<std::mutex> lock(write_mutex);
+	if (!ofs.is_open())
+	{
+		return false;
+	}
+
+	// 1. 生成 3TZ 索引：每个路径只保留最后一次写入的条目
+	std::vector<TileArchiveIndexEntry> index;
+	index.reserve(entry_lookup.size());
+	for (const auto& item : entry_lookup)
+	{
+		TileArchiveIndexEntry entry;
+		entry.hash = ContentHash::Md5(item.first.data(), item.first.size());
+		entry.offset = entries[item.second].offset;
+		index.emplace_back(entry);
+	}
+
+	std::sort(index.begin(), index.end(), [](const TileArchiveIndexEntry& a, const TileArchiveIndexEntry& b)
+	{
+		return TileArchiveIndexEntry::Less(a.hash, b.hash);
+	});
+
+	std::string index_buf;
+	index_buf.reserve(index.size() * 24);
+	for (const auto& entry : index)
+	{
+		index_buf.append(reinterpret_cast<const char*>(entry.hash.data()), entry.hash.size());
+		PutLE(index_buf, entry.offset, 8);
+	}
+
+	// 索引必须是归档中的最后一个条目
+	const uint32_t nIndexCrc = ContentHash::Crc32(index_buf.data(), index_buf.size());
+	WriteEntry(kIndexEntryName, index_buf.data(), index_buf.size(), nIndexCrc);
+
+	// 2. 中央目录与结束记录
+	if (!WriteCentralDirectory())
+	{
+		failed = true;
+	}
+
+	ofs.close();
+	if (failed)
+	{
+		LOG_E("归档写入失败: {}", archive_path);
+		return false;
+	}
+
+	LOG_I("归档写入完成: {} ({} 个条目, {} 字节)", archive_path, entries.size() - 1, position);
+
+	return true;
+}
+
+bool TileArchiveWriter::WriteCentralDirectory()
+{
+	const uint64_t nCentralOffset = position;
+
+	std::string central;
+	central.reserve(entries.size() * 80);
+	for (const auto& entry : entries)
+	{
+		// ZIP64 扩展字段只包含超出32位的字段，顺序为：原始大小、压缩大小、本地头偏移
+		std::string extra;
+		if (entry.size >= kMax32)
+		{
+			PutLE(extra, entry.size, 8);
+			PutLE(extra, entry.size, 8);
+		}
+		if (entry.offset >= kMax32)
+		{
+			PutLE(extra, entry.offset, 8);
+		}
+
+		std::string zip64_field;
+		if (!extra.empty())
+		{
+			PutLE(zip64_field, 0x0001, 2);
+			PutLE(zip64_field, extra.size(), 2);
+			zip64_field += extra;
+		}
+
+		const uint16_t nVersion = zip64_field.empty() ? kVersionDefault : kVersionZip64;
+		PutLE(central, kCentralHeaderSig, 4);
+		PutLE(central, nVersion, 2);	// version made by
+		PutLE(central, nVersion, 2);	// version needed
+		PutLE(central, kFlagUtf8, 2);
+		PutLE(central, 0, 2);
+		PutLE(central, kDosTime, 2);
+		PutLE(central, kDosDate, 2);
+		PutLE(central, entry.crc32, 4);
+		PutLE(central, std::min(entry.size, kMax32), 4);
+		PutLE(central, std::min(entry.size, kMax32), 4);
+		PutLE(central, entry.name.size(), 2);
+		PutLE(central, zip64_field.size(), 2);
+		PutLE(central, 0, 2);	// 注释长度
+		PutLE(central, 0, 2);	// 起始磁盘号
+		PutLE(central, 0, 2);	// 内部属性
+		PutLE(central, 0, 4);	// 外部属性
+		PutLE(central, std::min(entry.offset, kMax32), 4);
+		central += entry.name;
+		central += zip64_field;
+	}
+
+	const uint64_t nCentralSize = central.size();
+	const uint64_t nEntries = entries.size();
+	const bool bZip64 = nEntries >= kMax16 || nCentralOffset >= kMax32 || nCentralSize >= kMax32;
+
+	std::string tail;
+	if (bZip64)
+	{
+		const uint64_t nZip64EndOffset = nCentralOffset + nCentralSize;
+
+		PutLE(tail, kZip64EndSig, 4);
+		PutLE(tail, 44, 8);	// 记录剩余长度
+		PutLE(tail, kVersionZip64, 2);
+		PutLE(tail, kVersionZip64, 2);
+		PutLE(tail, 0, 4);
+		PutLE(tail, 0, 4);
+		PutLE(tail, nEntries, 8);
+		PutLE(tail, nEntries, 8);
+		PutLE(tail, nCentralSize, 8);
+		PutLE(tail, nCentralOffset, 8);
+
+		PutLE(tail, kZip64LocatorSig, 4);
+		PutLE(tail, 0, 4);
+		PutLE(tail, nZip64EndOffset, 8);
+		PutLE(tail, 1, 4);
+	}
+
+	PutLE(tail, kEndSig, 4);
+	PutLE(tail, 0, 2);
+	PutLE(tail, 0, 2);
+	PutLE(tail, std::min(nEntries, kMax16), 2);
+	PutLE(tail, std::min(nEntries, kMax16), 2);
+	PutLE(tail, std::min(nCentralSize, kMax32), 4);
+	PutLE(tail, std::min(nCentralOffset, kMax32), 4);
+	PutLE(tail, 0, 2);
+
+	ofs.write(central.data(), static_cast<std::streamsize>(central.size()));
+	ofs.write(tail.data(), static_cast<std::streamsize>(tail.size()));
+	position += central.size() + tail.size();
+
+	return !ofs.fail();
+}
+
+size_t TileArchiveWriter::GetEntryCount() const
+{
+	std::lock_guard<std::mutex> lock(write_mutex);
+	return entries.size();
+}
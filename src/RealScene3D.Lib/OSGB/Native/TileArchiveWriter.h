@@ -0,0 +1,127 @@
+#ifndef TILE_ARCHIVE_WRITER_H
+#define TILE_ARCHIVE_WRITER_H
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ContentHash.h"
+
+/**
+ * @brief 3TZ归档索引条目（24字节：路径MD5 + 本地文件头偏移）
+ */
+struct TileArchiveIndexEntry
+{
+	// 条目路径的MD5摘要
+	ContentHash::Md5Digest hash;
+
+	// 条目本地文件头在归档中的偏移
+	uint64_t offset = 0;
+
+	// 索引排序规则：把MD5视为两个小端 uint64，先比较高8字节再比较低8字节
+	static bool Less(const ContentHash::Md5Digest& a, const ContentHash::Md5Digest& b);
+};
+
+/**
+ * @brief 瓦片归档写入器（3TZ格式）
+ *
+ * 把所有瓦片写入单个 ZIP 文件（仅存储，不压缩），末尾追加 3TZ 规范的
+ * "@3dtilesIndex1@" 索引条目：按路径MD5排序的 {md5, 本地文件头偏移} 数组，
+ * 读取端二分查找即可定位瓦片。条目数或偏移超出32位时自动使用 ZIP64。
+ * 普通 zip 工具与支持 3TZ 的客户端（如 CesiumJS、Cesium ion）都能直接读取。
+ *
+ * 写入在互斥锁内顺序追加，CRC32 在锁外计算；文件时间固定为 1980-01-01，
+ * 相同输入产生相同的归档。
+ *
+ * @example
+ * TileArchiveWriter archive;
+ * archive.Open("D:/out/city.3tz");
+ * archive.Append("Data/Tile_0/Tile_0.b3dm", b3dm_buf.data(), b3dm_buf.size());
+ * archive.Append("tileset.json", json.data(), json.size());
+ * bool ok = archive.Close();  // 写入索引和中央目录
+ */
+class TileArchiveWriter
+{
+public:
+	// 3TZ 索引条目名
+	static constexpr const char* kIndexEntryName = "@3dtilesIndex1@";
+
+	TileArchiveWriter() = default;
+
+	// 析构时未关闭的归档会自动 Close
+	~TileArchiveWriter();
+
+	TileArchiveWriter(const TileArchiveWriter&) = delete;
+	TileArchiveWriter& operator=(const TileArchiveWriter&) = delete;
+
+	/**
+	 * @brief 创建归档文件（已存在时覆盖）
+	 */
+	bool Open(const std::string& strArchivePath);
+
+	/**
+	 * @brief 是否处于打开状态
+	 */
+	bool IsOpen() const { return ofs.is_open(); }
+
+	/**
+	 * @brief 追加一个条目
+	 * @param strPath 条目路径（'\\' 会被替换为 '/'，去除开头的 '/' 和 "./"）
+	 * @param pData 数据指针
+	 * @param nSize 数据大小
+	 * @return 是否写入成功
+	 * @note 线程安全；同一路径重复写入时索引指向最后一次写入的数据
+	 */
+	bool Append(const std::string& strPath, const char* pData, size_t nSize);
+
+	/**
+	 * @brief 写入索引、中央目录和结束记录并关闭文件
+	 * @return 所有条目及尾部结构都写入成功返回 true
+	 */
+	bool Close();
+
+	// 已写入的条目数（Close 后包含索引条目）
+	size_t GetEntryCount() const;
+
+	/**
+	 * @brief 规范化条目路径
+	 */
+	static std::string NormalizePath(const std::string& strPath);
+
+private:
+	/**
+	 * @brief 已写入条目（用于生成中央目录）
+	 */
+	struct EntryRecord
+	{
+		std::string name;
+		uint32_t crc32 = 0;
+		uint64_t size = 0;
+		uint64_t offset = 0;
+	};
+
+	// 写入本地文件头与数据（调用方持有锁）
+	bool WriteEntry(const std::string& strName, const char* pData, size_t nSize, uint32_t nCrc);
+
+	// 写入中央目录与（ZIP64）结束记录（调用方持有锁）
+	bool WriteCentralDirectory();
+
+	std::ofstream ofs;
+	std::string archive_path;
+
+	// 当前写入位置
+	uint64_t position = 0;
+
+	std::vector<EntryRecord> entries;
+
+	// 路径 -> entries 下标，用于重复路径检测
+	std::unordered_map<std::string, size_t> entry_lookup;
+
+	bool failed = false;
+	mutable std::mutex write_mutex;
+};
+
+#endif // TILE_ARCHIVE_WRITER_H
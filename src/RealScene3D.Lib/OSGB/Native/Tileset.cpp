@@ -71,6 +71,14 @@ BoundingVolume BoundingVolume::FromRegion(const Region& region)
 	return bv;
 }
 
+BoundingVolume BoundingVolume::FromSphere(double dX, double dY, double dZ, double dRadius)
+{
+	BoundingVolume bv;
+	bv.type = BoundingVolumeType::Sphere;
+	bv.data = { dX, dY, dZ, dRadius };
+	return bv;
+}
+
 std::string BoundingVolume::ToJson() const
 {
 	std::string json = "\"boundingVolume\":{";
@@ -79,6 +87,10 @@ std::string BoundingVolume::ToJson() const
 	{
 		json += "\"box\":[";
 	}
+	else if (type == BoundingVolumeType::Sphere)
+	{
+		json += "\"sphere\":[";
+	}
 	else
 	{
 		json += "\"region\":[";
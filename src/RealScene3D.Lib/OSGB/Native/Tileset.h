@@ -63,13 +63,16 @@ enum class BoundingVolumeType
 	Box, 
 
 	// 3D Tiles region格式：6个值 [west, south, east, north, minHeight, maxHeight]    
-	Region   
+	Region,
+
+	// 3D Tiles sphere格式：4个值 [centerX, centerY, centerZ, radius]
+	Sphere
 };
 
 /**
  * @brief 统一的边界体积表示
  *
- * 用于表示3D Tiles中的boundingVolume，支持box和region两种格式。
+ * 用于表示3D Tiles中的boundingVolume，支持box、region和sphere三种格式。
  *
  * @example
  * // 从Box创建
@@ -80,7 +83,7 @@ enum class BoundingVolumeType
 struct BoundingVolume
 {
 	BoundingVolumeType type;      // 边界体积类型
-	std::vector<double> data;     // 边界体积数据：box=12个值，region=6个值
+	std::vector<double> data;     // 边界体积数据：box=12个值，region=6个值，sphere=4个值
 
 	/**
 	 * @brief 从Box结构创建BoundingVolume
@@ -96,6 +99,16 @@ struct BoundingVolume
 	 */
 	static BoundingVolume FromRegion(const Region& region);
 
+	/**
+	 * @brief 从包围球创建BoundingVolume
+	 * @param dX 球心X
+	 * @param dY 球心Y
+	 * @param dZ 球心Z
+	 * @param dRadius 半径
+	 * @return BoundingVolume实例
+	 */
+	static BoundingVolume FromSphere(double dX, double dY, double dZ, double dRadius);
+
 	/**
 	 * @brief 生成JSON字符串表示
 	 * @return 返回boundingVolume的JSON片段，如 "boundingVolume":{"box":[...]}
@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+
+#include <json.hpp>
+
+#include "TilesetMerger.h"
+#include "GeoTransform.h"
+#include "OSGBTools.h"
+#include "OutputSink.h"
+#include "Tileset.h"
+
+using namespace OSGBLog;
+
+// ============================================================================
+// 内部辅助函数（仅在本文件内使用）
+// ============================================================================
+
+namespace
+{
+	using Vec3 = std::array<double, 3>;
+
+	double Length(const Vec3& v)
+	{
+		return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+	}
+
+	/**
+	 * @brief 按列主序 4x4 矩阵变换点
+	 */
+	Vec3 TransformPoint(const std::vector<double>& m, const Vec3& p)
+	{
+		return {
+			m[0] * p[0] + m[4] * p[1] + m[8] * p[2] + m[12],
+			m[1] * p[0] + m[5] * p[1] + m[9] * p[2] + m[13],
+			m[2] * p[0] + m[6] * p[1] + m[10] * p[2] + m[14]
+		};
+	}
+
+	/**
+	 * @brief 按列主序 4x4 矩阵变换方向（不含平移）
+	 */
+	Vec3 TransformVector(const std::vector<double>& m, const Vec3& v)
+	{
+		return {
+			m[0] * v[0] + m[4] * v[1] + m[8] * v[2],
+			m[1] * v[0] + m[5] * v[1] + m[9] * v[2],
+			m[2] * v[0] + m[6] * v[1] + m[10] * v[2]
+		};
+	}
+
+	/**
+	 * @brief 根节点包围体（box / sphere / region）在ECEF中的包围球
+	 * @param bv boundingVolume JSON
+	 * @param transform 根节点 transform（列主序16个值）
+	 */
+	bool SphereFromBoundingVolume(const nlohmann::json& bv, const std::vector<double>& transform,
+		Vec3& center, double& radius)
+	{
+		if (bv.contains("box"))
+		{
+			std::vector<double> box = bv.at("box").get<std::vector<double>>();
+			if (box.size() != 12)
+			{
+				return false;
+			}
+
+			center = TransformPoint(transform, { box[0], box[1], box[2] });
+			Vec3 axes[3];
+			for (int i = 0; i < 3; i++)
+			{
+				axes[i] = TransformVector(transform, { box[3 + i * 3], box[4 + i * 3], box[5 + i * 3] });
+			}
+
+			// 最远的角点
+			radius = 0.0;
+			for (int sign = 0; sign < 8; sign++)
+			{
+				Vec3 corner = { 0.0, 0.0, 0.0 };
+				for (int i = 0; i < 3; i++)
+				{
+					double s = (sign >> i) & 1 ? 1.0 : -1.0;
+					for (int k = 0; k < 3; k++)
+					{
+						corner[k] += s * axes[i][k];
+					}
+				}
+				radius = std::max(radius, Length(corner));
+			}
+
+			return true;
+		}
+
+		if (bv.contains("sphere"))
+		{
+			std::vector<double> sphere = bv.at("sphere").get<std::vector<double>>();
+			if (sphere.size() != 4)
+			{
+				return false;
+			}
+
+			center = TransformPoint(transform, { sphere[0], sphere[1], sphere[2] });
+
+			// 按最大轴向缩放放大半径
+			double scale = 0.0;
+			for (int i = 0; i < 3; i++)
+			{
+				Vec3 axis = { 0.0, 0.0, 0.0 };
+				axis[i] = 1.0;
+				scale = std::max(scale, Length(TransformVector(transform, axis)));
+			}
+			radius = sphere[3] * scale;
+
+			return true;
+		}
+
+		if (bv.contains("region"))
+		{
+			// region 始终为经纬度（弧度），不受 transform 影响；取角点、边中点与中心的ECEF坐标
+			std::vector<double> region = bv.at("region").get<std::vector<double>>();
+			if (region.size() != 6)
+			{
+				return false;
+			}
+
+			const double to_degree = 180.0 / std::acos(-1.0);
+			std::vector<Vec3> points;
+			for (int ix = 0; ix < 3; ix++)
+			{
+				for (int iy = 0; iy < 3; iy++)
+				{
+					double lon = (region[0] + (region[2] - region[0]) * ix / 2.0) * to_degree;
+					double lat = (region[1] + (region[3] - region[1]) * iy / 2.0) * to_degree;
+					for (double height : { region[4], region[5] })
+					{
+						glm::dvec3 p = GeoTransform::CartographicToEcef(lon, lat, height);
+						points.push_back({ p.x, p.y, p.z });
+					}
+				}
+			}
+
+			center = { 0.0, 0.0, 0.0 };
+			for (const auto& p : points)
+			{
+				for (int k = 0; k < 3; k++)
+				{
+					center[k] += p[k] / points.size();
+				}
+			}
+
+			radius = 0.0;
+			for (const auto& p : points)
+			{
+				radius = std::max(radius, Length({ p[0] - center[0], p[1] - center[1], p[2] - center[2] }));
+			}
+
+			return true;
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief 扩大包围球以包含另一个包围球
+	 */
+	void ExpandSphere(Vec3& center, double& radius, const Vec3& other_center, double other_radius)
+	{
+		Vec3 d = { other_center[0] - center[0], other_center[1] - center[1], other_center[2] - center[2] };
+		double dist = Length(d);
+
+		if (dist + other_radius <= radius)
+		{
+			return;
+		}
+
+		if (dist + radius <= other_radius)
+		{
+			center = other_center;
+			radius = other_radius;
+			return;
+		}
+
+		double new_radius = (dist + radius + other_radius) / 2.0;
+		double t = (new_radius - radius) / dist;
+		for (int k = 0; k < 3; k++)
+		{
+			center[k] += d[k] * t;
+		}
+		radius = new_radius;
+	}
+
+	/**
+	 * @brief 输出目录到 tileset.json 的相对URI
+	 */
+	std::string RelativeUri(const std::string& strOutputDir, const std::string& strTilesetPath)
+	{
+		std::error_code ec;
+		std::filesystem::path target = std::filesystem::absolute(strTilesetPath, ec);
+		std::filesystem::path base = std::filesystem::absolute(strOutputDir.empty() ? "." : strOutputDir, ec);
+		std::filesystem::path relative = target.lexically_normal().lexically_relative(base.lexically_normal());
+
+		// 不在同一盘符等无法计算相对路径时使用绝对路径
+		if (relative.empty())
+		{
+			LOG_W("无法计算相对路径，使用绝对路径: {}", strTilesetPath);
+			return OSGBTools::Utf8String(target.generic_string());
+		}
+
+		std::string uri = OSGBTools::Utf8String(relative.generic_string());
+		if (uri.compare(0, 3, "../") != 0)
+		{
+			uri = "./" + uri;
+		}
+
+		return uri;
+	}
+
+	/**
+	 * @brief 路径以 .json 结尾（不区分大小写）
+	 */
+	bool IsJsonFile(const std::string& strPath)
+	{
+		if (strPath.size() < 5)
+		{
+			return false;
+		}
+
+		std::string ext = strPath.substr(strPath.size() - 5);
+		std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+		return ext == ".json";
+	}
+
+} // anonymous namespace
+
+bool TilesetMerger::AddTileset(const std::string& strTilesetPath)
+{
+	using nlohmann::json;
+
+	std::string path = OSGBTools::OSGString(strTilesetPath);
+	if (!path.empty() && (path.back() == '/' || path.back() == '\\'))
+	{
+		path.pop_back();
+	}
+	if (OSGBTools::IsDirectory(path))
+	{
+		path += "/tileset.json";
+	}
+
+	std::string strContent;
+	if (!OSGBTools::ReadFile(path, strContent))
+	{
+		LOG_E("读取 tileset.json 失败: {}", strTilesetPath);
+		return false;
+	}
+
+	Input input;
+	input.tileset_path = path;
+
+	try
+	{
+		json tileset = json::parse(strContent);
+		const json& root = tileset.at("root");
+
+		// 没有 transform 时为单位矩阵
+		std::vector<double> transform = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+		if (root.contains("transform"))
+		{
+			transform = root.at("transform").get<std::vector<double>>();
+			if (transform.size() != 16)
+			{
+				LOG_E("tileset.json 根节点 transform 无效: {}", strTilesetPath);
+				return false;
+			}
+		}
+
+		if (!SphereFromBoundingVolume(root.at("boundingVolume"), transform, input.center, input.radius))
+		{
+			LOG_E("tileset.json 根节点包围体无效: {}", strTilesetPath);
+			return false;
+		}
+
+		input.geometric_error = tileset.value("geometricError", root.value("geometricError", 0.0));
+	}
+	catch (const std::exception& e)
+	{
+		LOG_E("解析 tileset.json 失败: {} ({})", strTilesetPath, e.what());
+		return false;
+	}
+
+	inputs.emplace_back(std::move(input));
+
+	return true;
+}
+
+std::string TilesetMerger::ToJson(const std::string& strOutputDir) const
+{
+	if (inputs.empty())
+	{
+		return "";
+	}
+
+	// 根节点不带 transform：各数据集的 transform 在其 tileset.json 中，包围体使用ECEF
+	TilesetNode root;
+	Vec3 center = inputs[0].center;
+	double radius = inputs[0].radius;
+
+	for (const auto& input : inputs)
+	{
+		TilesetNode child;
+		child.geometricError = input.geometric_error;
+		child.boundingVolume = BoundingVolume::FromSphere(input.center[0], input.center[1], input.center[2], input.radius);
+		child.contentUri = RelativeUri(strOutputDir, input.tileset_path);
+		root.children.emplace_back(child);
+
+		ExpandSphere(center, radius, input.center, input.radius);
+		root.geometricError = std::max(root.geometricError, input.geometric_error);
+	}
+
+	root.boundingVolume = BoundingVolume::FromSphere(center[0], center[1], center[2], radius);
+
+	return root.ToJson(true);
+}
+
+bool TilesetMerger::Write(const std::string& strOutputPath) const
+{
+	if (inputs.empty())
+	{
+		LOG_E("没有可合并的数据集");
+		return false;
+	}
+
+	std::string output_path = strOutputPath;
+	if (!IsJsonFile(output_path))
+	{
+		output_path += "/tileset.json";
+	}
+	std::string output_dir = OSGBTools::GetParent(output_path);
+
+	LocalFileSink sink(false);
+	sink.MakeDirs(output_dir);
+	if (!sink.Write(output_path, ToJson(output_dir)) || !sink.Flush())
+	{
+		LOG_E("写入合并后的 tileset.json 失败: {}", output_path);
+		return false;
+	}
+
+	LOG_I("已合并 {} 个数据集: {}", inputs.size(), output_path);
+
+	return true;
+}
+
+bool TilesetMerger::Merge(const std::vector<std::string>& vecTilesetPaths, const std::string& strOutputPath)
+{
+	TilesetMerger merger;
+	for (const auto& path : vecTilesetPaths)
+	{
+		if (!merger.AddTileset(path))
+		{
+			return false;
+		}
+	}
+
+	return merger.Write(strOutputPath);
+}
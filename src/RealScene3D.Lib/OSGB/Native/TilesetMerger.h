@@ -0,0 +1,79 @@
+#ifndef TILESET_MERGER_H
+#define TILESET_MERGER_H
+
+#include <array>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 已转换数据集的合并工具
+ *
+ * 读取多个已转换输出的根 tileset.json（只读取根节点的 transform、包围体与几何误差），
+ * 在ECEF中计算各数据集的包围球及合并后的包围球，生成新的根 tileset.json，
+ * 各数据集作为外部 tileset 以相对路径引用。子数据集的 transform 保留在其自身的 tileset.json 中，
+ * 新根节点不带 transform，因此各数据集的相对位置与单独加载时一致。不读写任何瓦片内容。
+ *
+ * @example
+ * TilesetMerger merger;
+ * merger.AddTileset("E:/Tiles/BlockA");
+ * merger.AddTileset("E:/Tiles/BlockB/tileset.json");
+ * merger.Write("E:/Tiles/Merged/tileset.json");
+ */
+class TilesetMerger
+{
+public:
+	/**
+	 * @brief 添加一个已转换的数据集
+	 * @param strTilesetPath 根 tileset.json 路径或其所在目录
+	 * @return 读取并解析成功返回 true
+	 */
+	bool AddTileset(const std::string& strTilesetPath);
+
+	/**
+	 * @brief 已添加的数据集数量
+	 */
+	size_t GetCount() const { return inputs.size(); }
+
+	/**
+	 * @brief 生成合并后的根 tileset.json
+	 * @param strOutputDir 输出目录，用于计算各数据集的相对路径
+	 * @return tileset.json 内容，没有数据集时为空
+	 */
+	std::string ToJson(const std::string& strOutputDir) const;
+
+	/**
+	 * @brief 写出合并后的根 tileset.json
+	 * @param strOutputPath 输出 tileset.json 路径，不以 .json 结尾时视为输出目录
+	 * @return 写入成功返回 true
+	 */
+	bool Write(const std::string& strOutputPath) const;
+
+	/**
+	 * @brief 合并多个已转换的数据集
+	 * @param vecTilesetPaths 各数据集的根 tileset.json 路径或所在目录
+	 * @param strOutputPath 输出 tileset.json 路径或目录
+	 * @return 全部数据集读取成功且写入成功返回 true
+	 */
+	static bool Merge(const std::vector<std::string>& vecTilesetPaths, const std::string& strOutputPath);
+
+private:
+	/**
+	 * @brief 一个输入数据集
+	 */
+	struct Input
+	{
+		// 根 tileset.json 路径
+		std::string tileset_path;
+
+		// ECEF包围球
+		std::array<double, 3> center = { 0.0, 0.0, 0.0 };
+		double radius = 0.0;
+
+		// tileset 的几何误差
+		double geometric_error = 0.0;
+	};
+
+	std::vector<Input> inputs;
+};
+
+#endif // TILESET_MERGER_H
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <chrono>
+
+#include <json.hpp>
+
+#include "TraceRecorder.h"
+
+std::atomic<int> TraceRecorder::active_sessions{ 0 };
+
+TraceRecorder& TraceRecorder::Global()
+{
+	static TraceRecorder recorder;
+	return recorder;
+}
+
+int64_t TraceRecorder::Now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void TraceRecorder::BeginSession(size_t nEventsPerThread)
+{
+	std::lock_guard<std::mutex> lock(session_mutex);
+
+	capacity = std::max<size_t>(nEventsPerThread, 1);
+	active_sessions++;
+}
+
+void TraceRecorder::EndSession()
+{
+	std::lock_guard<std::mutex> lock(session_mutex);
+
+	if (--active_sessions == 0)
+	{
+		ReleaseBuffers();
+	}
+}
+
+void TraceRecorder::ReleaseBuffers()
+{
+	std::lock_guard<std::mutex> lock(buffers_mutex);
+
+	auto it = std::remove_if(buffers.begin(), buffers.end(), [](const std::shared_ptr<ThreadBuffer>& buffer)
+		{
+			std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+			if (buffer->exited)
+			{
+				return true;
+			}
+
+			// 仍在运行的线程保留缓冲区，只释放事件占用的内存
+			std::vector<Event>().swap(buffer->events);
+			buffer->next = 0;
+			return false;
+		});
+	buffers.erase(it, buffers.end());
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::LocalBuffer()
+{
+	// 线程退出时标记缓冲区，最后一个会话结束后移除
+	struct LocalHolder
+	{
+		std::shared_ptr<ThreadBuffer> buffer;
+
+		~LocalHolder()
+		{
+			if (buffer)
+			{
+				std::lock_guard<std::mutex> lock(buffer->mutex);
+				buffer->exited = true;
+			}
+		}
+	};
+
+	thread_local LocalHolder local;
+	if (!local.buffer)
+	{
+		local.buffer = std::make_shared<ThreadBuffer>();
+
+		std::lock_guard<std::mutex> lock(buffers_mutex);
+		local.buffer->tid = next_tid++;
+		buffers.emplace_back(local.buffer);
+	}
+
+	return *local.buffer;
+}
+
+void TraceRecorder::Record(const char* pszName, const char* pszCategory, int64_t nStart, int64_t nEnd, std::string&& strDetail)
+{
+	ThreadBuffer& buffer = LocalBuffer();
+	const size_t cap = capacity.load(std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> lock(buffer.mutex);
+
+	// 容量变小时丢弃旧事件
+	if (buffer.events.size() > cap)
+	{
+		buffer.events.clear();
+		buffer.next = 0;
+	}
+
+	// 未写满时追加，写满后覆盖最早的事件
+	Event event{ pszName, pszCategory, nStart, nEnd, std::move(strDetail) };
+	if (buffer.events.size() < cap)
+	{
+		buffer.events.emplace_back(std::move(event));
+	}
+	else
+	{
+		buffer.events[buffer.next] = std::move(event);
+		buffer.next = (buffer.next + 1) % cap;
+	}
+}
+
+std::string TraceRecorder::ExportChromeTrace(int64_t nFrom, int64_t nTo) const
+{
+	using nlohmann::json;
+
+	std::vector<std::shared_ptr<ThreadBuffer>> snapshot;
+	{
+		std::lock_guard<std::mutex> lock(buffers_mutex);
+		snapshot = buffers;
+	}
+
+	json events = json::array();
+	for (const auto& buffer : snapshot)
+	{
+		std::lock_guard<std::mutex> lock(buffer->mutex);
+
+		bool has_events = false;
+		for (const auto& event : buffer->events)
+		{
+			if (event.end < nFrom || event.start > nTo)
+			{
+				continue;
+			}
+
+			// Chrome trace 的时间单位为微秒
+			json item = {
+				{"name", event.name},
+				{"cat", event.category},
+				{"ph", "X"},
+				{"ts", (event.start - nFrom) / 1000.0},
+				{"dur", (event.end - event.start) / 1000.0},
+				{"pid", 1},
+				{"tid", buffer->tid}
+			};
+			if (!event.detail.empty())
+			{
+				item["args"] = { {"detail", event.detail} };
+			}
+			events.push_back(std::move(item));
+			has_events = true;
+		}
+
+		if (has_events)
+		{
+			events.push_back({
+				{"name", "thread_name"},
+				{"ph", "M"},
+				{"pid", 1},
+				{"tid", buffer->tid},
+				{"args", { {"name", "worker " + std::to_string(buffer->tid)} }}
+			});
+		}
+	}
+
+	json trace = {
+		{"traceEvents", events},
+		{"displayTimeUnit", "ms"}
+	};
+
+	// 路径等可能含非UTF-8字符，替换而不是抛出异常
+	return trace.dump(-1, ' ', false, json::error_handler_t::replace);
+}
+
+void TraceRecorder::Clear()
+{
+	std::lock_guard<std::mutex> lock(buffers_mutex);
+	for (const auto& buffer : buffers)
+	{
+		std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+		buffer->events.clear();
+		buffer->next = 0;
+	}
+}
+
+TraceSession::TraceSession(const TraceSettings& settings)
+	: active(settings.bEnable)
+{
+	if (active)
+	{
+		TraceRecorder::Global().BeginSession(settings.nEventsPerThread);
+		start = TraceRecorder::Now();
+	}
+}
+
+TraceSession::~TraceSession()
+{
+	if (active)
+	{
+		TraceRecorder::Global().EndSession();
+	}
+}
+
+std::string TraceSession::ToChromeTrace() const
+{
+	return active ? TraceRecorder::Global().ExportChromeTrace(start, TraceRecorder::Now()) : std::string();
+}
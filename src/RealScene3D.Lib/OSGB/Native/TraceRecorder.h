@@ -0,0 +1,215 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 时间线跟踪配置
+ */
+struct TraceSettings
+{
+	// 是否记录（关闭时各跟踪点只检查一个原子标志）
+	bool bEnable = false;
+
+	// 跟踪文件名（相对输出目录），转换成功结束时写出
+	std::string strFileName = "conversion-trace.json";
+
+	// 每个线程环形缓冲区的事件数，写满后覆盖最早的事件
+	size_t nEventsPerThread = 65536;
+};
+
+/**
+ * @brief 时间线跟踪记录器（进程共享）
+ *
+ * 跟踪点（TraceScope）把事件写入各线程独立的环形缓冲区，线程之间不竞争；
+ * 没有活动的跟踪会话时跟踪点只读取一个原子标志，不取时间也不分配内存。
+ * 导出为 Chrome trace JSON，可在 chrome://tracing 或 Perfetto 中查看各线程的时间线。
+ * 多个任务同时跟踪时，每个会话导出其时间范围内所有线程的事件。
+ * 最后一个会话结束时释放所有事件，并移除已退出线程的缓冲区。
+ */
+class TraceRecorder
+{
+public:
+	/**
+	 * @brief 进程共享的记录器
+	 */
+	static TraceRecorder& Global();
+
+	/**
+	 * @brief 是否有活动的跟踪会话
+	 */
+	static bool IsEnabled() { return active_sessions.load(std::memory_order_relaxed) > 0; }
+
+	/**
+	 * @brief 当前时间（steady_clock 纳秒）
+	 */
+	static int64_t Now();
+
+	/**
+	 * @brief 开始一个跟踪会话
+	 * @param nEventsPerThread 新建线程缓冲区的容量
+	 */
+	void BeginSession(size_t nEventsPerThread);
+
+	/**
+	 * @brief 结束一个跟踪会话（最后一个会话结束时释放缓冲区）
+	 */
+	void EndSession();
+
+	/**
+	 * @brief 记录一个事件（由 TraceScope 调用）
+	 * @param pszName 事件名（须为静态字符串）
+	 * @param pszCategory 分类（须为静态字符串）
+	 * @param nStart 开始时间（纳秒）
+	 * @param nEnd 结束时间（纳秒）
+	 * @param strDetail 附加信息（如文件名），可为空
+	 */
+	void Record(const char* pszName, const char* pszCategory, int64_t nStart, int64_t nEnd, std::string&& strDetail);
+
+	/**
+	 * @brief 导出时间范围内的事件为 Chrome trace JSON
+	 * @param nFrom 起始时间（纳秒）
+	 * @param nTo 结束时间（纳秒）
+	 */
+	std::string ExportChromeTrace(int64_t nFrom, int64_t nTo) const;
+
+	/**
+	 * @brief 清空所有线程的事件
+	 */
+	void Clear();
+
+private:
+	TraceRecorder() = default;
+
+	/**
+	 * @brief 一个事件
+	 */
+	struct Event
+	{
+		const char* name = nullptr;
+		const char* category = nullptr;
+		int64_t start = 0;
+		int64_t end = 0;
+		std::string detail;
+	};
+
+	/**
+	 * @brief 一个线程的环形缓冲区
+	 */
+	struct ThreadBuffer
+	{
+		int tid = 0;
+		std::mutex mutex;
+		std::vector<Event> events;
+
+		// 写满后下一个被覆盖的位置
+		size_t next = 0;
+
+		// 所属线程已退出
+		bool exited = false;
+	};
+
+	/**
+	 * @brief 当前线程的缓冲区（首次记录时创建并登记）
+	 */
+	ThreadBuffer& LocalBuffer();
+
+	/**
+	 * @brief 释放所有事件并移除已退出线程的缓冲区（需持有 session_mutex）
+	 */
+	void ReleaseBuffers();
+
+	static std::atomic<int> active_sessions;
+
+	std::atomic<size_t> capacity{ 65536 };
+
+	// 保护会话的开始与结束，释放缓冲区时不会有新会话开始
+	std::mutex session_mutex;
+
+	// 所有线程的缓冲区（线程退出后保留到最后一个会话结束，事件仍可导出）
+	mutable std::mutex buffers_mutex;
+	std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+	// 下一个线程编号（移除缓冲区后编号不重复）
+	int next_tid = 1;
+};
+
+/**
+ * @brief 跟踪点：构造到析构之间记为一个事件，没有活动的跟踪会话时不记录
+ *
+ * @example
+ * TraceScope trace("ToGLBBuf", "convert", strPath);
+ */
+class TraceScope
+{
+public:
+	TraceScope(const char* pszName, const char* pszCategory)
+		: name(pszName)
+		, category(pszCategory)
+	{
+		if (TraceRecorder::IsEnabled())
+		{
+			start = TraceRecorder::Now();
+		}
+	}
+
+	TraceScope(const char* pszName, const char* pszCategory, const std::string& strDetail)
+		: TraceScope(pszName, pszCategory)
+	{
+		if (start != 0)
+		{
+			detail = strDetail;
+		}
+	}
+
+	~TraceScope()
+	{
+		if (start != 0)
+		{
+			TraceRecorder::Global().Record(name, category, start, TraceRecorder::Now(), std::move(detail));
+		}
+	}
+
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+	const char* name;
+	const char* category;
+	int64_t start = 0;
+	std::string detail;
+};
+
+/**
+ * @brief 跟踪会话：启用时构造即开始记录，ToChromeTrace 导出本会话期间的事件
+ */
+class TraceSession
+{
+public:
+	explicit TraceSession(const TraceSettings& settings);
+	~TraceSession();
+
+	TraceSession(const TraceSession&) = delete;
+	TraceSession& operator=(const TraceSession&) = delete;
+
+	/**
+	 * @brief 是否在记录
+	 */
+	bool IsActive() const { return active; }
+
+	/**
+	 * @brief 导出会话开始至今的事件
+	 */
+	std::string ToChromeTrace() const;
+
+private:
+	bool active = false;
+	int64_t start = 0;
+};
+
+#endif // TRACE_RECORDER_H
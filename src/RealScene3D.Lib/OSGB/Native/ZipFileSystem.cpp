@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <mutex>
+
+#include "ZipFileSystem.h"
+#include "TileArchiveWriter.h"
+#include "OSGBTools.h"
+
+using namespace OSGBLog;
+
+// ============================================================================
+// 内部辅助函数（仅在本文件内使用）
+// ============================================================================
+
+namespace
+{
+	/**
+	 * @brief 已打开的压缩包及持有它的任务数
+	 */
+	struct MountedArchive
+	{
+		std::shared_ptr<ZipFileSystem> zip;
+
+		// Acquire 未配对 Release 的次数，降为 0 时关闭
+		int holders = 0;
+	};
+
+	std::unordered_map<std::string, MountedArchive> g_mounted;
+	std::mutex g_mounted_mutex;
+
+	// 查找下一个以 ".zip" 结尾的路径分量，返回分量结束位置
+	size_t FindArchiveEnd(const std::string& strPath, size_t nFrom)
+	{
+		for (size_t pos = nFrom; pos + 4 <= strPath.size(); ++pos)
+		{
+			if (strPath[pos] == '.' &&
+				std::tolower(static_cast<unsigned char>(strPath[pos + 1])) == 'z' &&
+				std::tolower(static_cast<unsigned char>(strPath[pos + 2])) == 'i' &&
+				std::tolower(static_cast<unsigned char>(strPath[pos + 3])) == 'p' &&
+				(pos + 4 == strPath.size() || strPath[pos + 4] == '/' || strPath[pos + 4] == '\\'))
+			{
+				return pos + 4;
+			}
+		}
+
+		return std::string::npos;
+	}
+
+} // anonymous namespace
+
+bool ZipFileSystem::Open(const std::string& strArchivePath)
+{
+	if (!reader.Open(OSGBTools::Utf8String(strArchivePath)))
+	{
+		return false;
+	}
+
+	archive_path = strArchivePath;
+	directories.clear();
+	directories[""];
+
+	// 由文件路径推导目录树（ZIP 中的目录条目可有可无）
+	for (const auto& name : reader.ListEntries())
+	{
+		std::string child = name;
+		bool bIsDirectory = false;
+		while (true)
+		{
+			size_t nSlash = child.find_last_of('/');
+			std::string parent = nSlash == std::string::npos ? "" : child.substr(0, nSlash);
+			std::string leaf = nSlash == std::string::npos ? child : child.substr(nSlash + 1);
+
+			// 目录已登记过则其所有上级也已登记
+			bool bParentKnown = directories.count(parent) > 0;
+			directories[parent].push_back({ leaf, bIsDirectory });
+			if (bParentKnown || parent.empty())
+			{
+				break;
+			}
+
+			child = parent;
+			bIsDirectory = true;
+		}
+	}
+
+	for (auto& item : directories)
+	{
+		std::sort(item.second.begin(), item.second.end(),
+			[](const Child& a, const Child& b) { return a.name < b.name; });
+	}
+
+	LOG_I("已挂载压缩包: {} ({} 个文件, {} 个目录)",
+		strArchivePath, reader.GetEntryCount(), directories.size());
+
+	return true;
+}
+
+std::string ZipFileSystem::NormalizeEntry(const std::string& strEntry)
+{
+	std::string entry = TileArchiveWriter::NormalizePath(strEntry);
+	while (!entry.empty() && entry.back() == '/')
+	{
+		entry.pop_back();
+	}
+
+	return entry;
+}
+
+bool ZipFileSystem::IsDirectory(const std::string& strEntry) const
+{
+	return directories.count(NormalizeEntry(strEntry)) > 0;
+}
+
+bool ZipFileSystem::IsRegularFile(const std::string& strEntry) const
+{
+	return reader.Contains(NormalizeEntry(strEntry));
+}
+
+const std::vector<ZipFileSystem::Child>* ZipFileSystem::GetChildren(const std::string& strEntry) const
+{
+	auto it = directories.find(NormalizeEntry(strEntry));
+	if (it == directories.end())
+	{
+		return nullptr;
+	}
+
+	return &it->second;
+}
+
+std::vector<std::string> ZipFileSystem::ListFiles(const std::string& strEntry, bool bRecursive) const
+{
+	std::vector<std::string> files;
+
+	std::vector<std::string> pending = { NormalizeEntry(strEntry) };
+	while (!pending.empty())
+	{
+		std::string dir = std::move(pending.back());
+		pending.pop_back();
+
+		auto it = directories.find(dir);
+		if (it == directories.end())
+		{
+			continue;
+		}
+
+		for (const auto& child : it->second)
+		{
+			std::string path = dir.empty() ? child.name : dir + "/" + child.name;
+			if (!child.is_directory)
+			{
+				files.emplace_back(std::move(path));
+			}
+			else if (bRecursive)
+			{
+				pending.emplace_back(std::move(path));
+			}
+		}
+	}
+
+	std::sort(files.begin(), files.end());
+
+	return files;
+}
+
+bool ZipFileSystem::ReadFile(const std::string& strEntry, std::string& data) const
+{
+	return reader.ReadEntry(NormalizeEntry(strEntry), data);
+}
+
+bool ZipFileSystem::IsArchivePath(const std::string& strPath)
+{
+	return FindArchiveEnd(strPath, 0) != std::string::npos;
+}
+
+std::shared_ptr<ZipFileSystem> ZipFileSystem::Resolve(const std::string& strPath, std::string& strEntry)
+{
+	return Mount(strPath, strEntry, false);
+}
+
+std::shared_ptr<ZipFileSystem> ZipFileSystem::Acquire(const std::string& strPath, std::string& strEntry)
+{
+	return Mount(strPath, strEntry, true);
+}
+
+std::shared_ptr<ZipFileSystem> ZipFileSystem::Mount(const std::string& strPath, std::string& strEntry, bool bAcquire)
+{
+	for (size_t nEnd = FindArchiveEnd(strPath, 0); nEnd != std::string::npos; nEnd = FindArchiveEnd(strPath, nEnd))
+	{
+		std::string archive = strPath.substr(0, nEnd);
+		std::replace(archive.begin(), archive.end(), '\\', '/');
+
+		std::lock_guard<std::mutex> lock(g_mounted_mutex);
+
+		auto it = g_mounted.find(archive);
+		if (it == g_mounted.end())
+		{
+			// 同名目录不是压缩包，继续查找后面的分量
+			std::error_code ec;
+			if (!std::filesystem::is_regular_file(archive, ec))
+			{
+				continue;
+			}
+
+			auto zip = std::make_shared<ZipFileSystem>();
+			if (!zip->Open(archive))
+			{
+				LOG_E("无法打开压缩包: {}", archive);
+				return nullptr;
+			}
+
+			it = g_mounted.emplace(archive, MountedArchive{ std::move(zip), 0 }).first;
+		}
+
+		if (bAcquire)
+		{
+			it->second.holders++;
+		}
+
+		strEntry = NormalizeEntry(nEnd < strPath.size() ? strPath.substr(nEnd + 1) : "");
+
+		return it->second.zip;
+	}
+
+	return nullptr;
+}
+
+void ZipFileSystem::Release(const std::string& strArchivePath)
+{
+	std::string archive = strArchivePath;
+	std::replace(archive.begin(), archive.end(), '\\', '/');
+
+	std::lock_guard<std::mutex> lock(g_mounted_mutex);
+
+	// 其他任务仍持有时保留，只有最后一个持有者释放后才关闭
+	auto it = g_mounted.find(archive);
+	if (it != g_mounted.end() && --it->second.holders <= 0)
+	{
+		g_mounted.erase(it);
+	}
+}
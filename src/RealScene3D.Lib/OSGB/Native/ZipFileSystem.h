@@ -0,0 +1,129 @@
+#ifndef ZIP_FILE_SYSTEM_H
+#define ZIP_FILE_SYSTEM_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TileArchiveReader.h"
+
+/**
+ * @brief ZIP 输入虚拟文件系统
+ *
+ * 把 ZIP 压缩包当作只读目录使用：路径中以 ".zip" 结尾的部分视为压缩包，其后为包内路径，
+ * 例如 "D:/survey.zip/Data/Tile_+000_+000/Tile_+000_+000.osgb"。
+ * 压缩包在首次访问时内存映射并建立中央目录索引与目录树，之后的目录查询只访问内存；
+ * 条目读取在调用线程解压，预读线程与转换线程可以并行解压不同条目。
+ *
+ * OSGBTools 的目录扫描、文件读取等输入函数通过 Resolve 自动识别压缩包路径，
+ * 转换流程无需先解压数据集。批量任务以 Acquire / Release 成对持有压缩包，
+ * 同一压缩包被多个任务使用时，最后一个任务结束后才关闭。
+ *
+ * @example
+ * std::string entry;
+ * auto zip = ZipFileSystem::Resolve("D:/survey.zip/Data", entry);  // entry = "Data"
+ * if (zip && zip->IsDirectory(entry)) { ... }
+ */
+class ZipFileSystem
+{
+public:
+	/**
+	 * @brief 包内目录条目
+	 */
+	struct Child
+	{
+		// 名称（不含路径）
+		std::string name;
+
+		// 是否为目录
+		bool is_directory = false;
+	};
+
+	ZipFileSystem() = default;
+
+	ZipFileSystem(const ZipFileSystem&) = delete;
+	ZipFileSystem& operator=(const ZipFileSystem&) = delete;
+
+	/**
+	 * @brief 打开压缩包并建立目录树
+	 * @param strArchivePath 压缩包路径（本地编码）
+	 * @return 是否成功
+	 */
+	bool Open(const std::string& strArchivePath);
+
+	/**
+	 * @brief 压缩包路径
+	 */
+	const std::string& GetArchivePath() const { return archive_path; }
+
+	/**
+	 * @brief 包内路径是否为目录（空字符串为根目录）
+	 */
+	bool IsDirectory(const std::string& strEntry) const;
+
+	/**
+	 * @brief 包内路径是否为文件
+	 */
+	bool IsRegularFile(const std::string& strEntry) const;
+
+	/**
+	 * @brief 获取目录的直接子项
+	 * @return 目录不存在返回 nullptr
+	 */
+	const std::vector<Child>* GetChildren(const std::string& strEntry) const;
+
+	/**
+	 * @brief 列出目录下的文件（包内路径）
+	 * @param strEntry 目录
+	 * @param bRecursive 是否包含子目录中的文件
+	 */
+	std::vector<std::string> ListFiles(const std::string& strEntry, bool bRecursive) const;
+
+	/**
+	 * @brief 读取（解压）文件内容
+	 */
+	bool ReadFile(const std::string& strEntry, std::string& data) const;
+
+	/**
+	 * @brief 路径是否位于压缩包内（只做字符串判断，不访问文件系统）
+	 */
+	static bool IsArchivePath(const std::string& strPath);
+
+	/**
+	 * @brief 解析路径，返回所在的压缩包（按需打开并缓存）
+	 * @param strPath 完整路径
+	 * @param strEntry 输出的包内路径（'/' 分隔，无首尾 '/'）
+	 * @return 不在压缩包内或打开失败返回 nullptr
+	 */
+	static std::shared_ptr<ZipFileSystem> Resolve(const std::string& strPath, std::string& strEntry);
+
+	/**
+	 * @brief 解析路径并持有所在的压缩包，任务结束时须调用 Release
+	 * @return 不在压缩包内或打开失败返回 nullptr（无需 Release）
+	 */
+	static std::shared_ptr<ZipFileSystem> Acquire(const std::string& strPath, std::string& strEntry);
+
+	/**
+	 * @brief 释放 Acquire 持有的压缩包，没有其他持有者时关闭缓存
+	 * （仍在使用的对象在最后一个引用释放后关闭）
+	 * @param strArchivePath 压缩包路径（GetArchivePath）
+	 */
+	static void Release(const std::string& strArchivePath);
+
+private:
+	// 解析路径并按需打开压缩包，bAcquire 时增加持有计数
+	static std::shared_ptr<ZipFileSystem> Mount(const std::string& strPath, std::string& strEntry, bool bAcquire);
+
+	// 规范化包内路径
+	static std::string NormalizeEntry(const std::string& strEntry);
+
+	std::string archive_path;
+
+	TileArchiveReader reader;
+
+	// 目录 -> 直接子项（根目录键为空字符串）
+	std::unordered_map<std::string, std::vector<Child>> directories;
+};
+
+#endif // ZIP_FILE_SYSTEM_H
@@ -4,9 +4,11 @@
 // ============================================================================
 
 #include "Native/OSGB23dTiles.h"
+#include "Native/LazyTileConverter.h"
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <cstdlib>
 #include <filesystem>
 
 #ifdef _WIN32
@@ -117,6 +119,161 @@ void test_minio_storage()
 }
 #endif
 
+bool test_resume_into_new_directory()
+{
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "测试3: 断点续传（首次运行时输出目录不存在）" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    std::filesystem::path root = std::filesystem::temp_directory_path() / "osgb_resume_test";
+    std::filesystem::remove_all(root);
+
+    // 与 ToB3DMBatch 默认的本地输出一致：进度日志位于输出目录下，输出目录在首次运行前不存在
+    std::string strOutputDir = (root / "output").string();
+    std::string strJournalPath = strOutputDir + "/.osgb-journal.jsonl";
+    std::string strTileDir = strOutputDir + "/Data/Tile_+000_+000";
+    std::string strTilesetPath = strTileDir + "/tileset.json";
+    std::string strSettingsKey = OSGB23dTiles::MakeSettingsKey("Production_3", 0.0, 0.0, -1,
+        false, false, false, false, SubsetSettings());
+
+    std::cout << "输出目录: " << strOutputDir << std::endl;
+
+    // 第一次运行：目录只登记给异步写入器（延迟创建），完成一个瓦片后中断（不删除日志）
+    {
+        AsyncWriteSettings settings;
+        settings.bSyncOnBarrier = true;
+        LocalFileSink sink(true, settings);
+        sink.MakeDirs(strTileDir);
+
+        BatchJournal journal;
+        if (!journal.Open(strJournalPath, strSettingsKey, 0))
+        {
+            std::cerr << "[FAILED] 输出目录不存在时进度日志无法创建" << std::endl;
+            return false;
+        }
+
+        sink.Write(strTilesetPath, std::string("{}"));
+
+        JournalRecord record;
+        record.tile_name = "Tile_+000_+000";
+        record.bbox = { 10.0, 10.0, 10.0, -10.0, -10.0, -10.0 };
+        record.geometric_error = 1.0;
+        record.tileset_path = strTilesetPath;
+        record.fingerprint = "fingerprint-1";
+        journal.Complete(record);
+
+        if (!journal.Checkpoint(sink, true))
+        {
+            std::cerr << "[FAILED] 检查点写入失败" << std::endl;
+            return false;
+        }
+    }
+
+    // 第二次运行：已完成的瓦片从进度日志续传，输入变化（指纹不同）的瓦片重新转换
+    BatchJournal journal;
+    bool bOpened = journal.Open(strJournalPath, strSettingsKey, 0);
+
+    JournalRecord record;
+    bool bResumed = bOpened && journal.GetResumedCount() == 1 &&
+        journal.Find("Tile_+000_+000", "fingerprint-1", record) && record.bbox[0] == 10.0;
+    bool bRejected = !journal.Find("Tile_+000_+000", "fingerprint-2", record);
+
+    BatchJournal other;
+    bool bOtherDataset = other.Open(strJournalPath, OSGB23dTiles::MakeSettingsKey("Production_4", 0.0, 0.0, -1,
+        false, false, false, false, SubsetSettings()), 0) && other.GetResumedCount() == 0;
+
+    other.Remove();
+    journal.Remove();
+    std::filesystem::remove_all(root);
+
+    if (!bResumed || !bRejected || !bOtherDataset)
+    {
+        std::cerr << "[FAILED] 续传结果不正确: resumed=" << bResumed << ", fingerprint_checked=" << bRejected
+            << ", dataset_checked=" << bOtherDataset << std::endl;
+        return false;
+    }
+
+    std::cout << "[SUCCESS] 断点续传成功" << std::endl;
+
+    return true;
+}
+
+bool test_lazy_matches_batch(const std::string& strInputPath)
+{
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "测试4: 按需转换与批量转换结果一致（含 metadata.xml 坐标转换）" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    std::filesystem::path root = std::filesystem::temp_directory_path() / "osgb_lazy_test";
+    std::filesystem::remove_all(root);
+
+    std::string strBatchDir = (root / "batch").string();
+    std::string strLazyDir = (root / "lazy").string();
+
+    std::cout << "输入目录: " << strInputPath << std::endl;
+
+    OSGB23dTiles reader;
+    if (!reader.ToB3DMBatch(strInputPath, strBatchDir, 0.0, 0.0, -1, false, false, false))
+    {
+        std::cerr << "[FAILED] 批量转换失败" << std::endl;
+        return false;
+    }
+
+    LazyTileConverter converter;
+    LazyDatasetSettings settings;
+    settings.strDataDir = strInputPath;
+    settings.strOutputDir = strLazyDir;
+    settings.nMaxLevel = -1;
+    settings.strIndexPath = (root / "lazy.index.json").string();
+
+    converter.RegisterDataset("lazy-test", settings);
+    if (!converter.BuildTileset("lazy-test"))
+    {
+        std::cerr << "[FAILED] 延迟模式生成 tileset 失败" << std::endl;
+        return false;
+    }
+
+    // 重新注册：从保存的索引恢复坐标系统，验证进程重启后的按需转换
+    LazyTileConverter restarted;
+    restarted.RegisterDataset("lazy-test", settings);
+
+    size_t nCompared = 0;
+    size_t nMismatched = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(strBatchDir))
+    {
+        if (!entry.is_regular_file() || entry.path().extension() != ".b3dm")
+        {
+            continue;
+        }
+
+        std::string strRelativePath = std::filesystem::relative(entry.path(), strBatchDir).generic_string();
+
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::string expected((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        std::string actual;
+        if (!restarted.ConvertTile("lazy-test", strRelativePath, actual) || actual != expected)
+        {
+            std::cerr << "  不一致: " << strRelativePath << std::endl;
+            nMismatched++;
+        }
+        nCompared++;
+    }
+
+    std::filesystem::remove_all(root);
+
+    if (nCompared == 0 || nMismatched > 0)
+    {
+        std::cerr << "[FAILED] 按需转换结果与批量转换不一致: compared=" << nCompared
+            << ", mismatched=" << nMismatched << std::endl;
+        return false;
+    }
+
+    std::cout << "[SUCCESS] 按需转换与批量转换一致，共比较 " << nCompared << " 个瓦片" << std::endl;
+
+    return true;
+}
+
 int main(int argc, char* argv[])
 {
 #ifdef _WIN32
@@ -130,12 +287,24 @@ int main(int argc, char* argv[])
     std::cout << "请输入要测试的功能编号:" << std::endl;
     std::cout << " 1: 本地文件系统存储" << std::endl; 
     std::cout << " 2: MinIO 对象存储" << std::endl;
+    std::cout << " 3: 断点续传（首次运行时输出目录不存在）" << std::endl;
+    std::cout << " 4: 按需转换与批量转换结果一致（可在编号后指定数据集目录）" << std::endl;
     std::cout << " 其他: 退出程序" << std::endl;
 
+    // 也可以通过命令行参数指定编号（非交互运行）
     int nChoice = 0;
-    std::cin >> nChoice;
+    if (argc > 1)
+    {
+        nChoice = std::atoi(argv[1]);
+    }
+    else
+    {
+        std::cin >> nChoice;
+    }
+
+    bool bSuccess = true;
 
-    if (nChoice != 1 && nChoice != 2)
+    if (nChoice < 1 || nChoice > 4)
     {
         std::cout << "退出程序" << std::endl;
         return 0;
@@ -154,10 +323,20 @@ int main(int argc, char* argv[])
         std::cout << "  编译时添加 -DENABLE_MINIO 启用 MinIO 测试" << std::endl;
 #endif      
     }
+    else if (nChoice == 3)
+    {
+        bSuccess = test_resume_into_new_directory();
+    }
+    else if (nChoice == 4)
+    {
+        // 数据集应带 metadata.xml（可用 OSGBDatasetGenerator --srs 生成）
+        std::string strInputPath = argc > 2 ? argv[2] : "E:/Data/3D/Production_3";
+        bSuccess = test_lazy_matches_batch(strInputPath);
+    }
 
     std::cout << "\n========================================" << std::endl;
     std::cout << "所有测试完成" << std::endl;
     std::cout << "========================================" << std::endl;
 
-    return 0;
+    return bSuccess ? 0 : 1;
 }
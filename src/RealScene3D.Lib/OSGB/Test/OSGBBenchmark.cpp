@@ -0,0 +1,457 @@
+// ============================================================================
+// OSGB 转换分阶段性能测试
+// 对数据集中的每个 OSGB 文件分别计时：读取、遍历、坐标变换、网格简化、Draco、
+// 纹理编码（JPEG / KTX2）、GLB 生成、tileset JSON 生成，以及批量转换整体耗时。
+// 输出字段顺序固定、不含时间戳的 JSON，便于比较不同构建的结果。
+//
+// 用法:
+//   OSGBBenchmark --data <数据集目录> [--iterations 3] [--max-files 0] [--label dev] [--out result.json]
+//
+// 数据集可由 OSGBDatasetGenerator 生成。未启用的可选功能（meshoptimizer、Draco、KTX2）
+// 对应阶段的 status 为 "unavailable"。
+// ============================================================================
+
+#include "Native/OSGB23dTiles.h"
+#include "Native/GlbCache.h"
+#include "Native/MeshProcessor.h"
+#include "Native/OSGBTools.h"
+#include "Native/OutputSink.h"
+#include "Native/Tileset.h"
+
+#include <osg/Matrixd>
+#include <osgDB/ReadFile>
+
+#include <json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+struct BenchmarkOptions
+{
+    std::string data_dir;
+    int iterations = 3;
+    size_t max_files = 0;
+    std::string label = "dev";
+    std::string out_path;
+};
+
+// 一个阶段的计时结果
+struct StageResult
+{
+    std::string name;
+    std::vector<double> samples_ms;
+    uint64_t bytes = 0;
+    size_t failures = 0;
+    std::string status = "ok";
+};
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ms(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double round3(double value)
+{
+    return std::round(value * 1000.0) / 1000.0;
+}
+
+double percentile(std::vector<double> sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    size_t index = static_cast<size_t>(std::ceil(p * sorted.size())) - 1;
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+nlohmann::ordered_json stage_json(const StageResult& stage)
+{
+    double total = 0.0;
+    for (double v : stage.samples_ms)
+    {
+        total += v;
+    }
+
+    nlohmann::ordered_json j;
+    j["name"] = stage.name;
+    j["status"] = stage.status;
+    j["samples"] = stage.samples_ms.size();
+    j["failures"] = stage.failures;
+    j["total_ms"] = round3(total);
+    j["mean_ms"] = round3(stage.samples_ms.empty() ? 0.0 : total / stage.samples_ms.size());
+    j["p50_ms"] = round3(percentile(stage.samples_ms, 0.50));
+    j["p95_ms"] = round3(percentile(stage.samples_ms, 0.95));
+    j["min_ms"] = round3(stage.samples_ms.empty() ? 0.0 : *std::min_element(stage.samples_ms.begin(), stage.samples_ms.end()));
+    j["max_ms"] = round3(stage.samples_ms.empty() ? 0.0 : *std::max_element(stage.samples_ms.begin(), stage.samples_ms.end()));
+    j["bytes"] = stage.bytes;
+    return j;
+}
+
+// 数据集中的 OSGB 文件（按路径排序，结果与文件系统遍历顺序无关）
+std::vector<std::string> collect_osgb_files(const std::string& data_dir, size_t max_files)
+{
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(data_dir, ec))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".osgb")
+        {
+            files.emplace_back(entry.path().generic_string());
+        }
+    }
+
+    std::sort(files.begin(), files.end());
+    if (max_files > 0 && files.size() > max_files)
+    {
+        files.resize(max_files);
+    }
+    return files;
+}
+
+// 与转换时相同的几何体选择：没有 PagedLOD 几何体时使用普通几何体
+const std::vector<osg::Geometry*>& node_geometries(const InfoVisitor& visitor)
+{
+    return visitor.geometry_array.empty() ? visitor.other_geometry_array : visitor.geometry_array;
+}
+
+osg::ref_ptr<osg::Geometry> copy_geometry(osg::Geometry* geometry)
+{
+    return new osg::Geometry(*geometry, osg::CopyOp::DEEP_COPY_ARRAYS | osg::CopyOp::DEEP_COPY_PRIMITIVES);
+}
+
+// 由文件引用关系构建 tileset 节点树（包围盒取节点包围球的外接立方体）
+TilesetNode build_tileset_node(const std::string& file,
+    const std::map<std::string, std::vector<std::string>>& children,
+    const std::map<std::string, osg::BoundingSphere>& bounds,
+    std::set<std::string>& visited)
+{
+    TilesetNode node;
+    visited.insert(file);
+
+    TileBox box;
+    auto bound = bounds.find(file);
+    if (bound != bounds.end() && bound->second.valid())
+    {
+        const osg::Vec3& c = bound->second.center();
+        double r = bound->second.radius();
+        box.min = { c.x() - r, c.y() - r, c.z() - r };
+        box.max = { c.x() + r, c.y() + r, c.z() + r };
+        node.geometricError = r / 20.0;
+    }
+    else
+    {
+        box.min = { 0.0, 0.0, 0.0 };
+        box.max = { 1.0, 1.0, 1.0 };
+    }
+    node.boundingVolume = BoundingVolumeFromTileBox(box);
+    node.contentUri = "./" + OSGBTools::Replace(OSGBTools::GetFileName(file), ".osgb", ".b3dm");
+
+    auto it = children.find(file);
+    if (it != children.end())
+    {
+        for (const auto& child : it->second)
+        {
+            if (!visited.count(child) && bounds.count(child))
+            {
+                node.children.emplace_back(build_tileset_node(child, children, bounds, visited));
+            }
+        }
+    }
+
+    return node;
+}
+
+bool parse_args(int argc, char* argv[], BenchmarkOptions& opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string key = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "[ERROR] 参数缺少取值: " << key << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        try
+        {
+            if (key == "--data") opt.data_dir = value;
+            else if (key == "--iterations") opt.iterations = std::max(1, std::stoi(value));
+            else if (key == "--max-files") opt.max_files = static_cast<size_t>(std::stoul(value));
+            else if (key == "--label") opt.label = value;
+            else if (key == "--out") opt.out_path = value;
+            else
+            {
+                std::cerr << "[ERROR] 未知参数: " << key << std::endl;
+                return false;
+            }
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "[ERROR] 参数取值无效: " << key << " " << value << std::endl;
+            return false;
+        }
+    }
+
+    return !opt.data_dir.empty();
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+
+    BenchmarkOptions opt;
+    if (!parse_args(argc, argv, opt))
+    {
+        std::cout << "用法: OSGBBenchmark --data <数据集目录> [--iterations 3] [--max-files 0] [--label dev] [--out result.json]" << std::endl;
+        return 1;
+    }
+
+    std::string scan_dir = opt.data_dir;
+    if (std::filesystem::is_directory(std::filesystem::path(opt.data_dir) / "Data"))
+    {
+        scan_dir = (std::filesystem::path(opt.data_dir) / "Data").generic_string();
+    }
+
+    std::vector<std::string> files = collect_osgb_files(scan_dir, opt.max_files);
+    if (files.empty())
+    {
+        std::cerr << "[ERROR] 未找到 OSGB 文件: " << scan_dir << std::endl;
+        return 1;
+    }
+
+    // 每次都执行完整转换，不使用 GLB 缓存
+    GlbCacheSettings cache_settings;
+    cache_settings.bEnable = false;
+    GlbCache::Global().Configure(cache_settings);
+
+    StageResult read{ "read" }, visit{ "visit" }, transform{ "transform" }, simplify{ "simplify" };
+    StageResult draco{ "draco" }, texture_jpeg{ "texture_jpeg" }, texture_ktx2{ "texture_ktx2" };
+    StageResult glb{ "glb" }, tileset{ "tileset_json" }, batch{ "batch" };
+
+    size_t triangle_count = 0;
+    size_t texture_count = 0;
+
+    // ENU 原点到 ECEF 的变换（与批量转换根节点 transform 相同的计算）
+    double enu_to_ecef[16];
+    OSGBTools::TransformC(114.3, 30.5, 0.0, enu_to_ecef);
+    osg::Matrixd ecef_matrix(enu_to_ecef);
+
+    OSGB23dTiles converter;
+    double checksum = 0.0;
+
+    for (int iteration = 0; iteration < opt.iterations; iteration++)
+    {
+        std::map<std::string, std::vector<std::string>> children;
+        std::map<std::string, osg::BoundingSphere> bounds;
+
+        for (const auto& file : files)
+        {
+            // 读取
+            auto start = Clock::now();
+            osg::ref_ptr<osg::Node> node = osgDB::readNodeFile(file);
+            read.samples_ms.push_back(elapsed_ms(start));
+            if (!node)
+            {
+                read.failures++;
+                continue;
+            }
+            std::error_code ec;
+            read.bytes += std::filesystem::file_size(file, ec);
+
+            // 遍历
+            start = Clock::now();
+            InfoVisitor visitor(OSGBTools::GetParent(file));
+            node->accept(visitor);
+            visit.samples_ms.push_back(elapsed_ms(start));
+
+            const std::vector<osg::Geometry*>& geometries = node_geometries(visitor);
+            children[file] = visitor.sub_node_names;
+            bounds[file] = node->getBound();
+
+            // 坐标变换：全部顶点从 ENU 变换到 ECEF
+            start = Clock::now();
+            for (auto geometry : geometries)
+            {
+                osg::Vec3Array* vertices = dynamic_cast<osg::Vec3Array*>(geometry->getVertexArray());
+                if (!vertices)
+                {
+                    continue;
+                }
+                for (const auto& v : *vertices)
+                {
+                    osg::Vec3d p = osg::Vec3d(v) * ecef_matrix;
+                    checksum += p.x();
+                }
+            }
+            transform.samples_ms.push_back(elapsed_ms(start));
+
+            for (auto geometry : geometries)
+            {
+                if (iteration == 0)
+                {
+                    for (unsigned k = 0; k < geometry->getNumPrimitiveSets(); k++)
+                    {
+                        triangle_count += geometry->getPrimitiveSet(k)->getNumIndices() / 3;
+                    }
+                }
+
+                // 网格简化（修改几何体，使用副本，复制不计时）
+                osg::ref_ptr<osg::Geometry> copy = copy_geometry(geometry);
+                SimplificationParams simplify_params;
+                simplify_params.bEnableSimplification = true;
+                start = Clock::now();
+                bool ok = MeshProcessor::SimplifyMeshGeometry(copy.get(), simplify_params);
+                simplify.samples_ms.push_back(elapsed_ms(start));
+                simplify.failures += ok ? 0 : 1;
+
+                // Draco
+                DracoCompressionParams draco_params;
+                draco_params.bEnableCompression = true;
+                std::vector<unsigned char> compressed;
+                size_t compressed_size = 0;
+                start = Clock::now();
+                ok = MeshProcessor::CompressMeshGeometry(geometry, draco_params, compressed, compressed_size);
+                draco.samples_ms.push_back(elapsed_ms(start));
+                draco.failures += ok ? 0 : 1;
+                draco.bytes += compressed_size;
+            }
+
+            // 纹理编码
+            for (auto texture : visitor.texture_array)
+            {
+                texture_count += iteration == 0 ? 1 : 0;
+
+                std::vector<unsigned char> image_data;
+                std::string mime_type;
+                start = Clock::now();
+                bool ok = MeshProcessor::ProcessTexture(texture, image_data, mime_type, false);
+                texture_jpeg.samples_ms.push_back(elapsed_ms(start));
+                texture_jpeg.failures += ok ? 0 : 1;
+                texture_jpeg.bytes += image_data.size();
+
+                image_data.clear();
+                start = Clock::now();
+                ok = MeshProcessor::ProcessTexture(texture, image_data, mime_type, true);
+                texture_ktx2.samples_ms.push_back(elapsed_ms(start));
+                texture_ktx2.failures += ok ? 0 : 1;
+                texture_ktx2.bytes += image_data.size();
+
+                // 未启用 KTX2 时回退为 JPEG
+                if (ok && mime_type != "image/ktx2")
+                {
+                    texture_ktx2.status = "unavailable";
+                }
+            }
+
+            // GLB 生成（单文件完整转换，含读取与遍历）
+            start = Clock::now();
+            std::vector<uint8_t> glb_data = converter.ToGLBBuf(file, -1, true, false, false, false);
+            glb.samples_ms.push_back(elapsed_ms(start));
+            glb.failures += glb_data.empty() ? 1 : 0;
+            glb.bytes += glb_data.size();
+        }
+
+        // tileset JSON：由文件引用关系生成节点树并序列化
+        auto start = Clock::now();
+        std::set<std::string> visited;
+        std::set<std::string> referenced;
+        for (const auto& item : children)
+        {
+            referenced.insert(item.second.begin(), item.second.end());
+        }
+        TilesetNode root;
+        root.geometricError = 1000.0;
+        TileBox root_box;
+        root_box.min = { 0.0, 0.0, 0.0 };
+        root_box.max = { 1.0, 1.0, 1.0 };
+        root.boundingVolume = BoundingVolumeFromTileBox(root_box);
+        for (const auto& item : children)
+        {
+            if (!referenced.count(item.first))
+            {
+                root.children.emplace_back(build_tileset_node(item.first, children, bounds, visited));
+            }
+        }
+        std::string tileset_json = root.ToJson(true);
+        tileset.samples_ms.push_back(elapsed_ms(start));
+        tileset.bytes += tileset_json.size();
+
+        // 批量转换整体耗时（输出丢弃，不写磁盘）
+        OSGB23dTiles batch_converter;
+        ResumeSettings resume;
+        resume.bEnable = false;
+        batch_converter.SetResumeSettings(resume);
+        NullSink sink;
+        start = Clock::now();
+        bool ok = batch_converter.ToB3DMBatch(opt.data_dir, "benchmark", 0.0, 0.0, -1, false, false, false, &sink);
+        batch.samples_ms.push_back(elapsed_ms(start));
+        batch.failures += ok ? 0 : 1;
+        batch.bytes += sink.GetTotalBytes();
+    }
+
+    // 可选功能未编译时对应函数直接返回失败
+    for (StageResult* stage : { &simplify, &draco })
+    {
+        if (!stage->samples_ms.empty() && stage->failures == stage->samples_ms.size())
+        {
+            stage->status = "unavailable";
+        }
+    }
+
+    nlohmann::ordered_json result;
+    result["schema"] = 1;
+    result["label"] = opt.label;
+    result["dataset"] = {
+        {"path", std::filesystem::path(opt.data_dir).filename().generic_string()},
+        {"files", files.size()},
+        {"triangles", triangle_count},
+        {"textures", texture_count}
+    };
+    result["iterations"] = opt.iterations;
+
+    nlohmann::ordered_json stages = nlohmann::ordered_json::array();
+    for (const StageResult* stage : { &read, &visit, &transform, &simplify, &draco,
+        &texture_jpeg, &texture_ktx2, &glb, &tileset, &batch })
+    {
+        stages.push_back(stage_json(*stage));
+    }
+    result["stages"] = stages;
+
+    std::string text = result.dump(2);
+    if (opt.out_path.empty())
+    {
+        std::cout << text << std::endl;
+    }
+    else
+    {
+        std::ofstream out(opt.out_path, std::ios::binary);
+        out << text << "\n";
+    }
+
+    // 防止坐标变换被优化掉
+    if (checksum == 0.123456789)
+    {
+        std::cerr << checksum << std::endl;
+    }
+
+    return 0;
+}
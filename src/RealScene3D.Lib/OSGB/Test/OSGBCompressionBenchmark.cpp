@@ -0,0 +1,1021 @@
+// ============================================================================
+// OSGB 压缩方案对比测试
+// 对数据集中抽样的 OSGB 文件逐一尝试每种几何与纹理压缩方案，统计编码耗时、输出字节数
+// （及 gzip 传输字节数）、解码耗时与误差，输出对比表，用于按数据集选择转换预设。
+//
+//   几何：raw（glTF 未压缩布局）、draco_q10/q11/q12/q14/q16（位置量化位数）、
+//         meshopt（EXT_meshopt_compression）、meshopt_q14（再加 KHR_mesh_quantization 量化）
+//         误差为解码顶点到原始顶点的最近距离（最大值与均方根，数据集坐标单位）
+//   纹理：raw_rgba、jpeg、ktx2_etc1s、ktx2_uastc
+//         误差为解码后 RGB 相对原始图像的 PSNR（dB）
+//
+// 解码分别使用 Draco 解码器、meshoptimizer 解码器、basisu 转码器（转码为 RGBA32）和 stb_image。
+//
+// 用法:
+//   OSGBCompressionBenchmark --data <数据集目录> [--sample 20] [--iterations 3] [--label dev]
+//                            [--out result.json] [--table result.md]
+//
+// 数据集可以是实际成果或 OSGBDatasetGenerator 生成的合成数据。--sample 从按路径排序的文件中
+// 等间隔抽取（0 表示全部）。对比表输出到控制台（及 --table 文件），完整结果为固定字段顺序的 JSON。
+// ============================================================================
+
+#include "Native/OSGB23dTiles.h"
+#include "Native/MeshProcessor.h"
+#include "Native/Precompressor.h"
+
+#include <osg/Texture>
+#include <osgDB/ReadFile>
+
+#include <draco/compression/decode.h>
+#include <draco/core/decoder_buffer.h>
+#include <meshoptimizer.h>
+#include <basisu/transcoder/basisu_transcoder.h>
+
+#include <json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+struct MatrixOptions
+{
+    std::string data_dir;
+    size_t sample = 20;
+    int iterations = 3;
+    std::string label = "dev";
+    std::string out_path;
+    std::string table_path;
+};
+
+// 一个几何体样本（与 Draco 压缩相同：只取第一个三角形图元集）
+struct MeshSample
+{
+    osg::ref_ptr<osg::Geometry> geometry;
+    std::vector<osg::Vec3f> positions;
+    std::vector<osg::Vec3f> normals;
+    std::vector<osg::Vec2f> uvs;
+    std::vector<uint32_t> indices;
+};
+
+// 一个纹理样本（原始 RGBA 作为误差基准）
+struct TextureSample
+{
+    osg::ref_ptr<osg::Texture> texture;
+    std::vector<unsigned char> rgba;
+    int width = 0;
+    int height = 0;
+};
+
+// 一种方案的统计结果
+struct ProfileResult
+{
+    std::string kind;
+    std::string name;
+    std::string status = "ok";
+    size_t items = 0;
+    size_t failures = 0;
+    uint64_t input_bytes = 0;
+    uint64_t output_bytes = 0;
+    uint64_t gzip_bytes = 0;
+
+    // 每个样本多次运行取中位数后累加
+    double encode_ms = 0.0;
+    double decode_ms = 0.0;
+
+    // 几何误差
+    double max_error = 0.0;
+    double squared_error = 0.0;
+    uint64_t error_points = 0;
+
+    // 纹理 PSNR
+    std::vector<double> psnr;
+};
+
+// 几何方案：编码为字节，解码出顶点位置
+struct GeometryCodec
+{
+    std::string name;
+    std::function<bool(const MeshSample&, std::vector<unsigned char>&)> encode;
+    std::function<bool(const std::vector<unsigned char>&, std::vector<osg::Vec3f>&)> decode;
+};
+
+// 纹理方案：编码为字节，解码为 RGBA
+struct TextureCodec
+{
+    std::string name;
+    std::function<bool(const TextureSample&, std::vector<unsigned char>&)> encode;
+    std::function<bool(const std::vector<unsigned char>&, const TextureSample&, std::vector<unsigned char>&)> decode;
+};
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ms(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double round3(double value)
+{
+    return std::round(value * 1000.0) / 1000.0;
+}
+
+double median(std::vector<double> values)
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+// 数据集中的 OSGB 文件（按路径排序后等间隔抽样，结果与文件系统遍历顺序无关）
+std::vector<std::string> sample_osgb_files(const std::string& data_dir, size_t sample)
+{
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(data_dir, ec))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".osgb")
+        {
+            files.emplace_back(entry.path().generic_string());
+        }
+    }
+
+    std::sort(files.begin(), files.end());
+    if (sample == 0 || files.size() <= sample)
+    {
+        return files;
+    }
+
+    std::vector<std::string> sampled;
+    for (size_t i = 0; i < sample; i++)
+    {
+        sampled.emplace_back(files[i * files.size() / sample]);
+    }
+    return sampled;
+}
+
+// ============================================================================
+// 样本提取
+// ============================================================================
+
+bool make_mesh_sample(osg::Geometry* geometry, MeshSample& sample)
+{
+    osg::Vec3Array* vertices = dynamic_cast<osg::Vec3Array*>(geometry->getVertexArray());
+    if (!vertices || vertices->empty() || geometry->getNumPrimitiveSets() == 0)
+    {
+        return false;
+    }
+
+    osg::PrimitiveSet* primitive = geometry->getPrimitiveSet(0);
+    if (primitive->getMode() != osg::PrimitiveSet::TRIANGLES || primitive->getNumIndices() < 3)
+    {
+        return false;
+    }
+
+    sample.geometry = geometry;
+    sample.positions.assign(vertices->begin(), vertices->end());
+
+    osg::Vec3Array* normals = dynamic_cast<osg::Vec3Array*>(geometry->getNormalArray());
+    if (normals && normals->size() == vertices->size())
+    {
+        sample.normals.assign(normals->begin(), normals->end());
+    }
+
+    osg::Vec2Array* uvs = dynamic_cast<osg::Vec2Array*>(geometry->getTexCoordArray(0));
+    if (uvs && uvs->size() == vertices->size())
+    {
+        sample.uvs.assign(uvs->begin(), uvs->end());
+    }
+
+    unsigned count = primitive->getNumIndices() / 3 * 3;
+    sample.indices.resize(count);
+    for (unsigned i = 0; i < count; i++)
+    {
+        sample.indices[i] = primitive->index(i);
+    }
+
+    return true;
+}
+
+// 原始图像转为紧密排列的 RGBA（支持 RGB / RGBA / BGRA，其他格式如 DXT 不参与对比）
+bool make_texture_sample(osg::Texture* texture, TextureSample& sample)
+{
+    osg::Image* image = texture->getNumImages() > 0 ? texture->getImage(0) : nullptr;
+    if (!image || !image->data() || image->s() <= 0 || image->t() <= 0)
+    {
+        return false;
+    }
+
+    GLenum format = image->getPixelFormat();
+    int channels = format == GL_RGB ? 3 : (format == GL_RGBA || format == GL_BGRA) ? 4 : 0;
+    if (channels == 0 || image->getDataType() != GL_UNSIGNED_BYTE)
+    {
+        return false;
+    }
+
+    sample.texture = texture;
+    sample.width = image->s();
+    sample.height = image->t();
+    sample.rgba.resize(static_cast<size_t>(sample.width) * sample.height * 4);
+
+    for (int row = 0; row < sample.height; row++)
+    {
+        const unsigned char* src = image->data(0, row);
+        unsigned char* dst = &sample.rgba[static_cast<size_t>(row) * sample.width * 4];
+        for (int col = 0; col < sample.width; col++, src += channels, dst += 4)
+        {
+            bool bgr = format == GL_BGRA;
+            dst[0] = src[bgr ? 2 : 0];
+            dst[1] = src[1];
+            dst[2] = src[bgr ? 0 : 2];
+            dst[3] = channels == 4 ? src[3] : 255;
+        }
+    }
+
+    return true;
+}
+
+// ============================================================================
+// 误差
+// ============================================================================
+
+// 原始顶点的均匀网格索引，用于查找解码顶点的最近原始顶点
+class PointGrid
+{
+public:
+    explicit PointGrid(const std::vector<osg::Vec3f>& points)
+        : points(points)
+    {
+        osg::BoundingBoxf box;
+        for (const auto& p : points)
+        {
+            box.expandBy(p);
+        }
+
+        // 平均每个单元约一个顶点
+        double extent = std::max({ box.xMax() - box.xMin(), box.yMax() - box.yMin(), box.zMax() - box.zMin(), 1e-6f });
+        cell = std::max(extent / std::cbrt(static_cast<double>(points.size())), 1e-6);
+
+        for (uint32_t i = 0; i < points.size(); i++)
+        {
+            cells[key(cell_of(points[i].x()), cell_of(points[i].y()), cell_of(points[i].z()))].push_back(i);
+        }
+    }
+
+    // 到最近原始顶点的距离
+    double nearest(const osg::Vec3f& p) const
+    {
+        int64_t cx = cell_of(p.x()), cy = cell_of(p.y()), cz = cell_of(p.z());
+        double best = std::numeric_limits<double>::max();
+
+        // 逐圈扩大搜索，圈外的点距离至少为 r * cell（解码顶点通常在前两圈内找到）
+        for (int64_t r = 0; r < 64; r++)
+        {
+            for (int64_t dx = -r; dx <= r; dx++)
+            {
+                for (int64_t dy = -r; dy <= r; dy++)
+                {
+                    for (int64_t dz = -r; dz <= r; dz++)
+                    {
+                        if (std::max({ std::llabs(dx), std::llabs(dy), std::llabs(dz) }) != r)
+                        {
+                            continue;
+                        }
+                        auto it = cells.find(key(cx + dx, cy + dy, cz + dz));
+                        if (it == cells.end())
+                        {
+                            continue;
+                        }
+                        for (uint32_t index : it->second)
+                        {
+                            best = std::min(best, static_cast<double>((points[index] - p).length()));
+                        }
+                    }
+                }
+            }
+
+            if (best <= r * cell)
+            {
+                break;
+            }
+        }
+
+        return best;
+    }
+
+private:
+    int64_t cell_of(float value) const
+    {
+        return static_cast<int64_t>(std::floor(value / cell));
+    }
+
+    static uint64_t key(int64_t x, int64_t y, int64_t z)
+    {
+        const uint64_t mask = (1ull << 21) - 1;
+        return (static_cast<uint64_t>(x) & mask) | ((static_cast<uint64_t>(y) & mask) << 21) | ((static_cast<uint64_t>(z) & mask) << 42);
+    }
+
+    const std::vector<osg::Vec3f>& points;
+    double cell = 1.0;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells;
+};
+
+// RGB 峰值信噪比（完全一致时记为 99 dB）
+double psnr_rgb(const std::vector<unsigned char>& reference, const std::vector<unsigned char>& decoded)
+{
+    if (reference.size() != decoded.size() || reference.empty())
+    {
+        return 0.0;
+    }
+
+    double squared = 0.0;
+    for (size_t i = 0; i < reference.size(); i += 4)
+    {
+        for (size_t c = 0; c < 3; c++)
+        {
+            double d = static_cast<double>(reference[i + c]) - decoded[i + c];
+            squared += d * d;
+        }
+    }
+
+    double mse = squared / (reference.size() / 4 * 3);
+    return mse == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+// ============================================================================
+// 几何方案
+// ============================================================================
+
+// glTF 未压缩布局：位置、法线、纹理坐标与 32 位索引各自连续存放
+GeometryCodec raw_codec()
+{
+    GeometryCodec codec;
+    codec.name = "raw";
+    codec.encode = [](const MeshSample& sample, std::vector<unsigned char>& out)
+    {
+        uint32_t header[2] = { static_cast<uint32_t>(sample.positions.size()), static_cast<uint32_t>(sample.indices.size()) };
+        out.clear();
+        auto append = [&out](const void* data, size_t size)
+        {
+            out.insert(out.end(), static_cast<const unsigned char*>(data), static_cast<const unsigned char*>(data) + size);
+        };
+        append(header, sizeof(header));
+        append(sample.positions.data(), sample.positions.size() * sizeof(osg::Vec3f));
+        append(sample.normals.data(), sample.normals.size() * sizeof(osg::Vec3f));
+        append(sample.uvs.data(), sample.uvs.size() * sizeof(osg::Vec2f));
+        append(sample.indices.data(), sample.indices.size() * sizeof(uint32_t));
+        return true;
+    };
+    codec.decode = [](const std::vector<unsigned char>& data, std::vector<osg::Vec3f>& positions)
+    {
+        uint32_t header[2];
+        std::memcpy(header, data.data(), sizeof(header));
+        positions.resize(header[0]);
+        std::memcpy(positions.data(), data.data() + sizeof(header), header[0] * sizeof(osg::Vec3f));
+        return true;
+    };
+    return codec;
+}
+
+// Draco：使用转换时的压缩函数，只改变位置量化位数
+GeometryCodec draco_codec(int nPositionBits)
+{
+    GeometryCodec codec;
+    codec.name = "draco_q" + std::to_string(nPositionBits);
+    codec.encode = [nPositionBits](const MeshSample& sample, std::vector<unsigned char>& out)
+    {
+        DracoCompressionParams params;
+        params.bEnableCompression = true;
+        params.nPositionQuantizationBits = nPositionBits;
+        size_t size = 0;
+        return MeshProcessor::CompressMeshGeometry(sample.geometry.get(), params, out, size);
+    };
+    codec.decode = [](const std::vector<unsigned char>& data, std::vector<osg::Vec3f>& positions)
+    {
+        draco::DecoderBuffer buffer;
+        buffer.Init(reinterpret_cast<const char*>(data.data()), data.size());
+        draco::Decoder decoder;
+        auto decoded = decoder.DecodeMeshFromBuffer(&buffer);
+        if (!decoded.ok())
+        {
+            return false;
+        }
+
+        std::unique_ptr<draco::Mesh> mesh = std::move(decoded).value();
+        const draco::PointAttribute* attribute = mesh->GetNamedAttribute(draco::GeometryAttribute::POSITION);
+        if (!attribute)
+        {
+            return false;
+        }
+
+        positions.resize(mesh->num_points());
+        for (draco::PointIndex i(0); i < mesh->num_points(); ++i)
+        {
+            float value[3];
+            attribute->GetValue(attribute->mapped_index(i), value);
+            positions[i.value()].set(value[0], value[1], value[2]);
+        }
+        return true;
+    };
+    return codec;
+}
+
+// meshopt 编码后数据的头部：解码所需的数量与位置反量化参数
+struct MeshoptHeader
+{
+    uint32_t vertex_count;
+    uint32_t index_count;
+    uint32_t vertex_bytes;
+    float offset[3];
+    float scale;
+};
+
+// meshoptimizer：优化顶点缓存与取数顺序后编码（EXT_meshopt_compression）。
+// nPositionBits 为 0 时顶点为 32 位浮点（32 字节/顶点），否则按 KHR_mesh_quantization
+// 量化为 16 位位置、8 位法线、16 位纹理坐标（16 字节/顶点）
+GeometryCodec meshopt_codec(int nPositionBits)
+{
+    GeometryCodec codec;
+    codec.name = nPositionBits == 0 ? "meshopt" : "meshopt_q" + std::to_string(nPositionBits);
+    const size_t stride = nPositionBits == 0 ? 32 : 16;
+
+    codec.encode = [nPositionBits, stride](const MeshSample& sample, std::vector<unsigned char>& out)
+    {
+        size_t vertex_count = sample.positions.size();
+
+        MeshoptHeader header{};
+        header.index_count = static_cast<uint32_t>(sample.indices.size());
+
+        osg::BoundingBoxf box;
+        for (const auto& p : sample.positions)
+        {
+            box.expandBy(p);
+        }
+        header.offset[0] = box.xMin();
+        header.offset[1] = box.yMin();
+        header.offset[2] = box.zMin();
+        header.scale = std::max({ box.xMax() - box.xMin(), box.yMax() - box.yMin(), box.zMax() - box.zMin(), 1e-6f });
+
+        // 交错顶点
+        std::vector<unsigned char> vertices(vertex_count * stride, 0);
+        for (size_t i = 0; i < vertex_count; i++)
+        {
+            unsigned char* v = &vertices[i * stride];
+            const osg::Vec3f& p = sample.positions[i];
+            osg::Vec3f n = sample.normals.empty() ? osg::Vec3f() : sample.normals[i];
+            osg::Vec2f uv = sample.uvs.empty() ? osg::Vec2f() : sample.uvs[i];
+
+            if (nPositionBits == 0)
+            {
+                float values[8] = { p.x(), p.y(), p.z(), n.x(), n.y(), n.z(), uv.x(), uv.y() };
+                std::memcpy(v, values, sizeof(values));
+                continue;
+            }
+
+            uint16_t position[4] = {
+                static_cast<uint16_t>(meshopt_quantizeUnorm((p.x() - header.offset[0]) / header.scale, nPositionBits)),
+                static_cast<uint16_t>(meshopt_quantizeUnorm((p.y() - header.offset[1]) / header.scale, nPositionBits)),
+                static_cast<uint16_t>(meshopt_quantizeUnorm((p.z() - header.offset[2]) / header.scale, nPositionBits)),
+                0
+            };
+            int8_t normal[4] = {
+                static_cast<int8_t>(meshopt_quantizeSnorm(n.x(), 8)),
+                static_cast<int8_t>(meshopt_quantizeSnorm(n.y(), 8)),
+                static_cast<int8_t>(meshopt_quantizeSnorm(n.z(), 8)),
+                0
+            };
+            uint16_t texcoord[2] = {
+                static_cast<uint16_t>(meshopt_quantizeUnorm(std::clamp(uv.x(), 0.0f, 1.0f), 16)),
+                static_cast<uint16_t>(meshopt_quantizeUnorm(std::clamp(uv.y(), 0.0f, 1.0f), 16))
+            };
+            std::memcpy(v, position, sizeof(position));
+            std::memcpy(v + 8, normal, sizeof(normal));
+            std::memcpy(v + 12, texcoord, sizeof(texcoord));
+        }
+
+        std::vector<uint32_t> indices(sample.indices);
+        meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertex_count);
+        // 取数顺序优化同时去掉未被引用的顶点
+        vertex_count = meshopt_optimizeVertexFetch(vertices.data(), indices.data(), indices.size(), vertices.data(), vertex_count, stride);
+        header.vertex_count = static_cast<uint32_t>(vertex_count);
+
+        std::vector<unsigned char> vertex_buffer(meshopt_encodeVertexBufferBound(vertex_count, stride));
+        vertex_buffer.resize(meshopt_encodeVertexBuffer(vertex_buffer.data(), vertex_buffer.size(), vertices.data(), vertex_count, stride));
+        std::vector<unsigned char> index_buffer(meshopt_encodeIndexBufferBound(indices.size(), vertex_count));
+        index_buffer.resize(meshopt_encodeIndexBuffer(index_buffer.data(), index_buffer.size(), indices.data(), indices.size()));
+        if (vertex_buffer.empty() || index_buffer.empty())
+        {
+            return false;
+        }
+
+        header.vertex_bytes = static_cast<uint32_t>(vertex_buffer.size());
+        out.resize(sizeof(header) + vertex_buffer.size() + index_buffer.size());
+        std::memcpy(out.data(), &header, sizeof(header));
+        std::memcpy(out.data() + sizeof(header), vertex_buffer.data(), vertex_buffer.size());
+        std::memcpy(out.data() + sizeof(header) + vertex_buffer.size(), index_buffer.data(), index_buffer.size());
+        return true;
+    };
+
+    codec.decode = [nPositionBits, stride](const std::vector<unsigned char>& data, std::vector<osg::Vec3f>& positions)
+    {
+        MeshoptHeader header;
+        std::memcpy(&header, data.data(), sizeof(header));
+        const unsigned char* vertex_data = data.data() + sizeof(header);
+        const unsigned char* index_data = vertex_data + header.vertex_bytes;
+
+        std::vector<unsigned char> vertices(header.vertex_count * stride);
+        std::vector<uint32_t> indices(header.index_count);
+        if (meshopt_decodeVertexBuffer(vertices.data(), header.vertex_count, stride, vertex_data, header.vertex_bytes) != 0 ||
+            meshopt_decodeIndexBuffer(indices.data(), indices.size(), sizeof(uint32_t), index_data,
+                data.size() - sizeof(header) - header.vertex_bytes) != 0)
+        {
+            return false;
+        }
+
+        positions.resize(header.vertex_count);
+        const float range = static_cast<float>((1 << nPositionBits) - 1);
+        for (size_t i = 0; i < positions.size(); i++)
+        {
+            const unsigned char* v = &vertices[i * stride];
+            if (nPositionBits == 0)
+            {
+                float values[3];
+                std::memcpy(values, v, sizeof(values));
+                positions[i].set(values[0], values[1], values[2]);
+                continue;
+            }
+
+            uint16_t position[3];
+            std::memcpy(position, v, sizeof(position));
+            for (int c = 0; c < 3; c++)
+            {
+                positions[i][c] = header.offset[c] + position[c] / range * header.scale;
+            }
+        }
+        return true;
+    };
+    return codec;
+}
+
+// ============================================================================
+// 纹理方案
+// ============================================================================
+
+// 使用 basisu 转码器把 KTX2 第 0 级转码为 RGBA32
+bool transcode_ktx2(const std::vector<unsigned char>& data, const TextureSample& sample, std::vector<unsigned char>& rgba)
+{
+    basist::ktx2_transcoder transcoder;
+    if (!transcoder.init(data.data(), static_cast<uint32_t>(data.size())) || !transcoder.start_transcoding())
+    {
+        return false;
+    }
+
+    basist::ktx2_image_level_info info;
+    if (!transcoder.get_image_level_info(info, 0, 0, 0) ||
+        static_cast<int>(info.m_orig_width) != sample.width || static_cast<int>(info.m_orig_height) != sample.height)
+    {
+        return false;
+    }
+
+    rgba.resize(static_cast<size_t>(info.m_orig_width) * info.m_orig_height * 4);
+    return transcoder.transcode_image_level(0, 0, 0, rgba.data(), info.m_orig_width * info.m_orig_height,
+        basist::transcoder_texture_format::cTFRGBA32, 0, info.m_orig_width, nullptr, info.m_orig_height);
+}
+
+std::vector<TextureCodec> texture_codecs()
+{
+    std::vector<TextureCodec> codecs;
+
+    codecs.push_back({ "raw_rgba",
+        [](const TextureSample& sample, std::vector<unsigned char>& out)
+        {
+            out = sample.rgba;
+            return true;
+        },
+        [](const std::vector<unsigned char>& data, const TextureSample&, std::vector<unsigned char>& rgba)
+        {
+            rgba = data;
+            return true;
+        } });
+
+    // JPEG 与 ETC1S 使用转换时的纹理处理函数
+    codecs.push_back({ "jpeg",
+        [](const TextureSample& sample, std::vector<unsigned char>& out)
+        {
+            std::string mime_type;
+            return MeshProcessor::ProcessTexture(sample.texture.get(), out, mime_type, false) && mime_type == "image/jpeg";
+        },
+        [](const std::vector<unsigned char>& data, const TextureSample& sample, std::vector<unsigned char>& rgba)
+        {
+            int width = 0, height = 0, channels = 0;
+            unsigned char* pixels = stbi_load_from_memory(data.data(), static_cast<int>(data.size()), &width, &height, &channels, 4);
+            if (!pixels)
+            {
+                return false;
+            }
+            rgba.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+            stbi_image_free(pixels);
+            return width == sample.width && height == sample.height;
+        } });
+
+    codecs.push_back({ "ktx2_etc1s",
+        [](const TextureSample& sample, std::vector<unsigned char>& out)
+        {
+            std::string mime_type;
+            return MeshProcessor::ProcessTexture(sample.texture.get(), out, mime_type, true) && mime_type == "image/ktx2";
+        },
+        transcode_ktx2 });
+
+    codecs.push_back({ "ktx2_uastc",
+        [](const TextureSample& sample, std::vector<unsigned char>& out)
+        {
+            return MeshProcessor::CompressToKtx2(sample.rgba, sample.width, sample.height, out,
+                static_cast<int>(basist::basis_tex_format::cUASTC4x4));
+        },
+        transcode_ktx2 });
+
+    return codecs;
+}
+
+// ============================================================================
+// 测试执行
+// ============================================================================
+
+// gzip 后的传输字节数（未编译 zlib 时为 0）
+uint64_t gzip_size(const std::vector<unsigned char>& data)
+{
+    std::string compressed;
+    if (!Precompressor::IsGzipAvailable() ||
+        !Precompressor::Gzip(reinterpret_cast<const char*>(data.data()), data.size(), compressed, 6))
+    {
+        return 0;
+    }
+    return compressed.size();
+}
+
+uint64_t raw_geometry_bytes(const MeshSample& sample)
+{
+    return sample.positions.size() * sizeof(osg::Vec3f) + sample.normals.size() * sizeof(osg::Vec3f) +
+        sample.uvs.size() * sizeof(osg::Vec2f) + sample.indices.size() * sizeof(uint32_t);
+}
+
+void run_geometry(const GeometryCodec& codec, const MeshSample& sample, const PointGrid& grid, int iterations, ProfileResult& result)
+{
+    result.items++;
+    result.input_bytes += raw_geometry_bytes(sample);
+
+    std::vector<unsigned char> encoded;
+    std::vector<osg::Vec3f> decoded;
+    std::vector<double> encode_samples, decode_samples;
+    for (int i = 0; i < iterations; i++)
+    {
+        auto start = Clock::now();
+        bool ok = codec.encode(sample, encoded);
+        encode_samples.push_back(elapsed_ms(start));
+        if (!ok || encoded.empty())
+        {
+            result.failures++;
+            return;
+        }
+
+        start = Clock::now();
+        ok = codec.decode(encoded, decoded);
+        decode_samples.push_back(elapsed_ms(start));
+        if (!ok)
+        {
+            result.failures++;
+            return;
+        }
+    }
+
+    result.encode_ms += median(encode_samples);
+    result.decode_ms += median(decode_samples);
+    result.output_bytes += encoded.size();
+    result.gzip_bytes += gzip_size(encoded);
+
+    for (const auto& p : decoded)
+    {
+        double error = grid.nearest(p);
+        result.max_error = std::max(result.max_error, error);
+        result.squared_error += error * error;
+        result.error_points++;
+    }
+}
+
+void run_texture(const TextureCodec& codec, const TextureSample& sample, int iterations, ProfileResult& result)
+{
+    result.items++;
+    result.input_bytes += sample.rgba.size();
+
+    std::vector<unsigned char> encoded;
+    std::vector<unsigned char> decoded;
+    std::vector<double> encode_samples, decode_samples;
+    for (int i = 0; i < iterations; i++)
+    {
+        encoded.clear();
+        auto start = Clock::now();
+        bool ok = codec.encode(sample, encoded);
+        encode_samples.push_back(elapsed_ms(start));
+        if (!ok || encoded.empty())
+        {
+            result.failures++;
+            return;
+        }
+
+        start = Clock::now();
+        ok = codec.decode(encoded, sample, decoded);
+        decode_samples.push_back(elapsed_ms(start));
+        if (!ok)
+        {
+            result.failures++;
+            return;
+        }
+    }
+
+    result.encode_ms += median(encode_samples);
+    result.decode_ms += median(decode_samples);
+    result.output_bytes += encoded.size();
+    result.gzip_bytes += gzip_size(encoded);
+    result.psnr.push_back(psnr_rgb(sample.rgba, decoded));
+}
+
+nlohmann::ordered_json profile_json(const ProfileResult& profile)
+{
+    nlohmann::ordered_json j;
+    j["kind"] = profile.kind;
+    j["name"] = profile.name;
+    j["status"] = profile.status;
+    j["items"] = profile.items;
+    j["failures"] = profile.failures;
+    j["input_bytes"] = profile.input_bytes;
+    j["output_bytes"] = profile.output_bytes;
+    j["gzip_bytes"] = profile.gzip_bytes;
+    j["ratio"] = round3(profile.output_bytes > 0 ? static_cast<double>(profile.input_bytes) / profile.output_bytes : 0.0);
+    j["encode_ms"] = round3(profile.encode_ms);
+    j["decode_ms"] = round3(profile.decode_ms);
+
+    if (profile.kind == "geometry")
+    {
+        j["max_error"] = profile.max_error;
+        j["rms_error"] = profile.error_points > 0 ? std::sqrt(profile.squared_error / profile.error_points) : 0.0;
+    }
+    else
+    {
+        double sum = 0.0;
+        for (double v : profile.psnr)
+        {
+            sum += v;
+        }
+        j["psnr_db_mean"] = round3(profile.psnr.empty() ? 0.0 : sum / profile.psnr.size());
+        j["psnr_db_min"] = round3(profile.psnr.empty() ? 0.0 : *std::min_element(profile.psnr.begin(), profile.psnr.end()));
+    }
+    return j;
+}
+
+// Markdown 对比表
+std::string comparison_table(const nlohmann::ordered_json& profiles)
+{
+    std::ostringstream table;
+    table << "| 类型 | 方案 | 样本 | 输出字节 | 压缩比 | gzip字节 | 编码ms | 解码ms | 误差 |\n";
+    table << "|---|---|---:|---:|---:|---:|---:|---:|---|\n";
+    for (const auto& profile : profiles)
+    {
+        std::ostringstream error;
+        if (profile["status"] != "ok")
+        {
+            error << profile["status"].get<std::string>();
+        }
+        else if (profile["kind"] == "geometry")
+        {
+            error << "max " << profile["max_error"].get<double>() << " / rms " << profile["rms_error"].get<double>();
+        }
+        else
+        {
+            error << "PSNR " << profile["psnr_db_mean"].get<double>() << " dB (min " << profile["psnr_db_min"].get<double>() << ")";
+        }
+
+        table << "| " << profile["kind"].get<std::string>()
+            << " | " << profile["name"].get<std::string>()
+            << " | " << profile["items"].get<size_t>()
+            << " | " << profile["output_bytes"].get<uint64_t>()
+            << " | " << profile["ratio"].get<double>()
+            << " | " << profile["gzip_bytes"].get<uint64_t>()
+            << " | " << profile["encode_ms"].get<double>()
+            << " | " << profile["decode_ms"].get<double>()
+            << " | " << error.str() << " |\n";
+    }
+    return table.str();
+}
+
+bool parse_args(int argc, char* argv[], MatrixOptions& opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string key = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "[ERROR] 参数缺少取值: " << key << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        try
+        {
+            if (key == "--data") opt.data_dir = value;
+            else if (key == "--sample") opt.sample = static_cast<size_t>(std::stoul(value));
+            else if (key == "--iterations") opt.iterations = std::max(1, std::stoi(value));
+            else if (key == "--label") opt.label = value;
+            else if (key == "--out") opt.out_path = value;
+            else if (key == "--table") opt.table_path = value;
+            else
+            {
+                std::cerr << "[ERROR] 未知参数: " << key << std::endl;
+                return false;
+            }
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "[ERROR] 参数取值无效: " << key << " " << value << std::endl;
+            return false;
+        }
+    }
+
+    return !opt.data_dir.empty();
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+
+    MatrixOptions opt;
+    if (!parse_args(argc, argv, opt))
+    {
+        std::cout << "用法: OSGBCompressionBenchmark --data <数据集目录> [--sample 20] [--iterations 3] [--label dev] [--out result.json] [--table result.md]" << std::endl;
+        return 1;
+    }
+
+    std::string scan_dir = opt.data_dir;
+    if (std::filesystem::is_directory(std::filesystem::path(opt.data_dir) / "Data"))
+    {
+        scan_dir = (std::filesystem::path(opt.data_dir) / "Data").generic_string();
+    }
+
+    std::vector<std::string> files = sample_osgb_files(scan_dir, opt.sample);
+    if (files.empty())
+    {
+        std::cerr << "[ERROR] 未找到 OSGB 文件: " << scan_dir << std::endl;
+        return 1;
+    }
+
+    basist::basisu_transcoder_init();
+
+    std::vector<GeometryCodec> geometry_codecs = { raw_codec() };
+    for (int bits : { 10, 11, 12, 14, 16 })
+    {
+        geometry_codecs.push_back(draco_codec(bits));
+    }
+    geometry_codecs.push_back(meshopt_codec(0));
+    geometry_codecs.push_back(meshopt_codec(14));
+
+    std::vector<TextureCodec> image_codecs = texture_codecs();
+
+    std::vector<ProfileResult> geometry_results(geometry_codecs.size());
+    for (size_t k = 0; k < geometry_codecs.size(); k++)
+    {
+        geometry_results[k].kind = "geometry";
+        geometry_results[k].name = geometry_codecs[k].name;
+    }
+    std::vector<ProfileResult> texture_results(image_codecs.size());
+    for (size_t k = 0; k < image_codecs.size(); k++)
+    {
+        texture_results[k].kind = "texture";
+        texture_results[k].name = image_codecs[k].name;
+    }
+
+    size_t vertex_count = 0, triangle_count = 0, texel_count = 0;
+    size_t mesh_count = 0, texture_count = 0, skipped_meshes = 0, skipped_textures = 0;
+
+    for (const auto& file : files)
+    {
+        osg::ref_ptr<osg::Node> node = osgDB::readNodeFile(file);
+        if (!node)
+        {
+            std::cerr << "[WARN] 读取失败: " << file << std::endl;
+            continue;
+        }
+
+        InfoVisitor visitor(OSGBTools::GetParent(file));
+        node->accept(visitor);
+
+        // 与转换时相同的几何体选择：没有 PagedLOD 几何体时使用普通几何体
+        const std::vector<osg::Geometry*>& geometries =
+            visitor.geometry_array.empty() ? visitor.other_geometry_array : visitor.geometry_array;
+        for (auto geometry : geometries)
+        {
+            MeshSample sample;
+            if (!make_mesh_sample(geometry, sample))
+            {
+                skipped_meshes++;
+                continue;
+            }
+
+            mesh_count++;
+            vertex_count += sample.positions.size();
+            triangle_count += sample.indices.size() / 3;
+
+            PointGrid grid(sample.positions);
+            for (size_t k = 0; k < geometry_codecs.size(); k++)
+            {
+                run_geometry(geometry_codecs[k], sample, grid, opt.iterations, geometry_results[k]);
+            }
+        }
+
+        for (auto texture : visitor.texture_array)
+        {
+            TextureSample sample;
+            if (!make_texture_sample(texture, sample))
+            {
+                skipped_textures++;
+                continue;
+            }
+
+            texture_count++;
+            texel_count += static_cast<size_t>(sample.width) * sample.height;
+            for (size_t k = 0; k < image_codecs.size(); k++)
+            {
+                run_texture(image_codecs[k], sample, opt.iterations, texture_results[k]);
+            }
+        }
+    }
+
+    nlohmann::ordered_json result;
+    result["schema"] = 1;
+    result["label"] = opt.label;
+    result["dataset"] = {
+        {"path", std::filesystem::path(opt.data_dir).filename().generic_string()},
+        {"files", files.size()},
+        {"meshes", mesh_count},
+        {"vertices", vertex_count},
+        {"triangles", triangle_count},
+        {"textures", texture_count},
+        {"texels", texel_count},
+        {"skipped_meshes", skipped_meshes},
+        {"skipped_textures", skipped_textures}
+    };
+    result["iterations"] = opt.iterations;
+
+    nlohmann::ordered_json profiles = nlohmann::ordered_json::array();
+    for (std::vector<ProfileResult>* group : { &geometry_results, &texture_results })
+    {
+        for (ProfileResult& profile : *group)
+        {
+            // 可选功能未编译时（如未启用 KTX2 时回退为 JPEG）所有样本都失败
+            if (profile.items > 0 && profile.failures == profile.items)
+            {
+                profile.status = "unavailable";
+            }
+            profiles.push_back(profile_json(profile));
+        }
+    }
+    result["profiles"] = profiles;
+
+    std::string table = comparison_table(profiles);
+    std::cout << table;
+    if (!opt.table_path.empty())
+    {
+        std::ofstream out(opt.table_path, std::ios::binary);
+        out << table;
+    }
+
+    std::string text = result.dump(2);
+    if (opt.out_path.empty())
+    {
+        std::cout << "\n" << text << std::endl;
+    }
+    else
+    {
+        std::ofstream out(opt.out_path, std::ios::binary);
+        out << text << "\n";
+    }
+
+    return 0;
+}
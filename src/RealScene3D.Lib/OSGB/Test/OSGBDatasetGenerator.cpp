@@ -0,0 +1,334 @@
+// ============================================================================
+// 合成 OSGB 数据集生成器
+// 生成与倾斜摄影成果相同布局的 PagedLOD 金字塔（Data/Tile_*/*.osgb + metadata.xml），
+// 用于在任意构建机上复现性能测试
+//
+// 用法:
+//   OSGBDatasetGenerator --out <目录> [--grid 2] [--depth 3] [--triangles 2000]
+//                        [--texture 256] [--tile-size 100] [--base-level 16] [--seed 1]
+//                        [--srs ENU:30.5,114.3] [--origin 0,0,0]
+// ============================================================================
+
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/Group>
+#include <osg/Image>
+#include <osg/PagedLOD>
+#include <osg/Texture2D>
+#include <osgDB/Options>
+#include <osgDB/Registry>
+#include <osgDB/WriteFile>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// 与主库一致：Linux/macOS 静态注册 osg 插件
+#if defined(__unix__) || defined(__APPLE__)
+USE_OSGPLUGIN(osg)
+#endif
+
+struct GeneratorOptions
+{
+    std::string out_dir;
+    int grid = 2;               // 瓦片网格边长（grid x grid 个瓦片）
+    int depth = 3;              // 根节点以下的层数（四叉树）
+    int triangles = 2000;       // 每个节点的三角形数
+    int texture = 256;          // 每个节点的纹理边长（像素）
+    double tile_size = 100.0;   // 瓦片边长（米）
+    int base_level = 16;        // 根节点以下第一层的 _L 层级
+    unsigned seed = 1;          // 地形与纹理的随机种子
+    std::string srs = "ENU:30.5,114.3";
+    std::string origin = "0,0,0";
+};
+
+struct GeneratorStats
+{
+    size_t files = 0;
+    size_t nodes = 0;
+    size_t triangles = 0;
+    uint64_t bytes = 0;
+};
+
+// 确定性的整数哈希噪声，结果在 [0, 1)
+double hash_noise(int x, int y, unsigned seed)
+{
+    uint32_t h = static_cast<uint32_t>(x) * 374761393u + static_cast<uint32_t>(y) * 668265263u + seed * 2246822519u;
+    h = (h ^ (h >> 13)) * 1274126177u;
+    h ^= h >> 16;
+    return (h & 0xFFFFFF) / static_cast<double>(0x1000000);
+}
+
+// 地形高度：若干正弦起伏叠加小尺度噪声，相邻节点在边界处连续
+double terrain_height(double x, double y, unsigned seed)
+{
+    double phase = seed * 0.37;
+    double z = 8.0 * std::sin(x * 0.021 + phase) * std::cos(y * 0.017 - phase)
+        + 3.0 * std::sin(x * 0.083 + y * 0.061 + phase)
+        + 1.2 * std::cos(x * 0.31 - y * 0.27);
+    return z + 0.4 * hash_noise(static_cast<int>(std::floor(x * 2.0)), static_cast<int>(std::floor(y * 2.0)), seed);
+}
+
+// 生成节点几何体：覆盖 [x0, x0 + size] x [y0, y0 + size] 的规则网格，带纹理坐标与内嵌纹理
+osg::ref_ptr<osg::Geode> make_node_geode(const GeneratorOptions& opt, double x0, double y0, double size, size_t& triangles)
+{
+    int cells = std::max(1, static_cast<int>(std::lround(std::sqrt(opt.triangles / 2.0))));
+
+    osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
+    osg::ref_ptr<osg::Vec2Array> uvs = new osg::Vec2Array;
+    vertices->reserve((cells + 1) * (cells + 1));
+    uvs->reserve((cells + 1) * (cells + 1));
+
+    for (int j = 0; j <= cells; j++)
+    {
+        for (int i = 0; i <= cells; i++)
+        {
+            double x = x0 + size * i / cells;
+            double y = y0 + size * j / cells;
+            vertices->push_back(osg::Vec3(static_cast<float>(x), static_cast<float>(y),
+                static_cast<float>(terrain_height(x, y, opt.seed))));
+            uvs->push_back(osg::Vec2(static_cast<float>(i) / cells, static_cast<float>(j) / cells));
+        }
+    }
+
+    osg::ref_ptr<osg::DrawElementsUInt> indices = new osg::DrawElementsUInt(GL_TRIANGLES);
+    indices->reserve(cells * cells * 6);
+    for (int j = 0; j < cells; j++)
+    {
+        for (int i = 0; i < cells; i++)
+        {
+            unsigned a = j * (cells + 1) + i;
+            unsigned b = a + 1;
+            unsigned c = a + (cells + 1);
+            unsigned d = c + 1;
+            indices->push_back(a); indices->push_back(b); indices->push_back(d);
+            indices->push_back(a); indices->push_back(d); indices->push_back(c);
+        }
+    }
+    triangles += static_cast<size_t>(cells) * cells * 2;
+
+    osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+    geometry->setVertexArray(vertices.get());
+    geometry->setTexCoordArray(0, uvs.get());
+    geometry->addPrimitiveSet(indices.get());
+
+    // 纹理：按高度着色并叠加噪声，压缩特性接近航拍影像
+    int s = std::max(4, opt.texture);
+    osg::ref_ptr<osg::Image> image = new osg::Image;
+    image->allocateImage(s, s, 1, GL_RGB, GL_UNSIGNED_BYTE);
+    unsigned char* pixels = image->data();
+    for (int v = 0; v < s; v++)
+    {
+        for (int u = 0; u < s; u++)
+        {
+            double x = x0 + size * (u + 0.5) / s;
+            double y = y0 + size * (v + 0.5) / s;
+            double shade = 0.5 + terrain_height(x, y, opt.seed) / 30.0;
+            double noise = hash_noise(static_cast<int>(x * 8.0), static_cast<int>(y * 8.0), opt.seed + 7);
+            unsigned char* p = pixels + (static_cast<size_t>(v) * s + u) * 3;
+            p[0] = static_cast<unsigned char>(std::clamp(60.0 + 120.0 * shade + 40.0 * noise, 0.0, 255.0));
+            p[1] = static_cast<unsigned char>(std::clamp(80.0 + 110.0 * shade + 30.0 * noise, 0.0, 255.0));
+            p[2] = static_cast<unsigned char>(std::clamp(50.0 + 70.0 * shade + 50.0 * noise, 0.0, 255.0));
+        }
+    }
+
+    osg::ref_ptr<osg::Texture2D> texture = new osg::Texture2D(image.get());
+    texture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+    texture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+    geometry->getOrCreateStateSet()->setTextureAttributeAndModes(0, texture.get(), osg::StateAttribute::ON);
+
+    osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+    geode->addDrawable(geometry.get());
+    return geode;
+}
+
+// 子节点组文件名：node_path 的四个子节点位于同一个文件
+std::string group_file_name(const std::string& tile_name, int level, const std::string& node_path)
+{
+    return tile_name + "_L" + std::to_string(level) + "_" + node_path + ".osgb";
+}
+
+bool write_file(const osg::Node& node, const std::filesystem::path& path, GeneratorStats& stats)
+{
+    static osg::ref_ptr<osgDB::Options> options = new osgDB::Options("WriteImageHint=IncludeData");
+    if (!osgDB::writeNodeFile(node, path.string(), options.get()))
+    {
+        std::cerr << "[ERROR] 写入失败: " << path.string() << std::endl;
+        return false;
+    }
+
+    std::error_code ec;
+    stats.files++;
+    stats.bytes += std::filesystem::file_size(path, ec);
+    return true;
+}
+
+// 生成一个节点的 PagedLOD：child 0 为本节点几何体，depth 未到底时 file 1 指向子节点组文件
+osg::ref_ptr<osg::PagedLOD> make_node(const GeneratorOptions& opt, const std::filesystem::path& tile_dir,
+    const std::string& tile_name, const std::string& node_path, int depth,
+    double x0, double y0, double size, GeneratorStats& stats, bool& ok);
+
+// 写出 node_path 的四个子节点（一个组文件）
+bool write_children(const GeneratorOptions& opt, const std::filesystem::path& tile_dir,
+    const std::string& tile_name, const std::string& node_path, int depth,
+    double x0, double y0, double size, GeneratorStats& stats)
+{
+    bool ok = true;
+    double half = size / 2.0;
+    osg::ref_ptr<osg::Group> group = new osg::Group;
+    for (int q = 0; q < 4; q++)
+    {
+        double cx = x0 + (q & 1) * half;
+        double cy = y0 + (q >> 1) * half;
+        group->addChild(make_node(opt, tile_dir, tile_name, node_path + std::to_string(q), depth + 1,
+            cx, cy, half, stats, ok).get());
+    }
+
+    std::string file_name = group_file_name(tile_name, opt.base_level + depth, node_path);
+    return write_file(*group, tile_dir / file_name, stats) && ok;
+}
+
+osg::ref_ptr<osg::PagedLOD> make_node(const GeneratorOptions& opt, const std::filesystem::path& tile_dir,
+    const std::string& tile_name, const std::string& node_path, int depth,
+    double x0, double y0, double size, GeneratorStats& stats, bool& ok)
+{
+    stats.nodes++;
+
+    double cx = x0 + size / 2.0;
+    double cy = y0 + size / 2.0;
+
+    osg::ref_ptr<osg::PagedLOD> lod = new osg::PagedLOD;
+    lod->setCenterMode(osg::LOD::USER_DEFINED_CENTER);
+    lod->setCenter(osg::Vec3(static_cast<float>(cx), static_cast<float>(cy), static_cast<float>(terrain_height(cx, cy, opt.seed))));
+    lod->setRadius(static_cast<float>(size * 0.75));
+    lod->setRangeMode(osg::LOD::PIXEL_SIZE_ON_SCREEN);
+    lod->addChild(make_node_geode(opt, x0, y0, size, stats.triangles).get(), 0.0f, 512.0f);
+
+    if (depth < opt.depth)
+    {
+        lod->setFileName(1, group_file_name(tile_name, opt.base_level + depth, node_path));
+        lod->setRange(1, 512.0f, 1e30f);
+        ok = write_children(opt, tile_dir, tile_name, node_path, depth, x0, y0, size, stats) && ok;
+    }
+
+    return lod;
+}
+
+std::string tile_index_name(int i)
+{
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "%+04d", i);
+    return buf;
+}
+
+bool write_metadata(const GeneratorOptions& opt)
+{
+    std::ofstream out(std::filesystem::path(opt.out_dir) / "metadata.xml");
+    out << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+        << "<ModelMetadata version=\"1\">\n"
+        << "\t<SRS>" << opt.srs << "</SRS>\n"
+        << "\t<SRSOrigin>" << opt.origin << "</SRSOrigin>\n"
+        << "\t<Texture>\n\t\t<ColorSource>Visible</ColorSource>\n\t</Texture>\n"
+        << "</ModelMetadata>\n";
+    return static_cast<bool>(out);
+}
+
+bool parse_args(int argc, char* argv[], GeneratorOptions& opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string key = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "[ERROR] 参数缺少取值: " << key << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        try
+        {
+            if (key == "--out") opt.out_dir = value;
+            else if (key == "--grid") opt.grid = std::stoi(value);
+            else if (key == "--depth") opt.depth = std::stoi(value);
+            else if (key == "--triangles") opt.triangles = std::stoi(value);
+            else if (key == "--texture") opt.texture = std::stoi(value);
+            else if (key == "--tile-size") opt.tile_size = std::stod(value);
+            else if (key == "--base-level") opt.base_level = std::stoi(value);
+            else if (key == "--seed") opt.seed = static_cast<unsigned>(std::stoul(value));
+            else if (key == "--srs") opt.srs = value;
+            else if (key == "--origin") opt.origin = value;
+            else
+            {
+                std::cerr << "[ERROR] 未知参数: " << key << std::endl;
+                return false;
+            }
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "[ERROR] 参数取值无效: " << key << " " << value << std::endl;
+            return false;
+        }
+    }
+
+    return !opt.out_dir.empty() && opt.grid > 0 && opt.depth >= 0 && opt.triangles > 0;
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+
+    GeneratorOptions opt;
+    if (!parse_args(argc, argv, opt))
+    {
+        std::cout << "用法: OSGBDatasetGenerator --out <目录> [--grid 2] [--depth 3] [--triangles 2000]" << std::endl;
+        std::cout << "                            [--texture 256] [--tile-size 100] [--base-level 16] [--seed 1]" << std::endl;
+        std::cout << "                            [--srs ENU:30.5,114.3] [--origin 0,0,0]" << std::endl;
+        return 1;
+    }
+
+    std::filesystem::path data_dir = std::filesystem::path(opt.out_dir) / "Data";
+    std::filesystem::create_directories(data_dir);
+
+    GeneratorStats stats;
+    bool ok = write_metadata(opt);
+
+    for (int ty = 0; ty < opt.grid && ok; ty++)
+    {
+        for (int tx = 0; tx < opt.grid && ok; tx++)
+        {
+            std::string tile_name = "Tile_" + tile_index_name(tx) + "_" + tile_index_name(ty);
+            std::filesystem::path tile_dir = data_dir / tile_name;
+            std::filesystem::create_directories(tile_dir);
+
+            // 根文件（无层级编号）：最粗一级几何体，子节点组文件为 _L<base-level>_0
+            osg::ref_ptr<osg::PagedLOD> root = make_node(opt, tile_dir, tile_name, "0", 0,
+                tx * opt.tile_size, ty * opt.tile_size, opt.tile_size, stats, ok);
+            ok = ok && write_file(*root, tile_dir / (tile_name + ".osgb"), stats);
+        }
+    }
+
+    if (!ok)
+    {
+        std::cerr << "[FAILED] 数据集生成失败" << std::endl;
+        return 1;
+    }
+
+    std::cout << "{\"tiles\":" << opt.grid * opt.grid
+        << ",\"files\":" << stats.files
+        << ",\"nodes\":" << stats.nodes
+        << ",\"triangles\":" << stats.triangles
+        << ",\"bytes\":" << stats.bytes << "}" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,480 @@
+// ============================================================================
+// 不依赖 OSGB 数据集的单元测试
+//
+// 用法:
+//   OSGBUnitTest            运行全部测试
+//   OSGBUnitTest <名称>     只运行名称以参数开头的测试（如 glb_cache）
+// ============================================================================
+
+#include "Native/GlbCache.h"
+#include "Native/SubsetFilter.h"
+#include "Native/TileArchiveReader.h"
+#include "Native/TileArchiveWriter.h"
+#include "Native/ZipFileSystem.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace
+{
+    // 测试用临时目录，每个测试开始时清空
+    std::filesystem::path test_dir(const std::string& name)
+    {
+        std::filesystem::path dir = std::filesystem::temp_directory_path() / "osgb_unit_test" / name;
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        return dir;
+    }
+
+    std::string write_file(const std::filesystem::path& path, const std::string& content)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << content;
+        return path.string();
+    }
+
+    bool check(bool condition, const std::string& message)
+    {
+        if (!condition)
+        {
+            std::cerr << "  断言失败: " << message << std::endl;
+        }
+        return condition;
+    }
+
+    // 返回固定长度数据的转换函数，并记录调用次数
+    GlbCache::Producer counting_producer(size_t size, int& calls)
+    {
+        return [size, &calls](std::string& data)
+        {
+            calls++;
+            data.assign(size, 'g');
+            return true;
+        };
+    }
+}
+
+bool test_glb_cache_lru_eviction()
+{
+    std::filesystem::path dir = test_dir("glb_cache_lru");
+    std::string a = write_file(dir / "a.osgb", "a");
+    std::string b = write_file(dir / "b.osgb", "b");
+    std::string c = write_file(dir / "c.osgb", "c");
+
+    GlbCacheSettings settings;
+    settings.nMaxBytes = 10;
+    GlbCache cache(settings);
+
+    int calls = 0;
+    std::shared_ptr<const std::string> data;
+    cache.GetOrCreate(a, "opt", data, counting_producer(4, calls));
+    cache.GetOrCreate(b, "opt", data, counting_producer(4, calls));
+
+    // 访问 a 后 b 成为最近最少使用的条目，插入 c 时被淘汰
+    cache.GetOrCreate(a, "opt", data, counting_producer(4, calls));
+    cache.GetOrCreate(c, "opt", data, counting_producer(4, calls));
+
+    GlbCacheStats stats = cache.GetStats();
+    bool bOk = check(calls == 3, "a 命中时不应再次转换") &
+        check(stats.nEvictions == 1, "应淘汰 1 个条目") &
+        check(stats.nEntries == 2 && stats.nBytes == 8, "应保留 a 与 c");
+
+    int a_calls = 0;
+    cache.GetOrCreate(a, "opt", data, counting_producer(4, a_calls));
+    int b_calls = 0;
+    cache.GetOrCreate(b, "opt", data, counting_producer(4, b_calls));
+
+    bOk &= check(a_calls == 0, "a 应仍在缓存中") & check(b_calls == 1, "b 应已被淘汰");
+
+    // 不同转换参数分别缓存
+    int opt_calls = 0;
+    cache.GetOrCreate(c, "other", data, counting_producer(4, opt_calls));
+    bOk &= check(opt_calls == 1, "不同转换参数不应命中");
+
+    return bOk;
+}
+
+bool test_glb_cache_byte_budget()
+{
+    std::filesystem::path dir = test_dir("glb_cache_budget");
+    std::string small = write_file(dir / "small.osgb", "s");
+    std::string large = write_file(dir / "large.osgb", "l");
+
+    GlbCacheSettings settings;
+    settings.nMaxBytes = 16;
+    GlbCache cache(settings);
+
+    int calls = 0;
+    std::shared_ptr<const std::string> data;
+    cache.GetOrCreate(small, "opt", data, counting_producer(8, calls));
+
+    // 单个结果超过上限时不缓存，也不淘汰已有条目
+    cache.GetOrCreate(large, "opt", data, counting_producer(32, calls));
+    bool bOk = check(data && data->size() == 32, "超限结果仍应返回给调用方");
+    cache.GetOrCreate(large, "opt", data, counting_producer(32, calls));
+
+    GlbCacheStats stats = cache.GetStats();
+    bOk &= check(calls == 3, "超限结果不应缓存") &
+        check(stats.nEntries == 1 && stats.nBytes == 8, "已有条目不应被淘汰") &
+        check(stats.nEvictions == 0, "不应发生淘汰");
+
+    // 缩小上限时立即淘汰
+    settings.nMaxBytes = 4;
+    cache.Configure(settings);
+    stats = cache.GetStats();
+    bOk &= check(stats.nEntries == 0 && stats.nBytes == 0, "缩小上限后应淘汰超出的条目");
+
+    // 源文件变化后缓存失效
+    int changed_calls = 0;
+    settings.nMaxBytes = 16;
+    cache.Configure(settings);
+    cache.GetOrCreate(small, "opt", data, counting_producer(8, changed_calls));
+    write_file(dir / "small.osgb", "changed");
+    cache.GetOrCreate(small, "opt", data, counting_producer(8, changed_calls));
+    bOk &= check(changed_calls == 2, "源文件变化后应重新转换");
+
+    return bOk;
+}
+
+bool test_glb_cache_single_flight()
+{
+    std::filesystem::path dir = test_dir("glb_cache_flight");
+    std::string path = write_file(dir / "tile.osgb", "tile");
+
+    GlbCache cache;
+
+    std::atomic<int> calls(0);
+    auto producer = [&](std::string& data)
+    {
+        calls++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        data = "glb";
+        return true;
+    };
+
+    const int nThreads = 8;
+    std::vector<std::shared_ptr<const std::string>> results(nThreads);
+    std::vector<std::thread> threads;
+    std::atomic<int> failures(0);
+    for (int i = 0; i < nThreads; ++i)
+    {
+        threads.emplace_back([&, i]()
+        {
+            if (!cache.GetOrCreate(path, "opt", results[i], producer))
+            {
+                failures++;
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    bool bOk = check(calls == 1, "并发请求只应转换一次") & check(failures == 0, "所有请求都应成功");
+    for (const auto& result : results)
+    {
+        bOk &= check(result && result.get() == results[0].get(), "所有请求应共享同一份数据");
+    }
+
+    GlbCacheStats stats = cache.GetStats();
+    bOk &= check(stats.nMisses == 1 && stats.nHits == nThreads - 1, "统计应为 1 次未命中");
+
+    // 转换失败不缓存，下次请求重新转换
+    std::string failed = write_file(dir / "failed.osgb", "failed");
+    int failed_calls = 0;
+    auto failing = [&](std::string&) { failed_calls++; return false; };
+    std::shared_ptr<const std::string> data;
+    bOk &= check(!cache.GetOrCreate(failed, "opt", data, failing), "转换失败应返回 false");
+    cache.GetOrCreate(failed, "opt", data, failing);
+    bOk &= check(failed_calls == 2, "失败结果不应缓存");
+
+    return bOk;
+}
+
+bool test_tile_archive_round_trip()
+{
+    std::filesystem::path dir = test_dir("tile_archive");
+    std::string archive = (dir / "tiles.3tz").string();
+
+    std::string binary("b3dm\0\x01\xff", 7);
+    std::vector<std::pair<std::string, std::string>> files = {
+        { "tileset.json", "{\"asset\":{\"version\":\"1.0\"}}" },
+        { "Data/Tile_+000_+000/Tile_+000_+000.b3dm", binary },
+        { "Data/Tile_+000_+000/empty.b3dm", "" }
+    };
+
+    TileArchiveWriter writer;
+    bool bOk = check(writer.Open(archive), "归档创建失败");
+    for (const auto& file : files)
+    {
+        bOk &= check(writer.Append(file.first, file.second.data(), file.second.size()), "条目写入失败: " + file.first);
+    }
+    // 反斜杠与开头的 "./" 被规范化
+    bOk &= check(writer.Append(".\\Data\\nested.json", "{}", 2), "条目写入失败: nested.json");
+    bOk &= check(writer.Close(), "归档关闭失败");
+    if (!bOk)
+    {
+        return false;
+    }
+
+    TileArchiveReader reader;
+    if (!check(reader.Open(archive), "归档打开失败"))
+    {
+        return false;
+    }
+
+    bOk &= check(reader.GetEntryCount() == files.size() + 1, "条目数不正确（索引条目不应列出）");
+    for (const auto& file : files)
+    {
+        std::string data;
+        bOk &= check(reader.ReadEntry(file.first, data) && data == file.second, "条目内容不一致: " + file.first);
+    }
+
+    std::string data;
+    bOk &= check(reader.ReadEntry("Data/nested.json", data) && data == "{}", "规范化路径的条目应可读取") &
+        check(reader.Contains("/Data/Tile_+000_+000/Tile_+000_+000.b3dm"), "查找时应同样规范化路径") &
+        check(!reader.ReadEntry("Data/missing.b3dm", data), "不存在的条目应返回 false");
+
+    return bOk;
+}
+
+bool test_tile_archive_zip64()
+{
+    std::filesystem::path dir = test_dir("tile_archive_zip64");
+    std::string archive = (dir / "tiles.3tz").string();
+
+    // 条目数超过 65535 时使用 ZIP64 结束记录
+    const size_t nEntries = 70000;
+    TileArchiveWriter writer;
+    bool bOk = check(writer.Open(archive), "归档创建失败");
+    for (size_t i = 0; i < nEntries && bOk; ++i)
+    {
+        std::string content = std::to_string(i);
+        bOk &= check(writer.Append("Data/" + content + ".b3dm", content.data(), content.size()), "条目写入失败");
+    }
+    bOk &= check(writer.Close(), "归档关闭失败");
+    if (!bOk)
+    {
+        return false;
+    }
+
+    {
+        TileArchiveReader reader;
+        if (!check(reader.Open(archive), "ZIP64 归档打开失败"))
+        {
+            return false;
+        }
+
+        bOk &= check(reader.GetEntryCount() == nEntries, "ZIP64 条目数不正确");
+        for (size_t i : { size_t(0), size_t(65535), nEntries - 1 })
+        {
+            std::string data;
+            bOk &= check(reader.ReadEntry("Data/" + std::to_string(i) + ".b3dm", data) && data == std::to_string(i),
+                "ZIP64 条目内容不一致: " + std::to_string(i));
+        }
+    }
+
+    // 损坏的 ZIP64 结束记录应拒绝打开，而不是越界读取或抛出异常
+    std::string bytes;
+    {
+        std::ifstream file(archive, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    uint64_t nZip64EndPos = 0;
+    std::memcpy(&nZip64EndPos, bytes.data() + bytes.size() - 22 - 20 + 8, 8);
+
+    // 从 nField 起写入两个连续的 8 字节字段后打开
+    auto open_patched = [&](const std::string& name, size_t nField, uint64_t nValue, uint64_t nValue2)
+    {
+        std::string patched = bytes;
+        std::memcpy(&patched[nZip64EndPos + nField], &nValue, 8);
+        std::memcpy(&patched[nZip64EndPos + nField + 8], &nValue2, 8);
+        std::string path = (dir / name).string();
+        write_file(path, patched);
+
+        try
+        {
+            TileArchiveReader reader;
+            return check(!reader.Open(path), "损坏的中央目录应拒绝打开: " + name);
+        }
+        catch (const std::exception& e)
+        {
+            return check(false, "打开损坏的归档不应抛出异常: " + name + " (" + e.what() + ")");
+        }
+    };
+
+    // 条目数远超中央目录容量（预留前按中央目录大小截断）
+    bOk &= open_patched("entries.3tz", 24, uint64_t(1) << 40, uint64_t(1) << 40);
+
+    // 中央目录偏移与大小相加溢出（回绕后小于文件大小）
+    bOk &= open_patched("overflow.3tz", 40, 0x20, ~uint64_t(0) - 0xF);
+
+    return bOk;
+}
+
+bool test_zip_mount_reference_count()
+{
+    std::filesystem::path dir = test_dir("zip_mount");
+    std::string archive = (dir / "survey.zip").generic_string();
+
+    TileArchiveWriter writer;
+    std::string content = "osgb";
+    if (!check(writer.Open(archive) && writer.Append("Data/Tile_+000_+000/Tile_+000_+000.osgb",
+        content.data(), content.size()) && writer.Close(), "测试压缩包写入失败"))
+    {
+        return false;
+    }
+
+    // 两个任务同时读取同一压缩包
+    std::string entry;
+    auto first = ZipFileSystem::Acquire(archive + "/Data", entry);
+    auto second = ZipFileSystem::Acquire(archive + "/Data", entry);
+    bool bOk = check(first && first == second, "同一压缩包应共享同一映射") & check(entry == "Data", "包内路径不正确");
+    if (!bOk)
+    {
+        return false;
+    }
+
+    // 第一个任务结束后仍保留映射，第二个任务结束后关闭
+    ZipFileSystem::Release(first->GetArchivePath());
+    bOk &= check(ZipFileSystem::Resolve(archive, entry) == first, "其他任务仍持有时不应关闭");
+
+    ZipFileSystem::Release(second->GetArchivePath());
+    auto reopened = ZipFileSystem::Resolve(archive, entry);
+    bOk &= check(reopened && reopened != first, "最后一个持有者释放后应关闭");
+
+    std::string data;
+    bOk &= check(reopened && reopened->ReadFile("Data/Tile_+000_+000/Tile_+000_+000.osgb", data) && data == content,
+        "重新打开后应能读取条目");
+
+    // 释放测试创建的映射，之后才能删除测试目录
+    ZipFileSystem::Acquire(archive, entry);
+    ZipFileSystem::Release(archive);
+
+    return bOk;
+}
+
+bool test_subset_filter_region()
+{
+    SubsetSettings settings;
+    settings.vecRegion = SubsetFilter::BoxRegion(0.0, 0.0, 10.0, 10.0);
+    SubsetFilter filter(settings);
+
+    bool bOk = check(filter.HasRegion() && filter.IsActive(), "应限制区域");
+
+    // 圆心在区域内
+    bOk &= check(filter.IntersectsSphere(5.0, 5.0, 1.0), "区域内的包围球应相交");
+
+    // 区域外：远离区域，以及外包矩形相交但与角点距离大于半径
+    bOk &= check(!filter.IntersectsSphere(20.0, 20.0, 1.0), "远离区域的包围球不应相交") &
+        check(!filter.IntersectsSphere(15.0, 5.0, 4.9), "与边距离大于半径的包围球不应相交") &
+        check(!filter.IntersectsSphere(12.0, 12.0, 2.0), "与角点距离大于半径的包围球不应相交");
+
+    // 恰好与边或角点相切
+    bOk &= check(filter.IntersectsSphere(15.0, 5.0, 5.0), "与边相切的包围球应相交") &
+        check(filter.IntersectsSphere(13.0, 14.0, 5.0), "与角点相切的包围球应相交");
+
+    // 区域整体在包围球内
+    bOk &= check(filter.IntersectsSphere(5.0, 5.0, 100.0), "包含整个区域的包围球应相交");
+
+    // 凹多边形（L 形）的缺口处不相交
+    SubsetSettings concave;
+    concave.vecRegion = { 0.0, 0.0, 10.0, 0.0, 10.0, 4.0, 4.0, 4.0, 4.0, 10.0, 0.0, 10.0 };
+    SubsetFilter concave_filter(concave);
+    bOk &= check(!concave_filter.IntersectsSphere(8.0, 8.0, 1.0), "凹多边形缺口处的包围球不应相交") &
+        check(concave_filter.IntersectsSphere(2.0, 8.0, 1.0), "凹多边形内的包围球应相交");
+
+    // 少于 3 个顶点不限制区域
+    SubsetSettings degenerate;
+    degenerate.vecRegion = { 0.0, 0.0, 10.0, 10.0 };
+    SubsetFilter degenerate_filter(degenerate);
+    bOk &= check(!degenerate_filter.HasRegion() && !degenerate_filter.IsActive(), "少于 3 个顶点不应限制区域") &
+        check(degenerate_filter.IntersectsSphere(1000.0, 1000.0, 1.0), "未限制区域时总是相交");
+
+    return bOk;
+}
+
+bool test_subset_filter_origin_and_levels()
+{
+    // 区域为数据集坐标，节点为减去 SRSOrigin 后的本地坐标
+    SubsetSettings settings;
+    settings.vecRegion = SubsetFilter::BoxRegion(500100.0, 3500200.0, 500900.0, 3500800.0);
+    settings.nMinLevel = 16;
+    settings.nMaxLevel = 18;
+    SubsetFilter filter(settings, 500000.0, 3500000.0);
+
+    bool bOk = check(filter.IntersectsSphere(500.0, 500.0, 1.0), "平移后区域内的节点应相交") &
+        check(!filter.IntersectsSphere(50.0, 500.0, 10.0), "平移后区域外的节点不应相交") &
+        check(!filter.IntersectsSphere(500500.0, 3500500.0, 1.0), "区域不应按未平移的坐标比较") &
+        check(filter.IntersectsSphere(95.0, 500.0, 5.0), "平移后与边相切的节点应相交");
+
+    // 层级范围（含两端），无法识别层级（-1）时不过滤
+    bOk &= check(!filter.IsAboveMaxLevel(18) && filter.IsAboveMaxLevel(19), "最高层级判断不正确") &
+        check(!filter.IsBelowMinLevel(16) && filter.IsBelowMinLevel(15), "最低层级判断不正确") &
+        check(!filter.IsAboveMaxLevel(-1) && !filter.IsBelowMinLevel(-1), "未知层级不应过滤");
+
+    // 只限制层级
+    SubsetSettings levels_only;
+    levels_only.nMaxLevel = 17;
+    SubsetFilter levels_filter(levels_only);
+    bOk &= check(levels_filter.IsActive() && !levels_filter.HasRegion(), "只限制层级时应生效且不限制区域");
+
+    return bOk;
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+
+    const std::vector<std::pair<std::string, std::function<bool()>>> tests = {
+        { "glb_cache_lru_eviction", test_glb_cache_lru_eviction },
+        { "glb_cache_byte_budget", test_glb_cache_byte_budget },
+        { "glb_cache_single_flight", test_glb_cache_single_flight },
+        { "tile_archive_round_trip", test_tile_archive_round_trip },
+        { "tile_archive_zip64", test_tile_archive_zip64 },
+        { "zip_mount_reference_count", test_zip_mount_reference_count },
+        { "subset_filter_region", test_subset_filter_region },
+        { "subset_filter_origin_and_levels", test_subset_filter_origin_and_levels },
+    };
+
+    std::string strFilter = argc > 1 ? argv[1] : "";
+
+    int nFailed = 0;
+    int nRun = 0;
+    for (const auto& test : tests)
+    {
+        if (test.first.compare(0, strFilter.size(), strFilter) != 0)
+        {
+            continue;
+        }
+
+        nRun++;
+        bool bOk = test.second();
+        std::cout << (bOk ? "[SUCCESS] " : "[FAILED] ") << test.first << std::endl;
+        if (!bOk)
+        {
+            nFailed++;
+        }
+    }
+
+    std::filesystem::remove_all(std::filesystem::temp_directory_path() / "osgb_unit_test");
+
+    std::cout << "共运行 " << nRun << " 个测试，失败 " << nFailed << " 个" << std::endl;
+
+    return nFailed == 0 ? 0 : 1;
+}